@@ -18,6 +18,7 @@
 #include <TSystem.h>    // for TSystem, gSystem
 #include <cstdio>       // for printf, fprintf, fclose, fopen, FILE
 #include <cstring>      // for memcpy
+#include <vector>       // for vector
 #include "FairLogger.h" // for FairLogger
 #include "TMath.h"      // for BinarySearch, Sort
 #include "TMathBase.h"  // for Abs
@@ -444,6 +445,104 @@ void MagneticWrapperChebyshev::Field(const Double_t* xyz, Double_t* b) const
   par->Eval(xyz, b);
 }
 
+void MagneticWrapperChebyshev::fieldBatch(const Double_t* x, const Double_t* y, const Double_t* z, Double_t* bx,
+                                          Double_t* by, Double_t* bz, Int_t n) const
+{
+  fieldBatchImpl(x, y, z, bx, by, bz, n);
+}
+
+void MagneticWrapperChebyshev::fieldBatch(const Float_t* x, const Float_t* y, const Float_t* z, Float_t* bx,
+                                          Float_t* by, Float_t* bz, Int_t n) const
+{
+  fieldBatchImpl(x, y, z, bx, by, bz, n);
+}
+
+template <typename T>
+void MagneticWrapperChebyshev::fieldBatchImpl(const T* x, const T* y, const T* z, T* bx, T* by, T* bz, Int_t n) const
+{
+  // find the segment of every point exactly as Field does, numbering the solenoid segments first;
+  // points outside of the parameterized volume get a negative id
+  const int nSol = mNumberOfParameterizationSolenoid, nSeg = nSol + mNumberOfParameterizationDipole;
+  std::vector<int> segment(n), first(nSeg + 1, 0);
+  std::vector<T> pnt(2 * n); // r,phi for the solenoid, x,y for the dipole
+  for (int i = 0; i < n; i++) {
+    Double_t xyz[3] = {x[i], y[i], z[i]}, rphiz[3];
+    int id = -1;
+    if (xyz[2] > mMinZSolenoid) {
+      cartesianToCylindrical(xyz, rphiz);
+      id = findSolenoidSegment(rphiz);
+#ifndef _BRING_TO_BOUNDARY_
+      if (id >= 0 && !getParameterSolenoid(id)->isInside(rphiz)) {
+        id = -1;
+      }
+#endif
+      pnt[2 * i] = rphiz[0];
+      pnt[2 * i + 1] = rphiz[1];
+    } else {
+      id = findDipoleSegment(xyz);
+#ifndef _BRING_TO_BOUNDARY_
+      if (id >= 0 && !getParameterDipole(id)->isInside(xyz)) {
+        id = -1;
+      }
+#endif
+      if (id >= 0) {
+        id += nSol;
+      }
+      pnt[2 * i] = xyz[0];
+      pnt[2 * i + 1] = xyz[1];
+    }
+    segment[i] = id;
+    if (id < 0) {
+      bx[i] = by[i] = bz[i] = 0;
+    } else {
+      first[id + 1]++;
+    }
+  }
+
+  // group the points of the same segment together (counting sort) and evaluate each group at once
+  for (int is = 0; is < nSeg; is++) {
+    first[is + 1] += first[is];
+  }
+  const int nIn = first[nSeg];
+  std::vector<int> order(nIn), fill(first.begin(), first.end() - 1);
+  std::vector<T> grouped(6 * nIn);
+  T *g0 = grouped.data(), *g1 = g0 + nIn, *g2 = g1 + nIn, *b0 = g2 + nIn, *b1 = b0 + nIn, *b2 = b1 + nIn;
+  for (int i = 0; i < n; i++) {
+    if (segment[i] >= 0) {
+      int k = fill[segment[i]]++;
+      order[k] = i;
+      g0[k] = pnt[2 * i];
+      g1[k] = pnt[2 * i + 1];
+      g2[k] = z[i];
+    }
+  }
+  for (int is = 0; is < nSeg; is++) {
+    int k0 = first[is], np = first[is + 1] - k0;
+    if (!np) {
+      continue;
+    }
+    const T* par[3] = {g0 + k0, g1 + k0, g2 + k0};
+    T* res[3] = {b0 + k0, b1 + k0, b2 + k0};
+    (is < nSol ? getParameterSolenoid(is) : getParameterDipole(is - nSol))->Eval(par, res, np);
+  }
+
+  // scatter the results back, rotating the solenoid field from the cylindrical to the cartesian frame
+  // with cos(phi) = x/r, sin(phi) = y/r
+  const int nInSol = first[nSol];
+  for (int k = 0; k < nIn; k++) {
+    int i = order[k];
+    if (k < nInSol) {
+      T r = g0[k], cs = r > 0 ? x[i] / r : 1, sn = r > 0 ? y[i] / r : 0;
+      bx[i] = b0[k] * cs - b1[k] * sn;
+      by[i] = b0[k] * sn + b1[k] * cs;
+    } else {
+      bx[i] = b0[k];
+      by[i] = b1[k];
+    }
+    bz[i] = b2[k];
+  }
+}
+
 Double_t MagneticWrapperChebyshev::getBz(const Double_t* xyz) const
 {
   Double_t rphiz[3];
@@ -0,0 +1,88 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_MagneticField.cxx
+/// \brief Benchmark of the measured field map evaluation point by point and in batches
+
+#include "benchmark/benchmark.h"
+#include "Field/MagneticField.h"
+#include <fairlogger/Logger.h>
+#include <TMath.h>
+#include <random>
+#include <vector>
+
+using namespace o2::field;
+
+template <typename T>
+struct Points {
+  std::vector<T> x, y, z, bx, by, bz;
+};
+
+// random points in the parameterized volume of the map
+template <typename T>
+Points<T> generatePoints(const MagneticWrapperChebyshev& map, int n)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> r(0., map.getMaxRSol()), phi(0., TMath::TwoPi());
+  std::uniform_real_distribution<double> z(map.getMinZ(), map.getMaxZ());
+  Points<T> p;
+  for (auto* v : {&p.x, &p.y, &p.z, &p.bx, &p.by, &p.bz}) {
+    v->resize(n);
+  }
+  for (int i = 0; i < n; i++) {
+    double ri = r(gen), phii = phi(gen);
+    p.x[i] = ri * TMath::Cos(phii);
+    p.y[i] = ri * TMath::Sin(phii);
+    p.z[i] = z(gen);
+  }
+  return p;
+}
+
+MagneticWrapperChebyshev& getMap()
+{
+  static MagneticField field("Maps", "Maps", 1., 1., MagFieldParam::k5kG);
+  return *field.getMeasuredMap();
+}
+
+// Field called for each point
+static void BM_FieldScalar(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  const auto& map = getMap();
+  auto p = generatePoints<double>(map, state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      double xyz[3] = {p.x[i], p.y[i], p.z[i]}, b[3];
+      map.Field(xyz, b);
+      benchmark::DoNotOptimize(b);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// fieldBatch in double or float precision
+template <typename T>
+static void BM_FieldBatch(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  const auto& map = getMap();
+  auto p = generatePoints<T>(map, state.range(0));
+  for (auto _ : state) {
+    map.fieldBatch(p.x.data(), p.y.data(), p.z.data(), p.bx.data(), p.by.data(), p.bz.data(), state.range(0));
+    benchmark::DoNotOptimize(p.bz.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_FieldScalar)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_FieldBatch, double)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_FieldBatch, float)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
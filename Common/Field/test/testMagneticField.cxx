@@ -16,6 +16,8 @@
 #include "Field/MagneticField.h"
 #include "Field/MagFieldFast.h"
 #include <memory>
+#include <array>
+#include <vector>
 #include "FairLogger.h" // for FairLogger
 #include <TStopwatch.h>
 #include <TRandom.h>
@@ -97,3 +99,55 @@ BOOST_AUTO_TEST_CASE(MagneticField_test)
     BOOST_CHECK(TMath::Abs(rms[i] / nomBz) < 1.e-3);
   }
 }
+
+BOOST_AUTO_TEST_CASE(MagneticFieldBatch_test)
+{
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  const auto* map = fld->getMeasuredMap();
+
+  // points in the whole parameterized volume (solenoid and dipole) and slightly outside of it, including the axis
+  const int ntst = 100000;
+  const double rMax = map->getMaxRSol() + 20., zMin = map->getMinZ() - 20., zMax = map->getMaxZ() + 20.;
+  std::vector<double> x(ntst), y(ntst), z(ntst), bx(ntst), by(ntst), bz(ntst);
+  std::vector<float> xf(ntst), yf(ntst), zf(ntst), bxf(ntst), byf(ntst), bzf(ntst);
+  float rnd[3];
+  for (int it = ntst; it--;) {
+    gRandom->RndmArray(3, rnd);
+    double r = it % 100 ? rnd[0] * rMax : 0.;
+    x[it] = xf[it] = r * TMath::Cos(rnd[1] * TMath::Pi() * 2);
+    y[it] = yf[it] = r * TMath::Sin(rnd[1] * TMath::Pi() * 2);
+    z[it] = zf[it] = zMin + rnd[2] * (zMax - zMin); // same points in both precisions
+  }
+
+  TStopwatch swBatch;
+  swBatch.Start();
+  map->fieldBatch(x.data(), y.data(), z.data(), bx.data(), by.data(), bz.data(), ntst);
+  swBatch.Stop();
+  TStopwatch swBatchF;
+  swBatchF.Start();
+  map->fieldBatch(xf.data(), yf.data(), zf.data(), bxf.data(), byf.data(), bzf.data(), ntst);
+  swBatchF.Stop();
+
+  std::vector<std::array<double, 3>> bScalar(ntst);
+  TStopwatch swScalar;
+  swScalar.Start();
+  for (int it = 0; it < ntst; it++) {
+    double xyz[3] = {x[it], y[it], z[it]};
+    map->Field(xyz, bScalar[it].data());
+  }
+  swScalar.Stop();
+
+  int nOutside = 0;
+  for (int it = 0; it < ntst; it++) {
+    const auto& b = bScalar[it];
+    const double bb[3] = {bx[it], by[it], bz[it]}, bf[3] = {bxf[it], byf[it], bzf[it]};
+    nOutside += b[0] == 0. && b[1] == 0. && b[2] == 0.;
+    for (int i = 0; i < 3; i++) {
+      BOOST_CHECK_SMALL(bb[i] - b[i], 1e-5 * (1. + TMath::Abs(b[i])));
+      BOOST_CHECK_SMALL(bf[i] - b[i], 1e-4 * (1. + TMath::Abs(b[i])));
+    }
+  }
+  BOOST_CHECK(nOutside > 0 && nOutside < ntst / 2);
+  LOG(INFO) << "Timing per point: scalar " << swScalar.CpuTime() / ntst << " batch " << swBatch.CpuTime() / ntst
+            << " float batch " << swBatchF.CpuTime() / ntst << " s, " << nOutside << " points outside";
+}
@@ -135,6 +135,12 @@ class Chebyshev3D : public TNamed
 
   Double_t Eval(const Double_t* par, int idim);
 
+  /// Evaluates the parameterization in n points given by the arrays of their coordinates par[0], par[1], par[2],
+  /// filling the n values of i-th output dimension in res[i]. The points are processed in SIMD lanes.
+  void Eval(const Float_t* const* par, Float_t* const* res, int n) const;
+
+  void Eval(const Double_t* const* par, Double_t* const* res, int n) const;
+
   void evaluateDerivative(int dimd, const Float_t* par, Float_t* res);
 
   void evaluateDerivative2(int dimd1, int dimd2, const Float_t* par, Float_t* res);
@@ -233,6 +239,9 @@ class Chebyshev3D : public TNamed
   } // map from [-1:1] to x
 
  private:
+  template <typename T>
+  void evalLanes(const T* const* par, T* const* res, int n) const;
+
   Int_t mOutputArrayDimension;       ///< dimension of the ouput array
   Float_t mPrecision;                ///< requested precision
   Float_t mMinBoundaries[3];         ///< min boundaries in each dimension
@@ -147,6 +147,9 @@ class Chebyshev3DCalc : public TNamed
 
   static Float_t chebyshevEvaluation1D(Float_t x, const Float_t* array, int ncf);
 
+  /// Evaluates 1D Chebyshev parameterization for NLanes arguments x mapped to [-1:1] interval
+  static void chebyshevEvaluation1D(const Float_t* x, const Float_t* array, int ncf, Float_t* res);
+
   /// Evaluates 1D Chebyshev parameterization's derivative. x is the argument mapped to [-1:1] interval
   static Float_t chebyshevEvaluation1Derivative(Float_t x, const Float_t* array, int ncf);
 
@@ -168,6 +171,12 @@ class Chebyshev3DCalc : public TNamed
 
   Double_t Eval(const Double_t* par) const;
 
+  /// Evaluates Chebyshev parameterization for 3D function in NLanes points at once, par[i] being the NLanes
+  /// values of the i-th argument ALREADY MAPPED to [-1:1] interval
+  void Eval(const Float_t* const* par, Float_t* res) const;
+
+  static constexpr int NLanes = 8; ///< number of points processed together by the vectorized evaluation
+
  private:
   Int_t mNumberOfCoefficients;    ///< total number of coeeficients
   Int_t mNumberOfRows;            ///< number of significant rows in the 3D coeffs matrix
@@ -212,6 +221,22 @@ inline Float_t Chebyshev3DCalc::chebyshevEvaluation1D(Float_t x, const Float_t*
   return b0 - x * b1;
 }
 
+/// Evaluates 1D Chebyshev parameterization in NLanes points, the loops over the lanes are vectorized by the compiler
+inline void Chebyshev3DCalc::chebyshevEvaluation1D(const Float_t* x, const Float_t* array, int ncf, Float_t* res)
+{
+  Float_t b0[NLanes] = {0}, b1[NLanes] = {0}, b2[NLanes];
+  for (int i = ncf; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      b2[l] = b1[l];
+      b1[l] = b0[l];
+      b0[l] = array[i] + (x[l] + x[l]) * b1[l] - b2[l];
+    }
+  }
+  for (int l = 0; l < NLanes; l++) {
+    res[l] = b0[l] - x[l] * b1[l];
+  }
+}
+
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Float_t Chebyshev3DCalc::Eval(const Float_t* par) const
@@ -243,6 +268,41 @@ inline Double_t Chebyshev3DCalc::Eval(const Double_t* par) const
   }
   return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
 }
+
+/// Evaluates Chebyshev parameterization for 3D function in NLanes points.
+/// The 1D recursions over the 1st and 2nd dimensions are fused with the ones providing their coefficients,
+/// which are consumed in the same descending order as they are produced, so no temporary arrays are needed.
+/// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
+inline void Chebyshev3DCalc::Eval(const Float_t* const* par, Float_t* res) const
+{
+  const Float_t *x = par[0], *y = par[1];
+  Float_t b0x[NLanes] = {0}, b1x[NLanes] = {0}, b2x[NLanes], b0y[NLanes], b1y[NLanes], b2y[NLanes], cf[NLanes];
+  for (int id0 = mNumberOfRows; id0--;) {
+    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
+    int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    for (int l = 0; l < NLanes; l++) {
+      b0y[l] = b1y[l] = 0;
+    }
+    for (int id1 = nCLoc; id1--;) {
+      int id = id1 + col0;
+      chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id], cf);
+      for (int l = 0; l < NLanes; l++) {
+        b2y[l] = b1y[l];
+        b1y[l] = b0y[l];
+        b0y[l] = cf[l] + (y[l] + y[l]) * b1y[l] - b2y[l];
+      }
+    }
+    for (int l = 0; l < NLanes; l++) {
+      cf[l] = b0y[l] - y[l] * b1y[l];
+      b2x[l] = b1x[l];
+      b1x[l] = b0x[l];
+      b0x[l] = cf[l] + (x[l] + x[l]) * b1x[l] - b2x[l];
+    }
+  }
+  for (int l = 0; l < NLanes; l++) {
+    res[l] = b0x[l] - x[l] * b1x[l];
+  }
+}
 } // namespace math_utils
 } // namespace o2
 
@@ -17,6 +17,8 @@
 
 #ifndef GPUCA_GPUCODE_DEVICE
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #endif
 
 namespace o2
@@ -41,6 +43,24 @@ static float truncateFloatFraction(float x, uint32_t mask = 0xFFFFFF00)
   return myu.y;
 }
 
+#ifndef GPUCA_GPUCODE_DEVICE
+static void truncateFloatFraction(float* x, size_t n, uint32_t mask = 0xFFFFFF00)
+{
+  // In place truncation of n contiguous floats, written such that the compiler can vectorize it
+  constexpr uint32_t ProtMask = ((0x1u << 9) - 1u) << 23;
+  const uint32_t fullMask = ProtMask | mask;
+  if (fullMask == 0xFFFFFFFF) {
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    uint32_t iy;
+    std::memcpy(&iy, x + i, sizeof(float));
+    iy &= fullMask;
+    std::memcpy(x + i, &iy, sizeof(float));
+  }
+}
+#endif
+
 } // namespace detail
 } // namespace math_utils
 } // namespace o2
@@ -20,6 +20,7 @@
 #include <TRandom.h>                   // for TRandom, gRandom
 #include <TString.h>                   // for TString
 #include <TSystem.h>                   // for TSystem, gSystem
+#include <algorithm>                   // for min
 #include <cstdio>                      // for printf, fprintf, FILE, fclose, fflush, etc
 #include "MathUtils/Chebyshev3DCalc.h" // for Chebyshev3DCalc, etc
 #include "FairLogger.h"                // for FairLogger
@@ -323,6 +324,40 @@ void Chebyshev3D::Print(const Option_t* opt) const
   }
 }
 
+void Chebyshev3D::Eval(const Float_t* const* par, Float_t* const* res, int n) const
+{
+  evalLanes(par, res, n);
+}
+
+void Chebyshev3D::Eval(const Double_t* const* par, Double_t* const* res, int n) const
+{
+  evalLanes(par, res, n);
+}
+
+template <typename T>
+void Chebyshev3D::evalLanes(const T* const* par, T* const* res, int n) const
+{
+  // evaluate the parameterization in blocks of NLanes points, the lanes of the last incomplete block repeat its
+  // last point. The mapping to [-1:1] is done in the precision of the input, as in the single point Eval
+  constexpr int NLanes = Chebyshev3DCalc::NLanes;
+  Float_t mapped[3][NLanes], out[NLanes];
+  const Float_t* lanes[3] = {mapped[0], mapped[1], mapped[2]};
+  for (int i0 = 0; i0 < n; i0 += NLanes) {
+    int nl = std::min(NLanes, n - i0);
+    for (int d = 0; d < 3; d++) {
+      for (int l = 0; l < NLanes; l++) {
+        mapped[d][l] = mapToInternal(par[d][i0 + std::min(l, nl - 1)], d);
+      }
+    }
+    for (int i = 0; i < mOutputArrayDimension; i++) {
+      getChebyshevCalc(i)->Eval(lanes, out);
+      for (int l = 0; l < nl; l++) {
+        res[i][i0 + l] = out[l];
+      }
+    }
+  }
+}
+
 void Chebyshev3D::prepareBoundaries(const Float_t* bmin, const Float_t* bmax)
 {
   // Set and check boundaries defined by user, prepare coefficients for their conversion to [-1:1] interval
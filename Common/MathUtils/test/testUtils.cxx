@@ -17,6 +17,7 @@
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <vector>
 #include "MathUtils/Utils.h"
 
 using namespace o2;
@@ -120,3 +121,20 @@ BOOST_AUTO_TEST_CASE(Utils_test)
 
   } // test fastATan2()
 }
+
+BOOST_AUTO_TEST_CASE(TruncateFloatFraction_test)
+{
+  // the array version of truncateFloatFraction must give the same result as the scalar one
+  const int n = 1001;
+  std::vector<float> v(n), vt(n);
+  for (int i = 0; i < n; i++) {
+    v[i] = vt[i] = (i % 2 ? -1.f : 1.f) * std::pow(1.01f, i - n / 2) / 3.f;
+  }
+  for (uint32_t mask : {0xFFFFFFFFu, 0xFFFFFF00u, 0xFFFF0000u}) {
+    math_utils::truncateFloatFraction(vt.data(), n, mask);
+    for (int i = 0; i < n; i++) {
+      BOOST_CHECK_EQUAL(vt[i], math_utils::truncateFloatFraction(v[i], mask));
+    }
+    vt = v;
+  }
+}
@@ -16,6 +16,9 @@
 #ifndef ALICEO2_ENCODED_BLOCKS_H
 #define ALICEO2_ENCODED_BLOCKS_H
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <type_traits>
 #include <Rtypes.h>
 #include "rANS/rans.h"
@@ -410,6 +413,20 @@ class EncodedBlocks
   template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
   void decode(D_IT dest, int slot, const void* decoderExt = nullptr) const;
 
+  /// encode the message starting at srcBegin to the block at provided slot as consecutive sub-blocks which can be decoded
+  /// independently, chunkEnds giving the end of each sub-block in the message. The sub-blocks share the dictionary of the block.
+  /// When the message is entropy encoded, the data of the block start with the index of the sub-blocks: the end of the encoded
+  /// data of each of them (in words of the block data) followed by the end of its literals, 2 * chunkEnds.size() words in total
+  template <typename S_IT, typename VB>
+  void encodeChunks(const S_IT srcBegin, const std::vector<size_t>& chunkEnds, int slot, uint8_t probabilityBits, Metadata::OptStore opt,
+                    VB* buffer, const void* encoderExt);
+
+  /// decode the sub-block chunk out of nChunks of the block at provided slot encoded by encodeChunks: the nElements elements
+  /// starting at element elementBegin. If the block stores its dictionary, the provided decoder must be the one built from it
+  /// (see getDecoder), so that it is not rebuilt for every sub-block
+  template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+  void decodeChunk(D_IT dest, int slot, int chunk, int nChunks, size_t elementBegin, size_t nElements, const void* decoderExt = nullptr) const;
+
   /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
   static std::vector<char> createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& prbits);
 
@@ -452,6 +469,10 @@ class EncodedBlocks
   template <typename D>
   static void readTreeBranch(TTree& tree, const std::string& brname, D& dt, int ev = 0);
 
+  /// get the decoder for the block at provided slot: from the stored dictionary if any, otherwise the external one
+  template <typename dest_t>
+  const o2::rans::LiteralDecoder64<dest_t>* getDecoder(int slot, const void* decoderExt, std::unique_ptr<o2::rans::LiteralDecoder64<dest_t>>& decoderLoc) const;
+
   ClassDefNV(EncodedBlocks, 1);
 };
 
@@ -710,24 +731,8 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
   // decode
   if (block.getNStored()) {
     if (md.opt == Metadata::OptStore::EENCODE) {
-      if (!decoderExt && !block.getNDict()) {
-        LOG(ERROR) << "Dictionaty is not saved for slot " << slot << " and no external decoder is provided";
-        throw std::runtime_error("Dictionary is not saved and no external decoder provided");
-      }
-      const o2::rans::LiteralDecoder64<dest_t>* decoder = reinterpret_cast<const o2::rans::LiteralDecoder64<dest_t>*>(decoderExt);
       std::unique_ptr<o2::rans::LiteralDecoder64<dest_t>> decoderLoc;
-      if (block.getNDict()) { // if dictionaty is saved, prefer it
-        o2::rans::FrequencyTable frequencies;
-        frequencies.addFrequencies(block.getDict(), block.getDict() + block.getNDict(), md.min, md.max);
-        decoderLoc = std::make_unique<o2::rans::LiteralDecoder64<dest_t>>(frequencies, md.probabilityBits);
-        decoder = decoderLoc.get();
-      } else { // verify that decoded corresponds to stored metadata
-        if (md.min != decoder->getMinSymbol() || md.max != decoder->getMaxSymbol()) {
-          LOG(ERROR) << "Mismatch between min=" << md.min << "/" << md.max << " symbols in metadata and those in external decoder "
-                     << decoder->getMinSymbol() << "/" << decoder->getMaxSymbol() << " for slot " << slot;
-          throw std::runtime_error("Mismatch between min/max symbols in metadata and those in external decoder");
-        }
-      }
+      auto decoder = getDecoder<dest_t>(slot, decoderExt, decoderLoc);
       // load incompressible symbols if they existed
       std::vector<dest_t> literals;
       if (block.getNLiterals()) {
@@ -747,6 +752,171 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
   }
 }
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename dest_t>
+const o2::rans::LiteralDecoder64<dest_t>* EncodedBlocks<H, N, W>::getDecoder(int slot, const void* decoderExt,
+                                                                             std::unique_ptr<o2::rans::LiteralDecoder64<dest_t>>& decoderLoc) const
+{
+  const auto& block = mBlocks[slot];
+  const auto& md = mMetadata[slot];
+  if (!decoderExt && !block.getNDict()) {
+    LOG(ERROR) << "Dictionaty is not saved for slot " << slot << " and no external decoder is provided";
+    throw std::runtime_error("Dictionary is not saved and no external decoder provided");
+  }
+  const o2::rans::LiteralDecoder64<dest_t>* decoder = reinterpret_cast<const o2::rans::LiteralDecoder64<dest_t>*>(decoderExt);
+  if (block.getNDict()) { // if dictionaty is saved, prefer it
+    o2::rans::FrequencyTable frequencies;
+    frequencies.addFrequencies(block.getDict(), block.getDict() + block.getNDict(), md.min, md.max);
+    decoderLoc = std::make_unique<o2::rans::LiteralDecoder64<dest_t>>(frequencies, md.probabilityBits);
+    decoder = decoderLoc.get();
+  } else { // verify that decoded corresponds to stored metadata
+    if (md.min != decoder->getMinSymbol() || md.max != decoder->getMaxSymbol()) {
+      LOG(ERROR) << "Mismatch between min=" << md.min << "/" << md.max << " symbols in metadata and those in external decoder "
+                 << decoder->getMinSymbol() << "/" << decoder->getMaxSymbol() << " for slot " << slot;
+      throw std::runtime_error("Mismatch between min/max symbols in metadata and those in external decoder");
+    }
+  }
+  return decoder;
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
+void EncodedBlocks<H, N, W>::decodeChunk(D_IT dest,           // iterator to destination
+                                         int slot,            // slot of the block to decode
+                                         int chunk,           // sub-block to decode
+                                         int nChunks,         // number of sub-blocks of the block
+                                         size_t elementBegin, // first element of the sub-block in the message
+                                         size_t nElements,    // number of elements of the sub-block
+                                         const void* decoderExt) const // optional externally provided decoder
+{
+  const auto& block = mBlocks[slot];
+  const auto& md = mMetadata[slot];
+  using dest_t = typename std::iterator_traits<D_IT>::value_type;
+  if (!nElements || !block.getNStored()) {
+    return;
+  }
+  if (md.opt == Metadata::OptStore::EENCODE) {
+    std::unique_ptr<o2::rans::LiteralDecoder64<dest_t>> decoderLoc;
+    auto decoder = (decoderExt && block.getNDict()) ? reinterpret_cast<const o2::rans::LiteralDecoder64<dest_t>*>(decoderExt)
+                                                    : getDecoder<dest_t>(slot, decoderExt, decoderLoc);
+    // sub-block index at the beginning of the data: nChunks data ends followed by nChunks literal ends
+    const auto* index = block.getData();
+    const auto literalBegin = chunk ? index[nChunks + chunk - 1] : 0;
+    const auto literalEnd = index[nChunks + chunk];
+    std::vector<dest_t> literals;
+    if (literalEnd > literalBegin) {
+      auto lit = reinterpret_cast<const dest_t*>(block.getLiterals());
+      literals = std::vector<dest_t>{lit + literalBegin, lit + literalEnd};
+    }
+    decoder->process(dest, block.getData() + index[chunk], nElements, literals);
+  } else { // data was stored as is
+    auto srcBegin = reinterpret_cast<const dest_t*>(block.payload) + elementBegin;
+    std::copy(srcBegin, srcBegin + nElements, dest);
+  }
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename S_IT, typename VB>
+void EncodedBlocks<H, N, W>::encodeChunks(const S_IT srcBegin,                 // iterator begin of source message
+                                          const std::vector<size_t>& chunkEnds, // ends of the sub-blocks in the message
+                                          int slot,                             // slot in encoded data to fill
+                                          uint8_t probabilityBits,              // encoding into
+                                          Metadata::OptStore opt,               // option for data compression
+                                          VB* buffer,                           // optional buffer (vector) providing memory for encoded blocks
+                                          const void* encoderExt)               // optional external encoder
+{
+  using STYP = typename std::iterator_traits<S_IT>::value_type;
+  using stream_t = typename o2::rans::Encoder64<STYP>::stream_t;
+  const size_t messageLength = chunkEnds.empty() ? 0 : chunkEnds.back();
+  const size_t nChunks = chunkEnds.size();
+  if (opt != Metadata::OptStore::EENCODE || messageLength == 0) {
+    // sub-blocks of data stored as is are addressed by their elements only
+    encode(srcBegin, std::next(srcBegin, messageLength), slot, probabilityBits, opt, buffer, encoderExt);
+    return;
+  }
+  assert(slot == mRegistry.nFilledBlocks);
+  mRegistry.nFilledBlocks++;
+  static_assert(std::is_same<W, stream_t>());
+  const auto srcEnd = std::next(srcBegin, messageLength);
+
+  auto* bl = &mBlocks[slot];
+  auto* meta = &mMetadata[slot];
+
+  // resize underlying buffer of block if necessary and update all pointers.
+  auto expandStorage = [&](int nElems) {
+    auto eeb = get(bl->registry->head);           // extract pointer from the block, as "this" might be invalid
+    auto szNeed = eeb->estimateBlockSize(nElems); // size in bytes!!!
+    if (szNeed >= bl->registry->getFreeSize()) {
+      LOG(INFO) << "Slot " << slot << ": free size: " << bl->registry->getFreeSize() << ", need " << szNeed << " for " << nElems << " words";
+      if (buffer) {
+        eeb->expand(*buffer, size() + (szNeed - getFreeSize()));
+        meta = &(get(buffer->data())->mMetadata[slot]);
+        bl = &(get(buffer->data())->mBlocks[slot]); // in case of resizing this and any this.xxx becomes invalid
+      } else {
+        throw std::runtime_error("no room for encoded block in provided container");
+      }
+    }
+  };
+
+  constexpr size_t SizeEstMarginAbs = 10 * 1024;
+  constexpr float SizeEstMarginRel = 1.05;
+  const o2::rans::LiteralEncoder64<STYP>* encoder = reinterpret_cast<const o2::rans::LiteralEncoder64<STYP>*>(encoderExt);
+  std::unique_ptr<o2::rans::LiteralEncoder64<STYP>> encoderLoc;
+  std::unique_ptr<o2::rans::FrequencyTable> frequencies = nullptr;
+  int dictSize = 0;
+  if (!encoder) { // no external encoder provide, create one on spot from the full message
+    frequencies = std::make_unique<o2::rans::FrequencyTable>();
+    frequencies->addSamples(srcBegin, srcEnd);
+    encoderLoc = std::make_unique<o2::rans::LiteralEncoder64<STYP>>(*frequencies, probabilityBits);
+    encoder = encoderLoc.get();
+    dictSize = frequencies->size();
+  }
+
+  // estimate size of encode buffer, every sub-block has its own rANS states to flush and 2 words in the index
+  size_t dataSizeB = 2 * nChunks * sizeof(W), prevEnd = 0;
+  for (auto end : chunkEnds) {
+    dataSizeB += rans::calculateMaxBufferSize(end - prevEnd, encoder->getAlphabetRangeBits(), sizeof(STYP)) + 4 * sizeof(W);
+    prevEnd = end;
+  }
+  int dataSize = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSizeB / sizeof(W))) + (sizeof(STYP) < sizeof(W)); // size in words of output stream
+  expandStorage(dictSize + dataSize);
+  if (dictSize) {
+    bl->storeDict(dictSize, frequencies->data());
+  }
+  std::vector<STYP> literals;
+  auto blIn = bl->getCreateData();
+  auto frSize = bl->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
+  auto index = blIn; // sub-block index: data ends followed by literal ends
+  auto out = blIn + 2 * nChunks;
+  auto chunkBegin = srcBegin;
+  prevEnd = 0;
+  for (size_t ic = 0; ic < nChunks; ic++) {
+    auto chunkEnd = std::next(chunkBegin, chunkEnds[ic] - prevEnd);
+    if (chunkEnds[ic] > prevEnd) { // the encoder does not accept empty messages
+      out = encoder->process(out, blIn + frSize, chunkBegin, chunkEnd, literals);
+    }
+    index[ic] = out - blIn;
+    index[nChunks + ic] = literals.size();
+    chunkBegin = chunkEnd;
+    prevEnd = chunkEnds[ic];
+  }
+  dataSize = out - bl->getData();
+  bl->setNData(dataSize);
+  bl->realignBlock();
+
+  int literalSize = 0;
+  if (literals.size()) {
+    literalSize = (literals.size() * sizeof(STYP)) / sizeof(stream_t) + (sizeof(STYP) < sizeof(stream_t));
+    expandStorage(literalSize);
+    bl->storeLiterals(literalSize, reinterpret_cast<const stream_t*>(literals.data()));
+  }
+  *meta = Metadata{messageLength, literals.size(), sizeof(uint64_t), sizeof(stream_t), static_cast<uint8_t>(encoder->getProbabilityBits()), opt,
+                   encoder->getMinSymbol(), encoder->getMaxSymbol(), dictSize, dataSize, literalSize};
+}
+
 ///_____________________________________________________________________________
 template <typename H, int N, typename W>
 template <typename S_IT, typename VB>
@@ -24,10 +24,18 @@ namespace tpc
 {
 
 struct CTFHeader : public CompressedClustersCounters {
-  enum : uint32_t { CombinedColumns = 0x1 };
+  enum : uint32_t { CombinedColumns = 0x1,
+                    ChunkedColumns = 0x2 };
+  static constexpr int MaxChunks = 36; // one per sector
   uint32_t flags = 0;
 
-  ClassDefNV(CTFHeader, 1);
+  /// with ChunkedColumns set, each column is encoded as nChunks independently decodable sub-blocks: the clusters
+  /// of the tracks [i*nTracks/nChunks, (i+1)*nTracks/nChunks) for the attached columns and those of the sectors
+  /// [i*36/nChunks, (i+1)*36/nChunks) for the unattached ones. The counter columns are never split.
+  /// The index of the sub-blocks is stored at the beginning of the data of each entropy encoded column.
+  uint32_t nChunks = 0;
+
+  ClassDefNV(CTFHeader, 2);
 };
 
 /// wrapper for the Entropy-encoded clusters of the TF
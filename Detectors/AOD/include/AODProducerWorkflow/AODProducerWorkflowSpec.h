@@ -123,6 +123,43 @@ struct TripletEqualTo : std::binary_function<Triplet_t, Triplet_t, bool> {
 
 typedef boost::unordered_map<Triplet_t, int, TripletHash, TripletEqualTo> TripletsMap_t;
 
+// columns of the tracks tables (TracksTable, TracksCovTable, TracksExtraTable), filled in parallel
+// and appended to the tables in one go
+struct TracksColumns {
+  std::vector<int32_t> collisionId;
+  std::vector<uint8_t> trackType;
+  std::vector<float> x, alpha, y, z, snp, tgl, signed1Pt;
+  std::vector<float> sigmaY, sigmaZ, sigmaSnp, sigmaTgl, sigma1Pt;
+  std::vector<int8_t> rhoZY, rhoSnpY, rhoSnpZ, rhoTglY, rhoTglZ, rhoTglSnp, rho1PtY, rho1PtZ, rho1PtSnp, rho1PtTgl;
+  std::vector<float> tpcInnerParam;
+  std::vector<uint32_t> flags;
+  std::vector<uint8_t> itsClusterMap, tpcNClsFindable;
+  std::vector<int8_t> tpcNClsFindableMinusFound, tpcNClsFindableMinusCrossedRows;
+  std::vector<uint8_t> tpcNClsShared, trdPattern;
+  std::vector<float> itsChi2NCl, tpcChi2NCl, trdChi2, tofChi2, tpcSignal, trdSignal, tofSignal, length, tofExpMom, trackEtaEMCAL, trackPhiEMCAL;
+
+  void resize(size_t n);
+};
+
+// columns of the McTrackLabels table
+struct TrackLabelsColumns {
+  std::vector<int32_t> mcParticleId;
+  std::vector<uint16_t> mcMask;
+
+  void resize(size_t n);
+};
+
+// columns of the MCParticlesTable
+struct MCParticlesColumns {
+  std::vector<int32_t> mcCollisionId;
+  std::vector<int> pdgCode, statusCode;
+  std::vector<uint8_t> flags;
+  std::vector<int> mother0, mother1, daughter0, daughter1;
+  std::vector<float> weight, px, py, pz, e, vx, vy, vz, vt;
+
+  void resize(size_t n);
+};
+
 class AODProducerWorkflowDPL : public Task
 {
  public:
@@ -140,8 +177,11 @@ class AODProducerWorkflowDPL : public Task
   int mTruncate{1};
   int mIgnoreWriter{0};
   int mRecoOnly{0};
+  int mNThreads{1};
   TStopwatch mTimer;
 
+  static constexpr size_t ColumnsChunkSize = 1024; // number of rows filled and truncated by one task
+
   // truncation is enabled by default
   uint32_t mCollisionPosition = 0xFFFFFFF0;    // 19 bits mantissa
   uint32_t mCollisionPositionCov = 0xFFFFE000; // 10 bits mantissa
@@ -182,14 +222,20 @@ class AODProducerWorkflowDPL : public Task
   void findMinMaxBc(gsl::span<const o2::ft0::RecPoints>& ft0RecPoints, gsl::span<const o2::vertexing::PVertex>& primVertices, const std::vector<o2::InteractionTimeRecord>& mcRecords);
   uint64_t getTFNumber(uint64_t firstVtxGlBC, int runNumber);
 
-  template <typename TTracks, typename TTracksCursor, typename TTracksCovCursor, typename TTracksExtraCursor>
-  void fillTracksTable(const TTracks& tracks, std::vector<int>& vCollRefs, const TTracksCursor& tracksCursor,
-                       const TTracksCovCursor& tracksCovCursor, const TTracksExtraCursor& tracksExtraCursor, int trackType);
+  // fill the rows [offset, offset + tracks.size()) of the tracks columns
+  template <typename TTracks>
+  void fillTracksTable(const TTracks& tracks, const std::vector<int>& vCollRefs, TracksColumns& columns, size_t offset, int trackType);
+  void truncateTracksColumns(TracksColumns& columns, size_t first, size_t n) const;
+
+  // fill the rows [offset, offset + nLabels) of the track labels columns, getLabels(i) provides the ITS and TPC
+  // labels of the i-th track (the same label twice for single detector tracks)
+  template <typename TGetLabels>
+  void fillTrackLabels(size_t nLabels, const TGetLabels& getLabels, const TripletsMap_t& toStore, TrackLabelsColumns& columns, size_t offset);
 
-  template <typename MCParticlesCursorType>
-  void fillMCParticlesTable(o2::steer::MCKinematicsReader& mcReader, const MCParticlesCursorType& mcParticlesCursor,
+  void fillMCParticlesTable(o2::steer::MCKinematicsReader& mcReader, MCParticlesColumns& columns,
                             gsl::span<const o2::MCCompLabel>& mcTruthITS, gsl::span<const o2::MCCompLabel>& mcTruthTPC,
                             TripletsMap_t& toStore);
+  void truncateMCParticlesColumns(MCParticlesColumns& columns, size_t first, size_t n) const;
 
   void writeTableToFile(TFile* outfile, std::shared_ptr<arrow::Table>& table, const std::string& tableName, uint64_t tfNumber);
 };
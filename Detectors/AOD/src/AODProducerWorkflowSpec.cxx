@@ -31,7 +31,10 @@
 #include "SimulationDataFormat/MCTruthContainer.h"
 #include "TMath.h"
 #include "MathUtils/Utils.h"
+#include <array>
+#include <cmath>
 #include <map>
+#include <type_traits>
 #include <vector>
 
 using namespace o2::framework;
@@ -114,104 +117,170 @@ uint64_t AODProducerWorkflowDPL::getTFNumber(uint64_t firstVtxGlBC, int runNumbe
   return ts;
 };
 
-template <typename TTracks, typename TTracksCursor, typename TTracksCovCursor, typename TTracksExtraCursor>
-void AODProducerWorkflowDPL::fillTracksTable(const TTracks& tracks, std::vector<int>& vCollRefs, const TTracksCursor& tracksCursor,
-                                             const TTracksCovCursor& tracksCovCursor, const TTracksExtraCursor& tracksExtraCursor, int trackType)
+void TracksColumns::resize(size_t n)
 {
-  for (int i = 0; i < tracks.size(); i++) {
-    auto& track = tracks[i];
-    int collisionID = vCollRefs[i];
-
-    float tpcInnerParam = 0.f;
-    uint32_t flags = 0;
-    uint8_t itsClusterMap = 0;
-    uint8_t tpcNClsFindable = 0;
-    int8_t tpcNClsFindableMinusFound = 0;
-    int8_t tpcNClsFindableMinusCrossedRows = 0;
-    uint8_t tpcNClsShared = 0;
-    uint8_t trdPattern = 0;
-    float itsChi2NCl = -999.f;
-    float tpcChi2NCl = -999.f;
-    float trdChi2 = -999.f;
-    float tofChi2 = -999.f;
-    float tpcSignal = -999.f;
-    float trdSignal = -999.f;
-    float tofSignal = -999.f;
-    float length = -999.f;
-    float tofExpMom = -999.f;
-    float trackEtaEMCAL = -999.f;
-    float trackPhiEMCAL = -999.f;
-
-    // filling available columns for different track types
-    std::variant<o2::its::TrackITS, o2::tpc::TrackTPC, o2::dataformats::TrackTPCITS> tmp = track;
-    std::visit(
-      overloaded{
-        [&](o2::its::TrackITS itsTrack) {
-          itsClusterMap = itsTrack.getPattern();
-        },
-        [&](o2::tpc::TrackTPC tpcTrack) {
-          tpcChi2NCl = tpcTrack.getNClusters() ? tpcTrack.getChi2() / tpcTrack.getNClusters() : 0;
-          tpcSignal = tpcTrack.getdEdx().dEdxTotTPC;
-          tpcNClsFindable = tpcTrack.getNClusters();
-        },
-        [&](o2::dataformats::TrackTPCITS itsTpcTrack) {
-          LOG(DEBUG) << "TrackTPCITS: check";
-        }},
-      tmp);
-
-    // TODO:
-    // fill trackextra table
-    tracksCursor(0,
-                 collisionID,
-                 trackType,
-                 truncateFloatFraction(track.getX(), mTrackX),
-                 truncateFloatFraction(track.getAlpha(), mTrackAlpha),
-                 track.getY(),
-                 track.getZ(),
-                 truncateFloatFraction(track.getSnp(), mTrackSnp),
-                 truncateFloatFraction(track.getTgl(), mTrackTgl),
-                 truncateFloatFraction(track.getQ2Pt(), mTrack1Pt));
-    tracksCovCursor(0,
-                    truncateFloatFraction(TMath::Sqrt(track.getSigmaY2()), mTrackCovDiag),
-                    truncateFloatFraction(TMath::Sqrt(track.getSigmaZ2()), mTrackCovDiag),
-                    truncateFloatFraction(TMath::Sqrt(track.getSigmaSnp2()), mTrackCovDiag),
-                    truncateFloatFraction(TMath::Sqrt(track.getSigmaTgl2()), mTrackCovDiag),
-                    truncateFloatFraction(TMath::Sqrt(track.getSigma1Pt2()), mTrackCovDiag),
-                    (Char_t)(128. * track.getSigmaZY() / track.getSigmaZ2() / track.getSigmaY2()),
-                    (Char_t)(128. * track.getSigmaSnpY() / track.getSigmaSnp2() / track.getSigmaY2()),
-                    (Char_t)(128. * track.getSigmaSnpZ() / track.getSigmaSnp2() / track.getSigmaZ2()),
-                    (Char_t)(128. * track.getSigmaTglY() / track.getSigmaTgl2() / track.getSigmaY2()),
-                    (Char_t)(128. * track.getSigmaTglZ() / track.getSigmaTgl2() / track.getSigmaZ2()),
-                    (Char_t)(128. * track.getSigmaTglSnp() / track.getSigmaTgl2() / track.getSigmaSnp2()),
-                    (Char_t)(128. * track.getSigma1PtY() / track.getSigma1Pt2() / track.getSigmaY2()),
-                    (Char_t)(128. * track.getSigma1PtZ() / track.getSigma1Pt2() / track.getSigmaZ2()),
-                    (Char_t)(128. * track.getSigma1PtSnp() / track.getSigma1Pt2() / track.getSigmaSnp2()),
-                    (Char_t)(128. * track.getSigma1PtTgl() / track.getSigma1Pt2() / track.getSigmaTgl2()));
-    tracksExtraCursor(0,
-                      truncateFloatFraction(tpcInnerParam, mTrack1Pt),
-                      flags,
-                      itsClusterMap,
-                      tpcNClsFindable,
-                      tpcNClsFindableMinusFound,
-                      tpcNClsFindableMinusCrossedRows,
-                      tpcNClsShared,
-                      trdPattern,
-                      truncateFloatFraction(itsChi2NCl, mTrackCovOffDiag),
-                      truncateFloatFraction(tpcChi2NCl, mTrackCovOffDiag),
-                      truncateFloatFraction(trdChi2, mTrackCovOffDiag),
-                      truncateFloatFraction(tofChi2, mTrackCovOffDiag),
-                      truncateFloatFraction(tpcSignal, mTrackSignal),
-                      truncateFloatFraction(trdSignal, mTrackSignal),
-                      truncateFloatFraction(tofSignal, mTrackSignal),
-                      truncateFloatFraction(length, mTrackSignal),
-                      truncateFloatFraction(tofExpMom, mTrack1Pt),
-                      truncateFloatFraction(trackEtaEMCAL, mTrackPosEMCAL),
-                      truncateFloatFraction(trackPhiEMCAL, mTrackPosEMCAL));
+  for (auto* col : {&x, &alpha, &y, &z, &snp, &tgl, &signed1Pt, &sigmaY, &sigmaZ, &sigmaSnp, &sigmaTgl, &sigma1Pt, &tpcInnerParam,
+                    &itsChi2NCl, &tpcChi2NCl, &trdChi2, &tofChi2, &tpcSignal, &trdSignal, &tofSignal, &length, &tofExpMom, &trackEtaEMCAL, &trackPhiEMCAL}) {
+    col->resize(n);
+  }
+  for (auto* col : {&rhoZY, &rhoSnpY, &rhoSnpZ, &rhoTglY, &rhoTglZ, &rhoTglSnp, &rho1PtY, &rho1PtZ, &rho1PtSnp, &rho1PtTgl,
+                    &tpcNClsFindableMinusFound, &tpcNClsFindableMinusCrossedRows}) {
+    col->resize(n);
+  }
+  for (auto* col : {&trackType, &itsClusterMap, &tpcNClsFindable, &tpcNClsShared, &trdPattern}) {
+    col->resize(n);
+  }
+  collisionId.resize(n);
+  flags.resize(n);
+}
+
+void TrackLabelsColumns::resize(size_t n)
+{
+  mcParticleId.resize(n);
+  mcMask.resize(n);
+}
+
+void MCParticlesColumns::resize(size_t n)
+{
+  for (auto* col : {&weight, &px, &py, &pz, &e, &vx, &vy, &vz, &vt}) {
+    col->resize(n);
+  }
+  for (auto* col : {&pdgCode, &statusCode, &mother0, &mother1, &daughter0, &daughter1}) {
+    col->resize(n);
+  }
+  mcCollisionId.resize(n);
+  flags.resize(n);
+}
+
+template <typename TTracks>
+void AODProducerWorkflowDPL::fillTracksTable(const TTracks& tracks, const std::vector<int>& vCollRefs, TracksColumns& columns, size_t offset, int trackType)
+{
+  using TrackT = std::decay_t<decltype(tracks[0])>;
+  const size_t nTracks = tracks.size();
+  const int nChunks = (nTracks + ColumnsChunkSize - 1) / ColumnsChunkSize;
+  // every chunk of rows is filled and then truncated column-wise, the chunks are independent
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iChunk = 0; iChunk < nChunks; iChunk++) {
+    size_t first = iChunk * ColumnsChunkSize, last = std::min(first + ColumnsChunkSize, nTracks);
+    for (size_t i = first; i < last; i++) {
+      const auto& track = tracks[i];
+      size_t row = offset + i;
+      columns.collisionId[row] = vCollRefs[i];
+      columns.trackType[row] = trackType;
+      columns.x[row] = track.getX();
+      columns.alpha[row] = track.getAlpha();
+      columns.y[row] = track.getY();
+      columns.z[row] = track.getZ();
+      columns.snp[row] = track.getSnp();
+      columns.tgl[row] = track.getTgl();
+      columns.signed1Pt[row] = track.getQ2Pt();
+
+      columns.sigmaY[row] = std::sqrt(track.getSigmaY2());
+      columns.sigmaZ[row] = std::sqrt(track.getSigmaZ2());
+      columns.sigmaSnp[row] = std::sqrt(track.getSigmaSnp2());
+      columns.sigmaTgl[row] = std::sqrt(track.getSigmaTgl2());
+      columns.sigma1Pt[row] = std::sqrt(track.getSigma1Pt2());
+      columns.rhoZY[row] = (Char_t)(128. * track.getSigmaZY() / track.getSigmaZ2() / track.getSigmaY2());
+      columns.rhoSnpY[row] = (Char_t)(128. * track.getSigmaSnpY() / track.getSigmaSnp2() / track.getSigmaY2());
+      columns.rhoSnpZ[row] = (Char_t)(128. * track.getSigmaSnpZ() / track.getSigmaSnp2() / track.getSigmaZ2());
+      columns.rhoTglY[row] = (Char_t)(128. * track.getSigmaTglY() / track.getSigmaTgl2() / track.getSigmaY2());
+      columns.rhoTglZ[row] = (Char_t)(128. * track.getSigmaTglZ() / track.getSigmaTgl2() / track.getSigmaZ2());
+      columns.rhoTglSnp[row] = (Char_t)(128. * track.getSigmaTglSnp() / track.getSigmaTgl2() / track.getSigmaSnp2());
+      columns.rho1PtY[row] = (Char_t)(128. * track.getSigma1PtY() / track.getSigma1Pt2() / track.getSigmaY2());
+      columns.rho1PtZ[row] = (Char_t)(128. * track.getSigma1PtZ() / track.getSigma1Pt2() / track.getSigmaZ2());
+      columns.rho1PtSnp[row] = (Char_t)(128. * track.getSigma1PtSnp() / track.getSigma1Pt2() / track.getSigmaSnp2());
+      columns.rho1PtTgl[row] = (Char_t)(128. * track.getSigma1PtTgl() / track.getSigma1Pt2() / track.getSigmaTgl2());
+
+      // TODO:
+      // fill trackextra table
+      uint8_t itsClusterMap = 0;
+      uint8_t tpcNClsFindable = 0;
+      float tpcChi2NCl = -999.f;
+      float tpcSignal = -999.f;
+      // filling available columns for different track types
+      if constexpr (std::is_same_v<TrackT, o2::its::TrackITS>) {
+        itsClusterMap = track.getPattern();
+      } else if constexpr (std::is_same_v<TrackT, o2::tpc::TrackTPC>) {
+        tpcChi2NCl = track.getNClusters() ? track.getChi2() / track.getNClusters() : 0;
+        tpcSignal = track.getdEdx().dEdxTotTPC;
+        tpcNClsFindable = track.getNClusters();
+      }
+      columns.tpcInnerParam[row] = 0.f;
+      columns.flags[row] = 0;
+      columns.itsClusterMap[row] = itsClusterMap;
+      columns.tpcNClsFindable[row] = tpcNClsFindable;
+      columns.tpcNClsFindableMinusFound[row] = 0;
+      columns.tpcNClsFindableMinusCrossedRows[row] = 0;
+      columns.tpcNClsShared[row] = 0;
+      columns.trdPattern[row] = 0;
+      columns.itsChi2NCl[row] = -999.f;
+      columns.tpcChi2NCl[row] = tpcChi2NCl;
+      columns.trdChi2[row] = -999.f;
+      columns.tofChi2[row] = -999.f;
+      columns.tpcSignal[row] = tpcSignal;
+      columns.trdSignal[row] = -999.f;
+      columns.tofSignal[row] = -999.f;
+      columns.length[row] = -999.f;
+      columns.tofExpMom[row] = -999.f;
+      columns.trackEtaEMCAL[row] = -999.f;
+      columns.trackPhiEMCAL[row] = -999.f;
+    }
+    truncateTracksColumns(columns, offset + first, last - first);
+  }
+}
+
+void AODProducerWorkflowDPL::truncateTracksColumns(TracksColumns& columns, size_t first, size_t n) const
+{
+  const std::pair<std::vector<float>*, uint32_t> toTruncate[] = {
+    {&columns.x, mTrackX}, {&columns.alpha, mTrackAlpha}, {&columns.snp, mTrackSnp}, {&columns.tgl, mTrackTgl}, {&columns.signed1Pt, mTrack1Pt}, {&columns.sigmaY, mTrackCovDiag}, {&columns.sigmaZ, mTrackCovDiag}, {&columns.sigmaSnp, mTrackCovDiag}, {&columns.sigmaTgl, mTrackCovDiag}, {&columns.sigma1Pt, mTrackCovDiag}, {&columns.tpcInnerParam, mTrack1Pt}, {&columns.itsChi2NCl, mTrackCovOffDiag}, {&columns.tpcChi2NCl, mTrackCovOffDiag}, {&columns.trdChi2, mTrackCovOffDiag}, {&columns.tofChi2, mTrackCovOffDiag}, {&columns.tpcSignal, mTrackSignal}, {&columns.trdSignal, mTrackSignal}, {&columns.tofSignal, mTrackSignal}, {&columns.length, mTrackSignal}, {&columns.tofExpMom, mTrack1Pt}, {&columns.trackEtaEMCAL, mTrackPosEMCAL}, {&columns.trackPhiEMCAL, mTrackPosEMCAL}};
+  for (auto& [col, mask] : toTruncate) {
+    truncateFloatFraction(col->data() + first, n, mask);
   }
 }
 
-template <typename MCParticlesCursorType>
-void AODProducerWorkflowDPL::fillMCParticlesTable(o2::steer::MCKinematicsReader& mcReader, const MCParticlesCursorType& mcParticlesCursor,
+template <typename TGetLabels>
+void AODProducerWorkflowDPL::fillTrackLabels(size_t nLabels, const TGetLabels& getLabels, const TripletsMap_t& toStore, TrackLabelsColumns& columns, size_t offset)
+{
+  // labelMask (temporary) usage:
+  //   bit 13 -- ITS and TPC labels are not equal
+  //   bit 14 -- isNoise() == true
+  //   bit 15 -- isFake() == true
+  // labelID = std::numeric_limits<uint32_t>::max() -- label is not set
+  // the map is only read here, concurrent lookups are safe
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNThreads)
+#endif
+  for (size_t i = 0; i < nLabels; i++) {
+    const auto [mcTruthITS, mcTruthTPC] = getLabels(i);
+    uint32_t labelID = std::numeric_limits<uint32_t>::max();
+    uint32_t labelITS = std::numeric_limits<uint32_t>::max();
+    uint32_t labelTPC = std::numeric_limits<uint32_t>::max();
+    // TODO: fill label mask
+    // currently using label mask to indicate labelITS != labelTPC
+    uint16_t labelMask = 0;
+    if (mcTruthITS.isValid() && mcTruthTPC.isValid()) {
+      labelITS = toStore.at(Triplet_t(mcTruthITS.getSourceID(), mcTruthITS.getEventID(), mcTruthITS.getTrackID()));
+      labelTPC = mcTruthTPC == mcTruthITS ? labelITS : toStore.at(Triplet_t(mcTruthTPC.getSourceID(), mcTruthTPC.getEventID(), mcTruthTPC.getTrackID()));
+      labelID = labelITS;
+    }
+    if (mcTruthITS.isFake() || mcTruthTPC.isFake()) {
+      labelMask |= (0x1 << 15);
+    }
+    if (mcTruthITS.isNoise() || mcTruthTPC.isNoise()) {
+      labelMask |= (0x1 << 14);
+    }
+    if (labelITS != labelTPC) {
+      LOG(DEBUG) << "ITS-TPC MCTruth: labelIDs do not match at " << i;
+      labelMask |= (0x1 << 13);
+    }
+    columns.mcParticleId[offset + i] = labelID;
+    columns.mcMask[offset + i] = labelMask;
+  }
+}
+
+void AODProducerWorkflowDPL::fillMCParticlesTable(o2::steer::MCKinematicsReader& mcReader, MCParticlesColumns& columns,
                                                   gsl::span<const o2::MCCompLabel>& mcTruthITS, gsl::span<const o2::MCCompLabel>& mcTruthTPC,
                                                   TripletsMap_t& toStore)
 {
@@ -235,6 +304,7 @@ void AODProducerWorkflowDPL::fillMCParticlesTable(o2::steer::MCKinematicsReader&
     toStore[Triplet_t(source, event, particle)] = 1;
   }
   int tableIndex = 1;
+  std::vector<int> storedParticles;
   for (int source = 0; source < mcReader.getNSources(); source++) {
     for (int event = 0; event < mcReader.getNEvents(source); event++) {
       std::vector<MCTrack> const& mcParticles = mcReader.getTracks(source, event);
@@ -265,78 +335,74 @@ void AODProducerWorkflowDPL::fillMCParticlesTable(o2::steer::MCKinematicsReader&
             toStore[Triplet_t(source, event, daughterL)] = 1;
           }
         }
-        // enumerate reconstructed mc particles and their relatives to get mother/daughter relations
-        for (int particle = 0; particle < mcParticles.size(); particle++) {
+      }
+      // enumerate the mc particles to store (all of them if !mRecoOnly) to get mother/daughter relations,
+      // the table index of a particle - 1 is its row in the table
+      storedParticles.clear();
+      for (int particle = 0; particle < mcParticles.size(); particle++) {
+        if (mRecoOnly) {
           auto mapItem = toStore.find(Triplet_t(source, event, particle));
-          if (mapItem != toStore.end()) {
-            mapItem->second = tableIndex;
-            tableIndex++;
+          if (mapItem == toStore.end()) {
+            continue;
           }
-        }
-      }
-      // if all mc particles are stored, all mc particles will be enumerated
-      if (!mRecoOnly) {
-        for (int particle = 0; particle < mcParticles.size(); particle++) {
+          mapItem->second = tableIndex;
+        } else {
           toStore[Triplet_t(source, event, particle)] = tableIndex;
-          tableIndex++;
         }
+        tableIndex++;
+        storedParticles.push_back(particle);
       }
-      // fill survived mc tracks into the table
-      for (int particle = 0; particle < mcParticles.size(); particle++) {
-        if (toStore.find(Triplet_t(source, event, particle)) == toStore.end()) {
-          continue;
-        }
-        int statusCode = 0;
-        uint8_t flags = 0;
-        float weight = 0.f;
-        int mcMother0 = mcParticles[particle].getMotherTrackId();
-        auto item = toStore.find(Triplet_t(source, event, mcMother0));
-        int mother0 = -1;
-        if (item != toStore.end()) {
-          mother0 = item->second;
-        }
-        int mcMother1 = mcParticles[particle].getSecondMotherTrackId();
-        int mother1 = -1;
-        item = toStore.find(Triplet_t(source, event, mcMother1));
-        if (item != toStore.end()) {
-          mother1 = item->second;
-        }
-        int mcDaughter0 = mcParticles[particle].getFirstDaughterTrackId();
-        int daughter0 = -1;
-        item = toStore.find(Triplet_t(source, event, mcDaughter0));
-        if (item != toStore.end()) {
-          daughter0 = item->second;
-        }
-        int mcDaughterL = mcParticles[particle].getLastDaughterTrackId();
-        int daughterL = -1;
-        item = toStore.find(Triplet_t(source, event, mcDaughterL));
-        if (item != toStore.end()) {
-          daughterL = item->second;
+      // fill survived mc tracks into the table, the map is only read here
+      const size_t firstRow = columns.pdgCode.size();
+      const size_t nStored = storedParticles.size();
+      columns.resize(firstRow + nStored);
+      const int nChunks = (nStored + ColumnsChunkSize - 1) / ColumnsChunkSize;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+      for (int iChunk = 0; iChunk < nChunks; iChunk++) {
+        size_t first = iChunk * ColumnsChunkSize, last = std::min(first + ColumnsChunkSize, nStored);
+        for (size_t i = first; i < last; i++) {
+          const auto& mcParticle = mcParticles[storedParticles[i]];
+          auto getTableIndex = [&](int particle) {
+            auto item = toStore.find(Triplet_t(source, event, particle));
+            return item != toStore.end() ? item->second : -1;
+          };
+          size_t row = firstRow + i;
+          columns.mcCollisionId[row] = event;
+          columns.pdgCode[row] = mcParticle.GetPdgCode();
+          columns.statusCode[row] = 0;
+          columns.flags[row] = 0;
+          columns.mother0[row] = getTableIndex(mcParticle.getMotherTrackId());
+          columns.mother1[row] = getTableIndex(mcParticle.getSecondMotherTrackId());
+          columns.daughter0[row] = getTableIndex(mcParticle.getFirstDaughterTrackId());
+          columns.daughter1[row] = getTableIndex(mcParticle.getLastDaughterTrackId());
+          columns.weight[row] = 0.f;
+          columns.px[row] = mcParticle.Px();
+          columns.py[row] = mcParticle.Py();
+          columns.pz[row] = mcParticle.Pz();
+          columns.e[row] = mcParticle.GetEnergy();
+          columns.vx[row] = mcParticle.Vx();
+          columns.vy[row] = mcParticle.Vy();
+          columns.vz[row] = mcParticle.Vz();
+          columns.vt[row] = mcParticle.T();
         }
-        mcParticlesCursor(0,
-                          event,
-                          mcParticles[particle].GetPdgCode(),
-                          statusCode,
-                          flags,
-                          mother0,
-                          mother1,
-                          daughter0,
-                          daughterL,
-                          truncateFloatFraction(weight, mMcParticleW),
-                          truncateFloatFraction((float)mcParticles[particle].Px(), mMcParticleMom),
-                          truncateFloatFraction((float)mcParticles[particle].Py(), mMcParticleMom),
-                          truncateFloatFraction((float)mcParticles[particle].Pz(), mMcParticleMom),
-                          truncateFloatFraction((float)mcParticles[particle].GetEnergy(), mMcParticleMom),
-                          truncateFloatFraction((float)mcParticles[particle].Vx(), mMcParticlePos),
-                          truncateFloatFraction((float)mcParticles[particle].Vy(), mMcParticlePos),
-                          truncateFloatFraction((float)mcParticles[particle].Vz(), mMcParticlePos),
-                          truncateFloatFraction((float)mcParticles[particle].T(), mMcParticlePos));
+        truncateMCParticlesColumns(columns, firstRow + first, last - first);
       }
       mcReader.releaseTracksForSourceAndEvent(source, event);
     }
   }
 }
 
+void AODProducerWorkflowDPL::truncateMCParticlesColumns(MCParticlesColumns& columns, size_t first, size_t n) const
+{
+  const std::pair<std::vector<float>*, uint32_t> toTruncate[] = {
+    {&columns.weight, mMcParticleW}, {&columns.px, mMcParticleMom}, {&columns.py, mMcParticleMom}, {&columns.pz, mMcParticleMom}, {&columns.e, mMcParticleMom}, {&columns.vx, mMcParticlePos}, {&columns.vy, mMcParticlePos}, {&columns.vz, mMcParticlePos}, {&columns.vt, mMcParticlePos}};
+  for (auto& [col, mask] : toTruncate) {
+    truncateFloatFraction(col->data() + first, n, mask);
+  }
+}
+
 void AODProducerWorkflowDPL::writeTableToFile(TFile* outfile, std::shared_ptr<arrow::Table>& table, const std::string& tableName, uint64_t tfNumber)
 {
   std::string treeName;
@@ -357,6 +423,13 @@ void AODProducerWorkflowDPL::init(InitContext& ic)
   mTFNumber = ic.options().get<int>("aod-timeframe-id");
   mRecoOnly = ic.options().get<int>("reco-mctracks-only");
   mTruncate = ic.options().get<int>("enable-truncation");
+  mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+#ifndef WITH_OPENMP
+  if (mNThreads > 1) {
+    LOG(WARNING) << "Multi-threading was requested but is not available, using 1 thread";
+    mNThreads = 1;
+  }
+#endif
 
   if (mTFNumber == -1) {
     LOG(INFO) << "TFNumber will be obtained from CCDB";
@@ -456,11 +529,6 @@ void AODProducerWorkflowDPL::run(ProcessingContext& pc)
   auto collisionsCursor = collisionsBuilder.cursor<o2::aod::Collisions>();
   auto ft0Cursor = ft0Builder.cursor<o2::aod::FT0s>();
   auto mcCollisionsCursor = mcCollisionsBuilder.cursor<o2::aod::McCollisions>();
-  auto tracksCursor = tracksBuilder.cursor<o2::aodproducer::TracksTable>();
-  auto tracksCovCursor = tracksCovBuilder.cursor<o2::aodproducer::TracksCovTable>();
-  auto tracksExtraCursor = tracksExtraBuilder.cursor<o2::aodproducer::TracksExtraTable>();
-  auto mcParticlesCursor = mcParticlesBuilder.cursor<o2::aodproducer::MCParticlesTable>();
-  auto mcTrackLabelCursor = mcTrackLabelBuilder.cursor<o2::aod::McTrackLabels>();
   auto fv0aCursor = fv0aBuilder.cursor<o2::aod::FV0As>();
   auto fv0cCursor = fv0cBuilder.cursor<o2::aod::FV0Cs>();
   auto fddCursor = fddBuilder.cursor<o2::aod::FDDs>();
@@ -758,7 +826,28 @@ void AODProducerWorkflowDPL::run(ProcessingContext& pc)
 
   // filling mc particles table
   TripletsMap_t toStore;
-  fillMCParticlesTable(mcReader, mcParticlesCursor, tracksITSMCTruth, tracksTPCMCTruth, toStore);
+  MCParticlesColumns mcParticlesColumns;
+  fillMCParticlesTable(mcReader, mcParticlesColumns, tracksITSMCTruth, tracksTPCMCTruth, toStore);
+  size_t nMCParticles = mcParticlesColumns.pdgCode.size();
+  auto mcParticlesCursor = mcParticlesBuilder.bulkCursor<o2::aodproducer::MCParticlesTable>(nMCParticles);
+  mcParticlesCursor(0,
+                    mcParticlesColumns.mcCollisionId,
+                    mcParticlesColumns.pdgCode,
+                    mcParticlesColumns.statusCode,
+                    mcParticlesColumns.flags,
+                    mcParticlesColumns.mother0,
+                    mcParticlesColumns.mother1,
+                    mcParticlesColumns.daughter0,
+                    mcParticlesColumns.daughter1,
+                    mcParticlesColumns.weight,
+                    mcParticlesColumns.px,
+                    mcParticlesColumns.py,
+                    mcParticlesColumns.pz,
+                    mcParticlesColumns.e,
+                    mcParticlesColumns.vx,
+                    mcParticlesColumns.vy,
+                    mcParticlesColumns.vz,
+                    mcParticlesColumns.vt);
   if (mIgnoreWriter) {
     std::shared_ptr<arrow::Table> tableMCParticles = mcParticlesBuilder.finalize();
     std::string tableName("O2mcparticle");
@@ -766,93 +855,104 @@ void AODProducerWorkflowDPL::run(ProcessingContext& pc)
   }
 
   // filling tracks tables and track label table
-
-  // labelMask (temporary) usage:
-  //   bit 13 -- ITS and TPC labels are not equal
-  //   bit 14 -- isNoise() == true
-  //   bit 15 -- isFake() == true
-  // labelID = std::numeric_limits<uint32_t>::max() -- label is not set
-
-  uint32_t labelID;
-  uint32_t labelITS;
-  uint32_t labelTPC;
-  uint16_t labelMask;
+  // the rows of each track type (and of their labels) are placed after those of the previous types
+  size_t nTracks = 0, nLabels = 0;
+  std::array<size_t, 3> trackOffsets{}, labelOffsets{}; // ITS, TPC, ITSTPC
+  if (mFillTracksITS) {
+    trackOffsets[0] = nTracks;
+    labelOffsets[0] = nLabels;
+    nTracks += tracksITS.size();
+    nLabels += tracksITSMCTruth.size();
+  }
+  if (mFillTracksTPC) {
+    trackOffsets[1] = nTracks;
+    labelOffsets[1] = nLabels;
+    nTracks += tracksTPC.size();
+    nLabels += tracksTPCMCTruth.size();
+  }
+  if (mFillTracksITSTPC) {
+    trackOffsets[2] = nTracks;
+    labelOffsets[2] = nLabels;
+    nTracks += tracksITSTPC.size();
+    nLabels += tracksITSTPC.size();
+  }
+  TracksColumns tracksColumns;
+  TrackLabelsColumns trackLabelsColumns;
+  tracksColumns.resize(nTracks);
+  trackLabelsColumns.resize(nLabels);
 
   if (mFillTracksITS) {
-    fillTracksTable(tracksITS, vCollRefsITS, tracksCursor, tracksCovCursor, tracksExtraCursor, o2::vertexing::GIndex::Source::ITS);
-    for (auto& mcTruthITS : tracksITSMCTruth) {
-      labelID = std::numeric_limits<uint32_t>::max();
-      // TODO: fill label mask
-      labelMask = 0;
-      if (mcTruthITS.isValid()) {
-        labelID = toStore.at(Triplet_t(mcTruthITS.getSourceID(), mcTruthITS.getEventID(), mcTruthITS.getTrackID()));
-      }
-      if (mcTruthITS.isFake()) {
-        labelMask |= (0x1 << 15);
-      }
-      if (mcTruthITS.isNoise()) {
-        labelMask |= (0x1 << 14);
-      }
-      mcTrackLabelCursor(0,
-                         labelID,
-                         labelMask);
-    }
+    fillTracksTable(tracksITS, vCollRefsITS, tracksColumns, trackOffsets[0], o2::vertexing::GIndex::Source::ITS);
+    fillTrackLabels(
+      tracksITSMCTruth.size(), [&](size_t i) { return std::make_pair(tracksITSMCTruth[i], tracksITSMCTruth[i]); }, toStore, trackLabelsColumns, labelOffsets[0]);
   }
 
   if (mFillTracksTPC) {
-    fillTracksTable(tracksTPC, vCollRefsTPC, tracksCursor, tracksCovCursor, tracksExtraCursor, o2::vertexing::GIndex::Source::TPC);
-    for (auto& mcTruthTPC : tracksTPCMCTruth) {
-      labelID = std::numeric_limits<uint32_t>::max();
-      // TODO: fill label mask
-      labelMask = 0;
-      if (mcTruthTPC.isValid()) {
-        labelID = toStore.at(Triplet_t(mcTruthTPC.getSourceID(), mcTruthTPC.getEventID(), mcTruthTPC.getTrackID()));
-      }
-      if (mcTruthTPC.isFake()) {
-        labelMask |= (0x1 << 15);
-      }
-      if (mcTruthTPC.isNoise()) {
-        labelMask |= (0x1 << 14);
-      }
-      mcTrackLabelCursor(0,
-                         labelID,
-                         labelMask);
-    }
+    fillTracksTable(tracksTPC, vCollRefsTPC, tracksColumns, trackOffsets[1], o2::vertexing::GIndex::Source::TPC);
+    fillTrackLabels(
+      tracksTPCMCTruth.size(), [&](size_t i) { return std::make_pair(tracksTPCMCTruth[i], tracksTPCMCTruth[i]); }, toStore, trackLabelsColumns, labelOffsets[1]);
   }
 
   if (mFillTracksITSTPC) {
-    fillTracksTable(tracksITSTPC, vCollRefsTPCITS, tracksCursor, tracksCovCursor, tracksExtraCursor, o2::vertexing::GIndex::Source::ITSTPC);
-    for (int i = 0; i < tracksITSTPC.size(); i++) {
-      const auto& trc = tracksITSTPC[i];
-      auto mcTruthITS = tracksITSMCTruth[trc.getRefITS()];
-      auto mcTruthTPC = tracksTPCMCTruth[trc.getRefTPC()];
-      labelID = std::numeric_limits<uint32_t>::max();
-      labelITS = std::numeric_limits<uint32_t>::max();
-      labelTPC = std::numeric_limits<uint32_t>::max();
-      // TODO: fill label mask
-      // currently using label mask to indicate labelITS != labelTPC
-      labelMask = 0;
-      if (mcTruthITS.isValid() && mcTruthTPC.isValid()) {
-        labelITS = toStore.at(Triplet_t(mcTruthITS.getSourceID(), mcTruthITS.getEventID(), mcTruthITS.getTrackID()));
-        labelTPC = toStore.at(Triplet_t(mcTruthTPC.getSourceID(), mcTruthTPC.getEventID(), mcTruthTPC.getTrackID()));
-        labelID = labelITS;
-      }
-      if (mcTruthITS.isFake() || mcTruthTPC.isFake()) {
-        labelMask |= (0x1 << 15);
-      }
-      if (mcTruthITS.isNoise() || mcTruthTPC.isNoise()) {
-        labelMask |= (0x1 << 14);
-      }
-      if (labelITS != labelTPC) {
-        LOG(DEBUG) << "ITS-TPC MCTruth: labelIDs do not match at " << i;
-        labelMask |= (0x1 << 13);
-      }
-      mcTrackLabelCursor(0,
-                         labelID,
-                         labelMask);
-    }
+    fillTracksTable(tracksITSTPC, vCollRefsTPCITS, tracksColumns, trackOffsets[2], o2::vertexing::GIndex::Source::ITSTPC);
+    fillTrackLabels(
+      tracksITSTPC.size(), [&](size_t i) { return std::make_pair(tracksITSMCTruth[tracksITSTPC[i].getRefITS()], tracksTPCMCTruth[tracksITSTPC[i].getRefTPC()]); }, toStore, trackLabelsColumns, labelOffsets[2]);
   }
 
+  auto tracksCursor = tracksBuilder.bulkCursor<o2::aodproducer::TracksTable>(nTracks);
+  tracksCursor(0,
+               tracksColumns.collisionId,
+               tracksColumns.trackType,
+               tracksColumns.x,
+               tracksColumns.alpha,
+               tracksColumns.y,
+               tracksColumns.z,
+               tracksColumns.snp,
+               tracksColumns.tgl,
+               tracksColumns.signed1Pt);
+  auto tracksCovCursor = tracksCovBuilder.bulkCursor<o2::aodproducer::TracksCovTable>(nTracks);
+  tracksCovCursor(0,
+                  tracksColumns.sigmaY,
+                  tracksColumns.sigmaZ,
+                  tracksColumns.sigmaSnp,
+                  tracksColumns.sigmaTgl,
+                  tracksColumns.sigma1Pt,
+                  tracksColumns.rhoZY,
+                  tracksColumns.rhoSnpY,
+                  tracksColumns.rhoSnpZ,
+                  tracksColumns.rhoTglY,
+                  tracksColumns.rhoTglZ,
+                  tracksColumns.rhoTglSnp,
+                  tracksColumns.rho1PtY,
+                  tracksColumns.rho1PtZ,
+                  tracksColumns.rho1PtSnp,
+                  tracksColumns.rho1PtTgl);
+  auto tracksExtraCursor = tracksExtraBuilder.bulkCursor<o2::aodproducer::TracksExtraTable>(nTracks);
+  tracksExtraCursor(0,
+                    tracksColumns.tpcInnerParam,
+                    tracksColumns.flags,
+                    tracksColumns.itsClusterMap,
+                    tracksColumns.tpcNClsFindable,
+                    tracksColumns.tpcNClsFindableMinusFound,
+                    tracksColumns.tpcNClsFindableMinusCrossedRows,
+                    tracksColumns.tpcNClsShared,
+                    tracksColumns.trdPattern,
+                    tracksColumns.itsChi2NCl,
+                    tracksColumns.tpcChi2NCl,
+                    tracksColumns.trdChi2,
+                    tracksColumns.tofChi2,
+                    tracksColumns.tpcSignal,
+                    tracksColumns.trdSignal,
+                    tracksColumns.tofSignal,
+                    tracksColumns.length,
+                    tracksColumns.tofExpMom,
+                    tracksColumns.trackEtaEMCAL,
+                    tracksColumns.trackPhiEMCAL);
+  auto mcTrackLabelCursor = mcTrackLabelBuilder.bulkCursor<o2::aod::McTrackLabels>(nLabels);
+  mcTrackLabelCursor(0,
+                     trackLabelsColumns.mcParticleId,
+                     trackLabelsColumns.mcMask);
+
   toStore.clear();
 
   if (!mIgnoreWriter) {
@@ -929,7 +1029,8 @@ DataProcessorSpec getAODProducerWorkflowSpec(int mIgnoreWriter)
       ConfigParamSpec{"fill-tracks-its-tpc", VariantType::Int, 1, {"Fill ITS-TPC tracks into tracks table"}},
       ConfigParamSpec{"aod-timeframe-id", VariantType::Int, -1, {"Set timeframe number"}},
       ConfigParamSpec{"enable-truncation", VariantType::Int, 1, {"Truncation parameter: 1 -- on, != 1 -- off"}},
-      ConfigParamSpec{"reco-mctracks-only", VariantType::Int, 0, {"Store only reconstructed MC tracks and their mothers/daughters. 0 -- off, != 0 -- on"}}}};
+      ConfigParamSpec{"reco-mctracks-only", VariantType::Int, 0, {"Store only reconstructed MC tracks and their mothers/daughters. 0 -- off, != 0 -- on"}},
+      ConfigParamSpec{"nthreads", VariantType::Int, 1, {"Number of threads filling the tracks and MC particles tables"}}}};
 }
 
 } // namespace o2::aodproducer
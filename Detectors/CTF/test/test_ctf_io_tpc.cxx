@@ -132,3 +132,100 @@ BOOST_AUTO_TEST_CASE(CTFTest)
   BOOST_CHECK(vecIn.size() == bVec.size());
   BOOST_CHECK(memcmp(vecIn.data(), bVec.data(), bVec.size()) == 0);
 }
+
+BOOST_AUTO_TEST_CASE(CTFTestChunked)
+{
+  // clusters with consistent counters: the sub-blocks of the chunked columns are defined by nTrackClusters and nSliceRowClusters
+  CompressedClusters c;
+  c.nTracks = 66;
+  std::vector<int> nTrackClusters(c.nTracks), nSliceRowClusters(c.nSliceRows);
+  for (int i = 0; i < c.nTracks; i++) {
+    nTrackClusters[i] = 1 + i % 5;
+    c.nAttachedClusters += nTrackClusters[i];
+    c.nAttachedClustersReduced += nTrackClusters[i] - 1;
+  }
+  for (int i = 0; i < c.nSliceRows; i++) {
+    nSliceRowClusters[i] = i % 3;
+    c.nUnattachedClusters += nSliceRowClusters[i];
+  }
+
+  std::vector<char> bVec;
+  CompressedClustersFlat* ccFlat = nullptr;
+  size_t sizeCFlatBody = CTFCoder::alignSize(ccFlat);
+  size_t sz = sizeCFlatBody + CTFCoder::estimateSize(c);
+  bVec.resize(sz);
+  ccFlat = reinterpret_cast<CompressedClustersFlat*>(bVec.data());
+  auto buff = reinterpret_cast<void*>(reinterpret_cast<char*>(bVec.data()) + sizeCFlatBody);
+  CTFCoder::setCompClusAddresses(c, buff);
+  ccFlat->set(sz, c);
+
+  // values fitting the bit widths of the combined columns
+  for (int i = 0; i < c.nUnattachedClusters; i++) {
+    c.qTotU[i] = i % 64;
+    c.qMaxU[i] = i % 64;
+    c.flagsU[i] = i % 64;
+    c.padDiffU[i] = i % 64;
+    c.timeDiffU[i] = i % 64;
+    c.sigmaPadU[i] = i % 64;
+    c.sigmaTimeU[i] = i % 64;
+  }
+  for (int i = 0; i < c.nAttachedClusters; i++) {
+    c.qTotA[i] = i % 64;
+    c.qMaxA[i] = i % 64;
+    c.flagsA[i] = i % 64;
+    c.sigmaPadA[i] = i % 64;
+    c.sigmaTimeA[i] = i % 64;
+  }
+  for (int i = 0; i < c.nAttachedClustersReduced; i++) {
+    c.rowDiffA[i] = i % 64;
+    c.sliceLegDiffA[i] = i % 64;
+    c.padResA[i] = i % 64;
+    c.timeResA[i] = i % 64;
+  }
+  for (int i = 0; i < c.nTracks; i++) {
+    c.qPtA[i] = i % 64;
+    c.rowA[i] = i % 64;
+    c.sliceA[i] = i % 64;
+    c.timeA[i] = i % 64;
+    c.padA[i] = i % 64;
+    c.nTrackClusters[i] = nTrackClusters[i];
+  }
+  for (int i = 0; i < c.nSliceRows; i++) {
+    c.nSliceRowClusters[i] = nSliceRowClusters[i];
+  }
+
+  for (bool combine : {false, true}) {
+    std::vector<o2::ctf::BufferType> vecIO;
+    {
+      CTFCoder coder;
+      coder.setCombineColumns(combine);
+      coder.setNChunks(CTFHeader::MaxChunks);
+      coder.encode(vecIO, c); // compress
+    }
+    const auto& ctf = *o2::tpc::CTF::get(vecIO.data());
+    BOOST_CHECK(ctf.getHeader().flags & CTFHeader::ChunkedColumns);
+    BOOST_CHECK(ctf.getHeader().nChunks == CTFHeader::MaxChunks);
+
+    std::vector<char> vecIn;
+    CTFCoder coder;
+    coder.setNThreads(2);
+    coder.decode(ctf, vecIn); // decompress
+    BOOST_CHECK(vecIn.size() == bVec.size());
+    BOOST_CHECK(memcmp(vecIn.data(), bVec.data(), bVec.size()) == 0);
+
+    // a single sector is decoded from its own sub-block
+    const int sector = 17, nRowsSector = c.nSliceRows / o2::tpc::constants::MAXSECTOR;
+    std::vector<char> vecSector;
+    auto [firstSector, lastSector] = coder.decodeSectors(ctf, sector, vecSector);
+    BOOST_CHECK(firstSector == sector && lastSector == sector + 1);
+    CompressedClusters cs(*reinterpret_cast<const CompressedClustersFlat*>(vecSector.data()));
+    int offset = 0, nClusters = 0;
+    for (int i = 0; i < (sector + 1) * nRowsSector; i++) {
+      (i < sector * nRowsSector ? offset : nClusters) += c.nSliceRowClusters[i];
+    }
+    BOOST_CHECK(cs.nUnattachedClusters == nClusters);
+    BOOST_CHECK(cs.nAttachedClusters == 0);
+    BOOST_CHECK(memcmp(cs.timeDiffU, c.timeDiffU + offset, nClusters * sizeof(*cs.timeDiffU)) == 0);
+    BOOST_CHECK(memcmp(cs.sigmaTimeU, c.sigmaTimeU + offset, nClusters * sizeof(*cs.sigmaTimeU)) == 0);
+  }
+}
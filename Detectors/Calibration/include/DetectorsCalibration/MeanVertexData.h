@@ -99,6 +99,7 @@ struct MeanVertexData {
   //_____________________________________________
 
   size_t getEntries() const { return entries; }
+  size_t getMemorySize() const { return sizeof(*this) + (histoX.capacity() + histoY.capacity() + histoZ.capacity()) * sizeof(float); }
   void print() const;
   void fill(const gsl::span<const PVertex> data);
   void merge(const MeanVertexData* prev);
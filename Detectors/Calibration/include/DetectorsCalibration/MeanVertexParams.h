@@ -35,6 +35,7 @@ struct MeanVertexParams : public o2::conf::ConfigurableParamHelper<MeanVertexPar
   bool useFit = false;
   int tfPerSlot = 5;
   int maxTFdelay = 3;
+  bool asyncFinalization = false; // finalize the slots in a separate thread
 
   O2ParamDef(MeanVertexParams, "MeanVertexCalib");
 };
@@ -11,7 +11,10 @@
 #ifndef DETECTOR_CALIB_TIMESLOT_H_
 #define DETECTOR_CALIB_TIMESLOT_H_
 
+#include <algorithm>
 #include <memory>
+#include <chrono>
+#include <type_traits>
 #include <Rtypes.h>
 #include "Framework/Logger.h"
 
@@ -24,22 +27,38 @@ namespace calibration
 
 using TFType = uint64_t;
 
+namespace detail
+{
+// containers may report their memory footprint via size_t getMemorySize() const
+template <typename C, typename = void>
+struct HasGetMemorySize : std::false_type {
+};
+template <typename C>
+struct HasGetMemorySize<C, std::void_t<decltype(std::declval<const C&>().getMemorySize())>> : std::true_type {
+};
+} // namespace detail
+
 template <typename Container>
 class TimeSlot
 {
  public:
   TimeSlot() = default;
-  TimeSlot(TFType tfS, TFType tfE) : mTFStart(tfS), mTFEnd(tfE) {}
-  TimeSlot(const TimeSlot& src) : mTFStart(src.mTFStart), mTFEnd(src.mTFEnd), mContainer(std::make_unique<Container>(*src.getContainer())) {}
+  TimeSlot(TFType tfS, TFType tfE) : mTFStart(tfS), mTFEnd(tfE), mCreationTime(now()) {}
+  TimeSlot(const TimeSlot& src) : mTFStart(src.mTFStart), mTFEnd(src.mTFEnd), mContainer(std::make_unique<Container>(*src.getContainer())), mNFills(src.mNFills), mFillTime(src.mFillTime), mCreationTime(src.mCreationTime) {}
+  TimeSlot(TimeSlot&& src) = default;
   TimeSlot& operator=(const TimeSlot& src)
   {
     if (&src != this) {
       mTFStart = src.mTFStart;
       mTFEnd = src.mTFEnd;
       mContainer = std::make_unique<Container>(*src.getContainer());
+      mNFills = src.mNFills;
+      mFillTime = src.mFillTime;
+      mCreationTime = src.mCreationTime;
     }
     return *this;
   }
+  TimeSlot& operator=(TimeSlot&& src) = default;
 
   ~TimeSlot() = default;
 
@@ -60,8 +79,32 @@ class TimeSlot
   {
     mContainer->merge(prev.mContainer.get());
     mTFStart = prev.mTFStart;
+    mNFills += prev.mNFills;
+    mFillTime += prev.mFillTime;
+    mCreationTime = std::min(mCreationTime, prev.mCreationTime);
   }
 
+  // bookkeeping for the slot metrics
+  void addFill(double fillTime)
+  {
+    mNFills++;
+    mFillTime += fillTime;
+  }
+  size_t getNFills() const { return mNFills; }
+  double getFillTime() const { return mFillTime; }
+  double getCreationTime() const { return mCreationTime; }
+  size_t getMemorySize() const
+  {
+    if constexpr (detail::HasGetMemorySize<Container>::value) {
+      return mContainer ? mContainer->getMemorySize() : 0;
+    } else {
+      return mContainer ? sizeof(Container) : 0;
+    }
+  }
+
+  // monotonic time in ms
+  static double now() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
   void print() const
   {
     LOGF(INFO, "Calibration slot %5d <=TF<=  %5d", mTFStart, mTFEnd);
@@ -73,8 +116,11 @@ class TimeSlot
   TFType mTFEnd = 0;
   size_t mEntries = 0;
   std::unique_ptr<Container> mContainer; // user object to accumulate the calibration data for this slot
+  size_t mNFills = 0;                    //! number of TFs filled to this slot
+  double mFillTime = 0.;                 //! time spent filling the container, in ms
+  double mCreationTime = 0.;             //! time of the slot creation, in ms
 
-  ClassDefNV(TimeSlot, 1);
+  ClassDefNV(TimeSlot, 2);
 };
 
 } // namespace calibration
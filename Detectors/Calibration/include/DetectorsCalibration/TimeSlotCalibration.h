@@ -14,7 +14,11 @@
 /// @brief Processor for the multiple time slots calibration
 
 #include "DetectorsCalibration/TimeSlot.h"
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <gsl/gsl>
 
 namespace o2
@@ -28,8 +32,27 @@ class TimeSlotCalibration
   using Slot = TimeSlot<Container>;
 
  public:
+  // metrics of the finalized slot
+  struct SlotMetrics {
+    TFType tfStart = 0;       // first TF of the slot
+    TFType tfEnd = 0;         // last TF of the slot
+    size_t nFills = 0;        // number of TFs accumulated in the slot
+    size_t memorySize = 0;    // memory used by the slot container when closing it, in bytes
+    double fillTime = 0.;     // total time spent filling the slot container, in ms
+    double lifeTime = 0.;     // time between the slot creation and its closing, in ms
+    double waitTime = 0.;     // time the closed slot waited for its finalization, in ms
+    double finalizeTime = 0.; // time spent in finalizeSlot, in ms
+  };
+
   TimeSlotCalibration() = default;
-  virtual ~TimeSlotCalibration() = default;
+  virtual ~TimeSlotCalibration()
+  {
+    // the derived calibrator is already destroyed here, the finalization thread running its finalizeSlot must
+    // have been stopped before
+    if (mFinalizationThread.joinable()) {
+      LOG(FATAL) << "Calibrator destroyed with asynchronous finalization running, setAsyncFinalization(false) must be called before";
+    }
+  }
   uint32_t getMaxSlotsDelay() const { return mMaxSlotsDelay; }
   void setMaxSlotsDelay(uint32_t v) { mMaxSlotsDelay = v; }
   //void setMaxSlotsDelay(uint32_t v) { (mSlotLength == 1 && mMaxSlotsDelay == 0) ? mMaxSlotsDelay = 0 : mMaxSlotsDelay = v < 1 ? 1 : v; }
@@ -67,21 +90,57 @@ class TimeSlotCalibration
 
   virtual void print() const;
 
+  // Finalize the closed slots on a dedicated thread, so that the accumulation of new data is not blocked by
+  // the finalization (fits, CCDB objects preparation). The slots are finalized one at a time, in the order
+  // they were closed. In this mode the output filled in finalizeSlot must be accessed holding the lock
+  // provided by lockOutput(), and waitForFinalization() must be called before the end of the processing.
+  // The owner of the calibrator must stop the finalization thread with setAsyncFinalization(false) before
+  // destroying it, e.g. in the Stop callback of the device
+  void setAsyncFinalization(bool v = true);
+  bool isAsyncFinalization() const { return mAsyncFinalization; }
+  // lock protecting the output filled by finalizeSlot; if wait == false the lock is not acquired (owns_lock() is
+  // false) when a slot is being finalized
+  std::unique_lock<std::mutex> lockOutput(bool wait = true) { return wait ? std::unique_lock<std::mutex>(mOutputMutex) : std::unique_lock<std::mutex>(mOutputMutex, std::try_to_lock); }
+  // block until all closed slots are finalized
+  void waitForFinalization();
+  // number of closed slots waiting for or being in finalization
+  size_t getNSlotsToFinalize() const;
+
+  // metrics of the last finalized slots
+  std::vector<SlotMetrics> getSlotMetrics() const;
+  void clearSlotMetrics();
+  void setMaxSlotMetrics(size_t n) { mMaxSlotMetrics = n; }
+
  protected:
   auto& getSlots() { return mSlots; }
 
  private:
   TFType tf2SlotMin(TFType tf) const;
+  void closeSlot(Slot& slot);
+  void runFinalization(Slot& slot, double closingTime);
+  void finalizationLoop();
+  void stopFinalizationThread();
 
   std::deque<Slot> mSlots;
 
+  bool mAsyncFinalization = false;                      //! finalize the closed slots on mFinalizationThread
+  std::thread mFinalizationThread;                      //! thread finalizing the closed slots in async mode
+  std::deque<std::pair<Slot, double>> mSlotsToFinalize; //! closed slots with their closing time, waiting for finalization
+  mutable std::mutex mQueueMutex;                       //! protects mSlotsToFinalize, mFinalizing and mStopFinalization
+  std::condition_variable mQueueCondition;              //! signals new slots to finalize or finalization done
+  bool mFinalizing = false;                             //! a slot is being finalized
+  bool mStopFinalization = false;                       //! request to stop mFinalizationThread
+  mutable std::mutex mOutputMutex;                      //! protects the output of finalizeSlot and mSlotMetrics
+  std::deque<SlotMetrics> mSlotMetrics;                 //! metrics of the last finalized slots
+  size_t mMaxSlotMetrics = 100;                         //! max number of slot metrics to keep
+
   TFType mLastClosedTF = 0;
   TFType mFirstTF = 0;
   uint32_t mSlotLength = 1;
   uint32_t mMaxSlotsDelay = 3;
   bool mUpdateAtTheEndOfRunOnly = false;
 
-  ClassDef(TimeSlotCalibration, 1);
+  ClassDef(TimeSlotCalibration, 2);
 };
 
 //_________________________________________________
@@ -102,7 +161,9 @@ bool TimeSlotCalibration<Input, Container>::process(TFType tf, const gsl::span<c
 
   // process current TF
   auto& slotTF = getSlotForTF(tf);
+  auto fillStart = Slot::now();
   slotTF.getContainer()->fill(data);
+  slotTF.addFill(Slot::now() - fillStart);
 
   return true;
 }
@@ -116,7 +177,7 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
   for (auto slot = mSlots.begin(); slot != mSlots.end(); slot++) {
     if (maxDelay == 0 || (slot->getTFEnd() + maxDelay) < tf) {
       if (hasEnoughData(*slot)) {
-        finalizeSlot(*slot); // will be removed after finalization
+        closeSlot(*slot); // will be removed after finalization
       } else if ((slot + 1) != mSlots.end()) {
         LOG(INFO) << "Merging underpopulated slot " << slot->getTFStart() << " <= TF <= " << slot->getTFEnd()
                   << " to slot " << (slot + 1)->getTFStart() << " <= TF <= " << (slot + 1)->getTFEnd();
@@ -146,11 +207,148 @@ void TimeSlotCalibration<Input, Container>::finalizeOldestSlot()
     LOG(WARNING) << "There are no slots defined";
     return;
   }
-  finalizeSlot(mSlots.front());
   mLastClosedTF = mSlots.front().getTFEnd() + 1; // do not accept any TF below this
+  closeSlot(mSlots.front());
   mSlots.erase(mSlots.begin());
 }
 
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::closeSlot(Slot& slot)
+{
+  // finalize the slot right away or, in async mode, move it to the finalization queue
+  if (!mAsyncFinalization) {
+    runFinalization(slot, Slot::now());
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mQueueMutex);
+    mSlotsToFinalize.emplace_back(std::move(slot), Slot::now());
+  }
+  mQueueCondition.notify_all();
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::runFinalization(Slot& slot, double closingTime)
+{
+  SlotMetrics metrics;
+  metrics.tfStart = slot.getTFStart();
+  metrics.tfEnd = slot.getTFEnd();
+  metrics.nFills = slot.getNFills();
+  metrics.memorySize = slot.getMemorySize();
+  metrics.fillTime = slot.getFillTime();
+  metrics.lifeTime = closingTime - slot.getCreationTime();
+  std::lock_guard<std::mutex> lock(mOutputMutex);
+  auto start = Slot::now();
+  metrics.waitTime = start - closingTime;
+  finalizeSlot(slot);
+  metrics.finalizeTime = Slot::now() - start;
+  LOGF(INFO, "Finalized slot %d <= TF <= %d: %zu TFs, %zu bytes, fill %.2f ms, life %.2f ms, wait %.2f ms, finalization %.2f ms",
+       metrics.tfStart, metrics.tfEnd, metrics.nFills, metrics.memorySize, metrics.fillTime, metrics.lifeTime, metrics.waitTime, metrics.finalizeTime);
+  mSlotMetrics.push_back(metrics);
+  while (mSlotMetrics.size() > mMaxSlotMetrics) {
+    mSlotMetrics.pop_front();
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::finalizationLoop()
+{
+  while (true) {
+    std::pair<Slot, double> next;
+    {
+      std::unique_lock<std::mutex> lock(mQueueMutex);
+      mQueueCondition.wait(lock, [this] { return mStopFinalization || !mSlotsToFinalize.empty(); });
+      if (mSlotsToFinalize.empty()) {
+        return;
+      }
+      next = std::move(mSlotsToFinalize.front());
+      mSlotsToFinalize.pop_front();
+      mFinalizing = true;
+    }
+    try {
+      runFinalization(next.first, next.second);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Failed to finalize slot " << next.first.getTFStart() << " <= TF <= " << next.first.getTFEnd() << ": " << e.what();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mFinalizing = false;
+    }
+    mQueueCondition.notify_all();
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::setAsyncFinalization(bool v)
+{
+  if (v == mAsyncFinalization) {
+    return;
+  }
+  if (v) {
+    mStopFinalization = false;
+    mFinalizationThread = std::thread(&TimeSlotCalibration::finalizationLoop, this);
+  } else {
+    waitForFinalization();
+    stopFinalizationThread();
+  }
+  mAsyncFinalization = v;
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::waitForFinalization()
+{
+  std::unique_lock<std::mutex> lock(mQueueMutex);
+  mQueueCondition.wait(lock, [this] { return mSlotsToFinalize.empty() && !mFinalizing; });
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+size_t TimeSlotCalibration<Input, Container>::getNSlotsToFinalize() const
+{
+  std::lock_guard<std::mutex> lock(mQueueMutex);
+  return mSlotsToFinalize.size() + (mFinalizing ? 1 : 0);
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::stopFinalizationThread()
+{
+  if (!mFinalizationThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mQueueMutex);
+    if (!mSlotsToFinalize.empty()) { // should not happen, the queue is drained by setAsyncFinalization(false)
+      LOG(WARNING) << "Discarding " << mSlotsToFinalize.size() << " slots which were not finalized";
+      mSlotsToFinalize.clear();
+    }
+    mStopFinalization = true;
+  }
+  mQueueCondition.notify_all();
+  mFinalizationThread.join();
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+auto TimeSlotCalibration<Input, Container>::getSlotMetrics() const -> std::vector<SlotMetrics>
+{
+  std::lock_guard<std::mutex> lock(mOutputMutex);
+  return {mSlotMetrics.begin(), mSlotMetrics.end()};
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::clearSlotMetrics()
+{
+  std::lock_guard<std::mutex> lock(mOutputMutex);
+  mSlotMetrics.clear();
+}
+
 //________________________________________
 template <typename Input, typename Container>
 inline TFType TimeSlotCalibration<Input, Container>::tf2SlotMin(TFType tf) const
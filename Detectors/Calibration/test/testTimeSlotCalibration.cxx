@@ -0,0 +1,133 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TimeSlotCalibration asynchronous finalization
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsCalibration/TimeSlotCalibration.h"
+#include "DetectorsCalibration/MeanVertexData.h"
+#include "ReconstructionDataFormats/PrimaryVertex.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace calibration
+{
+
+using PVertex = o2::dataformats::PrimaryVertex;
+constexpr TFType INFINITE_TF = 0xffffffffffffffff;
+
+// calibrator recording the finalized slots and the thread finalizing them
+class TestCalibrator final : public TimeSlotCalibration<PVertex, MeanVertexData>
+{
+  using Slot = o2::calibration::TimeSlot<MeanVertexData>;
+
+ public:
+  struct Finalized {
+    TFType tfStart;
+    TFType tfEnd;
+    size_t entries;
+    std::thread::id thread;
+  };
+
+  void initOutput() final { mFinalized.clear(); }
+  bool hasEnoughData(const Slot& slot) const final { return true; }
+  void finalizeSlot(Slot& slot) final
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2)); // let the slots queue up
+    mFinalized.push_back({slot.getTFStart(), slot.getTFEnd(), slot.getContainer()->getEntries(), std::this_thread::get_id()});
+  }
+  Slot& emplaceNewSlot(bool front, TFType tstart, TFType tend) final
+  {
+    auto& cont = getSlots();
+    auto& slot = front ? cont.emplace_front(tstart, tend) : cont.emplace_back(tstart, tend);
+    slot.setContainer(std::make_unique<MeanVertexData>(false, 10, 1.f, 10, 1.f, 10, 20.f));
+    return slot;
+  }
+  const std::vector<Finalized>& getFinalized() const { return mFinalized; }
+
+ private:
+  std::vector<Finalized> mFinalized;
+};
+
+BOOST_AUTO_TEST_CASE(TimeSlotCalibration_AsyncFinalization)
+{
+  const size_t nTF = 200, slotLength = 10, nVtxPerTF = 3;
+  std::vector<PVertex> vertices(nVtxPerTF);
+
+  auto calib = std::make_unique<TestCalibrator>();
+  calib->setSlotLength(slotLength);
+  calib->setMaxSlotsDelay(1);
+  calib->setAsyncFinalization(true);
+  BOOST_CHECK(calib->isAsyncFinalization());
+
+  for (TFType tf = 0; tf < nTF; tf++) {
+    BOOST_CHECK(calib->process(tf, vertices));
+  }
+  calib->checkSlotsToFinalize(INFINITE_TF); // close the remaining slots, as at the end of stream
+  calib->waitForFinalization();
+  BOOST_CHECK_EQUAL(calib->getNSlotsToFinalize(), 0);
+
+  {
+    auto lock = calib->lockOutput();
+    const auto& finalized = calib->getFinalized();
+    BOOST_REQUIRE_EQUAL(finalized.size(), nTF / slotLength);
+    for (size_t i = 0; i < finalized.size(); i++) { // all slots finalized in order, on the finalization thread
+      BOOST_CHECK_EQUAL(finalized[i].tfStart, i * slotLength);
+      BOOST_CHECK_EQUAL(finalized[i].tfEnd, (i + 1) * slotLength - 1);
+      BOOST_CHECK_EQUAL(finalized[i].entries, slotLength * nVtxPerTF);
+      BOOST_CHECK(finalized[i].thread != std::this_thread::get_id());
+      BOOST_CHECK(finalized[i].thread == finalized[0].thread);
+    }
+  }
+  auto metrics = calib->getSlotMetrics();
+  BOOST_CHECK_EQUAL(metrics.size(), nTF / slotLength);
+  for (const auto& m : metrics) {
+    BOOST_CHECK_EQUAL(m.nFills, slotLength);
+  }
+
+  // teardown as done by the devices: slots closed but not yet finalized are finalized by the stop,
+  // then the calibrator can be destroyed
+  for (TFType tf = nTF; tf < nTF + 5 * slotLength; tf++) {
+    calib->process(tf, vertices);
+  }
+  calib->checkSlotsToFinalize(INFINITE_TF);
+  calib->setAsyncFinalization(false);
+  BOOST_CHECK(!calib->isAsyncFinalization());
+  BOOST_CHECK_EQUAL(calib->getNSlotsToFinalize(), 0);
+  BOOST_CHECK_EQUAL(calib->getFinalized().size(), nTF / slotLength + 5);
+  calib.reset();
+}
+
+BOOST_AUTO_TEST_CASE(TimeSlotCalibration_AsyncFinalizationRestart)
+{
+  // the finalization thread can be stopped and restarted, and stopping it twice is harmless
+  TestCalibrator calib;
+  calib.setSlotLength(5);
+  std::vector<PVertex> vertices(1);
+  for (size_t pass = 0; pass < 3; pass++) {
+    calib.setAsyncFinalization(true);
+    for (TFType tf = pass * 20; tf < (pass + 1) * 20; tf++) {
+      calib.process(tf, vertices);
+    }
+    calib.checkSlotsToFinalize(INFINITE_TF);
+    calib.setAsyncFinalization(false);
+    calib.setAsyncFinalization(false);
+    BOOST_CHECK_EQUAL(calib.getFinalized().size(), (pass + 1) * 4);
+  }
+}
+
+} // namespace calibration
+} // namespace o2
@@ -28,6 +28,7 @@ namespace calibration
 class MeanVertexCalibDevice : public Task
 {
  public:
+  ~MeanVertexCalibDevice() override;
   void init(o2::framework::InitContext& ic) final;
   void run(o2::framework::ProcessingContext& pc) final;
   void endOfStream(o2::framework::EndOfStreamContext& ec) final;
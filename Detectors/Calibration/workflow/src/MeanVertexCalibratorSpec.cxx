@@ -11,6 +11,7 @@
 /// @file   MeanVertexCalibratorSpec.cxx
 
 #include "Framework/ControlService.h"
+#include "Framework/CallbackService.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/Logger.h"
 #include "DetectorsCalibrationWorkflow/MeanVertexCalibratorSpec.h"
@@ -43,6 +44,18 @@ void MeanVertexCalibDevice::init(InitContext& ic)
   mCalibrator = std::make_unique<o2::calibration::MeanVertexCalibrator>(minEnt, useFit, nbX, rangeX, nbY, rangeY, nbZ, rangeZ, nSlots4SMA);
   mCalibrator->setSlotLength(slotL);
   mCalibrator->setMaxSlotsDelay(delay);
+  mCalibrator->setAsyncFinalization(params->asyncFinalization);
+  // the finalization thread must be stopped while the calibrator is still complete
+  ic.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() { mCalibrator->setAsyncFinalization(false); });
+}
+
+//_____________________________________________________________
+
+MeanVertexCalibDevice::~MeanVertexCalibDevice()
+{
+  if (mCalibrator) {
+    mCalibrator->setAsyncFinalization(false);
+  }
 }
 
 //_____________________________________________________________
@@ -55,8 +68,6 @@ void MeanVertexCalibDevice::run(o2::framework::ProcessingContext& pc)
   LOG(INFO) << "Processing TF " << tfcounter << " with " << data.size() << " tracks";
   mCalibrator->process(tfcounter, data);
   sendOutput(pc.outputs());
-  const auto& infoVec = mCalibrator->getMeanVertexObjectInfoVector();
-  LOG(INFO) << "Created " << infoVec.size() << " objects for TF " << tfcounter;
 }
 
 //_____________________________________________________________
@@ -67,6 +78,7 @@ void MeanVertexCalibDevice::endOfStream(o2::framework::EndOfStreamContext& ec)
   LOG(INFO) << "Finalizing calibration";
   constexpr uint64_t INFINITE_TF = 0xffffffffffffffff;
   mCalibrator->checkSlotsToFinalize(INFINITE_TF);
+  mCalibrator->waitForFinalization();
   sendOutput(ec.outputs());
 }
 
@@ -79,6 +91,10 @@ void MeanVertexCalibDevice::sendOutput(DataAllocator& output)
   // TODO in principle, this routine is generic, can be moved to Utils.h
 
   using clbUtils = o2::calibration::Utils;
+  auto lock = mCalibrator->lockOutput(false);
+  if (!lock.owns_lock()) { // a slot is being finalized, its output will be sent with the next TF
+    return;
+  }
   const auto& payloadVec = mCalibrator->getMeanVertexObjectVector();
   auto& infoVec = mCalibrator->getMeanVertexObjectInfoVector(); // use non-const version as we update it
   assert(payloadVec.size() == infoVec.size());
@@ -91,6 +107,7 @@ void MeanVertexCalibDevice::sendOutput(DataAllocator& output)
     output.snapshot(Output{clbUtils::gDataOriginCLB, clbUtils::gDataDescriptionCLBPayload, i}, *image.get()); // vector<char>
     output.snapshot(Output{clbUtils::gDataOriginCLB, clbUtils::gDataDescriptionCLBInfo, i}, w);               // root-serialized
   }
+  LOG(INFO) << "Created " << infoVec.size() << " objects";
   if (payloadVec.size()) {
     mCalibrator->initOutput(); // reset the outputs once they are already sent
   }
@@ -14,12 +14,13 @@
 #include <memory>
 #include <Rtypes.h>
 #include <unordered_map>
-#include <deque>
+#include <cstring>
 #include <numeric>
 #include "Framework/Logger.h"
 #include "DetectorsDCS/DataPointCompositeObject.h"
 #include "DetectorsDCS/DataPointIdentifier.h"
 #include "DetectorsDCS/DataPointValue.h"
+#include "DetectorsDCS/DataPointRingBuffer.h"
 #include "DetectorsDCS/DeliveryType.h"
 #include "CCDB/CcdbObjectInfo.h"
 #include "CommonUtils/MemFileHelper.h"
@@ -46,14 +47,14 @@ class DCSProcessor
   using Binaries = std::array<uint64_t, 7>;
   using Strings = std::array<char, 56>;
 
-  using DQChars = std::deque<char>;
-  using DQInts = std::deque<int>;
-  using DQDoubles = std::deque<double>;
-  using DQUInts = std::deque<uint32_t>;
-  using DQBools = std::deque<bool>;
-  using DQStrings = std::deque<Strings>;
-  using DQTimes = std::deque<uint32_t>;
-  using DQBinaries = std::deque<Binaries>;
+  using RBChars = DataPointRingBuffer<char>;
+  using RBInts = DataPointRingBuffer<int>;
+  using RBDoubles = DataPointRingBuffer<double>;
+  using RBUInts = DataPointRingBuffer<uint32_t>;
+  using RBBools = DataPointRingBuffer<uint8_t>;
+  using RBStrings = DataPointRingBuffer<Strings>;
+  using RBTimes = DataPointRingBuffer<uint32_t>;
+  using RBBinaries = DataPointRingBuffer<Binaries>;
 
   using DPID = o2::dcs::DataPointIdentifier;
   using DPVAL = o2::dcs::DataPointValue;
@@ -76,16 +77,9 @@ class DCSProcessor
 
   int processDP(const std::pair<DPID, DPVAL>& dpcom);
 
-  std::unordered_map<DPID, DPVAL>::const_iterator findAndCheckPid(const DPID& pid, DeliveryType type,
-                                                                  const std::unordered_map<DPID, DPVAL>& map);
-
-  template <typename T>
-  int processArrayType(const std::vector<DPID>& array, DeliveryType type, const std::unordered_map<DPID, DPVAL>& map,
-                       std::vector<uint64_t>& latestTimeStamp, std::unordered_map<DPID, std::deque<T>>& destmap);
-
   template <typename T>
-  void checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                         std::unordered_map<DPID, T>& destmap);
+  bool checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, int idx, std::vector<uint64_t>& latestTimeStamp,
+                         DataPointRingBuffer<T>& dest);
 
   virtual void processCharDP(const DPID& pid);
   virtual void processIntDP(const DPID& pid);
@@ -98,17 +92,30 @@ class DCSProcessor
 
   virtual uint64_t processFlag(uint64_t flag, const char* pid);
 
-  template <typename T>
-  void doSimpleMovingAverage(int nelements, std::deque<T>& vect, float& avg, bool& isSMA);
+  // update the simple moving averages of the int DPs which received a new value
+  void doSimpleMovingAverages();
 
-  DQChars& getVectorForPidChar(const DPID& id) { return mDpscharsmap[id]; }
-  DQInts& getVectorForPidInt(const DPID& id) { return mDpsintsmap[id]; }
-  DQDoubles& getVectorForPidDouble(const DPID& id) { return mDpsdoublesmap[id]; }
-  DQUInts& getVectorForPidUInt(const DPID& id) { return mDpsUintsmap[id]; }
-  DQBools& getVectorForPidBool(const DPID& id) { return mDpsboolsmap[id]; }
-  DQStrings& getVectorForPidString(const DPID& id) { return mDpsstringsmap[id]; }
-  DQTimes& getVectorForPidTime(const DPID& id) { return mDpstimesmap[id]; }
-  DQBinaries& getVectorForPidBinary(const DPID& id) { return mDpsbinariesmap[id]; }
+  // index of the DP in the buffers of its type, -1 if the DP is not processed here
+  int getIndex(const DPID& id) const
+  {
+    auto el = mPids.find(id);
+    return el == mPids.end() ? -1 : el->second;
+  }
+
+  const RBChars& getBufferChars() const { return mDpschars; }
+  const RBInts& getBufferInts() const { return mDpsints; }
+  const RBDoubles& getBufferDoubles() const { return mDpsdoubles; }
+  const RBUInts& getBufferUInts() const { return mDpsUints; }
+  const RBBools& getBufferBools() const { return mDpsbools; }
+  const RBStrings& getBufferStrings() const { return mDpsstrings; }
+  const RBTimes& getBufferTimes() const { return mDpstimes; }
+  const RBBinaries& getBufferBinaries() const { return mDpsbinaries; }
+
+  float getSimpleMovingAverage(const DPID& id) const
+  {
+    int idx = getIndex(id);
+    return (idx < 0 || id.get_type() != DeliveryType::RAW_INT) ? 0.f : mSimpleMovingAverage[idx];
+  }
 
   void setNThreads(int n);
   int getNThreads() const { return mNThreads; }
@@ -127,6 +134,14 @@ class DCSProcessor
 
   uint64_t getNCyclesNoFullMap() const { return mNCyclesNoFullMap; }
 
+  // number of values kept for each DP, to be set before init
+  void setBufferCapacity(size_t n) { mBufferCapacity = n > 0 ? n : 1; }
+  size_t getBufferCapacity() const { return mBufferCapacity; }
+
+  // number of values used for the simple moving average, to be set before init; it cannot exceed the buffer capacity
+  void setNElementsSMA(size_t n) { mNElementsSMA = n > 0 ? n : 1; }
+  size_t getNElementsSMA() const { return mNElementsSMA; }
+
   template <typename T>
   void prepareCCDBobject(T& obj, CcdbObjectInfo& info, const std::string& path, TFType tf,
                          const std::map<std::string, std::string>& md);
@@ -135,6 +150,12 @@ class DCSProcessor
   const std::string getName() const { return mName; }
 
  private:
+  // allocate the buffers once all DPs are known
+  void initBuffers();
+
+  // checks the DP (type and flags) and stores its value, returns false if the DP was not filled
+  bool fillDP(const std::pair<DPID, DPVAL>& dpcom, int idx);
+
   bool mFullMapSent = false;                            // set to true as soon as a full map was sent. No delta can
                                                         // be received if there was never a full map sent
   int64_t mNCyclesNoFullMap = 0;                        // number of times the delta was sent withoug a full map
@@ -143,15 +164,19 @@ class DCSProcessor
                                                         // means a 5 minutes threshold)
   bool mIsDelta = false;                                // set to true in case you are processing  delta map
                                                         // (containing only DPs that changed)
-  std::unordered_map<DPID, float> mSimpleMovingAverage; // moving average for several DPs
-  std::unordered_map<DPID, DQChars> mDpscharsmap;
-  std::unordered_map<DPID, DQInts> mDpsintsmap;
-  std::unordered_map<DPID, DQDoubles> mDpsdoublesmap;
-  std::unordered_map<DPID, DQUInts> mDpsUintsmap;
-  std::unordered_map<DPID, DQBools> mDpsboolsmap;
-  std::unordered_map<DPID, DQStrings> mDpsstringsmap;
-  std::unordered_map<DPID, DQTimes> mDpstimesmap;
-  std::unordered_map<DPID, DQBinaries> mDpsbinariesmap;
+  size_t mBufferCapacity = 16;                          // number of values kept per DP
+  size_t mNElementsSMA = 2;                             // number of values used for the simple moving average
+  std::vector<float> mSimpleMovingAverage;              //! moving average for the int DPs, by DP index
+  std::vector<double> mSumSMA;                          //! sum of the last mNElementsSMA values of the int DPs
+  std::vector<int> mUpdatedInts;                        //! indices of the int DPs updated in the current map
+  RBChars mDpschars;                                    //! buffered values per DP type
+  RBInts mDpsints;                                      //!
+  RBDoubles mDpsdoubles;                                //!
+  RBUInts mDpsUints;                                    //!
+  RBBools mDpsbools;                                    //!
+  RBStrings mDpsstrings;                                //!
+  RBTimes mDpstimes;                                    //!
+  RBBinaries mDpsbinaries;                              //!
   std::vector<DPID> mPidschars;
   std::vector<DPID> mPidsints;
   std::vector<DPID> mPidsdoubles;
@@ -190,64 +215,12 @@ using Doubles = std::vector<double>;
 using Binaries = std::array<uint64_t, 7>;
 using Strings = std::array<char, 56>;
 
-using DQStrings = std::deque<Strings>;
-using DQBinaries = std::deque<Binaries>;
-
 using DPID = o2::dcs::DataPointIdentifier;
 using DPVAL = o2::dcs::DataPointValue;
 
 template <typename T>
-int DCSProcessor::processArrayType(const std::vector<DPID>& array,
-                                   DeliveryType type, const std::unordered_map<DPID, DPVAL>& map,
-                                   std::vector<uint64_t>& latestTimeStamp,
-                                   std::unordered_map<DPID, std::deque<T>>& destmap)
-{
-
-  // processing the array of type T
-
-  int found = 0;
-  //#ifdef WITH_OPENMP
-  //omp_set_num_threads(mNThreads);
-  //#pragma omp parallel for schedule(dynamic)
-  //#endif
-  for (size_t i = 0; i != array.size(); ++i) {
-    auto it = findAndCheckPid(array[i], type, map);
-    if (it == map.end()) {
-      if (!mIsDelta) {
-        LOG(ERROR) << "Element " << array[i] << " not found " << std::endl;
-      }
-      continue;
-    }
-    found++;
-    std::pair<DPID, DPVAL> pairIt = *it;
-    checkFlagsAndFill(pairIt, latestTimeStamp[i], destmap);
-    if (type == RAW_CHAR) {
-      processCharDP(array[i]);
-    } else if (type == RAW_INT) {
-      processIntDP(array[i]);
-    } else if (type == RAW_DOUBLE) {
-      processDoubleDP(array[i]);
-    } else if (type == RAW_UINT) {
-      processUIntDP(array[i]);
-    } else if (type == RAW_BOOL) {
-      processBoolDP(array[i]);
-    } else if (type == RAW_STRING) {
-      processStringDP(array[i]);
-    } else if (type == RAW_TIME) {
-      processTimeDP(array[i]);
-    } else if (type == RAW_BINARY) {
-      processBinaryDP(array[i]);
-    }
-    // todo: better to move the "found++" after the process, in case it fails?
-  }
-  return found;
-}
-
-//______________________________________________________________________
-
-template <typename T>
-void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                                     std::unordered_map<DPID, T>& destmap)
+bool DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, int idx, std::vector<uint64_t>& latestTimeStamp,
+                                     DataPointRingBuffer<T>& dest)
 {
 
   // check the flags for the upcoming data, and if ok, fill the accumulator
@@ -255,47 +228,21 @@ void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64
   auto& dpid = dpcom.first;
   auto& val = dpcom.second;
   auto flags = val.get_flags();
-  if (processFlag(flags, dpid.get_alias()) == 0) {
-    auto etime = val.get_epoch_time();
-    // fill only if new value has a timestamp different from the timestamp of the previous one
-    LOG(DEBUG) << "destmap[pid].size() = " << destmap[dpid].size();
-    if (destmap[dpid].size() == 0 || etime != latestTimeStamp) {
-      LOG(DEBUG) << "adding new value";
-      destmap[dpid].push_back(val.payload_pt1);
-      latestTimeStamp = etime;
-    }
+  if (processFlag(flags, dpid.get_alias()) != 0) {
+    return false;
   }
-}
-
-//______________________________________________________________________
-
-template <>
-void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                                     std::unordered_map<DPID, DCSProcessor::DQStrings>& destmap);
-
-//______________________________________________________________________
-
-template <>
-void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                                     std::unordered_map<DPID, DCSProcessor::DQBinaries>& destmap);
-
-//______________________________________________________________________
-
-template <typename T>
-void DCSProcessor::doSimpleMovingAverage(int nelements, std::deque<T>& vect, float& avg, bool& isSMA)
-{
-
-  // Do simple moving average on vector of type T
-
-  if (vect.size() <= nelements) {
-    //avg = std::accumulate(vect.begin(), vect.end(), 0.0) / vect.size();
-    avg = (avg * (vect.size() - 1) + vect.back()) / vect.size();
-    return;
+  auto etime = val.get_epoch_time();
+  // fill only if new value has a timestamp different from the timestamp of the previous one
+  if (!dest.empty(idx) && etime == latestTimeStamp[idx]) {
+    return false;
   }
-
-  avg += (vect[vect.size() - 1] - vect[0]) / nelements;
-  vect.pop_front();
-  isSMA = true;
+  // the payload holds the raw bytes of the value (for strings and binaries all 56 bytes are used)
+  T tmp{};
+  static_assert(sizeof(T) <= 7 * sizeof(uint64_t), "payload is too small for the type");
+  memcpy(&tmp, &(val.payload_pt1), sizeof(T));
+  dest.push(idx, tmp);
+  latestTimeStamp[idx] = etime;
+  return true;
 }
 
 //______________________________________________________________________
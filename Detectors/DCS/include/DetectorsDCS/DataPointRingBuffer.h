@@ -0,0 +1,96 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef DETECTOR_DCS_DATAPOINTRINGBUFFER_H_
+#define DETECTOR_DCS_DATAPOINTRINGBUFFER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/// @brief Fixed-capacity ring buffers for the values of many data points of the same type
+///
+/// The data points are addressed by a dense index (0..nDPs-1). The values of all data points
+/// are kept in one contiguous array, each data point owning a slice of "capacity" elements.
+/// Once a buffer is full, the oldest value is overwritten.
+/// Boolean values should be stored as uint8_t, to avoid the packed std::vector<bool>.
+
+namespace o2
+{
+namespace dcs
+{
+
+template <typename T>
+class DataPointRingBuffer
+{
+  static_assert(!std::is_same_v<T, bool>, "use uint8_t to store boolean values");
+
+ public:
+  DataPointRingBuffer() = default;
+  ~DataPointRingBuffer() = default;
+
+  void init(size_t nDPs, size_t capacity)
+  {
+    mCapacity = capacity > 0 ? capacity : 1;
+    mValues.assign(nDPs * mCapacity, T{});
+    mFirst.assign(nDPs, 0);
+    mSize.assign(nDPs, 0);
+  }
+
+  void clear()
+  {
+    std::fill(mFirst.begin(), mFirst.end(), 0);
+    std::fill(mSize.begin(), mSize.end(), 0);
+  }
+
+  size_t getNDPs() const { return mSize.size(); }
+  size_t capacity() const { return mCapacity; }
+  size_t size(size_t idp) const { return mSize[idp]; }
+  bool empty(size_t idp) const { return mSize[idp] == 0; }
+  bool full(size_t idp) const { return mSize[idp] == mCapacity; }
+
+  /// i-th value of data point idp, 0 being the oldest one
+  const T& at(size_t idp, size_t i) const { return mValues[slot(idp, i)]; }
+  const T& front(size_t idp) const { return at(idp, 0); }
+  const T& back(size_t idp) const { return at(idp, mSize[idp] - 1); }
+
+  /// i-th latest value of data point idp, 0 being the latest one
+  const T& fromBack(size_t idp, size_t i) const { return at(idp, mSize[idp] - 1 - i); }
+
+  /// add a value for data point idp, the oldest value is overwritten if the buffer is full
+  void push(size_t idp, const T& val)
+  {
+    if (mSize[idp] < mCapacity) {
+      mValues[slot(idp, mSize[idp]++)] = val;
+    } else {
+      mValues[idp * mCapacity + mFirst[idp]] = val;
+      mFirst[idp] = mFirst[idp] + 1 == mCapacity ? 0 : mFirst[idp] + 1;
+    }
+  }
+
+ private:
+  size_t slot(size_t idp, size_t i) const
+  {
+    size_t pos = mFirst[idp] + i;
+    return idp * mCapacity + (pos < mCapacity ? pos : pos - mCapacity);
+  }
+
+  size_t mCapacity = 1;         // number of values kept per data point
+  std::vector<T> mValues;       // values of all data points, mCapacity consecutive slots per data point
+  std::vector<uint32_t> mFirst; // position of the oldest value within the slice of each data point
+  std::vector<uint32_t> mSize;  // number of valid values for each data point
+};
+
+} // namespace dcs
+} // namespace o2
+
+#endif
@@ -10,7 +10,7 @@
 
 #include <DetectorsDCS/DCSProcessor.h>
 #include "Rtypes.h"
-#include <deque>
+#include <array>
 #include <string>
 #include <algorithm>
 #include <iterator>
@@ -103,14 +103,7 @@ void DCSProcessor::init(const std::vector<DPID>& pidschars, const std::vector<DP
     mPids[*it] = mPidsbinaries.size() - 1;
   }
 
-  mLatestTimestampchars.resize(pidschars.size(), 0);
-  mLatestTimestampints.resize(pidsints.size(), 0);
-  mLatestTimestampdoubles.resize(pidsdoubles.size(), 0);
-  mLatestTimestampUints.resize(pidsUints.size(), 0);
-  mLatestTimestampbools.resize(pidsbools.size(), 0);
-  mLatestTimestampstrings.resize(pidsstrings.size(), 0);
-  mLatestTimestamptimes.resize(pidstimes.size(), 0);
-  mLatestTimestampbinaries.resize(pidsbinaries.size(), 0);
+  initBuffers();
 }
 
 //______________________________________________________________________
@@ -163,14 +156,45 @@ void DCSProcessor::init(const std::vector<DPID>& pids)
     }
   }
 
-  mLatestTimestampchars.resize(nchars, 0);
-  mLatestTimestampints.resize(nints, 0);
-  mLatestTimestampdoubles.resize(ndoubles, 0);
-  mLatestTimestampUints.resize(nUints, 0);
-  mLatestTimestampbools.resize(nbools, 0);
-  mLatestTimestampstrings.resize(nstrings, 0);
-  mLatestTimestamptimes.resize(ntimes, 0);
-  mLatestTimestampbinaries.resize(nbinaries, 0);
+  initBuffers();
+}
+
+//__________________________________________________________________
+
+void DCSProcessor::initBuffers()
+{
+
+  // allocate the buffers for all DPs known to the processor; each DP gets a fixed number of slots
+  // (at least one more than the number of elements for the moving average, to know the value leaving the window)
+
+  if (mBufferCapacity <= mNElementsSMA) {
+    LOG(WARNING) << "Buffer capacity " << mBufferCapacity << " too small for a moving average over "
+                 << mNElementsSMA << " elements, increasing it";
+    mBufferCapacity = mNElementsSMA + 1;
+  }
+
+  mDpschars.init(mPidschars.size(), mBufferCapacity);
+  mDpsints.init(mPidsints.size(), mBufferCapacity);
+  mDpsdoubles.init(mPidsdoubles.size(), mBufferCapacity);
+  mDpsUints.init(mPidsUints.size(), mBufferCapacity);
+  mDpsbools.init(mPidsbools.size(), mBufferCapacity);
+  mDpsstrings.init(mPidsstrings.size(), mBufferCapacity);
+  mDpstimes.init(mPidstimes.size(), mBufferCapacity);
+  mDpsbinaries.init(mPidsbinaries.size(), mBufferCapacity);
+
+  mLatestTimestampchars.assign(mPidschars.size(), 0);
+  mLatestTimestampints.assign(mPidsints.size(), 0);
+  mLatestTimestampdoubles.assign(mPidsdoubles.size(), 0);
+  mLatestTimestampUints.assign(mPidsUints.size(), 0);
+  mLatestTimestampbools.assign(mPidsbools.size(), 0);
+  mLatestTimestampstrings.assign(mPidsstrings.size(), 0);
+  mLatestTimestamptimes.assign(mPidstimes.size(), 0);
+  mLatestTimestampbinaries.assign(mPidsbinaries.size(), 0);
+
+  mSimpleMovingAverage.assign(mPidsints.size(), 0.f);
+  mSumSMA.assign(mPidsints.size(), 0.);
+  mUpdatedInts.clear();
+  mUpdatedInts.reserve(mPidsints.size());
 }
 
 //__________________________________________________________________
@@ -197,39 +221,50 @@ int DCSProcessor::processMap(const std::unordered_map<DPID, DPVAL>& map, bool is
 
   mIsDelta = isDelta;
 
-  // we need to check if there are the Data Points that we need
-
-  int foundChars = 0, foundInts = 0, foundDoubles = 0, foundUInts = 0,
-      foundBools = 0, foundStrings = 0, foundTimes = 0, foundBinaries = 0;
-
-  // char type
-  foundChars = processArrayType(mPidschars, DeliveryType::RAW_CHAR, map, mLatestTimestampchars, mDpscharsmap);
-
-  // int type
-  foundInts = processArrayType(mPidsints, DeliveryType::RAW_INT, map, mLatestTimestampints, mDpsintsmap);
-
-  // double type
-  foundDoubles = processArrayType(mPidsdoubles, DeliveryType::RAW_DOUBLE, map, mLatestTimestampdoubles,
-                                  mDpsdoublesmap);
-
-  // UInt type
-  foundUInts = processArrayType(mPidsUints, DeliveryType::RAW_UINT, map, mLatestTimestampUints, mDpsUintsmap);
-
-  // Bool type
-  foundBools = processArrayType(mPidsbools, DeliveryType::RAW_BOOL, map, mLatestTimestampbools, mDpsboolsmap);
+  // we loop over the received DPs and find their index in the buffers with a single lookup each:
+  // a delta map only costs as much as the number of DPs which changed
 
-  // String type
-  foundStrings = processArrayType(mPidsstrings, DeliveryType::RAW_STRING, map, mLatestTimestampstrings,
-                                  mDpsstringsmap);
-
-  // Time type
-  foundTimes = processArrayType(mPidstimes, DeliveryType::RAW_TIME, map, mLatestTimestamptimes, mDpstimesmap);
+  std::array<int, DeliveryType::RAW_BINARY + 1> found{};
+  mUpdatedInts.clear();
+  for (const auto& dpcom : map) {
+    auto el = mPids.find(dpcom.first);
+    if (el == mPids.end()) {
+      continue; // not a DP for this processor
+    }
+    size_t type = dpcom.first.get_type();
+    if (type < found.size()) {
+      found[type]++;
+    }
+    fillDP(dpcom, el->second);
+  }
+  doSimpleMovingAverages();
 
-  // Binary type
-  foundBinaries = processArrayType(mPidsbinaries, DeliveryType::RAW_BINARY, map, mLatestTimestampbinaries,
-                                   mDpsbinariesmap);
+  int foundChars = found[DeliveryType::RAW_CHAR], foundInts = found[DeliveryType::RAW_INT],
+      foundDoubles = found[DeliveryType::RAW_DOUBLE], foundUInts = found[DeliveryType::RAW_UINT],
+      foundBools = found[DeliveryType::RAW_BOOL], foundStrings = found[DeliveryType::RAW_STRING],
+      foundTimes = found[DeliveryType::RAW_TIME], foundBinaries = found[DeliveryType::RAW_BINARY];
 
   if (!isDelta) {
+    // report the missing DPs; this is only done when something is missing
+    auto reportMissing = [&map](const std::vector<DPID>& pids, int nFound) {
+      if (nFound == pids.size()) {
+        return;
+      }
+      for (const auto& pid : pids) {
+        if (map.find(pid) == map.end()) {
+          LOG(ERROR) << "Element " << pid << " not found " << std::endl;
+        }
+      }
+    };
+    reportMissing(mPidschars, foundChars);
+    reportMissing(mPidsints, foundInts);
+    reportMissing(mPidsdoubles, foundDoubles);
+    reportMissing(mPidsUints, foundUInts);
+    reportMissing(mPidsbools, foundBools);
+    reportMissing(mPidsstrings, foundStrings);
+    reportMissing(mPidstimes, foundTimes);
+    reportMissing(mPidsbinaries, foundBinaries);
+
     if (foundChars != mPidschars.size()) {
       LOG(INFO) << "Not all expected char-typed DPs found!";
     }
@@ -277,105 +312,89 @@ int DCSProcessor::processDP(const std::pair<DPID, DPVAL>& dpcom)
 
   // processing single DP
 
-  DPID dpid = dpcom.first;
-  DeliveryType type = dpid.get_type();
-
   // first we check if the DP is in the list for the detector
-  auto el = mPids.find(dpid);
+  auto el = mPids.find(dpcom.first);
   if (el == mPids.end()) {
     LOG(ERROR) << "DP not found for this detector, please check";
     return 1;
   }
-  int posInVector = (*el).second;
-
-  if (type == DeliveryType::RAW_CHAR) {
-    checkFlagsAndFill(dpcom, mLatestTimestampchars[posInVector], mDpscharsmap);
-    processCharDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_INT) {
-    checkFlagsAndFill(dpcom, mLatestTimestampints[posInVector], mDpsintsmap);
-    processIntDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_DOUBLE) {
-    checkFlagsAndFill(dpcom, mLatestTimestampdoubles[posInVector], mDpsdoublesmap);
-    processDoubleDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_UINT) {
-    checkFlagsAndFill(dpcom, mLatestTimestampUints[posInVector], mDpsUintsmap);
-    processUIntDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_BOOL) {
-    checkFlagsAndFill(dpcom, mLatestTimestampbools[posInVector], mDpsboolsmap);
-    processBoolDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_STRING) {
-    checkFlagsAndFill(dpcom, mLatestTimestampstrings[posInVector], mDpsstringsmap);
-    processStringDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_TIME) {
-    checkFlagsAndFill(dpcom, mLatestTimestamptimes[posInVector], mDpstimesmap);
-    processTimeDP(dpid);
-  }
-
-  else if (type == DeliveryType::RAW_BINARY) {
-    checkFlagsAndFill(dpcom, mLatestTimestampbinaries[posInVector], mDpsbinariesmap);
-    processBinaryDP(dpid);
-  }
+  mUpdatedInts.clear();
+  fillDP(dpcom, el->second);
+  doSimpleMovingAverages();
 
   return 0;
 }
 
 //______________________________________________________________________
 
-template <>
-void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                                     std::unordered_map<DPID, DQStrings>& destmap)
+bool DCSProcessor::fillDP(const std::pair<DPID, DPVAL>& dpcom, int idx)
 {
 
-  // check the flags for the upcoming data, and if ok, fill the accumulator
-
-  auto& dpid = dpcom.first;
-  auto& val = dpcom.second;
-  auto flags = val.get_flags();
-  if (processFlag(flags, dpid.get_alias()) == 0) {
-    auto etime = val.get_epoch_time();
-    // fill only if new value has a timestamp different from the timestamp of the previous one
-    LOG(DEBUG) << "destmap[pid].size() = " << destmap[dpid].size();
-    if (destmap[dpid].size() == 0 || etime != latestTimeStamp) {
-      auto& tmp = destmap[dpid].emplace_back();
-      std::strncpy(tmp.data(), (char*)&(val.payload_pt1), 56);
-      latestTimeStamp = etime;
-    }
-  }
+  // fill the value of the DP in the buffer of its type and call the processing for the DP
+
+  const DPID& dpid = dpcom.first;
+  bool filled = false;
+  switch (dpid.get_type()) {
+    case DeliveryType::RAW_CHAR:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampchars, mDpschars);
+      processCharDP(dpid);
+      break;
+    case DeliveryType::RAW_INT:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampints, mDpsints);
+      if (filled) {
+        mUpdatedInts.push_back(idx);
+      }
+      processIntDP(dpid);
+      break;
+    case DeliveryType::RAW_DOUBLE:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampdoubles, mDpsdoubles);
+      processDoubleDP(dpid);
+      break;
+    case DeliveryType::RAW_UINT:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampUints, mDpsUints);
+      processUIntDP(dpid);
+      break;
+    case DeliveryType::RAW_BOOL:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampbools, mDpsbools);
+      processBoolDP(dpid);
+      break;
+    case DeliveryType::RAW_STRING:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampstrings, mDpsstrings);
+      processStringDP(dpid);
+      break;
+    case DeliveryType::RAW_TIME:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestamptimes, mDpstimes);
+      processTimeDP(dpid);
+      break;
+    case DeliveryType::RAW_BINARY:
+      filled = checkFlagsAndFill(dpcom, idx, mLatestTimestampbinaries, mDpsbinaries);
+      processBinaryDP(dpid);
+      break;
+    default:
+      LOG(ERROR) << "Unsupported delivery type for DP " << dpid;
+  }
+  return filled;
 }
 
 //______________________________________________________________________
 
-template <>
-void DCSProcessor::checkFlagsAndFill(const std::pair<DPID, DPVAL>& dpcom, uint64_t& latestTimeStamp,
-                                     std::unordered_map<DPID, DQBinaries>& destmap)
+void DCSProcessor::doSimpleMovingAverages()
 {
 
-  // check the flags for the upcoming data, and if ok, fill the accumulator
-
-  auto& dpid = dpcom.first;
-  auto& val = dpcom.second;
-  auto flags = val.get_flags();
-  if (processFlag(flags, dpid.get_alias()) == 0) {
-    auto etime = val.get_epoch_time();
-    // fill only if new value has a timestamp different from the timestamp of the previous one
-    LOG(DEBUG) << "destmap[pid].size() = " << destmap[dpid].size();
-    if (destmap[dpid].size() == 0 || etime != latestTimeStamp) {
-      auto& tmp = destmap[dpid].emplace_back();
-      memcpy(tmp.data(), &(val.payload_pt1), 7);
-      latestTimeStamp = etime;
+  // update the running sums of the last mNElementsSMA values for all int DPs which got a new value:
+  // the newest value enters the window, and once the window is full the value falling out of it is removed
+
+  for (auto idx : mUpdatedInts) {
+    size_t n = mDpsints.size(idx);
+    mSumSMA[idx] += mDpsints.back(idx);
+    if (n > mNElementsSMA) {
+      mSumSMA[idx] -= mDpsints.fromBack(idx, mNElementsSMA);
     }
+    mSimpleMovingAverage[idx] = mSumSMA[idx] / std::min(n, mNElementsSMA);
+  }
+  for (auto idx : mUpdatedInts) {
+    LOG(DEBUG) << "dpid = " << mPidsints[idx] << " --> Moving average = " << mSimpleMovingAverage[idx];
+    mccdbSimpleMovingAverage[mPidsints[idx].get_alias()] = mSimpleMovingAverage[idx];
   }
 }
 
@@ -391,14 +410,7 @@ void DCSProcessor::processCharDP(const DPID& pid)
 
 void DCSProcessor::processIntDP(const DPID& pid)
 {
-  // processing the single pid of type int
-  bool isSMA = false;
-  doSimpleMovingAverage(2, mDpsintsmap[pid], mSimpleMovingAverage[pid], isSMA);
-  LOG(DEBUG) << "dpid = " << pid << " --> Moving average = " << mSimpleMovingAverage[pid];
-  // create CCDB object
-  //if (isSMA) {
-  mccdbSimpleMovingAverage[pid.get_alias()] = mSimpleMovingAverage[pid];
-  //}
+  // empty for the example, the moving average of the int DPs is done in doSimpleMovingAverages
   return;
 }
 
@@ -452,27 +464,6 @@ void DCSProcessor::processBinaryDP(const DPID& pid)
 
 //______________________________________________________________________
 
-std::unordered_map<DPID, DPVAL>::const_iterator DCSProcessor::findAndCheckPid(const DPID& pid,
-                                                                              DeliveryType type,
-                                                                              const std::unordered_map<DPID, DPVAL>&
-                                                                                map)
-{
-
-  // processing basic checks for map: all needed pids must be present
-  // finds dp defined by "pid" in received map "map"
-
-  LOG(DEBUG) << "Processing " << pid;
-  auto it = map.find(pid);
-  DeliveryType tt = pid.get_type();
-  if (tt != type) {
-    LOG(FATAL) << "Delivery Type of pid " << pid.get_alias() << " does not match definition in DCSProcessor ("
-               << type << ")! Please fix";
-  }
-  return it;
-}
-
-//______________________________________________________________________
-
 uint64_t DCSProcessor::processFlag(const uint64_t flags, const char* pid)
 {
 
@@ -0,0 +1,94 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test DCS DCSProcessor
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <unordered_map>
+#include "DetectorsDCS/DataPointRingBuffer.h"
+#include "DetectorsDCS/DataPointCreator.h"
+#include "DetectorsDCS/DCSProcessor.h"
+
+using namespace o2::dcs;
+
+BOOST_AUTO_TEST_CASE(RingBufferWrap)
+{
+  DataPointRingBuffer<int> rb;
+  rb.init(2, 3);
+  for (int i = 0; i < 5; ++i) {
+    rb.push(1, i);
+  }
+  BOOST_CHECK(rb.empty(0));
+  BOOST_CHECK(rb.full(1));
+  BOOST_CHECK_EQUAL(rb.size(1), 3);
+  BOOST_CHECK_EQUAL(rb.front(1), 2);
+  BOOST_CHECK_EQUAL(rb.at(1, 1), 3);
+  BOOST_CHECK_EQUAL(rb.back(1), 4);
+  BOOST_CHECK_EQUAL(rb.fromBack(1, 2), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ProcessFullAndDeltaMaps)
+{
+  const int nInts = 10;
+  std::vector<DataPointIdentifier> pids;
+  for (int i = 0; i < nInts; ++i) {
+    pids.emplace_back("TestInt_" + std::to_string(i), DeliveryType::RAW_INT);
+  }
+  pids.emplace_back("TestDouble_0", DeliveryType::RAW_DOUBLE);
+
+  DCSProcessor proc;
+  proc.setBufferCapacity(4);
+  proc.setNElementsSMA(2);
+  proc.init(pids);
+
+  auto fillMap = [](std::unordered_map<DataPointIdentifier, DataPointValue>& map, const DataPointCompositeObject& dp) {
+    map.emplace(dp.id, dp.data);
+  };
+
+  // full map: all DPs, int i has value i
+  std::unordered_map<DataPointIdentifier, DataPointValue> full;
+  for (int i = 0; i < nInts; ++i) {
+    fillMap(full, createDataPointCompositeObject("TestInt_" + std::to_string(i), int32_t(i), 1000, 0));
+  }
+  fillMap(full, createDataPointCompositeObject("TestDouble_0", 3.5, 1000, 0));
+  proc.processMap(full, false);
+
+  int idxDouble = proc.getIndex(pids.back());
+  BOOST_CHECK_EQUAL(idxDouble, 0);
+  BOOST_CHECK_EQUAL(proc.getBufferDoubles().back(idxDouble), 3.5);
+  for (int i = 0; i < nInts; ++i) {
+    BOOST_CHECK_CLOSE(proc.getSimpleMovingAverage(pids[i]), float(i), 1e-4);
+  }
+
+  // delta maps: only TestInt_3 changes, the moving average is done over the last 2 values
+  const auto& pid3 = pids[3];
+  for (int iDelta = 1; iDelta <= 6; ++iDelta) {
+    std::unordered_map<DataPointIdentifier, DataPointValue> delta;
+    fillMap(delta, createDataPointCompositeObject("TestInt_3", int32_t(3 + 10 * iDelta), 1000 + iDelta, 0));
+    proc.processMap(delta, true);
+    float expected = (3 + 10 * iDelta + 3 + 10 * (iDelta - 1)) / 2.f;
+    BOOST_CHECK_CLOSE(proc.getSimpleMovingAverage(pid3), expected, 1e-4);
+  }
+  int idx3 = proc.getIndex(pid3);
+  BOOST_CHECK_EQUAL(proc.getBufferInts().size(idx3), 4);
+  BOOST_CHECK_EQUAL(proc.getBufferInts().back(idx3), 63);
+  BOOST_CHECK_EQUAL(proc.getBufferInts().front(idx3), 33);
+  // the others did not change
+  BOOST_CHECK_EQUAL(proc.getBufferInts().size(proc.getIndex(pids[4])), 1);
+
+  // same timestamp as the previous value: not added
+  std::unordered_map<DataPointIdentifier, DataPointValue> delta;
+  fillMap(delta, createDataPointCompositeObject("TestInt_3", int32_t(1000), 1006, 0));
+  proc.processMap(delta, true);
+  BOOST_CHECK_EQUAL(proc.getBufferInts().back(idx3), 63);
+}
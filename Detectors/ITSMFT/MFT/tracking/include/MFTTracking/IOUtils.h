@@ -59,6 +59,11 @@ int loadROFrameData(const o2::itsmft::ROFRecord& rof, ROframe& events, gsl::span
                     gsl::span<const unsigned char>::iterator& pattIt, const itsmft::TopologyDictionary& dict,
                     const dataformats::MCTruthContainer<MCCompLabel>* mClsLabels = nullptr, const o2::mft::Tracker* tracker = nullptr);
 
+/// advance the pattern iterator over the patterns of the clusters of a ROF without loading them,
+/// used to find the start of the patterns of each ROF before loading the ROFs in parallel
+void skipROFramePatterns(const o2::itsmft::ROFRecord& rof, gsl::span<const itsmft::CompClusterExt> clusters,
+                         gsl::span<const unsigned char>::iterator& pattIt, const itsmft::TopologyDictionary& dict);
+
 } // namespace ioutils
 } // namespace mft
 } // namespace o2
@@ -27,6 +27,9 @@
 #include "SimulationDataFormat/MCTruthContainer.h"
 #include "DataFormatsParameters/GRPObject.h"
 
+#include <gsl/gsl>
+#include <memory>
+
 namespace o2
 {
 namespace mft
@@ -60,6 +63,7 @@ class Tracker : public TrackerConfig
   std::uint32_t getROFrame() const { return mROFrame; }
 
   void initialize();
+  void initialize(const Tracker& tracker);
   void initConfig(const MFTTrackingParam& trkParam, bool printConfig = false);
 
  private:
@@ -93,8 +97,23 @@ class Tracker : public TrackerConfig
 
   bool mUseMC = false;
 
-  std::array<std::array<std::array<std::vector<Int_t>, constants::index_table::MaxRPhiBins>, (constants::mft::LayersNumber - 1)>, (constants::mft::LayersNumber - 1)> mBinsS;
-  std::array<std::array<std::array<std::vector<Int_t>, constants::index_table::MaxRPhiBins>, (constants::mft::LayersNumber - 1)>, (constants::mft::LayersNumber - 1)> mBins;
+  /// Look-Up-Table of the R-Phi bins in layer2 to be searched for an R-Phi bin in layer1,
+  /// the bins of all (layer1, layer2, bin) combinations are stored consecutively in one array
+  struct BinLUT {
+    gsl::span<const Int_t> getBins(Int_t layer1, Int_t layer2, Int_t bin) const
+    {
+      auto index = (layer1 * (constants::mft::LayersNumber - 1) + layer2 - 1) * nBinsPerLayer + bin;
+      return gsl::span<const Int_t>(bins.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+
+    Int_t nBinsPerLayer = 0;    // number of R-Phi bins + 1 for the clusters outside of the R-Phi range
+    std::vector<Int_t> offsets; // start of the bins of each (layer1, layer2, bin) combination
+    std::vector<Int_t> bins;    // R-Phi bin indices in layer2
+  };
+
+  /// read-only after initialization, shared by the trackers running in parallel
+  std::shared_ptr<const BinLUT> mBinsS; // LUT for the seed search window
+  std::shared_ptr<const BinLUT> mBins;  // LUT for the intermediate layers search window
 
   /// helper to store points of a track candidate
   struct TrackElement {
@@ -86,5 +86,16 @@ int ioutils::loadROFrameData(const o2::itsmft::ROFRecord& rof, ROframe& event, g
   return clusters_in_frame.size();
 }
 
+void ioutils::skipROFramePatterns(const o2::itsmft::ROFRecord& rof, gsl::span<const itsmft::CompClusterExt> clusters,
+                                  gsl::span<const unsigned char>::iterator& pattIt, const itsmft::TopologyDictionary& dict)
+{
+  for (auto& c : rof.getROFData(clusters)) {
+    auto pattID = c.getPatternID();
+    if (pattID == itsmft::CompCluster::InvalidPatternID || dict.isGroup(pattID)) {
+      o2::itsmft::ClusterPattern patt(pattIt);
+    }
+  }
+}
+
 } // namespace mft
 } // namespace o2
@@ -20,6 +20,8 @@
 
 #include "Framework/Logger.h"
 
+#include <stdexcept>
+
 namespace o2
 {
 namespace mft
@@ -88,26 +90,36 @@ void Tracker::initialize()
 {
   /// calculate Look-Up-Table of the R-Phi bins projection from one layer to another
   /// layer1 + global R-Phi bin index ---> layer2 + R bin index + Phi bin index
+  /// the bins are filled in the order of the flat index of (layer1, layer2, bin)
 
   Float_t dz, x, y, r, phi, x_proj, y_proj, r_proj, phi_proj;
-  Int_t binIndex1, binIndex2, binIndex2S, binR_proj, binPhi_proj;
+  Int_t binIndex2, binIndex2S, binR_proj, binPhi_proj;
+
+  auto binsS = std::make_shared<BinLUT>();
+  auto bins = std::make_shared<BinLUT>();
+  for (auto lut : {binsS.get(), bins.get()}) {
+    // one additional bin for the clusters outside of the R-Phi range
+    lut->nBinsPerLayer = mRPhiBins + 1;
+    lut->offsets.clear();
+    lut->offsets.reserve((constants::mft::LayersNumber - 1) * (constants::mft::LayersNumber - 1) * lut->nBinsPerLayer + 1);
+    lut->offsets.push_back(0);
+  }
 
   for (Int_t layer1 = 0; layer1 < (constants::mft::LayersNumber - 1); ++layer1) {
 
-    for (Int_t iRBin = 0; iRBin < mRBins; ++iRBin) {
+    for (Int_t layer2 = 1; layer2 < constants::mft::LayersNumber; ++layer2) {
 
-      r = (iRBin + 0.5) * mRBinSize + constants::index_table::RMin;
-
-      for (Int_t iPhiBin = 0; iPhiBin < mPhiBins; ++iPhiBin) {
+      // bin index = iPhiBin * mRBins + iRBin
+      for (Int_t iPhiBin = 0; iPhiBin < mPhiBins && layer2 > layer1; ++iPhiBin) {
 
         phi = (iPhiBin + 0.5) * mPhiBinSize + constants::index_table::PhiMin;
 
-        binIndex1 = getBinIndex(iRBin, iPhiBin);
+        for (Int_t iRBin = 0; iRBin < mRBins; ++iRBin) {
 
-        x = r * TMath::Cos(phi);
-        y = r * TMath::Sin(phi);
+          r = (iRBin + 0.5) * mRBinSize + constants::index_table::RMin;
 
-        for (Int_t layer2 = (layer1 + 1); layer2 < constants::mft::LayersNumber; ++layer2) {
+          x = r * TMath::Cos(phi);
+          y = r * TMath::Sin(phi);
 
           dz = constants::mft::LayerZCoordinate()[layer2] - constants::mft::LayerZCoordinate()[layer1];
           x_proj = x + dz * x * constants::mft::InverseLayerZCoordinate()[layer1];
@@ -141,9 +153,10 @@ void Tracker::initialize()
               }
 
               binIndex2S = getBinIndex(binRS, binPhiS);
-              mBinsS[layer1][layer2 - 1][binIndex1].emplace_back(binIndex2S);
+              binsS->bins.push_back(binIndex2S);
             }
           }
+          binsS->offsets.push_back(binsS->bins.size());
 
           int binR, binPhi;
 
@@ -166,14 +179,36 @@ void Tracker::initialize()
               }
 
               binIndex2 = getBinIndex(binR, binPhi);
-              mBins[layer1][layer2 - 1][binIndex1].emplace_back(binIndex2);
+              bins->bins.push_back(binIndex2);
             }
           }
+          bins->offsets.push_back(bins->bins.size());
 
-        } // end loop layer2
+        } // end loop RBinIndex
       }   // end loop PhiBinIndex
-    }     // end loop RBinIndex
-  }       // end loop layer1
+
+      // empty ranges for the bins without projection: all bins if layer2 <= layer1, the overflow bin otherwise
+      for (auto lut : {binsS.get(), bins.get()}) {
+        lut->offsets.resize((layer1 * (constants::mft::LayersNumber - 1) + layer2) * lut->nBinsPerLayer + 1, lut->bins.size());
+      }
+    } // end loop layer2
+  }   // end loop layer1
+
+  mBinsS = binsS;
+  mBins = bins;
+
+  mRoad.initialize();
+}
+
+//_________________________________________________________________________________________________
+void Tracker::initialize(const Tracker& tracker)
+{
+  /// share the read-only Look-Up-Tables of an initialized tracker with the same configuration
+  if (tracker.mRPhiBins != mRPhiBins || !tracker.mBinsS || !tracker.mBins) {
+    throw std::runtime_error("can not share the Look-Up-Tables of a tracker with a different configuration");
+  }
+  mBinsS = tracker.mBinsS;
+  mBins = tracker.mBins;
 
   mRoad.initialize();
 }
@@ -230,24 +265,24 @@ void Tracker::findTracksLTF(ROframe& event)
       continue;
     }
 
-    for (std::vector<Cluster>::iterator it1 = event.getClustersInLayer(layer1).begin(); it1 != event.getClustersInLayer(layer1).end(); ++it1) {
-      Cluster& cluster1 = *it1;
+    auto& clustersLayer1 = event.getClustersInLayer(layer1);
+    auto& clustersLayer2 = event.getClustersInLayer(layer2);
+    for (clsInLayer1 = 0; clsInLayer1 < (Int_t)clustersLayer1.size(); ++clsInLayer1) {
+      Cluster& cluster1 = clustersLayer1[clsInLayer1];
       if (cluster1.getUsed()) {
         continue;
       }
-      clsInLayer1 = it1 - event.getClustersInLayer(layer1).begin();
 
       // loop over the bins in the search window
-      for (auto& binS : mBinsS[layer1][layer2 - 1][cluster1.indexTableBin]) {
+      for (auto binS : mBinsS->getBins(layer1, layer2, cluster1.indexTableBin)) {
 
         getBinClusterRange(event, layer2, binS, clsMinIndexS, clsMaxIndexS);
 
-        for (std::vector<Cluster>::iterator it2 = (event.getClustersInLayer(layer2).begin() + clsMinIndexS); it2 != (event.getClustersInLayer(layer2).begin() + clsMaxIndexS + 1); ++it2) {
-          Cluster& cluster2 = *it2;
+        for (clsInLayer2 = clsMinIndexS; clsInLayer2 <= clsMaxIndexS; ++clsInLayer2) {
+          Cluster& cluster2 = clustersLayer2[clsInLayer2];
           if (cluster2.getUsed()) {
             continue;
           }
-          clsInLayer2 = it2 - event.getClustersInLayer(layer2).begin();
 
           // start a TrackLTF
           nPoints = 0;
@@ -262,18 +297,19 @@ void Tracker::findTracksLTF(ROframe& event)
 
             newPoint = kTRUE;
 
+            auto& clustersLayer = event.getClustersInLayer(layer);
+
             // loop over the bins in the search window
             dR2min = dR2cut;
-            for (auto& bin : mBins[layer1][layer - 1][cluster1.indexTableBin]) {
+            for (auto bin : mBins->getBins(layer1, layer, cluster1.indexTableBin)) {
 
               getBinClusterRange(event, layer, bin, clsMinIndex, clsMaxIndex);
 
-              for (std::vector<Cluster>::iterator it = (event.getClustersInLayer(layer).begin() + clsMinIndex); it != (event.getClustersInLayer(layer).begin() + clsMaxIndex + 1); ++it) {
-                Cluster& cluster = *it;
+              for (clsInLayer = clsMinIndex; clsInLayer <= clsMaxIndex; ++clsInLayer) {
+                Cluster& cluster = clustersLayer[clsInLayer];
                 if (cluster.getUsed()) {
                   continue;
                 }
-                clsInLayer = it - event.getClustersInLayer(layer).begin();
 
                 dR2 = getDistanceToSeed(cluster1, cluster2, cluster);
                 // retain the closest point within a radius dR2cut
@@ -369,24 +405,24 @@ void Tracker::findTracksCA(ROframe& event)
 
     for (Int_t layer2 = layer2Max; layer2 >= layer2Min[layer1]; --layer2) {
 
-      for (std::vector<Cluster>::iterator it1 = event.getClustersInLayer(layer1).begin(); it1 != event.getClustersInLayer(layer1).end(); ++it1) {
-        Cluster& cluster1 = *it1;
+      auto& clustersLayer1 = event.getClustersInLayer(layer1);
+      auto& clustersLayer2 = event.getClustersInLayer(layer2);
+      for (clsInLayer1 = 0; clsInLayer1 < (Int_t)clustersLayer1.size(); ++clsInLayer1) {
+        Cluster& cluster1 = clustersLayer1[clsInLayer1];
         if (cluster1.getUsed()) {
           continue;
         }
-        clsInLayer1 = it1 - event.getClustersInLayer(layer1).begin();
 
         // loop over the bins in the search window
-        for (auto& binS : mBinsS[layer1][layer2 - 1][cluster1.indexTableBin]) {
+        for (auto binS : mBinsS->getBins(layer1, layer2, cluster1.indexTableBin)) {
 
           getBinClusterRange(event, layer2, binS, clsMinIndexS, clsMaxIndexS);
 
-          for (std::vector<Cluster>::iterator it2 = (event.getClustersInLayer(layer2).begin() + clsMinIndexS); it2 != (event.getClustersInLayer(layer2).begin() + clsMaxIndexS + 1); ++it2) {
-            Cluster& cluster2 = *it2;
+          for (clsInLayer2 = clsMinIndexS; clsInLayer2 <= clsMaxIndexS; ++clsInLayer2) {
+            Cluster& cluster2 = clustersLayer2[clsInLayer2];
             if (cluster2.getUsed()) {
               continue;
             }
-            clsInLayer2 = it2 - event.getClustersInLayer(layer2).begin();
 
             // start a road
             roadPoints.clear();
@@ -396,17 +432,18 @@ void Tracker::findTracksCA(ROframe& event)
 
             for (Int_t layer = (layer1 + 1); layer <= (layer2 - 1); ++layer) {
 
+              auto& clustersLayer = event.getClustersInLayer(layer);
+
               // loop over the bins in the search window
-              for (auto& bin : mBins[layer1][layer - 1][cluster1.indexTableBin]) {
+              for (auto bin : mBins->getBins(layer1, layer, cluster1.indexTableBin)) {
 
                 getBinClusterRange(event, layer, bin, clsMinIndex, clsMaxIndex);
 
-                for (std::vector<Cluster>::iterator it = (event.getClustersInLayer(layer).begin() + clsMinIndex); it != (event.getClustersInLayer(layer).begin() + clsMaxIndex + 1); ++it) {
-                  Cluster& cluster = *it;
+                for (clsInLayer = clsMinIndex; clsInLayer <= clsMaxIndex; ++clsInLayer) {
+                  Cluster& cluster = clustersLayer[clsInLayer];
                   if (cluster.getUsed()) {
                     continue;
                   }
-                  clsInLayer = it - event.getClustersInLayer(layer).begin();
 
                   dR2 = getDistanceToSeed(cluster1, cluster2, cluster);
                   // add all points within a radius dR2cut
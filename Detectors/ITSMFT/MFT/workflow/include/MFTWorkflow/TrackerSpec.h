@@ -39,7 +39,9 @@ class TrackerDPL : public o2::framework::Task
   bool mUseMC = false;
   o2::itsmft::TopologyDictionary mDict;
   std::unique_ptr<o2::parameters::GRPObject> mGRP = nullptr;
-  std::unique_ptr<o2::mft::Tracker> mTracker = nullptr;
+  int mNThreads = 1;
+  std::vector<std::unique_ptr<o2::mft::Tracker>> mTrackers; // one tracker per thread
+  std::vector<std::unique_ptr<o2::mft::ROframe>> mEvents;   // one ROframe per thread
   TStopwatch mTimer;
 };
 
@@ -21,6 +21,10 @@
 
 #include <vector>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 #include "TGeoGlobalMagField.h"
 
 #include "Framework/ControlService.h"
@@ -55,17 +59,35 @@ void TrackerDPL::init(InitContext& ic)
 
     o2::base::GeometryManager::loadGeometry();
     o2::mft::GeometryTGeo* geom = o2::mft::GeometryTGeo::Instance();
+    // the L2G matrices are used when loading the clusters, fill the cache before loading ROFs in parallel
     geom->fillMatrixCache(o2::math_utils::bit2Mask(o2::math_utils::TransformType::T2L, o2::math_utils::TransformType::T2GRot,
-                                                   o2::math_utils::TransformType::T2G));
+                                                   o2::math_utils::TransformType::T2G, o2::math_utils::TransformType::L2G));
 
     // tracking configuration parameters
     auto& mftTrackingParam = MFTTrackingParam::Instance();
-    // create the tracker: set the B-field, the configuration and initialize
-    mTracker = std::make_unique<o2::mft::Tracker>(mUseMC);
+    // create the trackers: set the B-field, the configuration and initialize
+    // one tracker per thread, the Look-Up-Tables of the first one are shared
+    mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+#ifndef WITH_OPENMP
+    if (mNThreads > 1) {
+      LOG(WARNING) << "MFT tracker was compiled without OpenMP, running with 1 thread";
+      mNThreads = 1;
+    }
+#endif
     double centerMFT[3] = {0, 0, -61.4}; // Field at center of MFT
-    mTracker->setBz(field->getBz(centerMFT));
-    mTracker->initConfig(mftTrackingParam, true);
-    mTracker->initialize();
+    mTrackers.clear();
+    mEvents.clear();
+    for (int iThread = 0; iThread < mNThreads; iThread++) {
+      auto& tracker = mTrackers.emplace_back(std::make_unique<o2::mft::Tracker>(mUseMC));
+      tracker->setBz(field->getBz(centerMFT));
+      tracker->initConfig(mftTrackingParam, iThread == 0);
+      if (iThread == 0) {
+        tracker->initialize();
+      } else {
+        tracker->initialize(*mTrackers[0]);
+      }
+      mEvents.emplace_back(std::make_unique<o2::mft::ROframe>(0));
+    }
   } else {
     throw std::runtime_error(o2::utils::concat_string("Cannot retrieve GRP from the ", filename));
   }
@@ -109,20 +131,14 @@ void TrackerDPL::run(ProcessingContext& pc)
 
   //std::vector<o2::mft::TrackMFTExt> tracks;
   auto& allClusIdx = pc.outputs().make<std::vector<int>>(Output{"MFT", "TRACKCLSID", 0, Lifetime::Timeframe});
-  o2::dataformats::MCTruthContainer<o2::MCCompLabel> trackLabels;
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> allTrackLabels;
-  std::vector<o2::mft::TrackLTF> tracksLTF;
-  std::vector<o2::mft::TrackCA> tracksCA;
   auto& allTracksMFT = pc.outputs().make<std::vector<o2::mft::TrackMFT>>(Output{"MFT", "TRACKS", 0, Lifetime::Timeframe});
 
-  std::uint32_t roFrame = 0;
-  o2::mft::ROframe event(0);
-
   Bool_t continuous = mGRP->isDetContinuousReadOut("MFT");
   LOG(INFO) << "MFTTracker RO: continuous=" << continuous;
 
   // snippet to convert found tracks to final output tracks with separate cluster indices
-  auto copyTracks = [&event](auto& tracks, auto& allTracks, auto& allClusIdx) {
+  auto copyTracks = [](auto& tracks, auto& allTracks, auto& allClusIdx) {
     for (auto& trc : tracks) {
       trc.setExternalClusterIndexOffset(allClusIdx.size());
       int ncl = trc.getNumberOfPoints();
@@ -134,38 +150,79 @@ void TrackerDPL::run(ProcessingContext& pc)
     }
   };
 
+  // tracks found in one ROF
+  struct ROFTracks {
+    int nclUsed = 0;
+    std::vector<o2::mft::TrackLTF> tracksLTF;
+    std::vector<o2::mft::TrackCA> tracksCA;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> trackLabels;
+  };
+
   gsl::span<const unsigned char>::iterator pattIt = patterns.begin();
   if (continuous) {
+    // the cluster patterns of all ROFs are stored sequentially, find the start of the
+    // patterns of each ROF before loading the ROFs in parallel
+    std::vector<gsl::span<const unsigned char>::iterator> rofPattIt;
+    rofPattIt.reserve(rofs.size());
     for (auto& rof : rofs) {
-      int nclUsed = ioutils::loadROFrameData(rof, event, compClusters, pattIt, mDict, labels, mTracker.get());
-      if (nclUsed) {
+      rofPattIt.push_back(pattIt);
+      ioutils::skipROFramePatterns(rof, compClusters, pattIt, mDict);
+    }
+
+    // the ROFs are independent, each thread uses its own tracker and ROframe, the tracks
+    // are stored per ROF and concatenated in the order of the ROFs
+    std::vector<ROFTracks> rofTracks(rofs.size());
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int roFrame = 0; roFrame < (int)rofs.size(); roFrame++) {
+#ifdef WITH_OPENMP
+      int iThread = omp_get_thread_num();
+#else
+      int iThread = 0;
+#endif
+      auto& tracker = *mTrackers[iThread];
+      auto& event = *mEvents[iThread];
+      auto& result = rofTracks[roFrame];
+      auto rofPatt = rofPattIt[roFrame];
+      result.nclUsed = ioutils::loadROFrameData(rofs[roFrame], event, compClusters, rofPatt, mDict, labels, &tracker);
+      if (result.nclUsed) {
         event.setROFrameId(roFrame);
         event.initialize();
-        LOG(INFO) << "ROframe: " << roFrame << ", clusters loaded : " << nclUsed;
-        mTracker->setROFrame(roFrame);
-        mTracker->clustersToTracks(event);
-        tracksLTF.swap(event.getTracksLTF());
-        tracksCA.swap(event.getTracksCA());
-        nTracksLTF += tracksLTF.size();
-        nTracksCA += tracksCA.size();
-
+        tracker.setROFrame(roFrame);
+        tracker.clustersToTracks(event);
+        result.tracksLTF.swap(event.getTracksLTF());
+        result.tracksCA.swap(event.getTracksCA());
         if (mUseMC) {
-          mTracker->computeTracksMClabels(tracksLTF);
-          mTracker->computeTracksMClabels(tracksCA);
-          trackLabels = mTracker->getTrackLabels(); /// FIXME: assignment ctor is not optimal.
-          allTrackLabels.mergeAtBack(trackLabels);
+          tracker.computeTracksMClabels(result.tracksLTF);
+          tracker.computeTracksMClabels(result.tracksCA);
+          result.trackLabels = std::move(tracker.getTrackLabels());
         }
+      }
+    }
 
-        LOG(INFO) << "Found tracks LTF: " << tracksLTF.size();
-        LOG(INFO) << "Found tracks CA: " << tracksCA.size();
-        int first = allTracksMFT.size();
-        int number = tracksLTF.size() + tracksCA.size();
-        rof.setFirstEntry(first);
-        rof.setNEntries(number);
-        copyTracks(tracksLTF, allTracksMFT, allClusIdx);
-        copyTracks(tracksCA, allTracksMFT, allClusIdx);
+    for (int roFrame = 0; roFrame < (int)rofs.size(); roFrame++) {
+      auto& result = rofTracks[roFrame];
+      if (!result.nclUsed) {
+        continue;
       }
-      roFrame++;
+      auto& rof = rofs[roFrame];
+      LOG(INFO) << "ROframe: " << roFrame << ", clusters loaded : " << result.nclUsed;
+      nTracksLTF += result.tracksLTF.size();
+      nTracksCA += result.tracksCA.size();
+
+      if (mUseMC) {
+        allTrackLabels.mergeAtBack(result.trackLabels);
+      }
+
+      LOG(INFO) << "Found tracks LTF: " << result.tracksLTF.size();
+      LOG(INFO) << "Found tracks CA: " << result.tracksCA.size();
+      int first = allTracksMFT.size();
+      int number = result.tracksLTF.size() + result.tracksCA.size();
+      rof.setFirstEntry(first);
+      rof.setNEntries(number);
+      copyTracks(result.tracksLTF, allTracksMFT, allClusIdx);
+      copyTracks(result.tracksCA, allTracksMFT, allClusIdx);
     }
   }
 
@@ -212,7 +269,8 @@ DataProcessorSpec getTrackerSpec(bool useMC)
     AlgorithmSpec{adaptFromTask<TrackerDPL>(useMC)},
     Options{
       {"grp-file", VariantType::String, "o2sim_grp.root", {"Name of the output file"}},
-      {"mft-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}}}};
+      {"mft-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads for the tracking of the ROFs"}}}};
 }
 
 } // namespace mft
@@ -25,9 +25,11 @@
 #include <gsl/span>
 
 #include <TH2D.h>
+#include <TRandom3.h>
 
 #include "DataFormatsMCH/Digit.h"
 #include "MCHBase/ClusterBlock.h"
+#include "MCHBase/PreCluster.h"
 #include "MCHMappingInterface/Segmentation.h"
 #include "MCHPreClustering/PreClusterFinder.h"
 
@@ -51,16 +53,19 @@ class ClusterFinderOriginal
   ClusterFinderOriginal(ClusterFinderOriginal&&) = delete;
   ClusterFinderOriginal& operator=(ClusterFinderOriginal&&) = delete;
 
-  void init();
+  void init(int nThreads = 1, bool analyticGradient = false);
   void deinit();
   void reset();
 
   void findClusters(gsl::span<const Digit> digits);
+  void findClusters(gsl::span<const PreCluster> preClusters, gsl::span<const Digit> digits);
 
   /// return the list of reconstructed clusters
   const std::vector<ClusterStruct>& getClusters() const { return mClusters; }
   /// return the list of digits used in reconstructed clusters
   const std::vector<Digit>& getUsedDigits() const { return mUsedDigits; }
+  /// return the number of threads processing the preclusters (1 if OpenMP is not available)
+  int getNThreads() const { return mNThreads; }
 
  private:
   static constexpr double SDistancePrecision = 1.e-3;                   ///< precision used to check overlaps and so on (cm)
@@ -72,6 +77,31 @@ class ClusterFinderOriginal
   static constexpr double SLowestCoupling = 1.e-2;                      ///< minimum coupling between clusters of pixels and pads
   static constexpr float SDefaultClusterResolution = 0.2f;              ///< default cluster resolution (cm)
   static constexpr float SBadClusterResolution = 10.f;                  ///< bad (e.g. mono-cathode) cluster resolution (cm)
+  static constexpr unsigned int SRandomSeed = 4357;                     ///< seed of the random generator used in the fit
+
+  /// pad used in the fit, with its edges given as indices in the lists of distinct pad edges of the fit
+  struct FitPad {
+    int xMin;      ///< index of the lower pad edge in x
+    int xMax;      ///< index of the upper pad edge in x
+    int yMin;      ///< index of the lower pad edge in y
+    int yMax;      ///< index of the upper pad edge in y
+    double charge; ///< pad charge
+  };
+
+  /// primitive of the Mathieson of one cluster at one pad edge and its derivative
+  struct EdgePrimitive {
+    double value;      ///< primitive
+    double derivative; ///< derivative w.r.t. the pad edge
+  };
+
+  /// location of the clusters and digits produced by one precluster in the lists of the worker that processed it
+  struct PreClusterOutput {
+    int worker;       ///< index of the worker
+    int firstCluster; ///< index of the first cluster in the worker list
+    int nClusters;    ///< number of clusters
+    int firstDigit;   ///< index of the first digit in the worker list
+    int nDigits;      ///< number of digits
+  };
 
   void resetPreCluster(gsl::span<const Digit>& digits);
   void simplifyPreCluster(std::vector<int>& removedDigits);
@@ -96,9 +126,12 @@ class ClusterFinderOriginal
 
   int fit(const std::vector<const std::vector<int>*>& clustersOfPixels, const double fitRange[2][2], double fitParam[SNFitParamMax + 1]);
   double fit(double currentParam[SNFitParamMax + 2], const double parmin[SNFitParamMax], const double parmax[SNFitParamMax],
-             int nParamUsed, int& nTrials) const;
+             int nParamUsed, int& nTrials);
   double computeChi2(const double param[SNFitParamMax + 2], int nParamUsed) const;
+  void setFitPads();
+  double computeChi2(const double param[SNFitParamMax + 2], int nParamUsed, double gradient[SNFitParamMax]);
   void param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed, double fraction[SNFitClustersMax]) const;
+  void param2ChargeFractionDerivatives(const double param[SNFitParamMax], int nParamUsed, double derivatives[SNFitClustersMax][2]) const;
   float chargeIntegration(double x, double y, const PadOriginal& pad) const;
 
   void split(const TH2D& histMLEM, const std::vector<double>& coef);
@@ -120,6 +153,13 @@ class ClusterFinderOriginal
 
   std::unique_ptr<ClusterOriginal> mPreCluster; ///< precluster currently processed
   std::vector<PadOriginal> mPixels;             ///< list of pixels for the current precluster
+  std::vector<FitPad> mFitPads{};               ///< list of pads used in the current fit
+
+  std::vector<double> mFitPadEdges[2]{};                             ///< distinct pad edges in x and y of the pads used in the current fit
+  std::vector<EdgePrimitive> mEdgePrimitives[SNFitClustersMax][2]{}; ///< Mathieson primitives of each cluster at each pad edge in x and y
+
+  bool mAnalyticGradient = false; ///< use analytic instead of numerical chi2 derivatives in the fit
+  TRandom3 mRandom{SRandomSeed}; ///< random generator used in the fit, reset for every precluster
 
   const mapping::Segmentation* mSegmentation = nullptr; ///< pointer to the DE segmentation for the current precluster
 
@@ -127,6 +167,10 @@ class ClusterFinderOriginal
   std::vector<Digit> mUsedDigits{};       ///< list of digits used in reconstructed clusters
 
   PreClusterFinder mPreClusterFinder{}; ///< preclusterizer
+
+  int mNThreads = 1;                                              ///< number of threads processing the preclusters
+  std::vector<std::unique_ptr<ClusterFinderOriginal>> mWorkers{}; ///< clusterizers used by each thread
+  std::vector<PreClusterOutput> mPreClusterOutputs{};             ///< output location of every precluster processed in parallel
 };
 
 } // namespace mch
@@ -29,8 +29,13 @@
 
 #include <TH2I.h>
 #include <TAxis.h>
+#include <TDirectory.h>
 #include <TMath.h>
-#include <TRandom.h>
+#include <TROOT.h>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 #include <FairMQLogger.h>
 
@@ -65,10 +70,31 @@ ClusterFinderOriginal::ClusterFinderOriginal()
 ClusterFinderOriginal::~ClusterFinderOriginal() = default;
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::init()
+void ClusterFinderOriginal::init(int nThreads, bool analyticGradient)
 {
   /// initialize the clustering
+  /// nThreads is the number of threads used to process the preclusters given at once
+  /// analyticGradient selects the analytic instead of numerical chi2 derivatives in the Mathieson fit
+
   mPreClusterFinder.init();
+  mAnalyticGradient = analyticGradient;
+
+  mNThreads = std::max(nThreads, 1);
+  mWorkers.clear();
+#ifdef WITH_OPENMP
+  if (mNThreads > 1) {
+    // make gDirectory thread-local, so that the temporary histograms can be kept out of the shared directories
+    ROOT::EnableThreadSafety();
+    for (int i = 0; i < mNThreads; ++i) {
+      mWorkers.emplace_back(std::make_unique<ClusterFinderOriginal>())->init(1, analyticGradient);
+    }
+  }
+#else
+  if (mNThreads > 1) {
+    LOG(WARNING) << "OpenMP is not available: preclusters will be processed in a single thread";
+    mNThreads = 1;
+  }
+#endif
 }
 
 //_________________________________________________________________________________________________
@@ -76,6 +102,10 @@ void ClusterFinderOriginal::deinit()
 {
   /// deinitialize the clustering
   mPreClusterFinder.deinit();
+  for (auto& worker : mWorkers) {
+    worker->deinit();
+  }
+  mWorkers.clear();
 }
 
 //_________________________________________________________________________________________________
@@ -100,6 +130,9 @@ void ClusterFinderOriginal::findClusters(gsl::span<const Digit> digits)
   // set the Mathieson function to be used
   mMathieson = (digits[0].getDetID() < 300) ? &mMathiesons[0] : &mMathiesons[1];
 
+  // reset the random generator so that the result only depends on this precluster
+  mRandom.SetSeed(SRandomSeed);
+
   // reset the current precluster being processed
   resetPreCluster(digits);
 
@@ -157,6 +190,58 @@ void ClusterFinderOriginal::findClusters(gsl::span<const Digit> digits)
   }
 }
 
+//_________________________________________________________________________________________________
+void ClusterFinderOriginal::findClusters(gsl::span<const PreCluster> preClusters, gsl::span<const Digit> digits)
+{
+  /// reconstruct the clusters from the list of preclusters, pointing to their digits in the given list
+  /// reconstructed clusters and associated digits are added to the internal lists in the order of the
+  /// preclusters, with the same unique IDs and digit references as when they are processed one by one
+
+  if (mWorkers.empty() || preClusters.size() < 2) {
+    for (const auto& preCluster : preClusters) {
+      findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+    }
+    return;
+  }
+
+#ifdef WITH_OPENMP
+  for (auto& worker : mWorkers) {
+    worker->reset();
+  }
+  mPreClusterOutputs.resize(preClusters.size());
+
+  // process the preclusters in parallel, each thread with its own clusterizer
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+  for (int iPreCluster = 0; iPreCluster < preClusters.size(); ++iPreCluster) {
+    // do not attach the temporary histograms to the current directory
+    TDirectory::TContext context(nullptr);
+    int iWorker = omp_get_thread_num();
+    auto& worker = *mWorkers[iWorker];
+    auto& output = mPreClusterOutputs[iPreCluster];
+    output.worker = iWorker;
+    output.firstCluster = worker.mClusters.size();
+    output.firstDigit = worker.mUsedDigits.size();
+    const auto& preCluster = preClusters[iPreCluster];
+    worker.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+    output.nClusters = worker.mClusters.size() - output.firstCluster;
+    output.nDigits = worker.mUsedDigits.size() - output.firstDigit;
+  }
+
+  // collect the results in the order of the preclusters and update the cluster IDs and digit references
+  for (const auto& output : mPreClusterOutputs) {
+    const auto& worker = *mWorkers[output.worker];
+    int digitOffset = mUsedDigits.size() - output.firstDigit;
+    auto itFirstDigit = worker.mUsedDigits.begin() + output.firstDigit;
+    mUsedDigits.insert(mUsedDigits.end(), itFirstDigit, itFirstDigit + output.nDigits);
+    for (int iCluster = output.firstCluster; iCluster < output.firstCluster + output.nClusters; ++iCluster) {
+      auto& cluster = mClusters.emplace_back(worker.mClusters[iCluster]);
+      cluster.uid = ClusterStruct::buildUniqueId(cluster.getChamberId(), cluster.getDEId(), mClusters.size() - 1);
+      cluster.firstDigit += digitOffset;
+    }
+  }
+#endif
+}
+
 //_________________________________________________________________________________________________
 void ClusterFinderOriginal::resetPreCluster(gsl::span<const Digit>& digits)
 {
@@ -1317,6 +1402,11 @@ int ClusterFinderOriginal::fit(const std::vector<const std::vector<int>*>& clust
   }
   averagePadCharge /= nRealPadsToFit;
 
+  // prepare the pads for the computation of the chi2 derivatives
+  if (mAnalyticGradient) {
+    setFitPads();
+  }
+
   // determine the clusters' position seeds ordered per decreasing charge and the overall mean position
   // as well as the total charge of all the pixels associated to the part of the precluster being fitted
   double xMean(0.), yMean(0.);
@@ -1438,7 +1528,7 @@ int ClusterFinderOriginal::fit(const std::vector<const std::vector<int>*>& clust
 //_________________________________________________________________________________________________
 double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
                                   const double parmin[SNFitParamMax], const double parmax[SNFitParamMax],
-                                  int nParamUsed, int& nTrials) const
+                                  int nParamUsed, int& nTrials)
 {
   /// perform the fit with a custom algorithm, using currentParam as starting parameters
   /// update currentParam with the fitted parameters and return the corresponding chi2
@@ -1467,20 +1557,36 @@ double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
     // keep the best results from the previous step and save the new ones in the other slot
     int iCurrentParam = 1 - iBestParam;
 
-    // get the chi2 of the fit with the current parameters
-    chi2[iCurrentParam] = computeChi2(currentParam, nParamUsed);
-    ++nTrials;
-
-    // compute first and second chi2 derivatives w.r.t. each parameter
     double deriv2nd[SNFitParamMax] = {0.};
-    for (int i = 0; i < nParamUsed; ++i) {
-      param[iCurrentParam][i] = currentParam[i];
-      currentParam[i] += defaultShift[i] / 10.;
-      double chi2Shift = computeChi2(currentParam, nParamUsed);
+    if (mAnalyticGradient) {
+
+      // get the chi2 of the fit with the current parameters and its first derivatives w.r.t. each parameter
+      // count as many trials as with numerical derivatives to keep the same limit on the fit duration
+      chi2[iCurrentParam] = computeChi2(currentParam, nParamUsed, deriv[iCurrentParam]);
+      nTrials += 1 + nParamUsed;
+
+      // compute the second chi2 derivatives w.r.t. each parameter
+      for (int i = 0; i < nParamUsed; ++i) {
+        param[iCurrentParam][i] = currentParam[i];
+        deriv2nd[i] = param[0][i] != param[1][i] ? (deriv[0][i] - deriv[1][i]) / (param[0][i] - param[1][i]) : 0;
+      }
+
+    } else {
+
+      // get the chi2 of the fit with the current parameters
+      chi2[iCurrentParam] = computeChi2(currentParam, nParamUsed);
       ++nTrials;
-      deriv[iCurrentParam][i] = (chi2Shift - chi2[iCurrentParam]) / defaultShift[i] * 10;
-      deriv2nd[i] = param[0][i] != param[1][i] ? (deriv[0][i] - deriv[1][i]) / (param[0][i] - param[1][i]) : 0;
-      currentParam[i] -= defaultShift[i] / 10.;
+
+      // compute first and second chi2 derivatives w.r.t. each parameter
+      for (int i = 0; i < nParamUsed; ++i) {
+        param[iCurrentParam][i] = currentParam[i];
+        currentParam[i] += defaultShift[i] / 10.;
+        double chi2Shift = computeChi2(currentParam, nParamUsed);
+        ++nTrials;
+        deriv[iCurrentParam][i] = (chi2Shift - chi2[iCurrentParam]) / defaultShift[i] * 10;
+        deriv2nd[i] = param[0][i] != param[1][i] ? (deriv[0][i] - deriv[1][i]) / (param[0][i] - param[1][i]) : 0;
+        currentParam[i] -= defaultShift[i] / 10.;
+      }
     }
 
     // abort if we exceed the maximum number of trials (integrated over the fits with 1, 2 and 3 clusters)
@@ -1601,7 +1707,7 @@ double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
       }
       if (nFail > 10) {
         currentParam[iDerivMax] -= shift[iDerivMax];
-        shift[iDerivMax] = 4. * shiftSave * (gRandom->Rndm(0) - 0.5);
+        shift[iDerivMax] = 4. * shiftSave * (mRandom.Rndm() - 0.5);
         currentParam[iDerivMax] += shift[iDerivMax];
       }
     }
@@ -1650,6 +1756,116 @@ double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2],
   return chi2 / param[SNFitParamMax + 1];
 }
 
+//_________________________________________________________________________________________________
+void ClusterFinderOriginal::setFitPads()
+{
+  /// fill the list of pads used in the fit with their edges given as indices in the lists of distinct
+  /// pad edges, so that the Mathieson primitives are computed once per edge shared by several pads
+
+  for (auto& edges : mFitPadEdges) {
+    edges.clear();
+  }
+  for (const auto& pad : *mPreCluster) {
+    if (pad.status() == PadOriginal::kUseForFit) {
+      mFitPadEdges[0].push_back(pad.x() - pad.dx());
+      mFitPadEdges[0].push_back(pad.x() + pad.dx());
+      mFitPadEdges[1].push_back(pad.y() - pad.dy());
+      mFitPadEdges[1].push_back(pad.y() + pad.dy());
+    }
+  }
+  for (auto& edges : mFitPadEdges) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  }
+
+  auto edgeIndex = [this](int dim, double edge) {
+    return static_cast<int>(std::lower_bound(mFitPadEdges[dim].begin(), mFitPadEdges[dim].end(), edge) - mFitPadEdges[dim].begin());
+  };
+  mFitPads.clear();
+  for (const auto& pad : *mPreCluster) {
+    if (pad.status() == PadOriginal::kUseForFit) {
+      mFitPads.push_back({edgeIndex(0, pad.x() - pad.dx()), edgeIndex(0, pad.x() + pad.dx()),
+                          edgeIndex(1, pad.y() - pad.dy()), edgeIndex(1, pad.y() + pad.dy()), pad.charge()});
+    }
+  }
+}
+
+//_________________________________________________________________________________________________
+double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2], int nParamUsed, double gradient[SNFitParamMax])
+{
+  /// return the chi2 to be minimized when fitting the selected part of the precluster,
+  /// computed in double precision, and its analytic derivatives w.r.t. each cluster parameter in gradient
+  /// the parameters are the same as for the computation of the chi2 alone
+
+  // get the fraction of charge carried by each cluster and its derivatives w.r.t. param[2] and param[5]
+  double chargeFraction[SNFitClustersMax] = {0.};
+  param2ChargeFraction(param, nParamUsed, chargeFraction);
+  double fractionDeriv[SNFitClustersMax][2] = {{0.}};
+  param2ChargeFractionDerivatives(param, nParamUsed, fractionDeriv);
+
+  for (int i = 0; i < nParamUsed; ++i) {
+    gradient[i] = 0.;
+  }
+
+  // compute the Mathieson primitives of each cluster at each distinct pad edge
+  for (int iParam = 0; iParam < nParamUsed; iParam += 3) {
+    int iCluster = iParam / 3;
+    for (int dim = 0; dim < 2; ++dim) {
+      auto& primitives = mEdgePrimitives[iCluster][dim];
+      primitives.resize(mFitPadEdges[dim].size());
+      for (size_t iEdge = 0; iEdge < primitives.size(); ++iEdge) {
+        double distance = mFitPadEdges[dim][iEdge] - param[iParam + dim];
+        primitives[iEdge].value = (dim == 0) ? mMathieson->primitiveX(distance, primitives[iEdge].derivative)
+                                             : mMathieson->primitiveY(distance, primitives[iEdge].derivative);
+      }
+    }
+  }
+
+  double chi2(0.);
+  double integral[SNFitClustersMax] = {0.};
+  double integralDeriv[SNFitClustersMax][2] = {{0.}};
+  for (const auto& pad : mFitPads) {
+
+    // compute the expected pad charge with these cluster parameters
+    // moving the cluster center by +d moves both integration limits by -d
+    double padChargeFit(0.);
+    for (int iParam = 0; iParam < nParamUsed; iParam += 3) {
+      int iCluster = iParam / 3;
+      const auto& px = mEdgePrimitives[iCluster][0];
+      const auto& py = mEdgePrimitives[iCluster][1];
+      double ix = px[pad.xMax].value - px[pad.xMin].value;
+      double iy = py[pad.yMax].value - py[pad.yMin].value;
+      integral[iCluster] = ix * iy;
+      integralDeriv[iCluster][0] = -(px[pad.xMax].derivative - px[pad.xMin].derivative) * iy;
+      integralDeriv[iCluster][1] = -ix * (py[pad.yMax].derivative - py[pad.yMin].derivative);
+      padChargeFit += integral[iCluster] * chargeFraction[iCluster];
+    }
+    padChargeFit *= param[SNFitParamMax];
+
+    // compute the chi2 and add the contribution of this pad to its derivatives
+    double delta = padChargeFit - pad.charge;
+    chi2 += delta * delta / pad.charge;
+    double dChi2dCharge = 2. * delta / pad.charge * param[SNFitParamMax];
+    for (int iParam = 0; iParam < nParamUsed; iParam += 3) {
+      int iCluster = iParam / 3;
+      gradient[iParam] += dChi2dCharge * chargeFraction[iCluster] * integralDeriv[iCluster][0];
+      gradient[iParam + 1] += dChi2dCharge * chargeFraction[iCluster] * integralDeriv[iCluster][1];
+      if (nParamUsed > 2) {
+        gradient[2] += dChi2dCharge * integral[iCluster] * fractionDeriv[iCluster][0];
+      }
+      if (nParamUsed > 5) {
+        gradient[5] += dChi2dCharge * integral[iCluster] * fractionDeriv[iCluster][1];
+      }
+    }
+  }
+
+  for (int i = 0; i < nParamUsed; ++i) {
+    gradient[i] /= param[SNFitParamMax + 1];
+  }
+
+  return chi2 / param[SNFitParamMax + 1];
+}
+
 //_________________________________________________________________________________________________
 void ClusterFinderOriginal::param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed,
                                                  double fraction[SNFitClustersMax]) const
@@ -1667,6 +1883,28 @@ void ClusterFinderOriginal::param2ChargeFraction(const double param[SNFitParamMa
   }
 }
 
+//_________________________________________________________________________________________________
+void ClusterFinderOriginal::param2ChargeFractionDerivatives(const double param[SNFitParamMax], int nParamUsed,
+                                                            double derivatives[SNFitClustersMax][2]) const
+{
+  /// compute the derivatives of the fraction of charge carried by each cluster w.r.t. param[2] and param[5]
+  /// the derivatives are 0 where the fraction is bounded to 0
+  if (nParamUsed == 5) {
+    derivatives[0][0] = 1.;
+    derivatives[1][0] = (1. - param[2] > 0.) ? -1. : 0.;
+  } else if (nParamUsed == 8) {
+    derivatives[0][0] = 1.;
+    if ((1. - param[2]) * param[5] > 0.) {
+      derivatives[1][0] = -param[5];
+      derivatives[1][1] = 1. - param[2];
+    }
+    if (1. - param[2] - TMath::Max((1. - param[2]) * param[5], 0.) > 0.) {
+      derivatives[2][0] = -1. - derivatives[1][0];
+      derivatives[2][1] = -derivatives[1][1];
+    }
+  }
+}
+
 //_________________________________________________________________________________________________
 float ClusterFinderOriginal::chargeIntegration(double x, double y, const PadOriginal& pad) const
 {
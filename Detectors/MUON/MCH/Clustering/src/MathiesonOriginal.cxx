@@ -65,5 +65,31 @@ float MathiesonOriginal::integrate(float xMin, float yMin, float xMax, float yMa
                             mKy4 * (TMath::ATan(uyMax) - TMath::ATan(uyMin)));
 }
 
+//_________________________________________________________________________________________________
+double MathiesonOriginal::primitiveX(double x, double& derivative) const
+{
+  /// return the primitive in x of the Mathieson integrated over y, at the distance x from its center,
+  /// in double precision, and its derivative w.r.t. x in derivative
+  /// the integral over [xMin, xMax] x [yMin, yMax] is (primitiveX(xMax) - primitiveX(xMin)) * (primitiveY(yMax) - primitiveY(yMin))
+
+  double t = TMath::TanH(mKx2 * x * mInversePitch);
+  double u = mSqrtKx3 * t;
+  // d(atan(sqrt(K3) * tanh(K2 * x)))/dx = sqrt(K3) * K2 * (1 - tanh^2(K2 * x)) / (1 + K3 * tanh^2(K2 * x))
+  derivative = 2. * mKx4 * mSqrtKx3 * mKx2 * mInversePitch * (1. - t * t) / (1. + u * u);
+  return 2. * mKx4 * TMath::ATan(u);
+}
+
+//_________________________________________________________________________________________________
+double MathiesonOriginal::primitiveY(double y, double& derivative) const
+{
+  /// return the primitive in y of the Mathieson integrated over x, at the distance y from its center,
+  /// in double precision, and its derivative w.r.t. y in derivative
+
+  double t = TMath::TanH(mKy2 * y * mInversePitch);
+  double u = mSqrtKy3 * t;
+  derivative = 2. * mKy4 * mSqrtKy3 * mKy2 * mInversePitch * (1. - t * t) / (1. + u * u);
+  return 2. * mKy4 * TMath::ATan(u);
+}
+
 } // namespace mch
 } // namespace o2
@@ -40,6 +40,8 @@ class MathiesonOriginal
   void setSqrtKy3AndDeriveKy2Ky4(float sqrtKy3);
 
   float integrate(float xMin, float yMin, float xMax, float yMax) const;
+  double primitiveX(double x, double& derivative) const;
+  double primitiveY(double y, double& derivative) const;
 
  private:
   float mSqrtKx3 = 0.;      ///< Mathieson Sqrt(Kx3)
@@ -0,0 +1,222 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testClusterFinderOriginal.cxx
+/// \brief Regression test of the parallel processing and optional analytic-gradient fit of the original cluster finder
+
+#define BOOST_TEST_MODULE Test MCHClustering ClusterFinderOriginal
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/ClusterBlock.h"
+#include "MCHBase/PreCluster.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+#include "MCHMappingInterface/Segmentation.h"
+#include "MCHPreClustering/PreClusterFinder.h"
+#include "../src/MathiesonOriginal.h"
+
+using namespace o2::mch;
+
+struct ClusteringResult {
+  std::vector<ClusterStruct> clusters{};
+  std::vector<Digit> digits{};
+};
+
+/// generate the digits of nClusters clusters per detection element in a few detection elements of every station,
+/// with a charge distributed according to the Mathieson function used in the clustering, then preclusterize them
+void generatePreClusters(int nClusters, std::vector<PreCluster>& preClusters, std::vector<Digit>& digits)
+{
+  MathiesonOriginal mathieson[2];
+  mathieson[0].setPitch(0.21);
+  mathieson[0].setSqrtKx3AndDeriveKx2Kx4(0.7000);
+  mathieson[0].setSqrtKy3AndDeriveKy2Ky4(0.7550);
+  mathieson[1].setPitch(0.25);
+  mathieson[1].setSqrtKx3AndDeriveKx2Kx4(0.7131);
+  mathieson[1].setSqrtKy3AndDeriveKy2Ky4(0.7642);
+
+  std::mt19937 gen(20210301);
+  std::uniform_real_distribution<double> offset(-0.5, 0.5);
+  std::uniform_real_distribution<double> charge(50., 1000.);
+
+  std::vector<Digit> allDigits{};
+  for (int deId : {100, 300, 500, 603, 819, 1025}) {
+    const auto& segmentation = mapping::segmentation(deId);
+    const auto& mathiesonDE = (deId < 300) ? mathieson[0] : mathieson[1];
+    std::uniform_int_distribution<int> padIndex(0, segmentation.nofPads() - 1);
+    std::map<int, double> padCharges{};
+    for (int i = 0; i < nClusters; ++i) {
+      int seed = padIndex(gen);
+      double x = segmentation.padPositionX(seed) + offset(gen);
+      double y = segmentation.padPositionY(seed) + offset(gen);
+      double q = charge(gen);
+      segmentation.forEachPadInArea(x - 3., y - 3., x + 3., y + 3., [&](int padID) {
+        double xPad = segmentation.padPositionX(padID) - x;
+        double yPad = segmentation.padPositionY(padID) - y;
+        double dx = segmentation.padSizeX(padID) / 2.;
+        double dy = segmentation.padSizeY(padID) / 2.;
+        padCharges[padID] += q * mathiesonDE.integrate(xPad - dx, yPad - dy, xPad + dx, yPad + dy);
+      });
+    }
+    for (const auto& [padID, q] : padCharges) {
+      if (q > 1.) {
+        float adcCharge = q;
+        uint32_t adc(0);
+        std::memcpy(&adc, &adcCharge, sizeof(adc));
+        allDigits.emplace_back(deId, padID, adc, 0);
+      }
+    }
+  }
+
+  PreClusterFinder preClusterFinder{};
+  preClusterFinder.init();
+  preClusterFinder.reset();
+  preClusterFinder.loadDigits(allDigits);
+  preClusterFinder.run();
+  preClusters.clear();
+  digits.clear();
+  preClusterFinder.getPreClusters(preClusters, digits);
+  preClusterFinder.deinit();
+}
+
+ClusteringResult findClusters(const std::vector<PreCluster>& preClusters, const std::vector<Digit>& digits,
+                              int nThreads, bool analyticGradient)
+{
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(nThreads, analyticGradient);
+  clusterFinder.reset();
+  clusterFinder.findClusters(preClusters, digits);
+  ClusteringResult result{clusterFinder.getClusters(), clusterFinder.getUsedDigits()};
+  clusterFinder.deinit();
+  return result;
+}
+
+double clusterCharge(const ClusterStruct& cluster, const std::vector<Digit>& digits)
+{
+  double charge(0.);
+  for (uint32_t i = cluster.firstDigit; i < cluster.firstDigit + cluster.nDigits; ++i) {
+    uint32_t adc = digits[i].getADC();
+    float q(0.);
+    std::memcpy(&q, &adc, sizeof(adc));
+    charge += q;
+  }
+  return charge;
+}
+
+BOOST_AUTO_TEST_SUITE(o2_mch_clustering)
+
+BOOST_AUTO_TEST_CASE(ParallelClusteringIsDeterministic)
+{
+  std::vector<PreCluster> preClusters{};
+  std::vector<Digit> digits{};
+  generatePreClusters(100, preClusters, digits);
+
+  // the parallel processing requires OpenMP, without it the clustering falls back to a single thread
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(2);
+  bool parallelAvailable = clusterFinder.getNThreads() == 2;
+  clusterFinder.deinit();
+  if (!parallelAvailable) {
+    BOOST_TEST_MESSAGE("OpenMP not available: parallel clustering not tested");
+    return;
+  }
+
+  auto serial = findClusters(preClusters, digits, 1, false);
+  BOOST_REQUIRE(!serial.clusters.empty());
+
+  for (int nThreads : {2, 4}) {
+    auto parallel = findClusters(preClusters, digits, nThreads, false);
+    BOOST_REQUIRE_EQUAL(parallel.clusters.size(), serial.clusters.size());
+    BOOST_REQUIRE_EQUAL(parallel.digits.size(), serial.digits.size());
+    for (size_t i = 0; i < serial.clusters.size(); ++i) {
+      const auto& cl1 = serial.clusters[i];
+      const auto& cl2 = parallel.clusters[i];
+      BOOST_CHECK(cl1.x == cl2.x && cl1.y == cl2.y && cl1.ex == cl2.ex && cl1.ey == cl2.ey);
+      BOOST_CHECK(cl1.uid == cl2.uid && cl1.firstDigit == cl2.firstDigit && cl1.nDigits == cl2.nDigits);
+    }
+    for (size_t i = 0; i < serial.digits.size(); ++i) {
+      BOOST_CHECK(serial.digits[i] == parallel.digits[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ClusteringDependsOnlyOnEachPreCluster)
+{
+  // the fit uses its own random generator, reset for every precluster: the clusters of a precluster must not depend
+  // on the preclusters processed before it, so processing them all at once, one by one or in reverse order is the same
+  std::vector<PreCluster> preClusters{};
+  std::vector<Digit> digits{};
+  generatePreClusters(100, preClusters, digits);
+
+  auto all = findClusters(preClusters, digits, 1, false);
+  BOOST_REQUIRE(!all.clusters.empty());
+
+  std::vector<ClusteringResult> single(preClusters.size());
+  for (int i = preClusters.size() - 1; i >= 0; --i) {
+    single[i] = findClusters({preClusters[i]}, digits, 1, false);
+  }
+
+  size_t iCluster(0);
+  for (const auto& result : single) {
+    for (const auto& cl2 : result.clusters) {
+      BOOST_REQUIRE(iCluster < all.clusters.size());
+      const auto& cl1 = all.clusters[iCluster++];
+      BOOST_CHECK(cl1.x == cl2.x && cl1.y == cl2.y && cl1.ex == cl2.ex && cl1.ey == cl2.ey);
+      BOOST_CHECK(cl1.uid == cl2.uid && cl1.nDigits == cl2.nDigits);
+      BOOST_CHECK(clusterCharge(cl1, all.digits) == clusterCharge(cl2, result.digits));
+    }
+  }
+  BOOST_CHECK_EQUAL(iCluster, all.clusters.size());
+}
+
+BOOST_AUTO_TEST_CASE(AnalyticGradientFitReproducesNumericalGradientFit)
+{
+  // the analytic gradient is opt-in: check that its clusters stay close to the default ones
+  std::vector<PreCluster> preClusters{};
+  std::vector<Digit> digits{};
+  generatePreClusters(100, preClusters, digits);
+
+  auto numerical = findClusters(preClusters, digits, 1, false);
+  auto analytic = findClusters(preClusters, digits, 1, true);
+  BOOST_REQUIRE(!numerical.clusters.empty());
+
+  // the fit can stop at slightly different positions or, in rare ambiguous cases, end up with a different
+  // number of clusters: match every cluster of the current implementation with the closest new one in the same DE
+  int nMatched(0);
+  for (const auto& cl1 : numerical.clusters) {
+    const ClusterStruct* closest = nullptr;
+    double dist2Min(1.);
+    for (const auto& cl2 : analytic.clusters) {
+      double dist2 = (cl1.x - cl2.x) * (cl1.x - cl2.x) + (cl1.y - cl2.y) * (cl1.y - cl2.y);
+      if (cl2.getDEId() == cl1.getDEId() && dist2 < dist2Min) {
+        dist2Min = dist2;
+        closest = &cl2;
+      }
+    }
+    if (closest != nullptr && std::sqrt(dist2Min) < 0.01) {
+      ++nMatched;
+      BOOST_CHECK_CLOSE(clusterCharge(cl1, numerical.digits), clusterCharge(*closest, analytic.digits), 1.e-3);
+    }
+  }
+  BOOST_CHECK_GE(nMatched, 0.95 * numerical.clusters.size());
+  BOOST_CHECK_LE(std::abs(static_cast<int>(analytic.clusters.size()) - static_cast<int>(numerical.clusters.size())),
+                 0.02 * numerical.clusters.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,7 +55,9 @@ class ClusterFinderOriginalTask
     /// Prepare the clusterizer
     LOG(INFO) << "initializing cluster finder";
 
-    mClusterFinder.init();
+    auto nThreads = ic.options().get<int>("nthreads");
+    auto analyticGradient = ic.options().get<bool>("analytic-gradient");
+    mClusterFinder.init(nThreads, analyticGradient);
 
     /// Print the timer and clear the clusterizer when the processing is over
     ic.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() {
@@ -89,9 +91,7 @@ class ClusterFinderOriginalTask
       // clusterize every preclusters
       auto tStart = std::chrono::high_resolution_clock::now();
       mClusterFinder.reset();
-      for (const auto& preCluster : preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries())) {
-        mClusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
-      }
+      mClusterFinder.findClusters(preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries()), digits);
       auto tEnd = std::chrono::high_resolution_clock::now();
       mTimeClusterFinder += tEnd - tStart;
 
@@ -136,7 +136,8 @@ o2::framework::DataProcessorSpec getClusterFinderOriginalSpec()
             OutputSpec{{"clusters"}, "MCH", "CLUSTERS", 0, Lifetime::Timeframe},
             OutputSpec{{"clusterdigits"}, "MCH", "CLUSTERDIGITS", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<ClusterFinderOriginalTask>()},
-    Options{}};
+    Options{{"nthreads", VariantType::Int, 1, {"number of threads processing the preclusters of each interaction"}},
+            {"analytic-gradient", VariantType::Bool, false, {"use analytic instead of numerical chi2 derivatives in the fit"}}}};
 }
 
 } // end namespace mch
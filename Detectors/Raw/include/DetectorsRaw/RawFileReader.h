@@ -47,6 +47,7 @@ struct ReaderInp {
   uint32_t maxTF = 0xffffffff;
   bool partPerSP = true;
   bool cache = false;
+  bool mapFiles = false;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
 };
@@ -147,6 +148,7 @@ class RawFileReader
     uint16_t fileID = 0;               //! file id where the block is located
     uint8_t flags = 0;                 //! different flags
     std::unique_ptr<char[]> dataCache; //! optional cache for fast access
+    const char* data = nullptr;        //! block data in the file mapping, if the file is mapped
     LinkBlock() = default;
     LinkBlock(int fid, size_t offs) : offset(offs), fileID(fid) {}
     void setFlag(uint8_t fl, bool v = true)
@@ -201,6 +203,8 @@ class RawFileReader
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
+    size_t mapNextSuperPage(const char*& data, const PartStat* pstat = nullptr);
+    bool isNextSuperPageMapped(const PartStat* pstat = nullptr) const;
     size_t skipNextHBF();
     size_t skipNextTF();
 
@@ -209,6 +213,8 @@ class RawFileReader
     std::string describe() const;
 
    private:
+    int getNextSuperPageEnd(size_t& sz, const PartStat* pstat) const;
+    bool isInMapping(int ibl, size_t sz) const;
     RawFileReader* reader = nullptr; //!
   };
 
@@ -263,6 +269,11 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; } // files are mapped in the init(), must be set before it
+  bool isFileMapped(int i) const { return i < int(mFileMappings.size()) && mFileMappings[i].first != nullptr; }
+  void prefetchTF(uint32_t tf) const;
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -283,6 +294,7 @@ class RawFileReader
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  static std::pair<char*, size_t> mapFile(FILE* fl, const std::string& sname);
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -294,6 +306,7 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<std::pair<char*, size_t>> mFileMappings;                  //! read-only mappings of input files ({nullptr, 0} if not mapped)
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -311,6 +324,7 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! map input files to memory instead of reading them with stdio
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
   bool mPreferCalculatedTFStart = false;                            //! prefer TFstart calculated via HBFUtils
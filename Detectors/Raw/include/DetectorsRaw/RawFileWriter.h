@@ -23,6 +23,10 @@
 #include <string_view>
 #include <functional>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <new>
+#include <utility>
 
 #include <Rtypes.h>
 #include <TTree.h>
@@ -38,6 +42,44 @@ namespace o2
 namespace raw
 {
 
+/// allocator of page-aligned memory for the superpages, which leaves the elements uninitialized when the
+/// vector is expanded: the writer always fills the buffer right after expanding it
+template <typename T>
+struct SuperPageAllocator {
+  using value_type = T;
+  static constexpr size_t Alignment = 4096;
+
+  SuperPageAllocator() = default;
+  template <typename U>
+  SuperPageAllocator(const SuperPageAllocator<U>&)
+  {
+  }
+  T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment))); }
+  void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+  template <typename U>
+  void construct(U* p)
+  {
+    ::new (static_cast<void*>(p)) U; // default-, not value-initialization
+  }
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args)
+  {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+  template <typename U>
+  bool operator==(const SuperPageAllocator<U>&) const
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const SuperPageAllocator<U>&) const
+  {
+    return false;
+  }
+};
+
+using SuperPageBuffer = std::vector<char, SuperPageAllocator<char>>;
+
 class RawFileWriter
 {
 
@@ -51,20 +93,42 @@ class RawFileWriter
   using NewRDHCallBack = std::function<void(const RDHAny* rdh, bool prevEmpty, std::vector<char>& filler)>;
 
   ///=====================================================================================
-  /// output file handler with its own lock
+  /// output file handler with its own lock.
+  /// The superpages flushed by the links are handed over to the file, which writes them in the order of
+  /// submission with a single vectored write per batch, either immediately or in its own writer thread
   struct OutputFile {
     FILE* handler = nullptr;
     std::mutex fileMtx;
+    size_t writeBatchSize = 0;            // write the pending superpages once they hold this amount of memory
+    std::vector<SuperPageBuffer> pending; // superpages waiting to be written
+    std::vector<SuperPageBuffer> spare;   // buffers of written superpages, for reuse by the links
+    size_t pendingMemory = 0;             // memory held by the pending superpages
+    bool writing = false;                 // writer thread is writing superpages taken from the pending ones
+    bool flushRequested = false;          // writer thread must write the pending superpages regardless of the batch size
+    bool stopWriter = false;              // writer thread must write what is pending and exit
+    std::thread writerThread;
+    std::condition_variable writerCond;
     OutputFile() = default;
-    OutputFile(const OutputFile& src) : handler(src.handler) {}
+    OutputFile(const OutputFile& src) : handler(src.handler), writeBatchSize(src.writeBatchSize) {}
     OutputFile& operator=(const OutputFile& src)
     {
       if (this != &src) {
         handler = src.handler;
+        writeBatchSize = src.writeBatchSize;
       }
       return *this;
     }
+    ~OutputFile() { stopWriterThread(); }
     void write(const char* data, size_t size);
+    void push(SuperPageBuffer&& page);
+    SuperPageBuffer getSpareBuffer();
+    void startWriterThread();
+    void stopWriterThread();
+    void close();
+
+   private:
+    void writePending(std::unique_lock<std::mutex>& lock);
+    void writerLoop();
   };
   ///=====================================================================================
   struct PayloadCache {
@@ -93,7 +157,7 @@ class RawFileWriter
     size_t nBytesWritten = 0; // number of bytes written
     //
     std::string fileName{};                // file name associated with this link
-    std::vector<char> buffer;              // buffer to accumulate superpage data
+    SuperPageBuffer buffer;                //! buffer to accumulate superpage data
     RawFileWriter* writer = nullptr;       // pointer on the parent writer
 
     PayloadCache cacheBuffer;         // used for caching in case of async. data input
@@ -246,6 +310,19 @@ class RawFileWriter
   int getSuperPageSize() const { return mSuperPageSize; }
   void setSuperPageSize(int nbytes);
 
+  /// superpages are written to the file once they hold at least this amount of memory (0: write every superpage
+  /// when it is completed). This and the asynchronous writing below must be set before registering the links
+  void setWriteBatchSize(size_t nbytes) { mWriteBatchSize = nbytes; }
+  size_t getWriteBatchSize() const { return mWriteBatchSize; }
+
+  /// write superpages in a separate thread per output file
+  void setAsyncWrite(bool v) { mAsyncWrite = v; }
+  bool getAsyncWrite() const { return mAsyncWrite; }
+
+  /// write the completed superpages from the link buffer and compact it, instead of handing the buffer over to the file
+  void setCopySuperPages(bool v) { mCopySuperPages = v; }
+  bool getCopySuperPages() const { return mCopySuperPages; }
+
   /// get highest IR seen so far
   IR getIRMax() const;
 
@@ -400,6 +477,9 @@ class RawFileWriter
   bool mUseRDHStop = true;             // detector uses STOP in RDH
   bool mCRUDetector = true;            // Detector readout via CRU ( RORC if false)
   bool mApplyCarryOverToLastPage = false; // call CarryOver method also for last chunk and overwrite modified trailer
+  size_t mWriteBatchSize = 0;             // memory of superpages to accumulate before writing them to the file
+  bool mAsyncWrite = false;               // write superpages in separate thread per output file
+  bool mCopySuperPages = false;           // write superpages by copy from the link buffer
 
   //>> caching --------------
   bool mCachingStage = false; // signal that current data should be cached
@@ -29,6 +29,10 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -130,7 +134,9 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
       break;
     }
     ibl++;
-    if (blc.dataCache) {
+    if (blc.data) {
+      memcpy(buff + sz, blc.data, blc.size);
+    } else if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
     } else {
       auto fl = reader->mFiles[blc.fileID];
@@ -257,22 +263,17 @@ int RawFileReader::LinkData::getNHBFinTF() const
 }
 
 //____________________________________________
-size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReader::PartStat* pstat)
+int RawFileReader::LinkData::getNextSuperPageEnd(size_t& sz, const RawFileReader::PartStat* pstat) const
 {
-  // read data of the next complete HB, buffer of getNextHBFSize() must be allocated in advance
-  size_t sz = 0;
-  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
-    return sz;
-  }
+  // find the size of the next superpage and the block following it
   int ibl = nextBlock2Read, nbl = blocks.size();
-  auto tfID = blocks[nextBlock2Read].tfID;
-  bool error = false;
+  sz = 0;
   if (pstat) { // info is provided, use it derictly
     sz = pstat->size;
     ibl += pstat->nBlocks;
   } else { // need to calculate blocks to read
     while (ibl < nbl) {
-      auto& blc = blocks[ibl];
+      const auto& blc = blocks[ibl];
       if (ibl > nextBlock2Read && (blc.tfID != blocks[nextBlock2Read].tfID ||
                                    blc.testFlag(LinkBlock::StartSP) ||
                                    (sz + blc.size) > reader->mNominalSPageSize ||
@@ -283,8 +284,23 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
       sz += blc.size;
     }
   }
+  return ibl;
+}
+
+//____________________________________________
+size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReader::PartStat* pstat)
+{
+  // read data of the next complete HB, buffer of getNextHBFSize() must be allocated in advance
+  size_t sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return sz;
+  }
+  int ibl = getNextSuperPageEnd(sz, pstat);
+  bool error = false;
   if (sz) {
-    if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
+    if (blocks[nextBlock2Read].data && isInMapping(nextBlock2Read, sz)) {
+      memcpy(buff, blocks[nextBlock2Read].data, sz);
+    } else if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
     } else {
       auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
@@ -302,6 +318,53 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+size_t RawFileReader::LinkData::mapNextSuperPage(const char*& data, const RawFileReader::PartStat* pstat)
+{
+  // provide the pointer on the next superpage in the file mapping, w/o copying the data.
+  // The pointer stays valid until the reader is cleared.
+  size_t sz = 0;
+  data = nullptr;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return sz;
+  }
+  if (!blocks[nextBlock2Read].data) {
+    LOGF(ERROR, "File %s with the data of the %s is not mapped", reader->mFileNames[blocks[nextBlock2Read].fileID], describe());
+    return sz;
+  }
+  int ibl = getNextSuperPageEnd(sz, pstat);
+  if (!isInMapping(nextBlock2Read, sz)) {
+    LOGF(ERROR, "Superpage of %u bytes for the %s exceeds the size of the file mapping, a bloc:", sz, describe());
+    blocks[nextBlock2Read].print();
+    nextBlock2Read = ibl;
+    return 0; // as for the failed reading, the data is ignored
+  }
+  data = blocks[nextBlock2Read].data;
+  nextBlock2Read = ibl;
+  return sz;
+}
+
+//____________________________________________
+bool RawFileReader::LinkData::isNextSuperPageMapped(const RawFileReader::PartStat* pstat) const
+{
+  // check if the whole next superpage can be provided by mapNextSuperPage
+  if (nextBlock2Read < 0 || !blocks[nextBlock2Read].data) {
+    return false;
+  }
+  size_t sz = 0;
+  getNextSuperPageEnd(sz, pstat);
+  return isInMapping(nextBlock2Read, sz);
+}
+
+//____________________________________________
+bool RawFileReader::LinkData::isInMapping(int ibl, size_t sz) const
+{
+  // check if sz bytes starting from the block ibl are contained in the file mapping
+  const auto& blc = blocks[ibl];
+  const auto& mapping = reader->mFileMappings[blc.fileID];
+  return blc.data && blc.offset + sz <= mapping.second;
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -563,8 +626,9 @@ int RawFileReader::getLinkLocalID(const RDHAny& rdh, int fileID)
 bool RawFileReader::preprocessFile(int ifl)
 {
   // preprocess file, check RDH data, build statistics
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
+  std::unique_ptr<char[]> buffer;
   FILE* fl = mFiles[ifl];
+  const auto& mapping = mFileMappings[ifl];
   mCurrentFileID = ifl;
   LinkSpec_t specPrev = 0xffffffffffffffff;
   int lIDPrev = -1;
@@ -574,10 +638,25 @@ bool RawFileReader::preprocessFile(int ifl)
   mPosInFile = 0;
   size_t nRDHread = 0, boffs;
   bool readMore = true;
-  while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl))) {
+  const char* data = nullptr;
+  auto fillData = [&]() -> long int {
+    if (mapping.first) { // mapped file is scanned in place, refuse truncated RDH at the end
+      if (mPosInFile + sizeof(RDHUtils::RDHAny) > mapping.second) { // the last RDH may point beyond the end of file
+        return 0;
+      }
+      data = mapping.first + mPosInFile;
+      return mapping.second - mPosInFile;
+    }
+    if (!buffer) {
+      buffer = std::make_unique<char[]>(mBufferSize);
+    }
+    data = buffer.get();
+    return fread(buffer.get(), 1, mBufferSize, fl);
+  };
+  while (readMore && (nr = fillData())) {
     boffs = 0;
     while (1) {
-      auto& rdh = *reinterpret_cast<RDHUtils::RDHAny*>(&buffer[boffs]);
+      auto& rdh = *reinterpret_cast<const RDHUtils::RDHAny*>(&data[boffs]);
       nRDHread++;
       LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
       int lID = lIDPrev;
@@ -607,7 +686,7 @@ bool RawFileReader::preprocessFile(int ifl)
       mPosInFile += RDHUtils::getOffsetToNext(rdh);
       lIDPrev = lID;
       if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
-        if (fseek(fl, mPosInFile, SEEK_SET)) {
+        if (!mapping.first && fseek(fl, mPosInFile, SEEK_SET)) {
           readMore = false;
           break;
         }
@@ -638,6 +717,12 @@ void RawFileReader::clear()
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
+  for (auto& mp : mFileMappings) {
+    if (mp.first) {
+      munmap(mp.first, mp.second);
+    }
+  }
+  mFileMappings.clear();
   for (auto fl : mFiles) {
     fclose(fl);
   }
@@ -680,10 +765,64 @@ bool RawFileReader::addFile(const std::string& sname, o2::header::DataOrigin ori
   }
   mFileNames.push_back(sname);
   mFiles.push_back(inFile);
+  mFileMappings.emplace_back(nullptr, 0); // files are mapped, if requested, in the init()
   mDataSpecs.emplace_back(origin, desc, t);
   return true;
 }
 
+//_____________________________________________________________________
+std::pair<char*, size_t> RawFileReader::mapFile(FILE* fl, const std::string& sname)
+{
+  // map the file read-only, on failure the file will be read via stdio
+  struct stat st;
+  int fd = fileno(fl);
+  if (fstat(fd, &st) || st.st_size <= 0) {
+    LOG(WARNING) << "Cannot map empty or non-regular file " << sname << ", will read it with stdio";
+    return {nullptr, 0};
+  }
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {
+    LOG(WARNING) << "Failed to map file " << sname << " (" << strerror(errno) << "), will read it with stdio";
+    return {nullptr, 0};
+  }
+  madvise(addr, st.st_size, MADV_SEQUENTIAL); // preprocessing scans the whole file
+  return {static_cast<char*>(addr), size_t(st.st_size)};
+}
+
+//_____________________________________________________________________
+void RawFileReader::prefetchTF(uint32_t tf) const
+{
+  // ask the kernel to read ahead the mapped data of given TF, contiguous blocks are advised at once
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  auto advise = [](const char* beg, const char* end) {
+    auto pbeg = reinterpret_cast<uintptr_t>(beg) & ~(pageSize - 1);
+    madvise(reinterpret_cast<void*>(pbeg), reinterpret_cast<uintptr_t>(end) - pbeg, MADV_WILLNEED);
+  };
+  for (const auto& link : mLinksData) {
+    if (tf >= link.tfStartBlock.size()) {
+      continue;
+    }
+    int ibl = link.tfStartBlock[tf].first, nbl = link.blocks.size();
+    const char *beg = nullptr, *end = nullptr;
+    for (int i = ibl; i < nbl && link.blocks[i].tfID == link.blocks[ibl].tfID; i++) {
+      const auto& blc = link.blocks[i];
+      if (!blc.data) {
+        break;
+      }
+      if (blc.data != end) {
+        if (beg) {
+          advise(beg, end);
+        }
+        beg = blc.data;
+      }
+      end = blc.data + blc.size;
+    }
+    if (beg) {
+      advise(beg, end);
+    }
+  }
+}
+
 //_____________________________________________________________________
 bool RawFileReader::init()
 {
@@ -699,12 +838,32 @@ bool RawFileReader::init()
   }
 
   int nf = mFiles.size();
+  if (mMapFiles) {
+    for (int i = 0; i < nf; i++) {
+      if (!mFileMappings[i].first) {
+        mFileMappings[i] = mapFile(mFiles[i], mFileNames[i]);
+      }
+    }
+  }
   mEmpty = true;
   for (int i = 0; i < nf; i++) {
     if (preprocessFile(i)) {
       mEmpty = false;
     }
   }
+  for (auto& link : mLinksData) {
+    for (auto& blc : link.blocks) {
+      const auto& mapping = mFileMappings[blc.fileID];
+      if (mapping.first && blc.offset + blc.size <= mapping.second) { // block truncated by the end of file will fail as with stdio
+        blc.data = mapping.first + blc.offset;
+      }
+    }
+  }
+  for (const auto& mp : mFileMappings) { // after the sequential scan the data is accessed per link
+    if (mp.first) {
+      madvise(mp.first, mp.second, MADV_NORMAL);
+    }
+  }
   mOrderedIDs.resize(mLinksData.size());
   for (int i = mLinksData.size(); i--;) {
     mOrderedIDs[i] = i;
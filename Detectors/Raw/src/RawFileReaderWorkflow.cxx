@@ -96,6 +96,7 @@ RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mapFiles);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(INFO) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
@@ -259,9 +260,17 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
       hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+      FairMQMessagePtr plMessage;
+      size_t bread = 0;
       mTimer[TimerIO].Start(false);
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      if (mPartPerSP && link.isNextSuperPageMapped(&partsSP[hdrTmpl.splitPayloadIndex])) { // superpage is sent directly from the file mapping, which outlives the message
+        const char* spData = nullptr;
+        bread = link.mapNextSuperPage(spData, &partsSP[hdrTmpl.splitPayloadIndex]);
+        plMessage = fmqFactory->CreateMessage(const_cast<char*>(spData), bread, [](void*, void*) {}, nullptr);
+      } else { // superpages which are not entirely in the mapping (e.g. truncated file) fail as in the stdio reading
+        plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+        bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      }
       if (bread != hdrTmpl.payloadSize) {
         LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                    << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
@@ -318,6 +327,9 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   mSentMessages += tfNParts;
 
   mReader->setNextTFToRead(++tfID);
+  if (mReader->getMapFiles()) {
+    mReader->prefetchTF(tfID > mMaxTFID ? mMinTFID : tfID); // read ahead while the current TF is being processed downstream
+  }
   ++mTFCounter;
 }
 
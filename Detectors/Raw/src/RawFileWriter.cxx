@@ -12,11 +12,16 @@
 /// @author ruben.shahoyan@cern.ch
 /// @brief  Utility class to write detectors data to (multiple) raw data file(s) respecting CRU format
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <functional>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <sys/uio.h>
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsRaw/RawFileWriter.h"
 #include "DetectorsRaw/HBFUtils.h"
@@ -55,8 +60,7 @@ void RawFileWriter::close()
   // close all files
   for (auto& flh : mFName2File) {
     LOG(INFO) << "Closing output file " << flh.first;
-    fclose(flh.second.handler);
-    flh.second.handler = nullptr;
+    flh.second.close();
   }
   mFName2File.clear();
   mTimer.Stop();
@@ -127,6 +131,10 @@ RawFileWriter::LinkData& RawFileWriter::registerLink(uint16_t fee, uint16_t cru,
       LOG(ERROR) << "Failed to open output file " << outFileName;
       throw std::runtime_error(std::string("cannot open link output file ") + outFileName);
     }
+    file.writeBatchSize = mWriteBatchSize;
+    if (mAsyncWrite) {
+      file.startWriterThread();
+    }
   }
   if (!linkData.fileName.empty()) { // this link was already declared and associated with a file
     if (linkData.fileName == outFileName) {
@@ -149,7 +157,7 @@ RawFileWriter::LinkData& RawFileWriter::registerLink(uint16_t fee, uint16_t cru,
   }
   linkData.writer = this;
   linkData.updateIR = mHBFUtils.getFirstIR();
-  linkData.buffer.reserve(mSuperPageSize);
+  linkData.buffer.reserve(mSuperPageSize + RDHUtils::MAXCRUPage); // margin for the pushes done before flushing
   RDHUtils::printRDH(linkData.rdhCopy);
   LOGF(INFO, "Registered %s with output to %s", linkData.describe(), outFileName);
   return linkData;
@@ -544,20 +552,34 @@ void RawFileWriter::LinkData::flushSuperPage(bool keepLastPage)
   if (writer->mVerbosity) {
     LOGF(INFO, "Flushing super page of %u bytes for %s", pgSize, describe());
   }
-  writer->mFName2File.find(fileName)->second.write(buffer.data(), pgSize);
-  auto toMove = buffer.size() - pgSize;
-  if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
-    if (toMove > pgSize) {
-      memcpy(buffer.data(), &buffer[pgSize], toMove);
-    } else {
+  auto& file = writer->mFName2File.find(fileName)->second;
+  if (writer->mCopySuperPages) {
+    file.write(buffer.data(), pgSize);
+    auto toMove = buffer.size() - pgSize;
+    if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
       memmove(buffer.data(), &buffer[pgSize], toMove);
+      buffer.resize(toMove);
+      lastRDHoffset -= pgSize;
+    } else {
+      buffer.clear();
+      lastRDHoffset = -1;
     }
-    buffer.resize(toMove);
+    return;
+  }
+  // the superpage is handed over to the file as it is, only what is left after it is copied to the new buffer
+  auto next = file.getSpareBuffer();
+  next.reserve(writer->mSuperPageSize + RDHUtils::MAXCRUPage);
+  auto toMove = buffer.size() - pgSize;
+  if (toMove) { // is there something left in the buffer, move it to the beginning of the new buffer
+    next.resize(toMove);
+    memcpy(next.data(), &buffer[pgSize], toMove);
     lastRDHoffset -= pgSize;
   } else {
-    buffer.clear();
     lastRDHoffset = -1;
   }
+  buffer.resize(pgSize);
+  file.push(std::move(buffer));
+  buffer = std::move(next);
 }
 
 //___________________________________________________________________________________
@@ -639,8 +661,162 @@ void RawFileWriter::LinkData::print() const
 
 //================================================
 
+namespace
+{
+// write the whole content described by iov, which is modified in case of partial writes
+void writeFully(FILE* handler, std::vector<iovec>& iov)
+{
+  int fd = fileno(handler);
+  size_t first = 0;
+  while (first < iov.size()) {
+    auto written = writev(fd, &iov[first], int(std::min(iov.size() - first, size_t(IOV_MAX))));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(FATAL) << "failed to write raw data: " << strerror(errno);
+    }
+    while (first < iov.size() && size_t(written) >= iov[first].iov_len) { // skip fully written pieces
+      written -= iov[first++].iov_len;
+    }
+    if (written) {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+      iov[first].iov_len -= written;
+    }
+  }
+}
+} // namespace
+
 void RawFileWriter::OutputFile::write(const char* data, size_t sz)
 {
+  // write external data after the superpages submitted so far
+  std::unique_lock<std::mutex> lock(fileMtx);
+  if (writerThread.joinable()) {
+    flushRequested = true;
+    writerCond.notify_all();
+    writerCond.wait(lock, [this] { return pending.empty() && !writing; });
+    flushRequested = false;
+  } else {
+    writePending(lock);
+  }
+  std::vector<iovec> iov{{const_cast<char*>(data), sz}};
+  writeFully(handler, iov);
+}
+
+void RawFileWriter::OutputFile::push(SuperPageBuffer&& page)
+{
+  // take over the superpage to write
+  std::unique_lock<std::mutex> lock(fileMtx);
+  if (page.empty()) {
+    spare.emplace_back(std::move(page));
+    return;
+  }
+  pendingMemory += page.capacity();
+  pending.emplace_back(std::move(page));
+  if (pendingMemory < writeBatchSize) {
+    return;
+  }
+  if (writerThread.joinable()) {
+    writerCond.notify_all();
+    // do not let the links get ahead of the writer by more than a batch
+    writerCond.wait(lock, [this] { return pendingMemory <= writeBatchSize; });
+  } else {
+    writePending(lock);
+  }
+}
+
+SuperPageBuffer RawFileWriter::OutputFile::getSpareBuffer()
+{
+  // provide a buffer of already written superpage, if any
   std::lock_guard<std::mutex> lock(fileMtx);
-  fwrite(data, 1, sz, handler); // flush to file
+  SuperPageBuffer buffer;
+  if (!spare.empty()) {
+    buffer = std::move(spare.back());
+    spare.pop_back();
+  }
+  return buffer;
+}
+
+void RawFileWriter::OutputFile::writePending(std::unique_lock<std::mutex>& lock)
+{
+  // write pending superpages in the calling thread, the lock must be owned
+  if (pending.empty()) {
+    return;
+  }
+  std::vector<iovec> iov;
+  iov.reserve(pending.size());
+  for (auto& page : pending) {
+    iov.push_back({page.data(), page.size()});
+  }
+  writeFully(handler, iov);
+  for (auto& page : pending) {
+    page.clear();
+    spare.emplace_back(std::move(page));
+  }
+  pending.clear();
+  pendingMemory = 0;
+}
+
+void RawFileWriter::OutputFile::writerLoop()
+{
+  std::vector<SuperPageBuffer> pages;
+  std::vector<iovec> iov;
+  std::unique_lock<std::mutex> lock(fileMtx);
+  while (true) {
+    writerCond.wait(lock, [this] { return stopWriter || (!pending.empty() && (flushRequested || pendingMemory >= writeBatchSize)); });
+    if (pending.empty()) { // stop was requested and nothing is left to write
+      break;
+    }
+    pages.swap(pending);
+    pendingMemory = 0;
+    writing = true;
+    writerCond.notify_all(); // links waiting for the pending superpages to be taken can continue
+    lock.unlock();
+    iov.clear();
+    for (auto& page : pages) {
+      iov.push_back({page.data(), page.size()});
+    }
+    writeFully(handler, iov);
+    lock.lock();
+    for (auto& page : pages) {
+      page.clear();
+      spare.emplace_back(std::move(page));
+    }
+    pages.clear();
+    writing = false;
+    writerCond.notify_all();
+  }
+}
+
+void RawFileWriter::OutputFile::startWriterThread()
+{
+  if (!writerThread.joinable()) {
+    stopWriter = false;
+    writerThread = std::thread([this] { writerLoop(); });
+  }
+}
+
+void RawFileWriter::OutputFile::stopWriterThread()
+{
+  // write everything pending and stop the writer thread
+  if (writerThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fileMtx);
+      stopWriter = true;
+    }
+    writerCond.notify_all();
+    writerThread.join();
+  }
+}
+
+void RawFileWriter::OutputFile::close()
+{
+  stopWriterThread();
+  std::unique_lock<std::mutex> lock(fileMtx);
+  writePending(lock);
+  spare.clear();
+  if (handler) {
+    fclose(handler);
+    handler = nullptr;
+  }
 }
@@ -0,0 +1,138 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_RawFileReader.cxx
+/// \brief Benchmark of the RawFileReader throughput with stdio and memory-mapped input
+
+#include "benchmark/benchmark.h"
+#include "DetectorsRaw/RawFileReader.h"
+#include "DetectorsRaw/RawFileWriter.h"
+#include "DetectorsRaw/HBFUtils.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include <fairlogger/Logger.h>
+#include <vector>
+
+using namespace o2::raw;
+
+// The raw file is written once and then read repeatedly, so that all variants read it from the page cache
+constexpr size_t FileSizeMB = 2048;
+constexpr int NLinks = 8;
+constexpr size_t HBFPayload = 32 * 1024;
+const std::string RawFileName = "bench_rawreader.raw";
+const std::string CfgName = "bench_rawreader.cfg";
+
+void writeRawFile()
+{
+  static bool done = false;
+  if (done) {
+    return;
+  }
+  RawFileWriter writer{"TST"};
+  writer.useRDHVersion(6);
+  for (int il = 0; il < NLinks; il++) {
+    writer.registerLink(il, 0, il, 0, RawFileName);
+  }
+  writer.setContinuousReadout();
+  std::vector<char> payload(HBFPayload, 0x5a);
+  auto ir = HBFUtils::Instance().getFirstIR();
+  size_t nOrbits = (FileSizeMB << 20) / (NLinks * HBFPayload);
+  for (size_t i = 0; i < nOrbits; i++) {
+    for (int il = 0; il < NLinks; il++) {
+      writer.addData(il, 0, il, 0, ir, payload);
+    }
+    ir.orbit++;
+  }
+  writer.writeConfFile("TST", "RAWDATA", CfgName);
+  writer.close();
+  done = true;
+}
+
+std::unique_ptr<RawFileReader> createReader(bool mapFiles)
+{
+  writeRawFile();
+  auto reader = std::make_unique<RawFileReader>(CfgName, 0, 1024 * 1024);
+  reader->setCheckErrors(0);
+  reader->setMapFiles(mapFiles);
+  reader->init();
+  return reader;
+}
+
+// touch every RDH of the superpage, as the consumer of the data would do
+size_t scanRDHs(const char* data, size_t size)
+{
+  size_t payload = 0;
+  for (size_t offs = 0; offs < size;) {
+    const auto& rdh = *reinterpret_cast<const RDHUtils::RDHAny*>(data + offs);
+    payload += RDHUtils::getMemorySize(rdh) - RDHUtils::getHeaderSize(rdh);
+    offs += RDHUtils::getOffsetToNext(rdh);
+  }
+  return payload;
+}
+
+// read all superpages of all TFs, copying them to the buffer (Arg = 0: stdio, 1: mapped files) or
+// accessing them directly in the mapping (Arg = 2)
+static void BM_ReadSuperPages(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  auto reader = createReader(state.range(0) > 0);
+  bool zeroCopy = state.range(0) == 2;
+  std::vector<RawFileReader::PartStat> parts;
+  std::vector<char> buffer(reader->getNominalSPageSize());
+  size_t nBytes = 0;
+  for (auto _ : state) {
+    size_t payload = 0;
+    for (uint32_t tf = 0; tf < reader->getNTimeFrames(); tf++) {
+      if (reader->getMapFiles()) {
+        reader->prefetchTF(tf + 1);
+      }
+      for (int il = 0; il < reader->getNLinks(); il++) {
+        auto& link = reader->getLink(il);
+        if (!link.rewindToTF(tf)) {
+          continue;
+        }
+        link.getNextTFSuperPagesStat(parts);
+        for (const auto& part : parts) {
+          const char* data = buffer.data();
+          size_t sz = 0;
+          if (zeroCopy) {
+            sz = link.mapNextSuperPage(data, &part);
+          } else {
+            if (buffer.size() < size_t(part.size)) {
+              buffer.resize(part.size);
+            }
+            data = buffer.data();
+            sz = link.readNextSuperPage(buffer.data(), &part);
+          }
+          payload += scanRDHs(data, sz);
+          nBytes += sz;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(payload);
+  }
+  state.SetBytesProcessed(nBytes);
+}
+
+// preprocessing of the file (Arg = 0: stdio, 1: mapped file)
+static void BM_Preprocess(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  writeRawFile();
+  for (auto _ : state) {
+    auto reader = createReader(state.range(0) > 0);
+    benchmark::DoNotOptimize(reader->getNTimeFrames());
+  }
+  state.SetBytesProcessed(state.iterations() * (FileSizeMB << 20));
+}
+
+BENCHMARK(BM_ReadSuperPages)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Preprocess)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
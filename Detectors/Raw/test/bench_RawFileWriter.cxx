@@ -0,0 +1,98 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_RawFileWriter.cxx
+/// \brief Benchmark of the RawFileWriter throughput with ITS- and TPC-like MC to raw conversion patterns
+
+#include "benchmark/benchmark.h"
+#include "DetectorsRaw/RawFileWriter.h"
+#include "DetectorsRaw/HBFUtils.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include "CommonConstants/LHCConstants.h"
+#include <fairlogger/Logger.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::raw;
+
+constexpr int NOrbits = 128;
+
+struct Layout {
+  int nCRU;       // one output file per CRU
+  int nLinks;     // links per CRU
+  int nBCPerIR;   // BC spacing of the payloads (ROF length), 0 for one payload per HBF
+  int meanGBTs;   // mean number of 16B words in the payload of the link
+  std::string name;
+};
+
+// ITS: many links with small payloads per readout frame; TPC: fewer links with large payloads to be split over CRU pages
+const Layout ITSLike{4, 24, 594, 12, "its"};
+const Layout TPCLike{2, 20, 0, 1600, "tpc"};
+
+// convert the same payloads writing each superpage immediately (Arg = 0), in batches of 8 superpages (1)
+// or in batches written by the writer thread of the file (2)
+void writeRaw(benchmark::State& state, const Layout& layout)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  const int mode = state.range(0);
+  std::mt19937 gen(12345);
+  std::poisson_distribution<int> nGBTs(layout.meanGBTs);
+  std::vector<std::vector<char>> payloads(1024);
+  for (auto& payload : payloads) {
+    payload.resize((nGBTs(gen) + 2) * RDHUtils::GBTWord, 0x5a); // with header and trailer words
+  }
+  size_t nBytes = 0;
+  for (auto _ : state) {
+    RawFileWriter writer{"TST"};
+    writer.useRDHVersion(6);
+    writer.setContinuousReadout();
+    if (mode > 0) {
+      writer.setWriteBatchSize(8 * writer.getSuperPageSize());
+      writer.setAsyncWrite(mode == 2);
+    }
+    for (int icru = 0; icru < layout.nCRU; icru++) {
+      auto fileName = "bench_rawwriter_" + layout.name + std::to_string(icru) + ".raw";
+      for (int il = 0; il < layout.nLinks; il++) {
+        writer.registerLink((icru << 8) + il, icru, il, 0, fileName);
+      }
+    }
+    size_t ipl = 0;
+    auto ir = HBFUtils::Instance().getFirstIR();
+    const auto irEnd = ir + int64_t(NOrbits) * o2::constants::lhc::LHCMaxBunches;
+    while (ir < irEnd) {
+      for (int icru = 0; icru < layout.nCRU; icru++) {
+        for (int il = 0; il < layout.nLinks; il++) {
+          auto& payload = payloads[ipl++ % payloads.size()];
+          writer.addData((icru << 8) + il, icru, il, 0, ir, payload);
+          nBytes += payload.size();
+        }
+      }
+      ir += layout.nBCPerIR ? layout.nBCPerIR : o2::constants::lhc::LHCMaxBunches;
+    }
+    writer.close();
+  }
+  state.SetBytesProcessed(nBytes);
+}
+
+static void BM_WriteITSLike(benchmark::State& state)
+{
+  writeRaw(state, ITSLike);
+}
+
+static void BM_WriteTPCLike(benchmark::State& state)
+{
+  writeRaw(state, TPCLike);
+}
+
+BENCHMARK(BM_WriteITSLike)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_WriteTPCLike)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,186 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+// Workflow test of the raw file reader sending superpages from mapped input files:
+// the input file is truncated inside the last superpage, whose first block is still
+// in the file. The reader must not send that superpage from the mapping and all
+// the other superpages must arrive intact.
+
+#include "../src/RawFileReaderWorkflow.h"
+#include "DetectorsRaw/RawFileReader.h"
+#include "DetectorsRaw/RawFileWriter.h"
+#include "DetectorsRaw/HBFUtils.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include "CommonUtils/ConfigurableParam.h"
+#include "Framework/CallbackService.h"
+#include "Framework/ControlService.h"
+#include "Framework/DataRefUtils.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/InputRecordWalker.h"
+#include "Framework/Logger.h"
+#include "Headers/DataHeader.h"
+#include "Framework/runDataProcessing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace o2::framework;
+using namespace o2::raw;
+using RDHAny = o2::header::RDHAny;
+
+namespace
+{
+constexpr int NTF = 4;                  // number of TFs in the file
+constexpr int NHBFPerTF = 8;            // HBFs per TF
+constexpr int HBFPayload = 3 * 8192;    // payload per HBF, spans several pages
+constexpr size_t SPageSize = 0x1 << 15; // nominal superpage size of the reader
+const std::string RawName = "testRawFileReaderWorkflow.raw";
+const std::string TruncName = "testRawFileReaderWorkflow_truncated.raw";
+const std::string CfgName = "testRawFileReaderWorkflow.cfg";
+
+// the payload of each HBF is filled with the lowest byte of its orbit
+void writeRawFile()
+{
+  RawFileWriter writer{"TST"};
+  writer.useRDHVersion(6);
+  writer.setContinuousReadout();
+  writer.registerLink(0, 0, 0, 0, RawName);
+  std::vector<char> buffer(HBFPayload);
+  auto ir = HBFUtils::Instance().getFirstIR();
+  for (int hbf = 0; hbf < NTF * NHBFPerTF; hbf++) {
+    std::fill(buffer.begin(), buffer.end(), char(ir.orbit & 0xff));
+    writer.addData(0, 0, 0, 0, ir, buffer);
+    ir.orbit++;
+  }
+  writer.close();
+}
+
+// cut the file in the 2nd block of the last superpage of the last TF
+size_t findCut()
+{
+  RawFileReader reader;
+  reader.setCheckErrors(0);
+  reader.setNominalSPageSize(SPageSize);
+  reader.setMapFiles(true);
+  reader.addFile(RawName, "TST", "RAWDATA");
+  reader.init();
+  if (reader.getNLinks() != 1 || reader.getNTimeFrames() != NTF) {
+    LOG(FATAL) << "Expecting 1 link and " << NTF << " TFs, found " << reader.getNLinks() << " links and " << reader.getNTimeFrames() << " TFs";
+  }
+  auto& link = reader.getLink(0);
+  link.rewindToTF(NTF - 1);
+  std::vector<RawFileReader::PartStat> parts;
+  link.getNextTFSuperPagesStat(parts);
+  int ibl = link.nextBlock2Read;
+  for (size_t ip = 0; ip + 1 < parts.size(); ip++) {
+    ibl += parts[ip].nBlocks;
+  }
+  if (parts.size() < 2 || parts.back().nBlocks < 2) {
+    LOG(FATAL) << "Expecting at least 2 superpages in the last TF and 2 blocks in the last one";
+  }
+  return link.blocks[ibl + 1].offset + sizeof(RDHAny) + RDHUtils::GBTWord;
+}
+
+// the devices call this too: the files are only written if they do not exist yet, the
+// content does not depend on the run
+void createInput()
+{
+  if (std::ifstream(CfgName).good()) {
+    return;
+  }
+  writeRawFile();
+  auto cut = findCut();
+  std::string content;
+  {
+    std::ifstream file(RawName, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  auto tmpName = TruncName + ".tmp";
+  std::ofstream(tmpName, std::ios::binary).write(content.data(), cut);
+  std::rename(tmpName.c_str(), TruncName.c_str());
+  tmpName = CfgName + ".tmp";
+  {
+    std::ofstream cfg(tmpName);
+    cfg << "[input-0]" << std::endl;
+    cfg << "dataOrigin = TST" << std::endl;
+    cfg << "dataDescription = RAWDATA" << std::endl;
+    cfg << "filePath = " << TruncName << std::endl;
+  }
+  std::rename(tmpName.c_str(), CfgName.c_str());
+}
+
+// all pages must be complete and carry the payload of their HBF
+bool checkSuperPage(const char* data, size_t size)
+{
+  size_t offs = 0;
+  while (offs + sizeof(RDHAny) <= size) {
+    const auto* rdh = reinterpret_cast<const RDHAny*>(data + offs);
+    auto memSize = RDHUtils::getMemorySize(*rdh);
+    if (RDHUtils::getVersion(*rdh) != 6 || memSize < sizeof(RDHAny) || offs + memSize > size || RDHUtils::getOffsetToNext(*rdh) == 0) {
+      return false;
+    }
+    char fill = char(RDHUtils::getHeartBeatOrbit(*rdh) & 0xff);
+    for (size_t i = offs + sizeof(RDHAny); i < offs + memSize; i++) {
+      if (data[i] != fill) {
+        return false;
+      }
+    }
+    offs += RDHUtils::getOffsetToNext(*rdh);
+  }
+  return offs == size;
+}
+} // namespace
+
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  o2::conf::ConfigurableParam::updateFromString("HBFUtils.nHBFPerTF=" + std::to_string(NHBFPerTF));
+  createInput();
+
+  ReaderInp rinp;
+  rinp.inifile = CfgName;
+  rinp.spSize = SPageSize;
+  rinp.partPerSP = true;
+  rinp.mapFiles = true;
+  rinp.errMap = 0;
+  auto specs = getRawFileReaderWorkflow(rinp);
+
+  auto counters = std::make_shared<std::vector<int>>(2, 0); // TFs received, superpages checked
+  specs.emplace_back(DataProcessorSpec{
+    "raw-checker",
+    {InputSpec{"raw", ConcreteDataTypeMatcher{"TST", "RAWDATA"}}},
+    Outputs{},
+    AlgorithmSpec{[counters](InitContext& ic) {
+      ic.services().get<CallbackService>().set(CallbackService::Id::EndOfStream, [counters](EndOfStreamContext& ec) {
+        if ((*counters)[0] != NTF) {
+          LOG(FATAL) << "Received " << (*counters)[0] << " TFs instead of " << NTF;
+        }
+        LOG(INFO) << "Checked " << (*counters)[1] << " superpages in " << NTF << " TFs";
+        ec.services().get<ControlService>().readyToQuit(QuitRequest::All);
+      });
+      return [counters](ProcessingContext& pc) {
+        (*counters)[0]++;
+        for (auto const& ref : InputRecordWalker(pc.inputs())) {
+          auto const* dh = DataRefUtils::getHeader<o2::header::DataHeader*>(ref);
+          if (dh->tfCounter == NTF - 1 && dh->splitPayloadIndex == dh->splitPayloadParts - 1) {
+            continue; // the truncated superpage, which could not be read
+          }
+          if (!checkSuperPage(ref.payload, dh->payloadSize)) {
+            LOG(FATAL) << "Corrupted superpage " << dh->splitPayloadIndex << " of TF " << dh->tfCounter;
+          }
+          (*counters)[1]++;
+        }
+      };
+    }}});
+  return specs;
+}
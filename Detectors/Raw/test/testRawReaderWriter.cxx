@@ -15,11 +15,15 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <utility>
+#include <cstring>
 #include <TRandom.h>
 #include <boost/test/unit_test.hpp>
 #include "Steer/InteractionSampler.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "DetectorsRaw/RDHUtils.h"
+#include "DetectorsRaw/RawFileReader.h"
 #include "DetectorsRaw/RawFileWriter.h"
 #include "DetectorsRaw/SimpleRawReader.h"
 #include "DetectorsRaw/SimpleSTF.h"
@@ -58,6 +62,7 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
 
   RawFileWriter writer{"TST"};
   std::string configName = "rawConf.cfg";
+  std::string filePrefix = "testdata_";
 
   //_________________________________________________________________
   TestRawWriter(o2::header::DataOrigin origin = "TST", bool isCRU = true, const std::string& cfg = "rawConf.cfg") : writer(origin, isCRU), configName(cfg) {}
@@ -70,7 +75,7 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
     int feeIDShift = writer.isCRUDetector() ? 8 : 9;
     // register links
     for (int icru = 0; icru < NCRU; icru++) {
-      std::string outFileName = o2::utils::concat_string("testdata_", writer.isCRUDetector() ? "cru" : "rorc", std::to_string(icru), ".raw");
+      std::string outFileName = o2::utils::concat_string(filePrefix, writer.isCRUDetector() ? "cru" : "rorc", std::to_string(icru), ".raw");
       for (int il = 0; il < NLinkPerCRU; il++) {
         auto& link = writer.registerLink((icru << feeIDShift) + il, icru, il, 0, outFileName);
         RDHUtils::setDetectorField(link.rdhCopy, 0xff << icru); // if needed, set extra link info, will be copied to all RDHs
@@ -188,6 +193,7 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
 
   std::unique_ptr<RawFileReader> reader;
   std::string confName;
+  bool mapFiles = false;
 
   //_________________________________________________________________
   TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg") : confName(cfg) {}
@@ -199,6 +205,7 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
     uint32_t errCheck = 0xffffffff;
     errCheck ^= 0x1 << RawFileReader::ErrNoSuperPageForTF; // makes no sense for superpages not interleaved by others
     reader->setCheckErrors(errCheck);
+    reader->setMapFiles(mapFiles);
     reader->init();
   }
 
@@ -306,6 +313,96 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
   } // run
 };
 
+// compare superpages provided from the file mappings with those read via stdio,
+// return the number of superpages successfully read and the total number of superpages
+std::pair<int, int> compareMappedSuperPages(RawFileReader& rdStd, RawFileReader& rdMap)
+{
+  BOOST_REQUIRE(rdStd.getNLinks() == rdMap.getNLinks());
+  BOOST_REQUIRE(rdMap.getNFiles() > 0);
+  for (int i = 0; i < rdMap.getNFiles(); i++) {
+    BOOST_REQUIRE(rdMap.isFileMapped(i));
+    BOOST_REQUIRE(!rdStd.isFileMapped(i));
+  }
+  std::vector<RawFileReader::PartStat> partsStd, partsMap;
+  std::vector<char> buff;
+  int nSPages = 0, nSPagesRead = 0;
+  for (uint32_t tf = 0; tf < rdStd.getNTimeFrames(); tf++) {
+    rdMap.prefetchTF(tf);
+    for (int il = 0; il < rdStd.getNLinks(); il++) {
+      auto& lnkStd = rdStd.getLink(il);
+      auto& lnkMap = rdMap.getLink(il);
+      BOOST_REQUIRE(lnkStd.rewindToTF(tf) == lnkMap.rewindToTF(tf));
+      if (lnkStd.nextBlock2Read < 0) {
+        continue;
+      }
+      BOOST_REQUIRE(lnkStd.getNextTFSuperPagesStat(partsStd) == lnkMap.getNextTFSuperPagesStat(partsMap));
+      BOOST_REQUIRE(partsStd.size() == partsMap.size());
+      for (size_t ip = 0; ip < partsStd.size(); ip++) {
+        buff.resize(partsStd[ip].size);
+        const char* data = nullptr;
+        auto szStd = lnkStd.readNextSuperPage(buff.data(), &partsStd[ip]);
+        auto szMap = lnkMap.mapNextSuperPage(data, &partsMap[ip]);
+        BOOST_REQUIRE(szStd == szMap);
+        nSPages++;
+        if (szMap) {
+          BOOST_REQUIRE(data != nullptr);
+          BOOST_CHECK(szMap == buff.size());
+          BOOST_CHECK(memcmp(data, buff.data(), buff.size()) == 0);
+          nSPagesRead++;
+        }
+      }
+    }
+  }
+  return {nSPagesRead, nSPages};
+}
+
+void compareMappedSuperPages(const std::string& cfg)
+{
+  TestRawReader drStd{"TST", cfg}, drMap{"TST", cfg};
+  drMap.mapFiles = true;
+  drStd.init();
+  drMap.init();
+  auto [nRead, nSPages] = compareMappedSuperPages(*drStd.reader, *drMap.reader);
+  BOOST_CHECK(nSPages > 0);
+  BOOST_CHECK(nRead == nSPages);
+}
+
+// the superpage with the block extending beyond the end of the truncated file must be rejected by both readers
+void compareMappedSuperPagesTruncated(const std::string& fileName)
+{
+  std::string content;
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    BOOST_REQUIRE(file.good());
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  // cut the file in the payload of the last CRU page with data
+  size_t cut = 0;
+  for (size_t offs = 0; offs + sizeof(RDHAny) <= content.size();) {
+    const auto& rdh = *reinterpret_cast<const RDHAny*>(&content[offs]);
+    if (RDHUtils::getMemorySize(rdh) > sizeof(RDHAny) + RDHUtils::GBTWord) {
+      cut = offs + sizeof(RDHAny) + RDHUtils::GBTWord;
+    }
+    offs += RDHUtils::getOffsetToNext(rdh);
+  }
+  BOOST_REQUIRE(cut > 0);
+  const std::string truncName = "testdata_truncated.raw";
+  {
+    std::ofstream file(truncName, std::ios::binary);
+    file.write(content.data(), cut);
+  }
+  RawFileReader rdStd, rdMap;
+  for (auto* rd : {&rdStd, &rdMap}) {
+    rd->setCheckErrors(0);
+    rd->setMapFiles(rd == &rdMap);
+    BOOST_REQUIRE(rd->addFile(truncName, "TST", "RAWDATA"));
+    rd->init();
+  }
+  auto [nRead, nSPages] = compareMappedSuperPages(rdStd, rdMap);
+  BOOST_CHECK(nRead > 0);
+  BOOST_CHECK(nRead < nSPages);
+}
+
 BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
 {
   TestRawWriter dw{"TST", true, "test_raw_conf_GBT.cfg"}; // this is a CRU detector with origin TST
@@ -316,6 +413,14 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
   dr.init();
   dr.run(); // read back and check
 
+  // same checks with mapped input files
+  TestRawReader drm{"TST", "test_raw_conf_GBT.cfg"};
+  drm.mapFiles = true;
+  drm.init();
+  drm.run();
+  compareMappedSuperPages(dr.confName);
+  compareMappedSuperPagesTruncated("testdata_cru0.raw");
+
   // test SimpleReader
   int nLoops = 5;
   SimpleRawReader sr(dr.confName, false, nLoops);
@@ -385,4 +490,38 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
   }
 }
 
+// the output must be the one of the writing by copy from the link buffers, whatever the superpages are handed over
+// to the file, batched or written asynchronously
+BOOST_AUTO_TEST_CASE(RawReaderWriter_BatchedWrite)
+{
+  enum { Copy,
+         Direct,
+         Batched,
+         NModes };
+  const std::string prefixes[NModes] = {"testdata_copy_", "testdata_direct_", "testdata_batched_"};
+  for (int mode = 0; mode < NModes; mode++) {
+    gRandom->SetSeed(12345); // same payload for all writers
+    TestRawWriter dw{"TST", true, "test_raw_conf_batched.cfg"};
+    dw.filePrefix = prefixes[mode];
+    dw.writer.setCopySuperPages(mode == Copy);
+    if (mode == Batched) {
+      dw.writer.setWriteBatchSize(4 * dw.writer.getSuperPageSize());
+      dw.writer.setAsyncWrite(true);
+    }
+    dw.init();
+    dw.run();
+  }
+  for (int icru = 0; icru < NCRU; icru++) {
+    std::string content[NModes];
+    for (int mode = 0; mode < NModes; mode++) {
+      std::ifstream file(o2::utils::concat_string(prefixes[mode], "cru", std::to_string(icru), ".raw"), std::ios::binary);
+      BOOST_REQUIRE(file.good());
+      content[mode].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    BOOST_CHECK(!content[Copy].empty());
+    BOOST_CHECK(content[Direct] == content[Copy]);
+    BOOST_CHECK(content[Batched] == content[Copy]);
+  }
+}
+
 } // namespace o2
@@ -21,6 +21,7 @@
 #include "Framework/Task.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/ControlService.h"
+#include "Framework/CallbackService.h"
 #include "Framework/WorkflowSpec.h"
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CcdbObjectInfo.h"
@@ -44,6 +45,16 @@ class LHCClockCalibDevice : public o2::framework::Task
     mCalibrator = std::make_unique<o2::tof::LHCClockCalibrator>(minEnt, nb);
     mCalibrator->setSlotLength(slotL);
     mCalibrator->setMaxSlotsDelay(delay);
+    mCalibrator->setAsyncFinalization(ic.options().get<bool>("async-finalization"));
+    // the finalization thread must be stopped while the calibrator is still complete
+    ic.services().get<o2::framework::CallbackService>().set(o2::framework::CallbackService::Id::Stop, [this]() { mCalibrator->setAsyncFinalization(false); });
+  }
+
+  ~LHCClockCalibDevice() override
+  {
+    if (mCalibrator) {
+      mCalibrator->setAsyncFinalization(false);
+    }
   }
 
   void run(o2::framework::ProcessingContext& pc) final
@@ -53,8 +64,6 @@ class LHCClockCalibDevice : public o2::framework::Task
     LOG(INFO) << "Processing TF " << tfcounter << " with " << data.size() << " tracks";
     mCalibrator->process(tfcounter, data);
     sendOutput(pc.outputs());
-    const auto& infoVec = mCalibrator->getLHCphaseInfoVector();
-    LOG(INFO) << "Created " << infoVec.size() << " objects for TF " << tfcounter;
   }
 
   void endOfStream(o2::framework::EndOfStreamContext& ec) final
@@ -62,6 +71,7 @@ class LHCClockCalibDevice : public o2::framework::Task
     LOG(INFO) << "Finalizing calibration";
     constexpr uint64_t INFINITE_TF = 0xffffffffffffffff;
     mCalibrator->checkSlotsToFinalize(INFINITE_TF);
+    mCalibrator->waitForFinalization();
     sendOutput(ec.outputs());
   }
 
@@ -74,6 +84,10 @@ class LHCClockCalibDevice : public o2::framework::Task
     // extract CCDB infos and calibration objects, convert it to TMemFile and send them to the output
     // TODO in principle, this routine is generic, can be moved to Utils.h
     using clbUtils = o2::calibration::Utils;
+    auto lock = mCalibrator->lockOutput(false);
+    if (!lock.owns_lock()) { // a slot is being finalized, its output will be sent with the next TF
+      return;
+    }
     const auto& payloadVec = mCalibrator->getLHCphaseVector();
     auto& infoVec = mCalibrator->getLHCphaseInfoVector(); // use non-const version as we update it
     assert(payloadVec.size() == infoVec.size());
@@ -86,6 +100,7 @@ class LHCClockCalibDevice : public o2::framework::Task
       output.snapshot(Output{clbUtils::gDataOriginCLB, clbUtils::gDataDescriptionCLBPayload, i}, *image.get()); // vector<char>
       output.snapshot(Output{clbUtils::gDataOriginCLB, clbUtils::gDataDescriptionCLBInfo, i}, w);               // root-serialized
     }
+    LOG(INFO) << "Created " << infoVec.size() << " objects";
     if (payloadVec.size()) {
       mCalibrator->initOutput(); // reset the outputs once they are already sent
     }
@@ -114,7 +129,8 @@ DataProcessorSpec getLHCClockCalibDeviceSpec()
       {"tf-per-slot", VariantType::Int, 5, {"number of TFs per calibration time slot"}},
       {"max-delay", VariantType::Int, 3, {"number of slots in past to consider"}},
       {"min-entries", VariantType::Int, 500, {"minimum number of entries to fit single time slot"}},
-      {"nbins", VariantType::Int, 1000, {"number of bins for "}}}};
+      {"nbins", VariantType::Int, 1000, {"number of bins for "}},
+      {"async-finalization", VariantType::Bool, false, {"finalize the slots in a separate thread"}}}};
 }
 
 } // namespace framework
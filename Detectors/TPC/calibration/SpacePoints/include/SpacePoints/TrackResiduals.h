@@ -98,6 +98,37 @@ class TrackResiduals
     std::array<unsigned char, VoxDim> bvox{}; ///< voxel identifier: VoxZ, VoxF, VoxX
   };
 
+  /// Columnar in-memory storage of the local residuals of one sector.
+  /// Can be used instead of the intermediate local residual trees, the values are stored in the same compressed format as in LocalResid
+  struct LocalResidContainer {
+    std::vector<short> dy;              ///< residuals in y
+    std::vector<short> dz;              ///< residuals in z
+    std::vector<short> tgSlp;           ///< track dip angles
+    std::vector<unsigned short> voxBin; ///< global voxel bin
+    size_t size() const { return dy.size(); }
+    void reserve(size_t n)
+    {
+      dy.reserve(n);
+      dz.reserve(n);
+      tgSlp.reserve(n);
+      voxBin.reserve(n);
+    }
+    void clear()
+    {
+      dy.clear();
+      dz.clear();
+      tgSlp.clear();
+      voxBin.clear();
+    }
+    void push_back(short dyIn, short dzIn, short tgSlpIn, unsigned short bin)
+    {
+      dy.push_back(dyIn);
+      dz.push_back(dzIn);
+      tgSlp.push_back(tgSlpIn);
+      voxBin.push_back(bin);
+    }
+  };
+
   /// Helper structure to organize acess to delta trees from Run2 (legacy method)
   /// All parameters are on a per-track basis
   struct DeltaStruct {
@@ -141,6 +172,15 @@ class TrackResiduals
   // -------------------------------------- settings --------------------------------------------------
   /// Sets a flag to print the memory usage at certain points in the program for performance studies.
   void setPrintMemoryUsage() { mPrintMem = true; }
+  /// Sets the number of threads used for the processing of the residuals (sectors and voxels are processed in parallel).
+  /// Without OpenMP support only a single thread is used.
+  /// \param n Number of threads
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+  /// Keep the local residuals in memory (see LocalResidContainer) instead of writing them to the intermediate trees.
+  /// \param flag If true, the residuals are stored in memory
+  void setStoreLocalResidualsInMemory(bool flag = true) { mStoreLocResInMemory = flag; }
+  bool getStoreLocalResidualsInMemory() const { return mStoreLocResInMemory; }
   /// Sets the kernel type used for smoothing.
   /// \param kernel Kernel type (Epanechnikov / Gaussian)
   /// \param bwX Bin width in X
@@ -168,16 +208,43 @@ class TrackResiduals
   /// Write trees with local residuals to file
   void writeLocalResidualTreesToFile();
 
+  /// Stores the content of mLocalResid either in the tree or in the in-memory container for given sector
+  /// \param iSec Sector number
+  void storeLocalResidual(int iSec);
+
+  /// Access to the in-memory local residuals of a sector (filled if setStoreLocalResidualsInMemory() was set)
+  /// \param iSec Sector number
+  LocalResidContainer& getLocalResidContainer(int iSec) { return mLocalResidMem[iSec]; }
+  const LocalResidContainer& getLocalResidContainer(int iSec) const { return mLocalResidMem[iSec]; }
+
   /// Loads residual data from track interpolation and fills voxel data structures local residuals
   void convertToLocalResiduals();
 
   /// Steers the processing of the residuals for all sectors.
   void processResiduals();
 
-  /// Processes residuals for given sector.
+  /// Processes residuals for given sector and dumps the results to the debug tree (if it was created).
   /// \param iSec Sector to process
   void processSectorResiduals(Int_t iSec);
 
+  /// Extracts, validates and smoothes the voxel residuals for given sector.
+  /// Does not write any output, so that it can be called concurrently for different sectors.
+  /// \param iSec Sector to process
+  /// \return true if the results for this sector are complete
+  bool fitSectorResiduals(int iSec);
+
+  /// Reads the local residuals of given sector from the local residual tree.
+  /// \param iSec Sector to read
+  /// \param dy Vector for residuals in y
+  /// \param dz Vector for residuals in z
+  /// \param tg Vector for tan(phi) of the tracks
+  /// \param bin Vector for the global voxel bins
+  /// \return false in case the input could not be read
+  bool readLocalResiduals(int iSec, std::vector<float>& dy, std::vector<float>& dz, std::vector<float>& tg, std::vector<unsigned short>& bin) const;
+
+  /// Same as above, but the local residuals are taken from the in-memory container
+  bool readLocalResidualsFromMemory(int iSec, std::vector<float>& dy, std::vector<float>& dz, std::vector<float>& tg, std::vector<unsigned short>& bin) const;
+
   /// Performs the robust linear fit for one voxel to estimate the distortions in X, Y and Z and their errors.
   /// \param dy Vector with residuals in y
   /// \param dz Vector with residuals in z
@@ -201,6 +268,12 @@ class TrackResiduals
   /// \param iSec Sector to process
   void smooth(int iSec);
 
+  /// Sorts the given voxel bins and determines for each voxel with data the range of entries in the sorted index.
+  /// \param binData Vector with global voxel bin of each point
+  /// \param binIndices Is filled with the indices of the points sorted by voxel
+  /// \param voxRanges Is filled with the global voxel bin, the first and the last+1 index in binIndices for each voxel
+  void buildVoxelRanges(const std::vector<unsigned short>& binData, std::vector<size_t>& binIndices, std::vector<std::array<size_t, 3>>& voxRanges) const;
+
   // -------------------------------------- statistics --------------------------------------------------
 
   /// Performs a robust linear fit y(x) = a + b * x for given x and y.
@@ -472,6 +545,10 @@ class TrackResiduals
   float getMaxSigZ() const { return mMaxSigZ; }
   float getMaxGaussStdDev() const { return mMaxGaussStdDev; }
 
+  /// Get the results for all voxels of a sector
+  /// \param iSec Sector number
+  const std::vector<VoxRes>& getVoxelResults(int iSec) const { return mVoxelResults[iSec]; }
+
   // ------------------------- conversion of delta trees -> compact trees ------------------------------
   /// For use with Run 2 data, outlier filtering
   bool validateTrack(std::array<int, 3>& counterTrkValidation);
@@ -530,8 +607,10 @@ class TrackResiduals
   std::unique_ptr<TFile> mFileOut{}; ///< output debug file
   std::unique_ptr<TTree> mTreeOut{}; ///< tree holding debug output
   // status flags
-  bool mIsInitialized{}; ///< initialize only once
-  bool mPrintMem{};      ///< turn on to print memory usage at certain points
+  bool mIsInitialized{};       ///< initialize only once
+  bool mPrintMem{};            ///< turn on to print memory usage at certain points
+  bool mStoreLocResInMemory{}; ///< keep local residuals in mLocalResidMem instead of writing the trees
+  int mNThreads{1};            ///< number of threads for the residual processing
   // binning
   int mNXBins{param::NPadRows};            ///< number of bins in radial direction
   int mNY2XBins{param::NY2XBins};          ///< number of y/x bins per sector
@@ -553,10 +632,11 @@ class TrackResiduals
   float mMaxZ2X{1.f};                      ///< max z/x value
   std::array<bool, VoxDim> mUniformBins{true, true, true}; ///< if binning is uniform for each dimension
   // local residual data, extracted from track interpolation
-  std::array<std::unique_ptr<TFile>, SECTORSPERSIDE * SIDES> mTmpFile{}; ///< I/O file
-  std::array<std::unique_ptr<TTree>, SECTORSPERSIDE * SIDES> mTmpTree{}; ///< I/O tree per sector
-  LocalResid mLocalResid{};                                              ///< data exchange structure for filling mTmpTree
-  LocalResid* mLocalResidPtr{&mLocalResid};                              ///< pointer to mLocalResid
+  std::array<std::unique_ptr<TFile>, SECTORSPERSIDE * SIDES> mTmpFile{};    ///< I/O file
+  std::array<std::unique_ptr<TTree>, SECTORSPERSIDE * SIDES> mTmpTree{};    ///< I/O tree per sector
+  LocalResid mLocalResid{};                                                 ///< data exchange structure for filling mTmpTree
+  LocalResid* mLocalResidPtr{&mLocalResid};                                 ///< pointer to mLocalResid
+  std::array<LocalResidContainer, SECTORSPERSIDE * SIDES> mLocalResidMem{}; ///< in-memory local residuals per sector
   // settings
   std::string mLocalResFileName{"deltasSect"};   ///< filename for local residuals input
   std::string mLocalResTreeName{"treeSec"};      ///< name for tree with local residuals
@@ -583,7 +663,6 @@ class TrackResiduals
   std::array<int, VoxDim> mStepKern{};                             ///< N bins to consider with given kernel settings
   std::array<float, VoxDim> mKernelScaleEdge{};                    ///< optional scaling factors for kernel width on the edge
   std::array<float, VoxDim> mKernelWInv{};                         ///< inverse kernel width in bins
-  std::array<double, ResDim * sMaxSmtDim> mLastSmoothingRes{};     ///< results of last smoothing operation
   // (intermediate) results
   std::array<std::bitset<param::NPadRows>, SECTORSPERSIDE * SIDES> mXBinsIgnore{};          ///< flags which X bins to ignore
   std::array<std::array<float, param::NPadRows>, SECTORSPERSIDE * SIDES> mValidFracXBins{}; ///< for each sector for each X-bin the fraction of validated voxels
@@ -22,5 +22,6 @@
 #pragma link C++ class std::vector < o2::tpc::TPCClusterResiduals> + ;
 #pragma link C++ class o2::tpc::TrackResiduals::LocalResid + ;
 #pragma link C++ class o2::tpc::TrackResiduals::VoxRes + ;
+#pragma link C++ class o2::tpc::TrackResiduals::LocalResidContainer + ;
 
 #endif
@@ -38,6 +38,12 @@
 
 #include <fairlogger/Logger.h>
 
+#include "TROOT.h"
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 //#define TPC_RUN2 // if defined, use run 2 geometry for TPC
 
 #define LOCAL_RESIDUAL_FORMAT_OLD // if defined, data in compact trees is stored as Double32_t, otherwise as short
@@ -531,12 +537,20 @@ void TrackResiduals::fillLocalResidualsTrees()
     mLocalResid.dy = static_cast<short>(mArrDY[iCl] * 0x7fff / param::MaxResid);
     mLocalResid.dz = static_cast<short>(mArrDZ[iCl] * 0x7fff / param::MaxResid);
     mLocalResid.tgSlp = static_cast<short>(mArrTgSlp[iCl] * 0x7fff / param::MaxTgSlp);
-    // fill tree
-    mTmpTree[secId]->Fill();
+    storeLocalResidual(secId);
     // TODO: fill statistics distribution within the voxel
   }
 }
 
+void TrackResiduals::storeLocalResidual(int iSec)
+{
+  if (mStoreLocResInMemory) {
+    mLocalResidMem[iSec].push_back(mLocalResid.dy, mLocalResid.dz, mLocalResid.tgSlp, getGlbVoxBin(mLocalResid.bvox));
+  } else {
+    mTmpTree[iSec]->Fill();
+  }
+}
+
 bool TrackResiduals::validateTrack(std::array<int, 3>& counterTrkValidation)
 {
   if (mNCl < mNMALong) {
@@ -692,6 +706,10 @@ void TrackResiduals::prepareLocalResidualTrees()
 {
   // prepare tree structure
   for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
+    if (mStoreLocResInMemory) {
+      mLocalResidMem[iSec].clear();
+      continue;
+    }
     mTmpFile[iSec] = std::make_unique<TFile>(Form("%s%d.root", mLocalResFileName.c_str(), iSec), "recreate");
     mTmpTree[iSec] = std::make_unique<TTree>(Form("%s%d", mLocalResTreeName.c_str(), iSec), "TPC local residuals");
     mTmpTree[iSec]->Branch(mLocalResBranchName.c_str(), &mLocalResidPtr);
@@ -762,7 +780,7 @@ void TrackResiduals::convertToLocalResiduals()
       mLocalResid.dz = mClRes[clIdx].dz;
       mLocalResid.tgSlp = mClRes[clIdx].phi;
       mLocalResid.bvox = bvox;
-      mTmpTree[sec]->Fill();
+      storeLocalResidual(sec);
       // TODO calculate mean position of clusters in each voxel (can be updated each time a new measurement is found inside voxel)
     }
   }
@@ -771,67 +789,83 @@ void TrackResiduals::convertToLocalResiduals()
   writeLocalResidualTreesToFile();
 }
 
+//______________________________________________________________________________
+void TrackResiduals::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________________________________________
 void TrackResiduals::processResiduals()
 {
   if (!mIsInitialized) {
     init();
   }
+  if (mNThreads > 1 && !mStoreLocResInMemory) {
+    // each sector opens its own file with local residuals
+    ROOT::EnableThreadSafety();
+  }
+  std::array<bool, SECTORSPERSIDE * SIDES> sectorDone{};
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
+    sectorDone[iSec] = fitSectorResiduals(iSec);
+  }
+  // debug output is written sequentially
   for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
-    processSectorResiduals(iSec);
+    if (sectorDone[iSec]) {
+      dumpResults(iSec);
+    }
   }
 }
 
 //______________________________________________________________________________
 void TrackResiduals::processSectorResiduals(int iSec)
 {
-  if (iSec < 0 || iSec > 35) {
-    LOG(error) << "wrong sector: " << iSec;
-    return;
-  }
-  LOG(info) << "processing sector residuals for sector " << iSec;
   if (!mIsInitialized) {
     init();
   }
+  if (fitSectorResiduals(iSec)) {
+    dumpResults(iSec);
+  }
+}
+
+//______________________________________________________________________________
+bool TrackResiduals::readLocalResiduals(int iSec, std::vector<float>& dyData, std::vector<float>& dzData, std::vector<float>& tgSlpData, std::vector<unsigned short>& binData) const
+{
   // open file and retrieve data tree (only local files are supported at the moment)
   std::string filename = mLocalResFileName + std::to_string(iSec) + ".root";
   std::unique_ptr<TFile> flin = std::make_unique<TFile>(filename.c_str());
   if (!flin || flin->IsZombie()) {
     LOG(error) << "failed to open " << filename.c_str();
-    return;
+    return false;
   }
   std::string treename = mLocalResTreeName + std::to_string(iSec);
   std::unique_ptr<TTree> tree((TTree*)flin->Get(treename.c_str()));
   if (!tree) {
     LOG(error) << "did not find the data tree " << treename.c_str();
-    return;
+    return false;
   }
   // read compact delte trees created with AliRoot or o2
   LocResStruct trkRes;
   auto* pTrkRes = &trkRes;
   tree->SetBranchAddress(mLocalResBranchName.c_str(), &pTrkRes);
   auto nPoints = tree->GetEntries();
-  if (!nPoints) {
-    LOG(warning) << "no entries found for sector " << iSec;
-    flin->Close();
-    return;
-  }
   if (nPoints > mMaxPointsPerSector) {
     nPoints = mMaxPointsPerSector;
   }
-  // initialize container holding results
-  initResultsContainer(iSec);
-
   LOG(info) << "extracted " << nPoints << " of unbinned data";
 
-  std::vector<VoxRes>& secData = mVoxelResults[iSec];
-
   unsigned int nAccepted = 0;
-
-  std::vector<float> dyData(nPoints);
-  std::vector<float> dzData(nPoints);
-  std::vector<float> tgSlpData(nPoints);
-  std::vector<unsigned short> binData(nPoints);
+  dyData.resize(nPoints);
+  dzData.resize(nPoints);
+  tgSlpData.resize(nPoints);
+  binData.resize(nPoints);
 
   if (mPrintMem) {
     printMem();
@@ -862,14 +896,6 @@ void TrackResiduals::processSectorResiduals(int iSec)
   tree.release();
   flin->Close();
 
-  if (mPrintMem) {
-    printMem();
-  }
-
-  LOG(info) << "Done reading input data (accepted " << nAccepted << " points)";
-
-  std::vector<size_t> binIndices(nAccepted);
-
   dyData.resize(nAccepted);
   dzData.resize(nAccepted);
   tgSlpData.resize(nAccepted);
@@ -877,61 +903,133 @@ void TrackResiduals::processSectorResiduals(int iSec)
 
 #ifdef LOCAL_RESIDUAL_FORMAT_OLD
   // convert to short and back to float to be compatible with AliRoot version
-  std::vector<short> dyDataShort(nAccepted);
-  std::vector<short> dzDataShort(nAccepted);
-  std::vector<short> tgSlpDataShort(nAccepted);
   for (unsigned int i = 0; i < nAccepted; ++i) {
-    dyDataShort[i] = short(dyData[i] * 0x7fff / param::MaxResid);
-    dzDataShort[i] = short(dzData[i] * 0x7fff / param::MaxResid);
-    tgSlpDataShort[i] = short(tgSlpData[i] * 0x7fff / param::MaxTgSlp);
-
-    dyData[i] = dyDataShort[i] * param::MaxResid / 0x7fff;
-    dzData[i] = dzDataShort[i] * param::MaxResid / 0x7fff;
-    tgSlpData[i] = tgSlpDataShort[i] * param::MaxTgSlp / 0x7fff;
+    dyData[i] = short(dyData[i] * 0x7fff / param::MaxResid) * param::MaxResid / 0x7fff;
+    dzData[i] = short(dzData[i] * 0x7fff / param::MaxResid) * param::MaxResid / 0x7fff;
+    tgSlpData[i] = short(tgSlpData[i] * 0x7fff / param::MaxTgSlp) * param::MaxTgSlp / 0x7fff;
   }
 #endif
+  return true;
+}
+
+//______________________________________________________________________________
+bool TrackResiduals::readLocalResidualsFromMemory(int iSec, std::vector<float>& dyData, std::vector<float>& dzData, std::vector<float>& tgSlpData, std::vector<unsigned short>& binData) const
+{
+  const auto& store = mLocalResidMem[iSec];
+  size_t nPoints = std::min(store.size(), static_cast<size_t>(mMaxPointsPerSector));
+  LOG(info) << "extracted " << nPoints << " of unbinned data";
+  dyData.resize(nPoints);
+  dzData.resize(nPoints);
+  tgSlpData.resize(nPoints);
+  binData.resize(nPoints);
+  size_t nAccepted = 0;
+  for (size_t i = 0; i < nPoints; ++i) {
+    float tgSlp = store.tgSlp[i] * param::MaxTgSlp / 0x7fff;
+    if (fabs(tgSlp) >= param::MaxTgSlp) {
+      continue;
+    }
+    dyData[nAccepted] = store.dy[i] * param::MaxResid / 0x7fff;
+    dzData[nAccepted] = store.dz[i] * param::MaxResid / 0x7fff;
+    tgSlpData[nAccepted] = tgSlp;
+    binData[nAccepted] = store.voxBin[i];
+    nAccepted++;
+  }
+  dyData.resize(nAccepted);
+  dzData.resize(nAccepted);
+  tgSlpData.resize(nAccepted);
+  binData.resize(nAccepted);
+  return true;
+}
 
+//______________________________________________________________________________
+void TrackResiduals::buildVoxelRanges(const std::vector<unsigned short>& binData, std::vector<size_t>& binIndices, std::vector<std::array<size_t, 3>>& voxRanges) const
+{
+  binIndices.resize(binData.size());
   // sort in voxel increasing order
   o2::math_utils::SortData(binData, binIndices);
+  voxRanges.clear();
+  for (size_t iFirst = 0; iFirst < binIndices.size();) {
+    auto voxBin = binData[binIndices[iFirst]];
+    size_t iLast = iFirst + 1;
+    while (iLast < binIndices.size() && binData[binIndices[iLast]] == voxBin) {
+      ++iLast;
+    }
+    voxRanges.push_back({voxBin, iFirst, iLast});
+    iFirst = iLast;
+  }
+}
+
+//______________________________________________________________________________
+bool TrackResiduals::fitSectorResiduals(int iSec)
+{
+  if (iSec < 0 || iSec > 35) {
+    LOG(error) << "wrong sector: " << iSec;
+    return false;
+  }
+  LOG(info) << "processing sector residuals for sector " << iSec;
+
+  std::vector<float> dyData;
+  std::vector<float> dzData;
+  std::vector<float> tgSlpData;
+  std::vector<unsigned short> binData;
+  bool inputOK = mStoreLocResInMemory ? readLocalResidualsFromMemory(iSec, dyData, dzData, tgSlpData, binData)
+                                      : readLocalResiduals(iSec, dyData, dzData, tgSlpData, binData);
+  if (!inputOK) {
+    return false;
+  }
+  if (binData.empty()) {
+    LOG(warning) << "no entries found for sector " << iSec;
+    return false;
+  }
+  // initialize container holding results
+  initResultsContainer(iSec);
+
+  std::vector<VoxRes>& secData = mVoxelResults[iSec];
+
   if (mPrintMem) {
     printMem();
   }
 
-  // vectors holding the data for one voxel at a time
-  std::vector<float> dyVec;
-  std::vector<float> dzVec;
-  std::vector<float> tgVec;
-  // assuming we will always have around 1000 entries per voxel
-  dyVec.reserve(1e3);
-  dzVec.reserve(1e3);
-  tgVec.reserve(1e3);
-  int currVoxBin = -1;
-  unsigned int nPointsInVox = 0;
-  unsigned int nProcessed = 0;
-  while (nProcessed < nAccepted) {
-    // read all points, voxel by voxel
-    int idx = binIndices[nProcessed];
-    if (currVoxBin != binData[idx]) {
-      if (nPointsInVox) {
-        VoxRes& resVox = secData[currVoxBin];
-        processVoxelResiduals(dyVec, dzVec, tgVec, resVox);
-      }
-      currVoxBin = binData[idx];
-      nPointsInVox = 0;
+  LOG(info) << "Done reading input data (accepted " << binData.size() << " points)";
+
+  // sort in voxel increasing order and find the data range for each voxel
+  std::vector<size_t> binIndices;
+  std::vector<std::array<size_t, 3>> voxRanges;
+  buildVoxelRanges(binData, binIndices, voxRanges);
+  if (mPrintMem) {
+    printMem();
+  }
+  int nVoxWithData = voxRanges.size();
+
+  // voxels are independent of each other, each thread uses its own buffers
+#ifdef WITH_OPENMP
+#pragma omp parallel num_threads(mNThreads)
+#endif
+  {
+    // vectors holding the data for one voxel at a time
+    std::vector<float> dyVec;
+    std::vector<float> dzVec;
+    std::vector<float> tgVec;
+    // assuming we will always have around 1000 entries per voxel
+    dyVec.reserve(1e3);
+    dzVec.reserve(1e3);
+    tgVec.reserve(1e3);
+#ifdef WITH_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int iVox = 0; iVox < nVoxWithData; ++iVox) {
+      const auto& range = voxRanges[iVox];
       dyVec.clear();
       dzVec.clear();
       tgVec.clear();
+      for (size_t i = range[1]; i < range[2]; ++i) {
+        int idx = binIndices[i];
+        dyVec.push_back(dyData[idx]);
+        dzVec.push_back(dzData[idx]);
+        tgVec.push_back(tgSlpData[idx]);
+      }
+      processVoxelResiduals(dyVec, dzVec, tgVec, secData[range[0]]);
     }
-    dyVec.push_back(dyData[idx]);
-    dzVec.push_back(dzData[idx]);
-    tgVec.push_back(tgSlpData[idx]);
-    ++nPointsInVox;
-    ++nProcessed;
-  }
-  if (nPointsInVox) {
-    // process last voxel
-    VoxRes& resVox = secData[currVoxBin];
-    processVoxelResiduals(dyVec, dzVec, tgVec, resVox);
   }
   LOG(info) << "extracted residuals for sector " << iSec;
 
@@ -939,46 +1037,43 @@ void TrackResiduals::processSectorResiduals(int iSec)
   LOG(info) << "number of validated X rows: " << nRowsOK;
   if (!nRowsOK) {
     LOG(warning) << "sector " << iSec << ": all X-bins disabled, abandon smoothing";
-    return;
+    return false;
   } else {
     smooth(iSec);
   }
-  //dumpResults(iSec);
-  //return;
 
   // process dispersions
-  dyVec.clear();
-  tgVec.clear();
-  currVoxBin = -1;
-  nProcessed = 0;
-  nPointsInVox = 0;
-  while (nProcessed < nAccepted) {
-    int idx = binIndices[nProcessed];
-    if (currVoxBin != binData[idx]) {
-      if (nPointsInVox) {
-        VoxRes& resVox = secData[currVoxBin];
-        if (!getXBinIgnored(iSec, resVox.bvox[VoxX])) {
-          processVoxelDispersions(tgVec, dyVec, resVox);
-        }
+#ifdef WITH_OPENMP
+#pragma omp parallel num_threads(mNThreads)
+#endif
+  {
+    std::vector<float> dyVec;
+    std::vector<float> tgVec;
+    dyVec.reserve(1e3);
+    tgVec.reserve(1e3);
+#ifdef WITH_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int iVox = 0; iVox < nVoxWithData; ++iVox) {
+      const auto& range = voxRanges[iVox];
+      VoxRes& resVox = secData[range[0]];
+      if (getXBinIgnored(iSec, resVox.bvox[VoxX])) {
+        continue;
       }
-      currVoxBin = binData[idx];
-      nPointsInVox = 0;
       dyVec.clear();
       tgVec.clear();
-    }
-    dyVec.push_back(dyData[idx]);
-    tgVec.push_back(tgSlpData[idx]);
-    ++nPointsInVox;
-    ++nProcessed;
-  }
-  if (nPointsInVox) {
-    // process last voxel
-    VoxRes& resVox = secData[currVoxBin];
-    if (!getXBinIgnored(iSec, resVox.bvox[VoxX])) {
+      for (size_t i = range[1]; i < range[2]; ++i) {
+        int idx = binIndices[i];
+        dyVec.push_back(dyData[idx]);
+        tgVec.push_back(tgSlpData[idx]);
+      }
       processVoxelDispersions(tgVec, dyVec, resVox);
     }
   }
-  // smooth dispersions
+  // smooth dispersions, only the dispersion component of the voxels is modified here
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
   for (int ix = 0; ix < mNXBins; ++ix) {
     if (getXBinIgnored(iSec, ix)) {
       continue;
@@ -992,7 +1087,7 @@ void TrackResiduals::processSectorResiduals(int iSec)
     }
   }
   LOG(info) << "Done processing residuals for sector " << iSec;
-  dumpResults(iSec);
+  return true;
 }
 
 //______________________________________________________________________________
@@ -1184,6 +1279,23 @@ int TrackResiduals::validateVoxels(int iSec)
 void TrackResiduals::smooth(int iSec)
 {
   std::vector<VoxRes>& secData = mVoxelResults[iSec];
+  // the smoothing reads the flags of the neighbouring voxels, so the status is only updated once all voxels are done
+  std::vector<char> smoothOK(mNVoxPerSector, 0);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ix = 0; ix < mNXBins; ++ix) {
+    if (getXBinIgnored(iSec, ix)) {
+      continue;
+    }
+    for (int ip = 0; ip < mNY2XBins; ++ip) {
+      for (int iz = 0; iz < mNZ2XBins; ++iz) {
+        int voxBin = getGlbVoxBin(ix, ip, iz);
+        VoxRes& resVox = secData[voxBin];
+        smoothOK[voxBin] = getSmoothEstimate(resVox.bsec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, (0x1 << VoxX | 0x1 << VoxF | 0x1 << VoxZ));
+      }
+    }
+  }
   for (int ix = 0; ix < mNXBins; ++ix) {
     if (getXBinIgnored(iSec, ix)) {
       continue;
@@ -1193,8 +1305,7 @@ void TrackResiduals::smooth(int iSec)
         int voxBin = getGlbVoxBin(ix, ip, iz);
         VoxRes& resVox = secData[voxBin];
         resVox.flags &= ~SmoothDone;
-        bool res = getSmoothEstimate(resVox.bsec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, (0x1 << VoxX | 0x1 << VoxF | 0x1 << VoxZ));
-        if (!res) {
+        if (!smoothOK[voxBin]) {
           mNSmoothingFailedBins[iSec]++;
         } else {
           resVox.flags |= SmoothDone;
@@ -1267,9 +1378,10 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
   maxTrials[VoxX] = mMaxBadXBinsToCover * 2;
 
   std::array<int, VoxDim> trial{0};
+  std::array<double, ResDim * sMaxSmtDim> smoothingRes; // right hand side of the smoothing equations, holds the solution at the end
 
   while (true) {
-    std::fill(mLastSmoothingRes.begin(), mLastSmoothingRes.end(), 0);
+    std::fill(smoothingRes.begin(), smoothingRes.end(), 0);
     memset(&cmat[0][0], 0, sizeof(cmat));
 
     int nbOK = 0; // accounted neighbours
@@ -1455,7 +1567,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
           wi /= (voxNb->E[iDim] * voxNb->E[iDim]);
         }
         std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-        double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+        double* rhsD = &smoothingRes[iDim * sMaxSmtDim];
         unsigned short iMat = 0;
         unsigned short iRhs = 0;
         // linear part
@@ -1521,7 +1633,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
       }
       matrix.Zero(); // reset matrix
       std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-      double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+      double* rhsD = &smoothingRes[iDim * sMaxSmtDim];
       short iMat = -1;
       short iRhs = -1;
       short row = -1;
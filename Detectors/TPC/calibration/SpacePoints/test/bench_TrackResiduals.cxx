@@ -0,0 +1,77 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_TrackResiduals.cxx
+/// \brief Benchmark of the voxel residual processing using the in-memory local residuals
+
+#include "benchmark/benchmark.h"
+#include "SpacePoints/TrackResiduals.h"
+#include <fairlogger/Logger.h>
+#include <random>
+#include <thread>
+
+using namespace o2::tpc;
+
+// fill the in-memory containers with residuals following a smooth distortion pattern
+void fillResiduals(TrackResiduals& residuals, int nPointsPerSector)
+{
+  std::mt19937 gen(12345);
+  std::normal_distribution<float> gausY(0.f, 0.3f);
+  std::normal_distribution<float> gausZ(0.f, 0.2f);
+  std::uniform_real_distribution<float> flatTg(-0.5f, 0.5f);
+  std::uniform_int_distribution<int> binX(0, param::NPadRows - 1);
+  std::uniform_int_distribution<int> binF(0, param::NY2XBins - 1);
+  std::uniform_int_distribution<int> binZ(0, param::NZ2XBins - 1);
+  for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
+    auto& store = residuals.getLocalResidContainer(iSec);
+    store.clear();
+    store.reserve(nPointsPerSector);
+    for (int i = 0; i < nPointsPerSector; ++i) {
+      int ix = binX(gen), ip = binF(gen), iz = binZ(gen);
+      float tg = flatTg(gen);
+      float dx = 0.1f * ix / param::NPadRows;
+      float dy = 0.5f * ip / param::NY2XBins - dx * tg + gausY(gen);
+      float dz = 0.3f * iz / param::NZ2XBins + gausZ(gen);
+      store.push_back(static_cast<short>(dy * 0x7fff / param::MaxResid),
+                      static_cast<short>(dz * 0x7fff / param::MaxResid),
+                      static_cast<short>(tg * 0x7fff / param::MaxTgSlp),
+                      residuals.getGlbVoxBin(ix, ip, iz));
+    }
+  }
+}
+
+static void BM_ProcessResiduals(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  TrackResiduals residuals;
+  residuals.init();
+  residuals.setStoreLocalResidualsInMemory();
+  residuals.setNThreads(state.range(1));
+  fillResiduals(residuals, state.range(0));
+  for (auto _ : state) {
+    residuals.processResiduals();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * SECTORSPERSIDE * SIDES);
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (int nPoints : {100'000, 1'000'000}) {
+    for (int nThreads = 1; nThreads < maxThreads; nThreads *= 2) {
+      bench->Args({nPoints, nThreads});
+    }
+    bench->Args({nPoints, maxThreads});
+  }
+}
+
+BENCHMARK(BM_ProcessResiduals)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTrackResiduals.cxx
+/// \brief Check that the in-memory and parallel processing of the local residuals reproduce the serial processing of the residual trees
+
+#define BOOST_TEST_MODULE Test TPC TrackResiduals class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "SpacePoints/TrackResiduals.h"
+#include <fairlogger/Logger.h>
+#include "TFile.h"
+#include "TTree.h"
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace tpc
+{
+
+using LocalResid = TrackResiduals::LocalResid;
+
+// only a few sectors are filled to keep the test short, the others have no input
+const std::array<int, 2> Sectors{0, 21};
+const std::string LocalResFileName = "testTrackResiduals_deltasSect";
+
+// local residuals following a smooth distortion pattern
+std::vector<LocalResid> generateResiduals(int nPoints, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::normal_distribution<float> gausY(0.f, 0.3f);
+  std::normal_distribution<float> gausZ(0.f, 0.2f);
+  std::uniform_real_distribution<float> flatTg(-0.5f, 0.5f);
+  std::uniform_int_distribution<int> binX(0, param::NPadRows - 1);
+  std::uniform_int_distribution<int> binF(0, param::NY2XBins - 1);
+  std::uniform_int_distribution<int> binZ(0, param::NZ2XBins - 1);
+  std::vector<LocalResid> residuals(nPoints);
+  for (auto& res : residuals) {
+    int ix = binX(gen), ip = binF(gen), iz = binZ(gen);
+    float tg = flatTg(gen);
+    float dx = 0.1f * ix / param::NPadRows;
+    float dy = 0.5f * ip / param::NY2XBins - dx * tg + gausY(gen);
+    float dz = 0.3f * iz / param::NZ2XBins + gausZ(gen);
+    res.dy = static_cast<short>(dy * 0x7fff / param::MaxResid);
+    res.dz = static_cast<short>(dz * 0x7fff / param::MaxResid);
+    res.tgSlp = static_cast<short>(tg * 0x7fff / param::MaxTgSlp);
+    res.bvox[TrackResiduals::VoxX] = ix;
+    res.bvox[TrackResiduals::VoxF] = ip;
+    res.bvox[TrackResiduals::VoxZ] = iz;
+  }
+  return residuals;
+}
+
+// write the local residuals of a sector in the intermediate tree format read by TrackResiduals
+void writeResidualTree(const TrackResiduals& trackResiduals, int iSec, const std::vector<LocalResid>& residuals)
+{
+  TFile file((trackResiduals.getLocalResFileName() + std::to_string(iSec) + ".root").c_str(), "recreate");
+  TTree tree((trackResiduals.getLocalResTreeName() + std::to_string(iSec)).c_str(), "TPC local residuals");
+  LocalResid res;
+  auto* resPtr = &res;
+  tree.Branch(trackResiduals.getLocalResBranchName().c_str(), &resPtr);
+  for (const auto& r : residuals) {
+    res = r;
+    tree.Fill();
+  }
+  tree.Write();
+  file.Close();
+}
+
+std::unique_ptr<TrackResiduals> processResiduals(const std::vector<std::vector<LocalResid>>& residuals, bool inMemory, int nThreads)
+{
+  auto trackResiduals = std::make_unique<TrackResiduals>();
+  trackResiduals->init();
+  trackResiduals->setLocalResFileName(LocalResFileName);
+  trackResiduals->setMinEntriesPerVoxel(10);
+  trackResiduals->setNThreads(nThreads);
+  trackResiduals->setStoreLocalResidualsInMemory(inMemory);
+  for (size_t i = 0; i < Sectors.size(); ++i) {
+    if (inMemory) {
+      auto& store = trackResiduals->getLocalResidContainer(Sectors[i]);
+      for (const auto& r : residuals[i]) {
+        store.push_back(r.dy, r.dz, r.tgSlp, trackResiduals->getGlbVoxBin(r.bvox[TrackResiduals::VoxX], r.bvox[TrackResiduals::VoxF], r.bvox[TrackResiduals::VoxZ]));
+      }
+    } else {
+      writeResidualTree(*trackResiduals, Sectors[i], residuals[i]);
+    }
+  }
+  trackResiduals->processResiduals();
+  return trackResiduals;
+}
+
+void checkVoxelResults(const TrackResiduals& trackResiduals, const TrackResiduals& reference)
+{
+  int nProcessed = 0;
+  for (int iSec : Sectors) {
+    const auto& results = trackResiduals.getVoxelResults(iSec);
+    const auto& resultsRef = reference.getVoxelResults(iSec);
+    BOOST_REQUIRE_EQUAL(results.size(), resultsRef.size());
+    for (size_t iVox = 0; iVox < resultsRef.size(); ++iVox) {
+      const auto& res = results[iVox];
+      const auto& ref = resultsRef[iVox];
+      BOOST_CHECK(res.D == ref.D && res.E == ref.E && res.DS == ref.DS && res.DC == ref.DC);
+      BOOST_CHECK(res.EXYCorr == ref.EXYCorr && res.dYSigMAD == ref.dYSigMAD && res.dZSigLTM == ref.dZSigLTM);
+      BOOST_CHECK(res.stat == ref.stat && res.bvox == ref.bvox && res.bsec == ref.bsec && res.flags == ref.flags);
+      nProcessed += (ref.flags & TrackResiduals::DistDone) != 0;
+    }
+  }
+  BOOST_CHECK(nProcessed > 0);
+}
+
+BOOST_AUTO_TEST_CASE(TrackResiduals_InMemoryAndParallel)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  std::vector<std::vector<LocalResid>> residuals;
+  for (int iSec : Sectors) {
+    residuals.push_back(generateResiduals(200'000, 12345 + iSec));
+  }
+
+  // reference: serial processing of the intermediate trees
+  auto reference = processResiduals(residuals, false, 1);
+
+  checkVoxelResults(*processResiduals(residuals, true, 1), *reference);
+  for (int nThreads : {2, 4}) {
+    checkVoxelResults(*processResiduals(residuals, true, nThreads), *reference);
+    checkVoxelResults(*processResiduals(residuals, false, nThreads), *reference);
+  }
+}
+
+} // namespace tpc
+} // namespace o2
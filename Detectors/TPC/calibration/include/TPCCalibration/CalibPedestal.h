@@ -18,8 +18,10 @@
 #include <memory>
 
 #include "Rtypes.h"
+#include <gsl/span>
 
 #include "DataFormatsTPC/Defs.h"
+#include "DataFormatsTPC/Digit.h"
 #include "TPCBase/CalDet.h"
 #include "TPCBase/CRU.h"
 #include "TPCCalibration/CalibRawBase.h"
@@ -72,6 +74,20 @@ class CalibPedestal : public CalibRawBase
   Int_t updateCRU(const CRU& cru, const Int_t row, const Int_t pad,
                   const Int_t timeBin, const Float_t signal) final { return 0; }
 
+  /// bulk update function for a batch of decoded digits
+  ///
+  /// The ROC lookup is only done when the ROC changes between consecutive digits,
+  /// so digits should preferably be sorted by CRU.
+  /// \param digits digits to fill, the row is the global row in the sector
+  void fillDigits(const gsl::span<const Digit> digits);
+
+  /// merge the ADC value histograms of another pedestal calibration into this one
+  ///
+  /// The ADC range of both objects must be the same.
+  /// \param other calibration object to merge
+  /// \throw std::runtime_error if the ADC value histograms of a readout chamber have different sizes
+  void merge(const CalibPedestal* other);
+
   /// Reset pedestal data
   void resetData();
 
@@ -108,6 +124,12 @@ class CalibPedestal : public CalibRawBase
   /// return all pad clibrations as vector
   const std::vector<const o2::tpc::CalDet<float>*> getCalDets() const { return std::vector<const o2::tpc::CalDet<float>*>{&mPedestal, &mNoise}; }
 
+  /// Get the ADC value histograms of a readout chamber
+  ///
+  /// \param roc readout chamber
+  /// \return ADC values per pad, nullptr if no data was filled for this readout chamber
+  const vectorType* getADCData(ROC roc) const { return mADCdata[roc].get(); }
+
   /// Get the statistics type
   StatisticsType getStatisticsType() const { return mStatisticsType; }
 
@@ -11,11 +11,15 @@
 /// \file   CalibPedestal.cxx
 /// \author Jens Wiechula, Jens.Wiechula@ikf.uni-frankfurt.de
 
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include <fmt/format.h>
 
 #include "TH2F.h"
 #include "TFile.h"
 
+#include "Framework/Logger.h"
 #include "TPCBase/ROC.h"
 #include "MathUtils/fit.h"
 #include "TPCCalibration/CalibPedestal.h"
@@ -76,6 +80,66 @@ Int_t CalibPedestal::updateROC(const Int_t roc, const Int_t row, const Int_t pad
   return 0;
 }
 
+//______________________________________________________________________________
+void CalibPedestal::fillDigits(const gsl::span<const Digit> digits)
+{
+  const int nRowIROC = mMapper.getNumberOfRowsROC(0);
+  int lastCRU = -1;
+  int roc = 0;
+  int rowOffset = 0;
+  vectorType* adcVec = nullptr;
+  float* adcData = nullptr;
+
+  for (const auto& digit : digits) {
+    const int adcValue = digit.getCharge();
+    const int timeBin = digit.getTimeStamp();
+    if (timeBin < mFirstTimeBin || timeBin > mLastTimeBin) {
+      continue;
+    }
+    if (adcValue < mADCMin || adcValue > mADCMax) {
+      continue;
+    }
+
+    if (digit.getCRU() != lastCRU) {
+      lastCRU = digit.getCRU();
+      const CRU cru(lastCRU);
+      roc = cru.roc();
+      rowOffset = cru.isOROC() * nRowIROC;
+      adcVec = getVector(ROC(roc), kTRUE);
+      adcData = adcVec->data();
+    }
+
+    const GlobalPadNumber padInROC = mMapper.getPadNumberInROC(PadROCPos(roc, digit.getRow() - rowOffset, digit.getPad()));
+    ++adcData[padInROC * mNumberOfADCs + (adcValue - mADCMin)];
+  }
+}
+
+//______________________________________________________________________________
+void CalibPedestal::merge(const CalibPedestal* other)
+{
+  if (!other) {
+    return;
+  }
+  if ((other->mADCMin != mADCMin) || (other->mADCMax != mADCMax)) {
+    LOGP(error, "ADC ranges differ, cannot merge: [{}, {}] vs. [{}, {}]", mADCMin, mADCMax, other->mADCMin, other->mADCMax);
+    return;
+  }
+
+  for (size_t iroc = 0; iroc < other->mADCdata.size(); ++iroc) {
+    const auto otherVec = other->mADCdata[iroc].get();
+    if (!otherVec) {
+      continue;
+    }
+    auto& vec = *getVector(ROC(iroc), kTRUE);
+    if (vec.size() != otherVec->size()) {
+      throw std::runtime_error(fmt::format("ADC data sizes of ROC {} differ, cannot merge: {} vs. {}", iroc, vec.size(), otherVec->size()));
+    }
+    std::transform(vec.begin(), vec.end(), otherVec->begin(), vec.begin(), std::plus<float>());
+  }
+
+  mNevents += other->mNevents;
+}
+
 //______________________________________________________________________________
 CalibPedestal::vectorType* CalibPedestal::getVector(ROC roc, bool create /*=kFALSE*/)
 {
@@ -156,7 +220,8 @@ void CalibPedestal::resetData()
     if (!vec) {
       continue;
     }
-    vec->clear();
+    // keep the allocated memory, only reset the content
+    std::fill(vec->begin(), vec->end(), 0.f);
   }
 }
 
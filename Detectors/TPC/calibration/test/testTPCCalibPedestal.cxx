@@ -0,0 +1,134 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TPC CalibPedestal class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "DataFormatsTPC/Digit.h"
+#include "TPCBase/CRU.h"
+#include "TPCBase/Mapper.h"
+#include "TPCBase/ROC.h"
+#include "TPCBase/Sector.h"
+#include "TPCCalibration/CalibPedestal.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// random digits in a few sectors, partly outside of the default time bin and ADC ranges,
+/// not sorted by CRU to switch between readout chambers
+std::vector<Digit> generateDigits(size_t nDigits)
+{
+  const auto& mapper = Mapper::instance();
+  std::mt19937 gen(20210412);
+  std::uniform_int_distribution<int> sector(0, 3);
+  std::uniform_int_distribution<int> pad(0, Mapper::getPadsInSector() - 1);
+  std::uniform_int_distribution<int> timeBin(0, 600);
+  std::uniform_real_distribution<float> charge(0.f, 160.f);
+
+  std::vector<Digit> digits;
+  for (size_t i = 0; i < nDigits; ++i) {
+    const Sector sec(sector(gen) * 11);
+    const GlobalPadNumber globalPad = pad(gen);
+    const auto& padPos = mapper.padPos(globalPad);
+    digits.emplace_back(mapper.getCRU(sec, globalPad), charge(gen), padPos.getRow(), padPos.getPad(), timeBin(gen));
+  }
+  return digits;
+}
+
+/// fill the digits one by one with the per digit update function
+void fillDigitsWithUpdateROC(CalibPedestal& calib, const std::vector<Digit>& digits)
+{
+  const int nRowIROC = Mapper::instance().getNumberOfRowsROC(ROC(0));
+  for (const auto& digit : digits) {
+    const CRU cru(digit.getCRU());
+    calib.updateROC(cru.roc(), digit.getRow() - cru.isOROC() * nRowIROC, digit.getPad(), digit.getTimeStamp(), digit.getCharge());
+  }
+}
+
+void checkADCData(const CalibPedestal& calib, const CalibPedestal& reference)
+{
+  int nFilled = 0;
+  for (int iroc = 0; iroc < ROC::MaxROC; ++iroc) {
+    const ROC roc(iroc);
+    const auto data = calib.getADCData(roc);
+    const auto referenceData = reference.getADCData(roc);
+    BOOST_REQUIRE_EQUAL(data == nullptr, referenceData == nullptr);
+    if (!data) {
+      continue;
+    }
+    ++nFilled;
+    BOOST_REQUIRE_EQUAL(data->size(), referenceData->size());
+    BOOST_CHECK(*data == *referenceData);
+  }
+  BOOST_CHECK(nFilled > 0);
+}
+
+BOOST_AUTO_TEST_CASE(CalibPedestal_fillDigits)
+{
+  const auto digits = generateDigits(100000);
+
+  CalibPedestal calib;
+  calib.fillDigits(digits);
+
+  CalibPedestal reference;
+  fillDigitsWithUpdateROC(reference, digits);
+
+  checkADCData(calib, reference);
+}
+
+BOOST_AUTO_TEST_CASE(CalibPedestal_merge)
+{
+  const auto digits = generateDigits(100000);
+  const auto half = digits.size() / 2;
+
+  CalibPedestal calib;
+  calib.fillDigits(gsl::span<const Digit>(digits.data(), half));
+  calib.incrementNEvents();
+  calib.incrementNEvents();
+
+  CalibPedestal other;
+  other.fillDigits(gsl::span<const Digit>(digits.data() + half, digits.size() - half));
+  other.incrementNEvents();
+  other.incrementNEvents();
+  other.incrementNEvents();
+
+  CalibPedestal reference;
+  reference.fillDigits(digits);
+
+  calib.merge(&other);
+  checkADCData(calib, reference);
+  BOOST_CHECK_EQUAL(calib.getNumberOfProcessedEvents(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(CalibPedestal_mergeSizeMismatch)
+{
+  const auto digits = generateDigits(1000);
+
+  // the histograms are allocated with the ADC range set at the time of the first filling
+  CalibPedestal calib;
+  calib.fillDigits(digits);
+  calib.setADCRange(20, 100);
+
+  CalibPedestal other;
+  other.setADCRange(20, 100);
+  other.fillDigits(digits);
+
+  BOOST_CHECK_THROW(calib.merge(&other), std::runtime_error);
+}
+
+} // namespace tpc
+} // namespace o2
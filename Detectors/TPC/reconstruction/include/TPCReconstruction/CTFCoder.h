@@ -17,14 +17,17 @@
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <string>
 #include <cassert>
 #include <tuple>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 #include "DataFormatsTPC/CTF.h"
 #include "DataFormatsTPC/CompressedClusters.h"
+#include "DataFormatsTPC/Constants.h"
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "DetectorsBase/CTFCoderBase.h"
 #include "rANS/rans.h"
@@ -110,7 +113,13 @@ class CTFCoder : public o2::ctf::CTFCoderBase
   template <typename VEC>
   void decode(const CTF::base& ec, VEC& buff);
 
+  /// decode only the unattached clusters of the sub-block containing the requested sector of a CTF with chunked columns,
+  /// returns the range [first, last) of sectors decoded to buff
+  template <typename VEC>
+  std::pair<int, int> decodeSectors(const CTF::base& ec, int sector, VEC& buff);
+
   void createCoders(const std::string& dictPath, o2::ctf::CTFCoderBase::OpType op);
+  void createCoders(const CTF::container_t& ctf, o2::ctf::CTFCoderBase::OpType op);
   size_t estimateCompressedSize(const CompressedClusters& ccl);
 
   static size_t constexpr Alignment = 16;
@@ -138,9 +147,41 @@ class CTFCoder : public o2::ctf::CTFCoderBase
   bool getCombineColumns() const { return mCombineColumns; }
   void setCombineColumns(bool v) { mCombineColumns = v; }
 
+  /// number of independently decodable sub-blocks each column is split to, 1 for the single-block layout
+  int getNChunks() const { return mNChunks; }
+  void setNChunks(int n) { mNChunks = std::clamp(n, 1, int(CTFHeader::MaxChunks)); }
+
+  int getNThreads() const { return mNThreads; }
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+
  private:
+  /// ends (in elements) of the sub-blocks of the chunked columns, per type of column
+  struct ChunkBoundaries {
+    std::vector<size_t> attached;        // columns with nAttachedClusters elements
+    std::vector<size_t> attachedReduced; // columns with nAttachedClustersReduced elements
+    std::vector<size_t> tracks;          // columns with nTracks elements
+    std::vector<size_t> unattached;      // columns with nUnattachedClusters elements
+    const std::vector<size_t>& getEnds(CTF::Slots slot) const;
+  };
+
   void checkDataDictionaryConsistency(const CTFHeader& h);
 
+  static void getChunkBoundaries(const CompressedClusters& c, int nChunks, ChunkBoundaries& chunks);
+  static CompressedClusters getChunkView(const CompressedClusters& c, const ChunkBoundaries& chunks, int chunk);
+  void decodeChunks(const CTF::base& ec, const CompressedClusters& cc);
+
+  template <typename D_IT>
+  void decodeChunk(const CTF::base& ec, const ChunkBoundaries& chunks, int chunk, D_IT dest, CTF::Slots slot, const CTFCoder& storedDecoders) const;
+
+  template <typename F>
+  static void decodeAttachedColumns(const CompressedClusters& cc, bool combineColumns, F decodeTPC);
+
+  template <typename F>
+  static void decodeUnattachedColumns(const CompressedClusters& cc, bool combineColumns, F decodeTPC);
+
+  template <typename VEC>
+  static void setFlatBuffer(VEC& buffVec, CompressedClusters& cc);
+
   template <int NU, int NL, typename CU, typename CL>
   static void splitColumns(const std::vector<detail::combinedType_t<NU, NL>>& vm, CU*& vu, CL*& vl);
 
@@ -148,6 +189,8 @@ class CTFCoder : public o2::ctf::CTFCoderBase
   void buildCoder(ctf::CTFCoderBase::OpType coderType, const CTF::container_t& ctf, CTF::Slots slot);
 
   bool mCombineColumns = false; // combine correlated columns
+  int mNChunks = 1;             // number of sub-blocks per column at encoding
+  int mNThreads = 1;            // number of threads for decoding the sub-blocks
 
   ClassDefNV(CTFCoder, 1);
 };
@@ -155,6 +198,9 @@ class CTFCoder : public o2::ctf::CTFCoderBase
 template <typename source_T>
 void CTFCoder::buildCoder(ctf::CTFCoderBase::OpType coderType, const CTF::container_t& ctf, CTF::Slots slot)
 {
+  if (!ctf.getBlock(slot).getNDict()) { // nothing to build the coder from
+    return;
+  }
   auto buildFrequencyTable = [](const CTF::container_t& ctf, CTF::Slots slot) -> rans::FrequencyTable {
     rans::FrequencyTable frequencyTable;
     auto block = ctf.getBlock(slot);
@@ -211,14 +257,26 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
   if (mCombineColumns) {
     flags |= CTFHeader::CombinedColumns;
   }
-  ec->setHeader(CTFHeader{reinterpret_cast<const CompressedClustersCounters&>(ccl), flags});
+  CTFHeader header{reinterpret_cast<const CompressedClustersCounters&>(ccl), flags};
+  ChunkBoundaries chunks; // stays empty for the single-block layout
+  if (mNChunks > 1) {
+    header.flags |= CTFHeader::ChunkedColumns;
+    header.nChunks = mNChunks;
+    getChunkBoundaries(ccl, mNChunks, chunks);
+  }
+  ec->setHeader(header);
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
 
-  auto encodeTPC = [&buff, &optField, &coders = mCoders](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
+  auto encodeTPC = [&buff, &optField, &coders = mCoders, &chunks](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
     // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
     const auto slotVal = static_cast<int>(slot);
-    CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get());
+    const auto& chunkEnds = chunks.getEnds(slot);
+    if (chunkEnds.empty() || begin == end) {
+      CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get());
+    } else {
+      CTF::get(buff.data())->encodeChunks(begin, chunkEnds, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get());
+    }
   };
 
   if (mCombineColumns) {
@@ -283,6 +341,7 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 
   encodeTPC(ccl.nTrackClusters, ccl.nTrackClusters + ccl.nTracks, CTF::BLCnTrackClusters, 0);
   encodeTPC(ccl.nSliceRowClusters, ccl.nSliceRowClusters + ccl.nSliceRows, CTF::BLCnSliceRowClusters, 0);
+  CTF::get(buff.data())->setHeader(header); // with the sub-blocks index filled
   CTF::get(buff.data())->print(getPrefix());
 }
 
@@ -290,12 +349,84 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 template <typename VEC>
 void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 {
-  using namespace detail;
   CompressedClusters cc;
   CompressedClustersCounters& ccCount = cc;
   auto& header = ec.getHeader();
   checkDataDictionaryConsistency(header);
   ccCount = reinterpret_cast<const CompressedClustersCounters&>(header);
+  setFlatBuffer(buffVec, cc);
+  ec.print(getPrefix());
+
+  // decode encoded data directly to destination buff
+  auto decodeTPC = [&ec, &coders = mCoders](auto begin, CTF::Slots slot) {
+    const auto slotVal = static_cast<int>(slot);
+    ec.decode(begin, slotVal, coders[slotVal].get());
+  };
+
+  // the counters are never split, they define the boundaries of the sub-blocks of the other columns
+  decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
+  decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
+
+  if (header.flags & CTFHeader::ChunkedColumns) {
+    decodeChunks(ec, cc);
+  } else {
+    decodeAttachedColumns(cc, mCombineColumns, decodeTPC);
+    decodeUnattachedColumns(cc, mCombineColumns, decodeTPC);
+  }
+}
+
+/// decode the unattached clusters of the sector sub-block to TPC CompressedClusters with no attached clusters,
+/// nSliceRowClusters being set only for the decoded sectors
+template <typename VEC>
+std::pair<int, int> CTFCoder::decodeSectors(const CTF::base& ec, int sector, VEC& buffVec)
+{
+  auto& header = ec.getHeader();
+  if (!(header.flags & CTFHeader::ChunkedColumns)) {
+    throw std::runtime_error("Sectors can be decoded separately only from CTF with chunked columns");
+  }
+  if (sector < 0 || sector >= constants::MAXSECTOR) {
+    throw std::runtime_error("Wrong sector " + std::to_string(sector) + " requested");
+  }
+  checkDataDictionaryConsistency(header);
+
+  CompressedClusters ccAll;
+  CompressedClustersCounters& ccAllCount = ccAll;
+  ccAllCount = reinterpret_cast<const CompressedClustersCounters&>(header);
+  ccAll.nTracks = ccAll.nAttachedClusters = ccAll.nAttachedClustersReduced = 0;
+  std::vector<std::remove_pointer_t<decltype(ccAll.nSliceRowClusters)>> nSliceRowClusters(ccAll.nSliceRows);
+  ccAll.nSliceRowClusters = nSliceRowClusters.data();
+  ec.decode(ccAll.nSliceRowClusters, int(CTF::BLCnSliceRowClusters), mCoders[CTF::BLCnSliceRowClusters].get());
+  const int nChunks = header.nChunks;
+  ChunkBoundaries chunks;
+  getChunkBoundaries(ccAll, nChunks, chunks);
+
+  int chunk = 0;
+  while ((chunk + 1) * constants::MAXSECTOR / nChunks <= sector) {
+    chunk++;
+  }
+  const int firstSector = chunk * constants::MAXSECTOR / nChunks, lastSector = (chunk + 1) * constants::MAXSECTOR / nChunks;
+  const int nRowsSector = ccAll.nSliceRows / constants::MAXSECTOR;
+
+  CompressedClusters cc;
+  CompressedClustersCounters& ccCount = cc;
+  ccCount = ccAllCount;
+  cc.nUnattachedClusters = chunks.unattached[chunk] - (chunk ? chunks.unattached[chunk - 1] : 0);
+  setFlatBuffer(buffVec, cc);
+  std::fill(cc.nSliceRowClusters, cc.nSliceRowClusters + cc.nSliceRows, 0);
+  std::copy(nSliceRowClusters.begin() + firstSector * nRowsSector, nSliceRowClusters.begin() + lastSector * nRowsSector,
+            cc.nSliceRowClusters + firstSector * nRowsSector);
+  CTFCoder storedDecoders; // decoders of the dictionaries stored in the CTF
+  storedDecoders.createCoders(ec, o2::ctf::CTFCoderBase::OpType::Decoder);
+  decodeUnattachedColumns(cc, mCombineColumns, [this, &ec, &chunks, &storedDecoders, chunk](auto begin, CTF::Slots slot) {
+    decodeChunk(ec, chunks, chunk, begin, slot, storedDecoders);
+  });
+  return {firstSector, lastSector};
+}
+
+/// allocate in the buffVec the flat CompressedClusters with the counters of cc and set the cc addresses to its payload
+template <typename VEC>
+void CTFCoder::setFlatBuffer(VEC& buffVec, CompressedClusters& cc)
+{
   CompressedClustersFlat* ccFlat = nullptr;
   size_t sizeCFlatBody = alignSize(ccFlat);
   size_t sz = sizeCFlatBody + estimateSize(cc);                                             // total size of the buffVec accounting for the alignment
@@ -306,15 +437,23 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   setCompClusAddresses(cc, buff);
   ccFlat->set(sz, cc); // set offsets
-  ec.print(getPrefix());
+}
 
-  // decode encoded data directly to destination buff
-  auto decodeTPC = [&ec, &coders = mCoders](auto begin, CTF::Slots slot) {
-    const auto slotVal = static_cast<int>(slot);
-    ec.decode(begin, slotVal, coders[slotVal].get());
-  };
+/// decode the sub-block chunk of the column at slot to dest, with the decoder of the dictionary stored in the CTF if any
+template <typename D_IT>
+void CTFCoder::decodeChunk(const CTF::base& ec, const ChunkBoundaries& chunks, int chunk, D_IT dest, CTF::Slots slot, const CTFCoder& storedDecoders) const
+{
+  const auto slotVal = static_cast<int>(slot);
+  const auto& ends = chunks.getEnds(slot);
+  const auto& decoder = storedDecoders.mCoders[slotVal] ? storedDecoders.mCoders[slotVal] : mCoders[slotVal];
+  size_t first = chunk ? ends[chunk - 1] : 0;
+  ec.decodeChunk(dest, slotVal, chunk, ends.size(), first, ends[chunk] - first, decoder.get());
+}
 
-  if (mCombineColumns) {
+template <typename F>
+void CTFCoder::decodeAttachedColumns(const CompressedClusters& cc, bool combineColumns, F decodeTPC)
+{
+  if (combineColumns) {
     detail::MergedColumnsDecoder<CTF::NBitsQTot, CTF::NBitsQMax>::decode(cc.qTotA, cc.qMaxA, CTF::BLCqTotA, decodeTPC);
   } else {
     decodeTPC(cc.qTotA, CTF::BLCqTotA);
@@ -323,7 +462,7 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   decodeTPC(cc.flagsA, CTF::BLCflagsA);
 
-  if (mCombineColumns) {
+  if (combineColumns) {
     detail::MergedColumnsDecoder<CTF::NBitsRowDiff, CTF::NBitsSliceLegDiff>::decode(cc.rowDiffA, cc.sliceLegDiffA, CTF::BLCrowDiffA, decodeTPC);
   } else {
     decodeTPC(cc.rowDiffA, CTF::BLCrowDiffA);
@@ -333,7 +472,7 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   decodeTPC(cc.padResA, CTF::BLCpadResA);
   decodeTPC(cc.timeResA, CTF::BLCtimeResA);
 
-  if (mCombineColumns) {
+  if (combineColumns) {
     detail::MergedColumnsDecoder<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>::decode(cc.sigmaPadA, cc.sigmaTimeA, CTF::BLCsigmaPadA, decodeTPC);
   } else {
     decodeTPC(cc.sigmaPadA, CTF::BLCsigmaPadA);
@@ -345,8 +484,12 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   decodeTPC(cc.sliceA, CTF::BLCsliceA);
   decodeTPC(cc.timeA, CTF::BLCtimeA);
   decodeTPC(cc.padA, CTF::BLCpadA);
+}
 
-  if (mCombineColumns) {
+template <typename F>
+void CTFCoder::decodeUnattachedColumns(const CompressedClusters& cc, bool combineColumns, F decodeTPC)
+{
+  if (combineColumns) {
     detail::MergedColumnsDecoder<CTF::NBitsQTot, CTF::NBitsQMax>::decode(cc.qTotU, cc.qMaxU, CTF::BLCqTotU, decodeTPC);
   } else {
     decodeTPC(cc.qTotU, CTF::BLCqTotU);
@@ -357,15 +500,12 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   decodeTPC(cc.padDiffU, CTF::BLCpadDiffU);
   decodeTPC(cc.timeDiffU, CTF::BLCtimeDiffU);
 
-  if (mCombineColumns) {
+  if (combineColumns) {
     detail::MergedColumnsDecoder<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>::decode(cc.sigmaPadU, cc.sigmaTimeU, CTF::BLCsigmaPadU, decodeTPC);
   } else {
     decodeTPC(cc.sigmaPadU, CTF::BLCsigmaPadU);
     decodeTPC(cc.sigmaTimeU, CTF::BLCsigmaTimeU);
   }
-
-  decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
-  decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
 }
 
 } // namespace tpc
@@ -15,6 +15,10 @@
 #include "TPCReconstruction/CTFCoder.h"
 #include <fmt/format.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::tpc;
 
 /// estimate size needed to store in the flat buffer the payload of the CompressedClusters (here only the counters are used)
@@ -91,8 +95,6 @@ void CTFCoder::setCompClusAddresses(CompressedClusters& c, void*& buff)
 ///________________________________
 void CTFCoder::createCoders(const std::string& dictPath, o2::ctf::CTFCoderBase::OpType op)
 {
-  using namespace detail;
-
   bool mayFail = true; // RS FIXME if the dictionary file is not there, do not produce exception
   auto buff = readDictionaryFromFile<CTF>(dictPath, mayFail);
   if (!buff.size()) {
@@ -104,52 +106,60 @@ void CTFCoder::createCoders(const std::string& dictPath, o2::ctf::CTFCoderBase::
   const CTF::container_t* ctf = CTF::get(buff.data());
   mCombineColumns = ctf->getHeader().flags & CTFHeader::CombinedColumns;
   LOG(INFO) << "TPC CTF Columns Combining " << (mCombineColumns ? "ON" : "OFF");
+  createCoders(*ctf, op);
+}
 
+///________________________________
+/// create the coders from the dictionaries stored in the ctf, leaving empty those of the blocks without dictionary
+void CTFCoder::createCoders(const CTF::container_t& ctf, o2::ctf::CTFCoderBase::OpType op)
+{
+  using namespace detail;
+  const bool combineColumns = ctf.getHeader().flags & CTFHeader::CombinedColumns;
   const CompressedClusters cc; // just to get member types
-  if (mCombineColumns) {
-    buildCoder<combinedType_t<CTF::NBitsQTot, CTF::NBitsQMax>>(op, *ctf, CTF::BLCqTotA);
+  if (combineColumns) {
+    buildCoder<combinedType_t<CTF::NBitsQTot, CTF::NBitsQMax>>(op, ctf, CTF::BLCqTotA);
   } else {
-    buildCoder<std::remove_pointer_t<decltype(cc.qTotA)>>(op, *ctf, CTF::BLCqTotA);
+    buildCoder<std::remove_pointer_t<decltype(cc.qTotA)>>(op, ctf, CTF::BLCqTotA);
   }
-  buildCoder<std::remove_pointer_t<decltype(cc.qMaxA)>>(op, *ctf, CTF::BLCqMaxA);
-  buildCoder<std::remove_pointer_t<decltype(cc.flagsA)>>(op, *ctf, CTF::BLCflagsA);
-  if (mCombineColumns) {
-    buildCoder<combinedType_t<CTF::NBitsRowDiff, CTF::NBitsSliceLegDiff>>(op, *ctf, CTF::BLCrowDiffA); // merged rowDiffA and sliceLegDiffA
+  buildCoder<std::remove_pointer_t<decltype(cc.qMaxA)>>(op, ctf, CTF::BLCqMaxA);
+  buildCoder<std::remove_pointer_t<decltype(cc.flagsA)>>(op, ctf, CTF::BLCflagsA);
+  if (combineColumns) {
+    buildCoder<combinedType_t<CTF::NBitsRowDiff, CTF::NBitsSliceLegDiff>>(op, ctf, CTF::BLCrowDiffA); // merged rowDiffA and sliceLegDiffA
 
   } else {
-    buildCoder<std::remove_pointer_t<decltype(cc.rowDiffA)>>(op, *ctf, CTF::BLCrowDiffA);
+    buildCoder<std::remove_pointer_t<decltype(cc.rowDiffA)>>(op, ctf, CTF::BLCrowDiffA);
   }
-  buildCoder<std::remove_pointer_t<decltype(cc.sliceLegDiffA)>>(op, *ctf, CTF::BLCsliceLegDiffA);
-  buildCoder<std::remove_pointer_t<decltype(cc.padResA)>>(op, *ctf, CTF::BLCpadResA);
-  buildCoder<std::remove_pointer_t<decltype(cc.timeResA)>>(op, *ctf, CTF::BLCtimeResA);
-  if (mCombineColumns) {
-    buildCoder<combinedType_t<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>>(op, *ctf, CTF::BLCsigmaPadA); // merged sigmaPadA and sigmaTimeA
+  buildCoder<std::remove_pointer_t<decltype(cc.sliceLegDiffA)>>(op, ctf, CTF::BLCsliceLegDiffA);
+  buildCoder<std::remove_pointer_t<decltype(cc.padResA)>>(op, ctf, CTF::BLCpadResA);
+  buildCoder<std::remove_pointer_t<decltype(cc.timeResA)>>(op, ctf, CTF::BLCtimeResA);
+  if (combineColumns) {
+    buildCoder<combinedType_t<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>>(op, ctf, CTF::BLCsigmaPadA); // merged sigmaPadA and sigmaTimeA
   } else {
-    buildCoder<std::remove_pointer_t<decltype(cc.sigmaPadA)>>(op, *ctf, CTF::BLCsigmaPadA);
+    buildCoder<std::remove_pointer_t<decltype(cc.sigmaPadA)>>(op, ctf, CTF::BLCsigmaPadA);
   }
-  buildCoder<std::remove_pointer_t<decltype(cc.sigmaTimeA)>>(op, *ctf, CTF::BLCsigmaTimeA);
-  buildCoder<std::remove_pointer_t<decltype(cc.qPtA)>>(op, *ctf, CTF::BLCqPtA);
-  buildCoder<std::remove_pointer_t<decltype(cc.rowA)>>(op, *ctf, CTF::BLCrowA);
-  buildCoder<std::remove_pointer_t<decltype(cc.sliceA)>>(op, *ctf, CTF::BLCsliceA);
-  buildCoder<std::remove_pointer_t<decltype(cc.timeA)>>(op, *ctf, CTF::BLCtimeA);
-  buildCoder<std::remove_pointer_t<decltype(cc.padA)>>(op, *ctf, CTF::BLCpadA);
-  if (mCombineColumns) {
-    buildCoder<combinedType_t<CTF::NBitsQTot, CTF::NBitsQMax>>(op, *ctf, CTF::BLCqTotU); // merged qTotU and qMaxU
+  buildCoder<std::remove_pointer_t<decltype(cc.sigmaTimeA)>>(op, ctf, CTF::BLCsigmaTimeA);
+  buildCoder<std::remove_pointer_t<decltype(cc.qPtA)>>(op, ctf, CTF::BLCqPtA);
+  buildCoder<std::remove_pointer_t<decltype(cc.rowA)>>(op, ctf, CTF::BLCrowA);
+  buildCoder<std::remove_pointer_t<decltype(cc.sliceA)>>(op, ctf, CTF::BLCsliceA);
+  buildCoder<std::remove_pointer_t<decltype(cc.timeA)>>(op, ctf, CTF::BLCtimeA);
+  buildCoder<std::remove_pointer_t<decltype(cc.padA)>>(op, ctf, CTF::BLCpadA);
+  if (combineColumns) {
+    buildCoder<combinedType_t<CTF::NBitsQTot, CTF::NBitsQMax>>(op, ctf, CTF::BLCqTotU); // merged qTotU and qMaxU
   } else {
-    buildCoder<std::remove_pointer_t<decltype(cc.qTotU)>>(op, *ctf, CTF::BLCqTotU);
+    buildCoder<std::remove_pointer_t<decltype(cc.qTotU)>>(op, ctf, CTF::BLCqTotU);
   }
-  buildCoder<std::remove_pointer_t<decltype(cc.qMaxU)>>(op, *ctf, CTF::BLCqMaxU);
-  buildCoder<std::remove_pointer_t<decltype(cc.flagsU)>>(op, *ctf, CTF::BLCflagsU);
-  buildCoder<std::remove_pointer_t<decltype(cc.padDiffU)>>(op, *ctf, CTF::BLCpadDiffU);
-  buildCoder<std::remove_pointer_t<decltype(cc.timeDiffU)>>(op, *ctf, CTF::BLCtimeDiffU);
-  if (mCombineColumns) {
-    buildCoder<combinedType_t<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>>(op, *ctf, CTF::BLCsigmaPadU); // merged sigmaPadU and sigmaTimeU
+  buildCoder<std::remove_pointer_t<decltype(cc.qMaxU)>>(op, ctf, CTF::BLCqMaxU);
+  buildCoder<std::remove_pointer_t<decltype(cc.flagsU)>>(op, ctf, CTF::BLCflagsU);
+  buildCoder<std::remove_pointer_t<decltype(cc.padDiffU)>>(op, ctf, CTF::BLCpadDiffU);
+  buildCoder<std::remove_pointer_t<decltype(cc.timeDiffU)>>(op, ctf, CTF::BLCtimeDiffU);
+  if (combineColumns) {
+    buildCoder<combinedType_t<CTF::NBitsSigmaPad, CTF::NBitsSigmaTime>>(op, ctf, CTF::BLCsigmaPadU); // merged sigmaPadU and sigmaTimeU
   } else {
-    buildCoder<std::remove_pointer_t<decltype(cc.sigmaPadU)>>(op, *ctf, CTF::BLCsigmaPadU);
+    buildCoder<std::remove_pointer_t<decltype(cc.sigmaPadU)>>(op, ctf, CTF::BLCsigmaPadU);
   }
-  buildCoder<std::remove_pointer_t<decltype(cc.sigmaTimeU)>>(op, *ctf, CTF::BLCsigmaTimeU);
-  buildCoder<std::remove_pointer_t<decltype(cc.nTrackClusters)>>(op, *ctf, CTF::BLCnTrackClusters);
-  buildCoder<std::remove_pointer_t<decltype(cc.nSliceRowClusters)>>(op, *ctf, CTF::BLCnSliceRowClusters);
+  buildCoder<std::remove_pointer_t<decltype(cc.sigmaTimeU)>>(op, ctf, CTF::BLCsigmaTimeU);
+  buildCoder<std::remove_pointer_t<decltype(cc.nTrackClusters)>>(op, ctf, CTF::BLCnTrackClusters);
+  buildCoder<std::remove_pointer_t<decltype(cc.nSliceRowClusters)>>(op, ctf, CTF::BLCnSliceRowClusters);
 }
 
 /// make sure loaded dictionaries (if any) are consistent with data
@@ -203,3 +213,129 @@ size_t CTFCoder::estimateCompressedSize(const CompressedClusters& ccl)
   LOG(INFO) << "Estimated output size is " << sz << " bytes";
   return sz;
 }
+
+///________________________________
+const std::vector<size_t>& CTFCoder::ChunkBoundaries::getEnds(CTF::Slots slot) const
+{
+  static const std::vector<size_t> NoChunks{};
+  switch (slot) {
+    case CTF::BLCqTotA:
+    case CTF::BLCqMaxA:
+    case CTF::BLCflagsA:
+    case CTF::BLCsigmaPadA:
+    case CTF::BLCsigmaTimeA:
+      return attached;
+    case CTF::BLCrowDiffA:
+    case CTF::BLCsliceLegDiffA:
+    case CTF::BLCpadResA:
+    case CTF::BLCtimeResA:
+      return attachedReduced;
+    case CTF::BLCqPtA:
+    case CTF::BLCrowA:
+    case CTF::BLCsliceA:
+    case CTF::BLCtimeA:
+    case CTF::BLCpadA:
+      return tracks;
+    case CTF::BLCqTotU:
+    case CTF::BLCqMaxU:
+    case CTF::BLCflagsU:
+    case CTF::BLCpadDiffU:
+    case CTF::BLCtimeDiffU:
+    case CTF::BLCsigmaPadU:
+    case CTF::BLCsigmaTimeU:
+      return unattached;
+    default: // counters are never split
+      return NoChunks;
+  }
+}
+
+///________________________________
+/// sub-block i holds the clusters of the tracks [i*nTracks/nChunks, (i+1)*nTracks/nChunks) for the attached columns and
+/// the clusters of the sectors [i*36/nChunks, (i+1)*36/nChunks) for the unattached ones, the unattached clusters being
+/// ordered by sector and row as nSliceRowClusters
+void CTFCoder::getChunkBoundaries(const CompressedClusters& c, int nChunks, ChunkBoundaries& chunks)
+{
+  chunks.attached.resize(nChunks);
+  chunks.attachedReduced.resize(nChunks);
+  chunks.tracks.resize(nChunks);
+  chunks.unattached.resize(nChunks);
+  size_t nAttached = 0, nAttachedReduced = 0, nUnattached = 0;
+  unsigned int track = 0, sliceRow = 0;
+  const unsigned int nRowsSector = c.nSliceRows / constants::MAXSECTOR;
+  for (int ic = 0; ic < nChunks; ic++) {
+    unsigned int trackEnd = (ic + 1) * size_t(c.nTracks) / nChunks;
+    for (; track < trackEnd; track++) {
+      nAttached += c.nTrackClusters[track];
+      nAttachedReduced += c.nTrackClusters[track] - 1;
+    }
+    unsigned int sliceRowEnd = ic + 1 == nChunks ? c.nSliceRows : (ic + 1) * constants::MAXSECTOR / nChunks * nRowsSector;
+    for (; sliceRow < sliceRowEnd; sliceRow++) {
+      nUnattached += c.nSliceRowClusters[sliceRow];
+    }
+    chunks.tracks[ic] = trackEnd;
+    chunks.attached[ic] = nAttached;
+    chunks.attachedReduced[ic] = nAttachedReduced;
+    chunks.unattached[ic] = nUnattached;
+  }
+  if (nAttached != c.nAttachedClusters || nAttachedReduced != c.nAttachedClustersReduced || nUnattached != c.nUnattachedClusters) {
+    throw std::runtime_error(fmt::format("Clusters counted in nTrackClusters and nSliceRowClusters: {:d} attached, {:d} reduced, {:d} unattached, "
+                                         "differ from counters: {:d} attached, {:d} reduced, {:d} unattached",
+                                         nAttached, nAttachedReduced, nUnattached, c.nAttachedClusters, c.nAttachedClustersReduced, c.nUnattachedClusters));
+  }
+}
+
+///________________________________
+/// CompressedClusters with the addresses of the chunked columns pointing to the first element of the sub-block
+CompressedClusters CTFCoder::getChunkView(const CompressedClusters& c, const ChunkBoundaries& chunks, int chunk)
+{
+  CompressedClusters v = c;
+  if (!chunk) {
+    return v;
+  }
+  if (c.nAttachedClusters) {
+    const size_t attached = chunks.attached[chunk - 1], reduced = chunks.attachedReduced[chunk - 1], tracks = chunks.tracks[chunk - 1];
+    v.qTotA += attached;
+    v.qMaxA += attached;
+    v.flagsA += attached;
+    v.rowDiffA += reduced;
+    v.sliceLegDiffA += reduced;
+    v.padResA += reduced;
+    v.timeResA += reduced;
+    v.sigmaPadA += attached;
+    v.sigmaTimeA += attached;
+    v.qPtA += tracks;
+    v.rowA += tracks;
+    v.sliceA += tracks;
+    v.timeA += tracks;
+    v.padA += tracks;
+  }
+  const size_t unattached = chunks.unattached[chunk - 1];
+  v.qTotU += unattached;
+  v.qMaxU += unattached;
+  v.flagsU += unattached;
+  v.padDiffU += unattached;
+  v.timeDiffU += unattached;
+  v.sigmaPadU += unattached;
+  v.sigmaTimeU += unattached;
+  return v;
+}
+
+///________________________________
+/// decode the chunked columns of the CTF, the sub-blocks being decoded in parallel
+void CTFCoder::decodeChunks(const CTF::base& ec, const CompressedClusters& cc)
+{
+  const int nChunks = ec.getHeader().nChunks;
+  ChunkBoundaries chunks;
+  getChunkBoundaries(cc, nChunks, chunks);
+  CTFCoder storedDecoders; // decoders of the dictionaries stored in the CTF, built once for all sub-blocks
+  storedDecoders.createCoders(ec, o2::ctf::CTFCoderBase::OpType::Decoder);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ic = 0; ic < nChunks; ic++) {
+    auto decodeTPC = [this, &ec, &chunks, &storedDecoders, ic](auto begin, CTF::Slots slot) { decodeChunk(ec, chunks, ic, begin, slot, storedDecoders); };
+    auto ccChunk = getChunkView(cc, chunks, ic);
+    decodeAttachedColumns(ccChunk, mCombineColumns, decodeTPC);
+    decodeUnattachedColumns(ccChunk, mCombineColumns, decodeTPC);
+  }
+}
@@ -0,0 +1,131 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_CTFCoder.cxx
+/// \brief Benchmark of the TPC CTF compression and decoding with single-block and chunked columns
+
+#include "benchmark/benchmark.h"
+#include "TPCReconstruction/CTFCoder.h"
+#include <fairlogger/Logger.h>
+#include <random>
+#include <thread>
+
+using namespace o2::tpc;
+
+// generate the compressed clusters of nTracks tracks and of as many unattached clusters as attached ones,
+// with values distributed roughly as those of the real data
+void generateClusters(CompressedClusters& c, std::vector<char>& buffer, int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::poisson_distribution<int> nClusTrack(80);
+  std::geometric_distribution<int> charge(0.02), res(0.1), sigma(0.2), diff(0.01);
+  std::uniform_int_distribution<int> flat(0, 1 << 16);
+
+  c.nTracks = nTracks;
+  c.nAttachedClusters = c.nAttachedClustersReduced = c.nUnattachedClusters = 0;
+  std::vector<int> nTrackClusters(c.nTracks), nSliceRowClusters(c.nSliceRows);
+  for (auto& n : nTrackClusters) {
+    n = 1 + std::min(nClusTrack(gen), 151);
+    c.nAttachedClusters += n;
+    c.nAttachedClustersReduced += n - 1;
+  }
+  const double unattachedPerRow = double(c.nAttachedClusters) / c.nSliceRows;
+  std::poisson_distribution<int> nUnattached(unattachedPerRow);
+  for (auto& n : nSliceRowClusters) {
+    n = nUnattached(gen);
+    c.nUnattachedClusters += n;
+  }
+
+  CompressedClustersFlat* ccFlat = nullptr;
+  size_t sizeCFlatBody = CTFCoder::alignSize(ccFlat);
+  size_t sz = sizeCFlatBody + CTFCoder::estimateSize(c);
+  buffer.resize(sz);
+  ccFlat = reinterpret_cast<CompressedClustersFlat*>(buffer.data());
+  auto buff = reinterpret_cast<void*>(buffer.data() + sizeCFlatBody);
+  CTFCoder::setCompClusAddresses(c, buff);
+  ccFlat->set(sz, c);
+
+  for (unsigned int i = 0; i < c.nAttachedClusters; i++) {
+    c.qTotA[i] = std::min(charge(gen), (1 << CTF::NBitsQTot) - 1);
+    c.qMaxA[i] = std::min(charge(gen) / 4, (1 << CTF::NBitsQMax) - 1);
+    c.flagsA[i] = flat(gen) % 16 ? 0 : 1;
+    c.sigmaPadA[i] = std::min(sigma(gen), (1 << CTF::NBitsSigmaPad) - 1);
+    c.sigmaTimeA[i] = std::min(sigma(gen), (1 << CTF::NBitsSigmaTime) - 1);
+  }
+  for (unsigned int i = 0; i < c.nAttachedClustersReduced; i++) {
+    c.rowDiffA[i] = 1 + flat(gen) % 3;
+    c.sliceLegDiffA[i] = flat(gen) % 64 ? 0 : 1;
+    c.padResA[i] = res(gen);
+    c.timeResA[i] = res(gen);
+  }
+  for (unsigned int i = 0; i < c.nTracks; i++) {
+    c.qPtA[i] = flat(gen) % 256;
+    c.rowA[i] = flat(gen) % 152;
+    c.sliceA[i] = flat(gen) % 36;
+    c.timeA[i] = flat(gen);
+    c.padA[i] = flat(gen) % 140;
+    c.nTrackClusters[i] = nTrackClusters[i];
+  }
+  for (unsigned int i = 0; i < c.nUnattachedClusters; i++) {
+    c.qTotU[i] = std::min(charge(gen), (1 << CTF::NBitsQTot) - 1);
+    c.qMaxU[i] = std::min(charge(gen) / 4, (1 << CTF::NBitsQMax) - 1);
+    c.flagsU[i] = flat(gen) % 16 ? 0 : 1;
+    c.padDiffU[i] = diff(gen);
+    c.timeDiffU[i] = diff(gen) * 8;
+    c.sigmaPadU[i] = std::min(sigma(gen), (1 << CTF::NBitsSigmaPad) - 1);
+    c.sigmaTimeU[i] = std::min(sigma(gen), (1 << CTF::NBitsSigmaTime) - 1);
+  }
+  for (unsigned int i = 0; i < c.nSliceRows; i++) {
+    c.nSliceRowClusters[i] = nSliceRowClusters[i];
+  }
+}
+
+static void BM_CTFDecode(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  CompressedClusters clusters;
+  std::vector<char> flat;
+  generateClusters(clusters, flat, 20000);
+
+  std::vector<o2::ctf::BufferType> vecIO;
+  CTFCoder encoder;
+  encoder.setCombineColumns(true);
+  encoder.setNChunks(state.range(0));
+  encoder.encode(vecIO, clusters);
+  auto ctf = CTF::get(vecIO.data());
+  ctf->compactify();
+  vecIO.resize(ctf->size());
+
+  CTFCoder decoder;
+  decoder.setNThreads(state.range(1));
+  std::vector<char> decoded;
+  for (auto _ : state) {
+    decoder.decode(*CTF::get(vecIO.data()), decoded);
+  }
+  state.counters["encodedBytes"] = vecIO.size() * sizeof(o2::ctf::BufferType);
+  state.counters["compressionRatio"] = double(flat.size()) / (vecIO.size() * sizeof(o2::ctf::BufferType));
+  state.SetBytesProcessed(state.iterations() * flat.size());
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  bench->Args({1, 1});
+  for (int nChunks : {6, 36}) {
+    for (int nThreads = 1; nThreads < maxThreads; nThreads *= 2) {
+      bench->Args({nChunks, nThreads});
+    }
+    bench->Args({nChunks, maxThreads});
+  }
+}
+
+BENCHMARK(BM_CTFDecode)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
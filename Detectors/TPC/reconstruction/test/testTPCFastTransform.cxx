@@ -196,5 +196,51 @@ BOOST_AUTO_TEST_CASE(FastTransform_test_setSpaceChargeCorrection)
   BOOST_CHECK_MESSAGE(fabs(maxDeviation) < 1.e-2, "test of inverse correction map failed, max difference " << maxDeviation << " cm is too large");
 }
 
+BOOST_AUTO_TEST_CASE(FastTransform_test_batch)
+{
+  auto correction = [](int roc, const double XYZ[3], double dXdYdZ[3]) {
+    dXdYdZ[0] = 0.5 + 0.01 * XYZ[1];
+    dXdYdZ[1] = -0.3 + 0.002 * XYZ[0];
+    dXdYdZ[2] = 0.2 + 0.001 * XYZ[2] + 0.0001 * XYZ[0] * XYZ[1];
+  };
+  TPCFastTransformHelperO2::instance()->setSpaceChargeCorrection(correction);
+  std::unique_ptr<TPCFastTransform> fastTransform(TPCFastTransformHelperO2::instance()->create(0));
+  const TPCFastTransformGeo& geo = fastTransform->getGeometry();
+
+  // the batch transformation must be bit-identical to the cluster-by-cluster one
+  std::vector<float> pad, time, x, y, z;
+  for (int applyCorrection = 0; applyCorrection < 2; applyCorrection++) {
+    if (applyCorrection) {
+      fastTransform->setApplyCorrectionOn();
+    } else {
+      fastTransform->setApplyCorrectionOff();
+    }
+    int nDiff = 0;
+    for (int slice = 0; slice < geo.getNumberOfSlices(); slice += 5) {
+      float lastTimeBin = fastTransform->getMaxDriftTime(slice, 0.f);
+      for (int row = 0; row < geo.getNumberOfRows(); row += 7) {
+        float maxPad = geo.getRowInfo(row).maxPad;
+        pad.clear();
+        time.clear();
+        for (int i = 0; i < 1000; i++) { // clusters not ordered in pad and time, some outside of the row
+          pad.push_back(-1.f + (maxPad + 2.f) * ((i * 37) % 1000) / 1000.f);
+          time.push_back(-10.f + (lastTimeBin + 20.f) * ((i * 91) % 1000) / 1000.f);
+        }
+        int n = pad.size();
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        fastTransform->Transform(slice, row, n, pad.data(), time.data(), x.data(), y.data(), z.data(), 1.f);
+        for (int i = 0; i < n; i++) {
+          float xs, ys, zs;
+          fastTransform->Transform(slice, row, pad[i], time[i], xs, ys, zs, 1.f);
+          nDiff += (xs != x[i]) || (ys != y[i]) || (zs != z[i]);
+        }
+      }
+    }
+    BOOST_CHECK_MESSAGE(nDiff == 0, nDiff << " clusters differ between batch and single cluster transformation, correction " << applyCorrection);
+  }
+}
+
 } // namespace tpc
 } // namespace o2
@@ -21,12 +21,14 @@
 #include "DataFormatsTPC/TPCSectorHeader.h"
 #include <memory> // for make_shared, make_unique, unique_ptr
 #include <array>
+#include <algorithm>
 #include <vector>
 #include <utility>   // std::move
 #include <stdexcept> //std::invalid_argument
 #include <TFile.h>
 #include <TTree.h>
 #include <TBranch.h>
+#include <TROOT.h>
 
 using namespace o2::framework;
 using namespace o2::header;
@@ -69,6 +71,8 @@ DataProcessorSpec createPublisherSpec(PublisherConf const& config, bool propagat
     auto mcbrName = ic.options().get<std::string>(config.mcbranch.option.c_str());
     auto nofEvents = ic.options().get<int>("nevents");
     auto publishingMode = nofEvents == -1 ? RootTreeReader::PublishingMode::Single : RootTreeReader::PublishingMode::Loop;
+    auto nPrefetch = std::max(0, ic.options().get<int>("prefetch"));
+    auto cacheSize = std::max(0, ic.options().get<int>("cache-size-mb"));
 
     // do a runtime check if the branch name without sector number suffix is found in the file
     // if found the publisher will publish the single data set at one output route and empty
@@ -140,6 +144,10 @@ DataProcessorSpec createPublisherSpec(PublisherConf const& config, bool propagat
                                   clusterbranchname.c_str(), // name of data branch
                                   mcbranchname.c_str(),      // name of mc label branch
                                   config.hook);
+        if (cacheSize > 0) {
+          readers[sector]->setCacheSize(Long64_t(cacheSize) * 1024 * 1024, ROOT::IsImplicitMTEnabled());
+        }
+        readers[sector]->setPrefetching(nPrefetch);
         if (sectorMode == SectorMode::Full) {
           break;
         }
@@ -241,6 +249,8 @@ DataProcessorSpec createPublisherSpec(PublisherConf const& config, bool propagat
                              {mcb.option.c_str(), VariantType::String, mcb.defval.c_str(), {mcb.help.c_str()}},
                              {"nevents", VariantType::Int, -1, {"number of events to run"}},
                              {"terminate-on-eod", VariantType::Bool, true, {"terminate on end-of-data"}},
+                             {"prefetch", VariantType::Int, 0, {"number of entries to read ahead on a background thread, 0 to disable"}},
+                             {"cache-size-mb", VariantType::Int, 0, {"size of the TTreeCache in MB, 0 to disable"}},
                            }};
 }
 } // end namespace tpc
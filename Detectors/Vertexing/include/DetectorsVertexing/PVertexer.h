@@ -50,6 +50,7 @@ class PVertexer
                                OK };
 
   void init();
+  void init(float bz);
 
   template <typename TR>
   int process(const TR& tracks, const gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
@@ -60,8 +61,9 @@ class PVertexer
                    std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs,
                    gsl::span<const o2::MCCompLabel> lblTracks, std::vector<o2::MCEventLabel>& lblVtx);
 
-  static void createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const std::vector<PVertex> vertices,
-                             const std::vector<uint32_t> trackIDs, const std::vector<V2TRef> v2tRefs, std::vector<o2::MCEventLabel>& lblVtx);
+  static void createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const std::vector<PVertex>& vertices,
+                             const std::vector<uint32_t>& trackIDs, const std::vector<V2TRef>& v2tRefs, std::vector<o2::MCEventLabel>& lblVtx,
+                             int nThreads = 1);
   bool findVertex(const VertexingInput& input, PVertex& vtx);
 
   void setStartIR(const o2::InteractionRecord& ir) { mStartIR = ir; } ///< set InteractionRecods for the beginning of the TF
@@ -81,6 +83,9 @@ class PVertexer
   void setValidateWithIR(bool v) { mValidateWithIR = v; }
   bool getValidateWithIR() const { return mValidateWithIR; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   auto& getTracksPool() const { return mTracksPool; }
   auto& getTimeZClusters() const { return mTimeZClusters; }
   auto& getSortedTrackIndices() const { return mSortedTrackID; }
@@ -118,9 +123,17 @@ class PVertexer
 
   std::pair<int, int> getBestIR(const PVertex& vtx, const gsl::span<o2::InteractionRecord> bcData, int& currEntry) const;
 
-  int dbscan_RangeQuery(int idxs, std::vector<int>& cand, std::vector<int>& status);
+  int dbscan_RangeQuery(int idxs, std::vector<int>& cand, std::vector<int>& status, std::vector<int>& neighbours);
+  void dbscan_buildGrid();
   void dbscan_clusterize();
 
+  ///< vertices found in a single time-Z cluster, with track references local to the cluster
+  struct ClusterVertices {
+    std::vector<PVertex> vertices;
+    std::vector<uint32_t> trackIDs;
+    std::vector<V2TRef> v2tRefs;
+  };
+
   o2::BunchFilling mBunchFilling;
   std::array<int16_t, o2::constants::lhc::LHCMaxBunches> mClosestBunchAbove; // closest filled bunch from above
   std::array<int16_t, o2::constants::lhc::LHCMaxBunches> mClosestBunchBelow; // closest filled bunch from below
@@ -133,9 +146,13 @@ class PVertexer
   std::vector<int> mSortedTrackID;         ///< indices of tracks sorted in time
   std::vector<TimeZCluster> mTimeZClusters; ///< set of time clusters
   std::vector<int> mClusterTrackIDs;        ///< IDs of tracks making the clusters
+  std::vector<ClusterVertices> mClusterVertices; ///< vertices found in each time-Z cluster
+  TimeZGrid mTimeZGrid;                     ///< time-Z grid of time-sorted tracks for DBSCAN
+  float mDBScanMaxDZ = 0.;                  ///< max Z distance of DBSCAN neighbours
 
   float mBz = 0.;                          ///< mag.field at beam line
   bool mValidateWithIR = false;            ///< require vertex validation with InteractionRecords (if available)
+  int mNThreads = 1;                       ///< number of threads for the processing of time-Z clusters
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
@@ -146,6 +163,9 @@ class PVertexer
   static constexpr float kHugeF = 1.e12;     ///< very large float
   static constexpr float kAlmost0F = 1e-12;  ///< tiny float
   static constexpr double kAlmost0D = 1e-16; ///< tiny double
+  static constexpr float kGridMargin = 0.05; ///< relative margin of the DBSCAN grid ranges against rounding
+  static constexpr int kMaxGridBinsT = 10000; ///< max number of time bins of the DBSCAN grid
+  static constexpr int kMaxGridBinsZ = 500;   ///< max number of Z bins of the DBSCAN grid
 
 };
 
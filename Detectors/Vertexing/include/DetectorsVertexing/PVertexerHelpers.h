@@ -250,6 +250,32 @@ struct SeedHisto {
   }
 };
 
+///< grid of time-sorted tracks in time and Z, used to bound the DBSCAN range queries
+struct TimeZGrid {
+  float tMin = 0.;
+  float zMin = 0.;
+  float tBinSizeInv = 0.;
+  float zBinSizeInv = 0.;
+  int nBinsT = 0;
+  int nBinsZ = 0;
+  std::vector<int> cellFirst;  ///< first entry of each cell in cellTracks, size nBinsT*nBinsZ+1
+  std::vector<int> cellTracks; ///< indices of the time-sorted tracks grouped by cell, ascending within each cell
+
+  int getBinT(float t) const
+  {
+    int n = (t - tMin) * tBinSizeInv;
+    return n < 0 ? 0 : (n < nBinsT ? n : nBinsT - 1);
+  }
+
+  int getBinZ(float z) const
+  {
+    int n = (z - zMin) * zBinSizeInv;
+    return n < 0 ? 0 : (n < nBinsZ ? n : nBinsZ - 1);
+  }
+
+  int getCell(int binT, int binZ) const { return binT * nBinsZ + binZ; }
+};
+
 struct TimeZCluster {
   TimeEst timeEst;
   int first = -1;
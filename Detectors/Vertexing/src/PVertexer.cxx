@@ -19,11 +19,18 @@
 #include <unordered_map>
 #include <TStopwatch.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::vertexing;
 
 constexpr float PVertexer::kAlmost0F;
 constexpr double PVertexer::kAlmost0D;
 constexpr float PVertexer::kHugeF;
+constexpr float PVertexer::kGridMargin;
+constexpr int PVertexer::kMaxGridBinsT;
+constexpr int PVertexer::kMaxGridBinsZ;
 
 //___________________________________________________________________
 int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
@@ -37,13 +44,55 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
 
-  for (auto tc : mTimeZClusters) {
+  // time-Z clusters share no tracks, so they are processed independently and their vertices
+  // are merged in the order of the clusters
+  int nClusters = mTimeZClusters.size();
+  float scaleSigma2 = 3. * estimateScale2();
+  mClusterVertices.resize(nClusters);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ic = 0; ic < nClusters; ic++) {
+    const auto& tc = mTimeZClusters[ic];
+    auto& clusVtx = mClusterVertices[ic];
+    clusVtx.vertices.clear();
+    clusVtx.trackIDs.clear();
+    clusVtx.v2tRefs.clear();
     VertexingInput inp;
     //    inp.idRange = gsl::span<int>((int*)&mSortedTrackID[tc.first], tc.count);
     inp.idRange = gsl::span<int>((int*)&mClusterTrackIDs[tc.first], tc.count);
-    inp.scaleSigma2 = 3. * estimateScale2();
+    inp.scaleSigma2 = scaleSigma2;
     inp.timeEst = tc.timeEst;
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+    findVertices(inp, clusVtx.vertices, clusVtx.trackIDs, clusVtx.v2tRefs);
+  }
+
+  for (int ic = 0; ic < nClusters; ic++) {
+    auto& clusVtx = mClusterVertices[ic];
+    int vtxOffset = verticesLoc.size(), trackOffset = trackIDs.size();
+    if (vtxOffset) { // vertex IDs assigned to the tracks are local to the cluster
+      const auto& tc = mTimeZClusters[ic];
+      for (int i = tc.first; i < tc.first + tc.count; i++) {
+        auto& trc = mTracksPool[mClusterTrackIDs[i]];
+        if (trc.vtxID >= 0) {
+          trc.vtxID += vtxOffset;
+        }
+      }
+    }
+    verticesLoc.insert(verticesLoc.end(), clusVtx.vertices.begin(), clusVtx.vertices.end());
+    trackIDs.insert(trackIDs.end(), clusVtx.trackIDs.begin(), clusVtx.trackIDs.end());
+    for (const auto& ref : clusVtx.v2tRefs) {
+      v2tRefsLoc.emplace_back(ref.getFirstEntry() + trackOffset, ref.getEntries());
+    }
+  }
+
+  // assign compatible IRs to all vertices before the sequential validation
+  int nVerticesLoc = verticesLoc.size();
+  std::vector<char> irSet(nVerticesLoc);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNThreads)
+#endif
+  for (int iv = 0; iv < nVerticesLoc; iv++) {
+    irSet[iv] = setCompatibleIR(verticesLoc[iv]);
   }
 
   // sort in time
@@ -61,15 +110,14 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   vertexTrackIDs.reserve(trackIDs.size());
 
   if (lblTracks.size()) {
-    createMCLabels(lblTracks, vertices, trackIDs, v2tRefsLoc, lblVtxLoc);
+    createMCLabels(lblTracks, vertices, trackIDs, v2tRefsLoc, lblVtxLoc, mNThreads);
   }
 
   int trCopied = 0, count = 0, vtimeID = 0;
   for (auto i : vtTimeSortID) {
     auto& vtx = verticesLoc[i];
 
-    bool irSet = setCompatibleIR(vtx);
-    if (!irSet) {
+    if (!irSet[i]) {
       continue;
     }
     // do we need to validate by Int. records ?
@@ -420,13 +468,28 @@ TimeEst PVertexer::timeEstimate(const VertexingInput& input) const
 
 //___________________________________________________________________
 void PVertexer::init()
+{
+  auto* prop = o2::base::Propagator::Instance();
+  init(prop->getNominalBz());
+}
+
+//___________________________________________________________________
+void PVertexer::init(float bz)
 {
   mPVParams = &PVertexerParams::Instance();
   setTukey(mPVParams->tukey);
   initMeanVertexConstraint();
+  setBz(bz);
+}
 
-  auto* prop = o2::base::Propagator::Instance();
-  setBz(prop->getNominalBz());
+//___________________________________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
 }
 
 //___________________________________________________________________
@@ -450,19 +513,17 @@ void PVertexer::finalizeVertex(const VertexingInput& input, const PVertex& vtx,
 }
 
 //___________________________________________________________________
-void PVertexer::createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const std::vector<PVertex> vertices,
-                               const std::vector<uint32_t> trackIDs, const std::vector<V2TRef> v2tRefs,
-                               std::vector<o2::MCEventLabel>& lblVtx)
+void PVertexer::createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const std::vector<PVertex>& vertices,
+                               const std::vector<uint32_t>& trackIDs, const std::vector<V2TRef>& v2tRefs,
+                               std::vector<o2::MCEventLabel>& lblVtx, int nThreads)
 {
   lblVtx.clear();
-  int nv = vertices.size();
   if (!lblTracks.size()) {
     LOG(ERROR) << "Track labels are not provided";
     return;
   }
-  std::unordered_map<o2::MCEventLabel, int> labelOccurence;
 
-  auto bestLbl = [](std::unordered_map<o2::MCEventLabel, int> mp, int norm) -> o2::MCEventLabel {
+  auto bestLbl = [](const std::unordered_map<o2::MCEventLabel, int>& mp, int norm) -> o2::MCEventLabel {
     o2::MCEventLabel best;
     int bestCount = 0;
     for (auto [lbl, cnt] : mp) {
@@ -477,9 +538,16 @@ void PVertexer::createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const
     return best;
   };
 
-  for (const auto& v2t : v2tRefs) {
+  // vertices are labelled independently, each one is written to its own slot
+  int nv = v2tRefs.size();
+  lblVtx.resize(nv);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+#endif
+  for (int iv = 0; iv < nv; iv++) {
+    const auto& v2t = v2tRefs[iv];
     int tref = v2t.getFirstEntry(), last = tref + v2t.getEntries();
-    labelOccurence.clear();
+    std::unordered_map<o2::MCEventLabel, int> labelOccurence;
     o2::MCEventLabel winner; // unset at the moment
     for (; tref < last; tref++) {
       const auto& lbl = lblTracks[trackIDs[tref]];
@@ -493,7 +561,7 @@ void PVertexer::createMCLabels(gsl::span<const o2::MCCompLabel> lblTracks, const
     if (labelOccurence.size()) {
       winner = bestLbl(labelOccurence, v2t.getEntries());
     }
-    lblVtx.push_back(winner);
+    lblVtx[iv] = winner;
   }
 }
 
@@ -556,7 +624,7 @@ bool PVertexer::setCompatibleIR(PVertex& vtx)
 }
 
 //___________________________________________________________________
-int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int>& status)
+int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int>& status, std::vector<int>& neighbours)
 {
   // find neighbours for dbscan cluster core point candidate
   // Since we use asymmetric distance definition, is it bit more complex than simple search within chi2 proximity
@@ -583,21 +651,82 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
     }
     return 1;
   };
-  int idL = id;
-  while (--idL >= 0) { // index in time decreasing direction
-    if (procPnt(idL) < 0) {
-      break;
+
+  // collect the tracks from the grid cells overlapping with the time-Z proximity of the track, the cells
+  // are larger than the proximity, so the tracks beyond the time cut are skipped rather than terminating the scan
+  const auto& grid = mTimeZGrid;
+  float tI0 = tI.timeEst.getTimeStamp(), dT = mPVParams->dbscanDeltaT * (1.f + kGridMargin), dZ = mDBScanMaxDZ;
+  int binTMin = grid.getBinT(tI0 - dT), binTMax = grid.getBinT(tI0 + dT);
+  int binZMin = grid.getBinZ(tI.z - dZ), binZMax = grid.getBinZ(tI.z + dZ);
+  neighbours.clear();
+  for (int binT = binTMin; binT <= binTMax; binT++) {
+    for (int binZ = binZMin; binZ <= binZMax; binZ++) {
+      int cell = grid.getCell(binT, binZ);
+      for (int k = grid.cellFirst[cell]; k < grid.cellFirst[cell + 1]; k++) {
+        if (grid.cellTracks[k] != id) {
+          neighbours.push_back(grid.cellTracks[k]);
+        }
+      }
     }
   }
-  int idU = id;
-  while (++idU < ntr) { // index in time increasing direction
-    if (procPnt(idU) < 0) {
-      break;
-    }
+  // process the neighbours in the same order as a scan of time-sorted tracks: first in time decreasing direction, then in increasing
+  std::sort(neighbours.begin(), neighbours.end(), [id, ntr](int a, int b) {
+    return (a < id ? id - a : ntr + a) < (b < id ? id - b : ntr + b);
+  });
+  for (int idN : neighbours) {
+    procPnt(idN);
   }
   return nFound;
 }
 
+//___________________________________________________________________
+void PVertexer::dbscan_buildGrid()
+{
+  // sort time-sorted tracks into time-Z cells: the time bin is the DBSCAN time cut, the Z bin is the largest
+  // Z distance at which 2 tracks can be neighbours
+  auto& grid = mTimeZGrid;
+  int ntr = mSortedTrackID.size();
+  float tMin = mTracksPool[mSortedTrackID.front()].timeEst.getTimeStamp(), tMax = mTracksPool[mSortedTrackID.back()].timeEst.getTimeStamp();
+  float zMin = kHugeF, zMax = -kHugeF, sig2ZMax = 0.;
+  bool validErrors = true;
+  for (const auto& trc : mTracksPool) {
+    zMin = std::min(zMin, trc.z);
+    zMax = std::max(zMax, trc.z);
+    if (trc.sig2ZI > 0.) {
+      sig2ZMax = std::max(sig2ZMax, 1.f / trc.sig2ZI);
+    } else {
+      validErrors = false;
+    }
+  }
+  // the distance to the track I is dist2 = dtnorm2 + dz^2 / sig2Z(L) < dbscanMaxDist2, i.e. |dz| < sqrt(dbscanMaxDist2 * sig2Z(L))
+  mDBScanMaxDZ = std::sqrt(std::max(0.f, mPVParams->dbscanMaxDist2) * sig2ZMax) * (1.f + kGridMargin);
+  float rangeT = tMax - tMin, rangeZ = zMax - zMin;
+  grid.tMin = tMin;
+  grid.zMin = zMin;
+  grid.nBinsT = mPVParams->dbscanDeltaT > 0. ? std::min(kMaxGridBinsT, int(rangeT / mPVParams->dbscanDeltaT) + 1) : 1;
+  grid.nBinsZ = validErrors && mDBScanMaxDZ > 0. ? std::min(kMaxGridBinsZ, int(rangeZ / mDBScanMaxDZ) + 1) : 1;
+  grid.tBinSizeInv = rangeT > 0. ? grid.nBinsT / (rangeT * (1.f + kGridMargin)) : 0.;
+  grid.zBinSizeInv = rangeZ > 0. ? grid.nBinsZ / (rangeZ * (1.f + kGridMargin)) : 0.;
+
+  // counting sort of the time-sorted track indices, the order within each cell is kept
+  int nCells = grid.nBinsT * grid.nBinsZ;
+  std::vector<int> cellID(ntr);
+  grid.cellFirst.assign(nCells + 1, 0);
+  for (int it = 0; it < ntr; it++) {
+    const auto& trc = mTracksPool[mSortedTrackID[it]];
+    cellID[it] = grid.getCell(grid.getBinT(trc.timeEst.getTimeStamp()), grid.getBinZ(trc.z));
+    grid.cellFirst[cellID[it] + 1]++;
+  }
+  for (int ic = 0; ic < nCells; ic++) {
+    grid.cellFirst[ic + 1] += grid.cellFirst[ic];
+  }
+  grid.cellTracks.resize(ntr);
+  std::vector<int> cellFill(grid.cellFirst.begin(), grid.cellFirst.end() - 1);
+  for (int it = 0; it < ntr; it++) {
+    grid.cellTracks[cellFill[cellID[it]]++] = it;
+  }
+}
+
 //_____________________________________________________
 void PVertexer::dbscan_clusterize()
 {
@@ -607,13 +736,16 @@ void PVertexer::dbscan_clusterize()
   TStopwatch timer;
   int clID = -1;
 
-  std::vector<int> nbVec;
+  std::vector<int> nbVec, neighbours;
+  if (ntr) {
+    dbscan_buildGrid();
+  }
   for (int it = 0; it < ntr; it++) {
     if (status[it] != DBS_UNDEF) {
       continue;
     }
     nbVec.clear();
-    auto nnb0 = dbscan_RangeQuery(it, nbVec, status);
+    auto nnb0 = dbscan_RangeQuery(it, nbVec, status, neighbours);
     int minNeighbours = mPVParams->minTracksPerVtx - 1;
     if (nnb0 < minNeighbours) {
       status[it] = DBS_NOISE; // noise
@@ -641,7 +773,7 @@ void PVertexer::dbscan_clusterize()
       if (clusVec.size() > minNeighbours) {
         minNeighbours = std::max(minNeighbours, int(clusVec.size() * mPVParams->dbscanAdaptCoef));
       }
-      auto nnb1 = dbscan_RangeQuery(jt, nbVec, status);
+      auto nnb1 = dbscan_RangeQuery(jt, nbVec, status, neighbours);
       if (nnb1 < minNeighbours) {
         for (unsigned k = ncurr; k < nbVec.size(); k++) {
           if (status[nbVec[k]] < DBS_INCHECK) {
@@ -656,6 +788,7 @@ void PVertexer::dbscan_clusterize()
   }
 
   mTimeZClusters.clear();
+  mClusterTrackIDs.clear();
   mClusterTrackIDs.reserve(ntr);
   for (const auto& clus : clusters) {
     if (clus.size() < mPVParams->minTracksPerVtx) {
@@ -0,0 +1,88 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_PVertexer.cxx
+/// \brief Benchmark of the primary vertex finder on time frames with Pb-Pb pile-up
+
+#include "benchmark/benchmark.h"
+#include "DetectorsVertexing/PVertexer.h"
+#include "CommonDataFormat/BunchFilling.h"
+#include <fairlogger/Logger.h>
+#include <random>
+#include <thread>
+
+using namespace o2::vertexing;
+
+// generate the tracks of nCollisions Pb-Pb collisions uniformly distributed in a TF of 128 orbits,
+// the tracks are defined at the DCA to the beam line in the frame rotated to their azimuthal angle
+void generateTF(std::vector<TrackWithTimeStamp>& tracks, std::vector<o2::dataformats::GlobalTrackID>& gids, int nCollisions, int meanMult)
+{
+  const float lengthTF = 128 * o2::constants::lhc::LHCOrbitMUS;
+  const float sigY = 30e-4, sigZ = 40e-4, sigT = 0.5; // cm, cm, \mus
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> flatT(0.f, lengthTF), flatPhi(-M_PI, M_PI), flatTgl(-1.f, 1.f), flatQ2Pt(-5.f, 5.f);
+  std::normal_distribution<float> gausZVtx(0.f, 6.f), gaus(0.f, 1.f);
+  std::exponential_distribution<float> expMult(1.f / meanMult);
+  const std::array<float, o2::track::kCovMatSize> cov{sigY * sigY, 0., sigZ * sigZ, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  tracks.clear();
+  gids.clear();
+  for (int icoll = 0; icoll < nCollisions; icoll++) {
+    float tColl = flatT(gen), zColl = gausZVtx(gen);
+    int mult = 2 + expMult(gen);
+    for (int itr = 0; itr < mult; itr++) {
+      std::array<float, o2::track::kNParams> par{gaus(gen) * sigY, zColl + gaus(gen) * sigZ, 0.f, flatTgl(gen), flatQ2Pt(gen)};
+      o2::track::TrackParCov trc(0.f, flatPhi(gen), par, cov);
+      tracks.emplace_back(TrackWithTimeStamp{trc, {tColl + gaus(gen) * sigT, sigT}});
+      gids.emplace_back(tracks.size() - 1, o2::dataformats::GlobalTrackID::ITSTPC);
+    }
+  }
+}
+
+static void BM_PVertexer(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  std::vector<TrackWithTimeStamp> tracks;
+  std::vector<o2::dataformats::GlobalTrackID> gids;
+  generateTF(tracks, gids, state.range(0), 300);
+
+  PVertexer vertexer;
+  o2::BunchFilling bunchFilling;
+  bunchFilling.setDefault();
+  vertexer.setBunchFilling(bunchFilling);
+  vertexer.setNThreads(state.range(1));
+  vertexer.init(-5.f);
+
+  std::vector<PVertex> vertices;
+  std::vector<o2::dataformats::VtxTrackIndex> vertexTrackIDs;
+  std::vector<V2TRef> v2tRefs;
+  std::vector<o2::MCEventLabel> lblVtx;
+  std::vector<o2::InteractionRecord> bcData;
+  gsl::span<const o2::MCCompLabel> lblTracks;
+  for (auto _ : state) {
+    vertexer.process(tracks, gids, bcData, vertices, vertexTrackIDs, v2tRefs, lblTracks, lblVtx);
+  }
+  state.counters["vertices"] = vertices.size();
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (int nCollisions : {100, 500}) {
+    for (int nThreads = 1; nThreads < maxThreads; nThreads *= 2) {
+      bench->Args({nCollisions, nThreads});
+    }
+    bench->Args({nCollisions, maxThreads});
+  }
+}
+
+BENCHMARK(BM_PVertexer)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,168 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test PVertexer class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsVertexing/PVertexer.h"
+#include "CommonDataFormat/BunchFilling.h"
+#include "CommonConstants/LHCConstants.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace vertexing
+{
+
+struct VertexingOutput {
+  std::vector<PVertex> vertices;
+  std::vector<o2::dataformats::VtxTrackIndex> vertexTrackIDs;
+  std::vector<V2TRef> v2tRefs;
+  std::vector<o2::MCEventLabel> lblVtx;
+};
+
+// generate the tracks of nCollisions collisions in filled bunches of a TF of 128 orbits with their MC labels and
+// interaction records, the tracks are defined at the DCA to the beam line in the frame rotated to their azimuthal angle
+void generateTF(const o2::BunchFilling& bunchFilling, std::vector<TrackWithTimeStamp>& tracks, std::vector<o2::dataformats::GlobalTrackID>& gids,
+                std::vector<o2::MCCompLabel>& labels, std::vector<o2::InteractionRecord>& bcData, int nCollisions, int meanMult)
+{
+  const float sigY = 30e-4, sigZ = 40e-4, sigT = 0.5; // cm, cm, \mus
+  std::mt19937 gen(54321);
+  std::uniform_int_distribution<int> flatOrbit(0, 127), flatBC(0, o2::constants::lhc::LHCMaxBunches - 1);
+  std::uniform_real_distribution<float> flatPhi(-M_PI, M_PI), flatTgl(-1.f, 1.f), flatQ2Pt(-5.f, 5.f), flat(0.f, 1.f);
+  std::normal_distribution<float> gausZVtx(0.f, 6.f), gaus(0.f, 1.f);
+  std::exponential_distribution<float> expMult(1.f / meanMult);
+  const std::array<float, o2::track::kCovMatSize> cov{sigY * sigY, 0., sigZ * sigZ, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  for (int icoll = 0; icoll < nCollisions; icoll++) {
+    int bc = 0;
+    do {
+      bc = flatBC(gen);
+    } while (!bunchFilling.testBC(bc));
+    const auto& ir = bcData.emplace_back(bc, flatOrbit(gen));
+    float tColl = ir.differenceInBC({0, 0}) * o2::constants::lhc::LHCBunchSpacingMUS, zColl = gausZVtx(gen);
+    int mult = 2 + expMult(gen);
+    for (int itr = 0; itr < mult; itr++) {
+      std::array<float, o2::track::kNParams> par{gaus(gen) * sigY, zColl + gaus(gen) * sigZ, 0.f, flatTgl(gen), flatQ2Pt(gen)};
+      o2::track::TrackParCov trc(0.f, flatPhi(gen), par, cov);
+      tracks.emplace_back(TrackWithTimeStamp{trc, {tColl + gaus(gen) * sigT, sigT}});
+      gids.emplace_back(tracks.size() - 1, o2::dataformats::GlobalTrackID::ITSTPC);
+      labels.emplace_back(itr, icoll, 0, flat(gen) < 0.05f); // a few fake labels
+    }
+  }
+  std::sort(bcData.begin(), bcData.end());
+}
+
+VertexingOutput runVertexer(const o2::BunchFilling& bunchFilling, int nThreads, const std::vector<TrackWithTimeStamp>& tracks,
+                            std::vector<o2::dataformats::GlobalTrackID>& gids, const std::vector<o2::MCCompLabel>& labels,
+                            std::vector<o2::InteractionRecord>& bcData)
+{
+  PVertexer vertexer;
+  vertexer.setBunchFilling(bunchFilling);
+  vertexer.setStartIR({0, 0});
+  vertexer.setValidateWithIR(true);
+  vertexer.setNThreads(nThreads);
+  vertexer.init(-5.f);
+  VertexingOutput out;
+  vertexer.process(tracks, gids, bcData, out.vertices, out.vertexTrackIDs, out.v2tRefs, labels, out.lblVtx);
+  return out;
+}
+
+void checkIdentical(const VertexingOutput& out, const VertexingOutput& ref)
+{
+  BOOST_REQUIRE_EQUAL(out.vertices.size(), ref.vertices.size());
+  for (size_t iv = 0; iv < ref.vertices.size(); iv++) {
+    const auto &vtx = out.vertices[iv], &vtxRef = ref.vertices[iv];
+    BOOST_CHECK(vtx.getX() == vtxRef.getX() && vtx.getY() == vtxRef.getY() && vtx.getZ() == vtxRef.getZ());
+    BOOST_CHECK(vtx.getCov() == vtxRef.getCov());
+    BOOST_CHECK(vtx.getChi2() == vtxRef.getChi2() && vtx.getNContributors() == vtxRef.getNContributors());
+    BOOST_CHECK(vtx.getTimeStamp().getTimeStamp() == vtxRef.getTimeStamp().getTimeStamp());
+    BOOST_CHECK(vtx.getTimeStamp().getTimeStampError() == vtxRef.getTimeStamp().getTimeStampError());
+    BOOST_CHECK(vtx.getIRMin() == vtxRef.getIRMin() && vtx.getIRMax() == vtxRef.getIRMax() && vtx.getFlags() == vtxRef.getFlags());
+  }
+  BOOST_REQUIRE_EQUAL(out.v2tRefs.size(), ref.v2tRefs.size());
+  for (size_t iv = 0; iv < ref.v2tRefs.size(); iv++) {
+    BOOST_CHECK(out.v2tRefs[iv].getFirstEntry() == ref.v2tRefs[iv].getFirstEntry() && out.v2tRefs[iv].getEntries() == ref.v2tRefs[iv].getEntries());
+  }
+  BOOST_REQUIRE_EQUAL(out.vertexTrackIDs.size(), ref.vertexTrackIDs.size());
+  for (size_t i = 0; i < ref.vertexTrackIDs.size(); i++) {
+    BOOST_CHECK(out.vertexTrackIDs[i].getRaw() == ref.vertexTrackIDs[i].getRaw());
+  }
+  BOOST_REQUIRE_EQUAL(out.lblVtx.size(), ref.lblVtx.size());
+  for (size_t iv = 0; iv < ref.lblVtx.size(); iv++) {
+    BOOST_CHECK(out.lblVtx[iv].getRawValue() == ref.lblVtx[iv].getRawValue());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PVertexer_MultiThreadReproducesSingleThread)
+{
+  o2::BunchFilling bunchFilling;
+  bunchFilling.setDefault();
+
+  // the parallel processing requires OpenMP, without it the vertexer falls back to a single thread
+  PVertexer vertexer;
+  vertexer.setNThreads(2);
+  if (vertexer.getNThreads() != 2) {
+    BOOST_TEST_MESSAGE("OpenMP not available: parallel vertexing not tested");
+    return;
+  }
+
+  std::vector<TrackWithTimeStamp> tracks;
+  std::vector<o2::dataformats::GlobalTrackID> gids;
+  std::vector<o2::MCCompLabel> labels;
+  std::vector<o2::InteractionRecord> bcData;
+  generateTF(bunchFilling, tracks, gids, labels, bcData, 200, 50);
+
+  // time-Z clustering, vertex fits, compatible IRs and MC labels
+  auto ref = runVertexer(bunchFilling, 1, tracks, gids, labels, bcData);
+  BOOST_REQUIRE(!ref.vertices.empty());
+  BOOST_REQUIRE_EQUAL(ref.lblVtx.size(), ref.vertices.size());
+  for (int nThreads : {2, 4}) {
+    auto out = runVertexer(bunchFilling, nThreads, tracks, gids, labels, bcData);
+    checkIdentical(out, ref);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PVertexer_MultiThreadMCLabels)
+{
+  // vertices of 4 to 40 tracks, with tracks of several events and a few fake labels
+  std::mt19937 gen(6789);
+  std::uniform_int_distribution<int> flatEvent(0, 4), flatSize(4, 40);
+  std::uniform_real_distribution<float> flat(0.f, 1.f);
+  std::vector<o2::MCCompLabel> labels;
+  std::vector<uint32_t> trackIDs;
+  std::vector<V2TRef> v2tRefs;
+  std::vector<PVertex> vertices(500);
+  for (size_t iv = 0; iv < vertices.size(); iv++) {
+    int first = trackIDs.size(), ntr = flatSize(gen);
+    for (int itr = 0; itr < ntr; itr++) {
+      trackIDs.push_back(labels.size());
+      labels.emplace_back(itr, flat(gen) < 0.7f ? int(iv) : flatEvent(gen), 0, flat(gen) < 0.05f);
+    }
+    v2tRefs.emplace_back(first, ntr);
+  }
+
+  std::vector<o2::MCEventLabel> lblRef, lbl;
+  PVertexer::createMCLabels(labels, vertices, trackIDs, v2tRefs, lblRef, 1);
+  BOOST_REQUIRE_EQUAL(lblRef.size(), vertices.size());
+  for (int nThreads : {2, 4}) {
+    PVertexer::createMCLabels(labels, vertices, trackIDs, v2tRefs, lbl, nThreads);
+    BOOST_REQUIRE_EQUAL(lbl.size(), lblRef.size());
+    for (size_t iv = 0; iv < lblRef.size(); iv++) {
+      BOOST_CHECK(lbl[iv].getRawValue() == lblRef[iv].getRawValue());
+    }
+  }
+}
+
+} // namespace vertexing
+} // namespace o2
@@ -21,6 +21,7 @@
 #include "Framework/RawDeviceService.h"
 #include "Framework/DataSpecUtils.h"
 #include "Framework/DataInputDirector.h"
+#include "Framework/DataFramePrefetcher.h"
 #include "Framework/SourceInfoHeader.h"
 #include "Framework/ChannelInfo.h"
 #include "Framework/Logger.h"
@@ -39,6 +40,7 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <optional>
 #include <thread>
 
 using namespace o2;
@@ -194,6 +196,19 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       }
     }
 
+    // read ahead the next DF while the current one is processed
+    std::shared_ptr<DataFramePrefetcher> prefetcher;
+    auto prefetchMemory = options.get<int64_t>("aod-prefetch-memory");
+    if (prefetchMemory > 0) {
+      std::vector<header::DataHeader> headers;
+      for (auto& route : requestedTables) {
+        auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+        headers.emplace_back(concrete.description, concrete.origin, concrete.subSpec);
+      }
+      prefetcher = std::make_shared<DataFramePrefetcher>(didir, headers, prefetchMemory);
+      prefetcher->request(spec.inputTimesliceId, 0, spec.maxInputTimeslices);
+    }
+
     auto fileCounter = std::make_shared<int>(0);
     auto numTF = std::make_shared<int>(-1);
     return adaptStateless([TFNumberHeader,
@@ -201,7 +216,8 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
                            fileCounter,
                            numTF,
                            watchdog,
-                           didir](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
+                           didir,
+                           prefetcher](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
       // Each parallel reader device.inputTimesliceId reads the files fileCounter*device.maxInputTimeslices+device.inputTimesliceId
       // the TF to read is numTF
       assert(device.inputTimesliceId < device.maxInputTimeslices);
@@ -220,6 +236,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       static size_t totalSizeUncompressed = 0;
       static size_t totalSizeCompressed = 0;
       static TFile* currentFile = nullptr;
+      static std::shared_ptr<TFile> currentPrefetchedFile = nullptr;
       static int tfCurrentFile = -1;
       static auto currentFileStartedAt = uv_hrtime();
       static uint64_t currentFileIOTime = 0;
@@ -228,6 +245,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       if (!watchdog->update()) {
         LOGP(INFO, "Run time exceeds run time limit of {} seconds. Exiting gracefully...", watchdog->runTimeLimit);
         LOGP(INFO, "Stopping reader {} after time frame {}.", device.inputTimesliceId, watchdog->numberTimeFrames - 1);
+        if (prefetcher) {
+          prefetcher->wait();
+        }
         dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
         monitoring.flushBuffer();
         didir->closeInputFiles();
@@ -238,16 +258,40 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
       auto ioStart = uv_hrtime();
 
-      for (auto route : requestedTables) {
+      // the prefetched DF may be the first one of the next file
+      std::optional<PrefetchedDataFrame> prefetched;
+      if (prefetcher) {
+        prefetched = prefetcher->get();
+        if (prefetched->atEnd || prefetched->counter != fcnt) {
+          dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
+          currentFile = nullptr;
+          currentPrefetchedFile = nullptr;
+          currentFileStartedAt = uv_hrtime();
+          currentFileIOTime = 0;
+        }
+        if (prefetched->atEnd) {
+          LOGP(INFO, "No input files left to read for reader {}!", device.inputTimesliceId);
+          didir->closeInputFiles();
+          control.endOfStream();
+          control.readyToQuit(QuitRequest::Me);
+          return;
+        }
+        fcnt = prefetched->counter;
+        ntf = prefetched->numTF;
+      }
+
+      for (size_t itable = 0; itable < requestedTables.size(); ++itable) {
+        auto& route = requestedTables[itable];
 
         // create header
         auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
         auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
 
         // create a TreeToTable object
-        TTree* tr = didir->getDataTree(dh, fcnt, ntf);
+        TTree* tr = prefetched ? prefetched->trees[itable] : didir->getDataTree(dh, fcnt, ntf);
         if (!tr) {
-          if (first) {
+          // the prefetcher already moved to the next file if needed
+          if (first && !prefetched) {
             // dump metrics of file which is done for reading
             dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
             currentFile = nullptr;
@@ -277,7 +321,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         }
 
         if (first) {
-          timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
+          timeFrameNumber = prefetched ? prefetched->timeFrameNumber : didir->getTimeFrameNumber(dh, fcnt, ntf);
           auto o = Output(TFNumberHeader);
           outputs.make<uint64_t>(o) = timeFrameNumber;
         }
@@ -306,8 +350,14 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
         // needed for metrics dumping (upon next file read, or terminate due to watchdog)
         if (currentFile == nullptr) {
-          currentFile = didir->getFileFolder(dh, fcnt, ntf).file;
-          tfCurrentFile = didir->getTimeFramesInFile(dh, fcnt);
+          if (prefetched) {
+            currentPrefetchedFile = prefetched->file;
+            currentFile = currentPrefetchedFile.get();
+            tfCurrentFile = prefetched->timeFramesInFile;
+          } else {
+            currentFile = didir->getFileFolder(dh, fcnt, ntf).file;
+            tfCurrentFile = didir->getTimeFramesInFile(dh, fcnt);
+          }
         }
 
         first = false;
@@ -320,6 +370,12 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
       *numTF = ntf;
       currentFileIOTime += (uv_hrtime() - ioStart);
+
+      // the trees of this DF are done, the next one can be read
+      if (prefetcher) {
+        prefetched.reset();
+        prefetcher->request(fcnt, ntf + 1, device.maxInputTimeslices);
+      }
     });
   })};
 
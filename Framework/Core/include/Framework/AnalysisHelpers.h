@@ -19,7 +19,9 @@
 #include "Framework/OutputObjHeader.h"
 #include "Framework/StringHelpers.h"
 #include "Framework/Output.h"
+#include <numeric>
 #include <string>
+#include <vector>
 #include "Framework/Logger.h"
 
 namespace o2::framework
@@ -194,12 +196,87 @@ struct Spawns : TableTransform<typename aod::MetadataTrait<framework::pack_head_
   std::shared_ptr<extension_t> extension = nullptr;
 };
 
+/// Keys of the rows of a table used to build an index, as a flat array
+struct IndexBuilderKeys {
+  int32_t const* keys = nullptr; // key of each row
+  int64_t size = 0;              // number of rows
+  int64_t offset = 0;            // global index of the first row
+  bool isKey = false;            // the table is the one being indexed
+  std::vector<int32_t> buffer;   // storage of the keys, if they cannot be used in place
+};
+
+/// Columnar engine of the index builders: the keys of all the tables are
+/// read as flat arrays, the rows of each table are bound to those of the
+/// first one exactly as the row-wise builders do, in parallel over the
+/// tables, and the index columns are written directly to arrow buffers.
+struct IndexBuilderHelpers {
+  /// Rows of the first table matched in all the others
+  static std::shared_ptr<arrow::Table> buildExclusive(std::vector<std::string> const& labels, std::vector<IndexBuilderKeys> const& keys);
+  /// All rows of the first table, -1 for the tables without a match
+  static std::shared_ptr<arrow::Table> buildSparse(std::vector<std::string> const& labels, std::vector<IndexBuilderKeys> const& keys);
+
+  /// Maximum number of threads used for a single index, each binding a
+  /// different table. The threads are kept in a pool shared by all the
+  /// builds, by default the index is built in the calling thread only
+  static void setNThreads(int n);
+  static int getNThreads() { return sNThreads; }
+
+  /// The keys are the same as those returned by getId<Key>() for each row
+  template <typename Key, typename T>
+  static IndexBuilderKeys getKeys(T const& table)
+  {
+    using iterator_t = typename T::iterator;
+    using bindings_pack_t = typename iterator_t::bindings_pack_t;
+    IndexBuilderKeys keys;
+    keys.size = table.size();
+    keys.offset = table.offset();
+    keys.isKey = std::is_same_v<T, Key>;
+    if constexpr (framework::has_type_v<Key, bindings_pack_t>) {
+      using index_column_t = framework::pack_element_t<framework::has_type_at_v<Key>(bindings_pack_t{}), typename iterator_t::external_index_columns_t>;
+      setKeys(keys, soa::getIndexFromLabel(table.asArrowTable().get(), index_column_t::columnLabel()));
+    } else if constexpr (std::is_same_v<Key, typename iterator_t::parent_t>) {
+      keys.buffer.resize(keys.size);
+      std::iota(keys.buffer.begin(), keys.buffer.end(), static_cast<int32_t>(keys.offset));
+      keys.keys = keys.buffer.data();
+    } else {
+      keys.buffer.assign(keys.size, -1);
+      keys.keys = keys.buffer.data();
+    }
+    return keys;
+  }
+
+  template <typename Key, typename... T>
+  static std::vector<IndexBuilderKeys> getAllKeys(std::tuple<T...> const& tables)
+  {
+    std::vector<IndexBuilderKeys> keys;
+    keys.reserve(sizeof...(T));
+    std::apply([&keys](auto const&... x) { (keys.push_back(getKeys<Key>(x)), ...); }, tables);
+    return keys;
+  }
+
+ private:
+  static void setKeys(IndexBuilderKeys& keys, arrow::ChunkedArray* column);
+  static int sNThreads;
+};
+
 /// Policy to control index building
 /// Exclusive index: each entry in a row has a valid index
 struct IndexExclusive {
   /// Generic builder for in index table
   template <typename... Cs, typename Key, typename T1, typename... T>
-  static auto indexBuilder(framework::pack<Cs...>, Key const&, std::tuple<T1, T...> tables)
+  static auto indexBuilder(framework::pack<Cs...>, Key const& key, std::tuple<T1, T...> tables)
+  {
+    static_assert(sizeof...(Cs) == sizeof...(T) + 1, "Number of columns does not coincide with number of supplied tables");
+    if constexpr ((soa::is_soa_filtered_t<std::decay_t<T1>>::value || ... || soa::is_soa_filtered_t<std::decay_t<T>>::value)) {
+      return indexBuilderRowWise(framework::pack<Cs...>{}, key, tables);
+    } else {
+      return IndexBuilderHelpers::buildExclusive({Cs::columnLabel()...}, IndexBuilderHelpers::getAllKeys<Key>(tables));
+    }
+  }
+
+  /// Row-by-row builder, walking the tables with their iterators
+  template <typename... Cs, typename Key, typename T1, typename... T>
+  static auto indexBuilderRowWise(framework::pack<Cs...>, Key const&, std::tuple<T1, T...> tables)
   {
     static_assert(sizeof...(Cs) == sizeof...(T) + 1, "Number of columns does not coincide with number of supplied tables");
     using tables_t = framework::pack<T...>;
@@ -264,7 +341,19 @@ struct IndexExclusive {
 /// to T1
 struct IndexSparse {
   template <typename... Cs, typename Key, typename T1, typename... T>
-  static auto indexBuilder(framework::pack<Cs...>, Key const&, std::tuple<T1, T...> tables)
+  static auto indexBuilder(framework::pack<Cs...>, Key const& key, std::tuple<T1, T...> tables)
+  {
+    static_assert(sizeof...(Cs) == sizeof...(T) + 1, "Number of columns does not coincide with number of supplied tables");
+    if constexpr ((soa::is_soa_filtered_t<std::decay_t<T1>>::value || ... || soa::is_soa_filtered_t<std::decay_t<T>>::value)) {
+      return indexBuilderRowWise(framework::pack<Cs...>{}, key, tables);
+    } else {
+      return IndexBuilderHelpers::buildSparse({Cs::columnLabel()...}, IndexBuilderHelpers::getAllKeys<Key>(tables));
+    }
+  }
+
+  /// Row-by-row builder, walking the tables with their iterators
+  template <typename... Cs, typename Key, typename T1, typename... T>
+  static auto indexBuilderRowWise(framework::pack<Cs...>, Key const&, std::tuple<T1, T...> tables)
   {
     static_assert(sizeof...(Cs) == sizeof...(T) + 1, "Number of columns does not coincide with number of supplied tables");
     using tables_t = framework::pack<T...>;
@@ -113,9 +113,11 @@ class DataAllocator
 
       // Note: initial payload size is 0 and will be set by the context before sending
       FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, 0);
-      return context.add<MessageContext::VectorObject<ValueType, MessageContext::ContainerRefObject<std::vector<ValueType, o2::pmr::NoConstructAllocator<ValueType>>>>>(
-                      std::move(headerMessage), channel, 0, std::forward<Args>(args)...)
-        .get();
+      auto& vector = context.add<MessageContext::VectorObject<ValueType, MessageContext::ContainerRefObject<std::vector<ValueType, o2::pmr::NoConstructAllocator<ValueType>>>>>(
+                             std::move(headerMessage), channel, 0, std::forward<Args>(args)...)
+                       .get();
+      preallocate(spec, vector);
+      return vector;
     } else if constexpr (is_specialization<T, std::vector>::value && has_messageable_value_type<T>::value) {
       // this catches all std::vector objects with messageable value type before checking if is also
       // has a root dictionary, so non-serialized transmission is preferred
@@ -125,7 +127,9 @@ class DataAllocator
 
       // Note: initial payload size is 0 and will be set by the context before sending
       FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, 0);
-      return context.add<MessageContext::VectorObject<ValueType>>(std::move(headerMessage), channel, 0, std::forward<Args>(args)...).get();
+      auto& vector = context.add<MessageContext::VectorObject<ValueType>>(std::move(headerMessage), channel, 0, std::forward<Args>(args)...).get();
+      preallocate(spec, vector);
+      return vector;
     } else if constexpr (has_root_dictionary<T>::value == true && is_messageable<T>::value == false) {
       // Extended support for types implementing the Root ClassDef interface, both TObject
       // derived types and others
@@ -443,6 +447,19 @@ class DataAllocator
     return snapshot(getOutputByBind(std::move(ref)), std::forward<Args>(args)...);
   }
 
+  /// Hint the payload size in bytes of the vectors created by make for the output.
+  /// Their capacity is preallocated accordingly for all the following timeslices,
+  /// a hint of 0 reverts to the size learned from the previous timeslices.
+  void setSizeHint(const Output& spec, size_t size)
+  {
+    mRegistry->get<MessageContext>().setPayloadSizeHint(spec, size);
+  }
+
+  void setSizeHint(OutputRef&& ref, size_t size)
+  {
+    setSizeHint(getOutputByBind(std::move(ref)), size);
+  }
+
   /// check if a certain output is allowed
   bool isAllowed(Output const& query);
 
@@ -468,6 +485,18 @@ class DataAllocator
                                            size_t payloadSize);                                 //
 
   Output getOutputByBind(OutputRef&& ref);
+
+  /// reserve the expected capacity of a vector output, to avoid its growing
+  /// by reallocations and copies in the shared memory
+  template <typename V>
+  void preallocate(const Output& spec, V& vector)
+  {
+    auto capacity = mRegistry->get<MessageContext>().expectedPayloadSize(spec) / sizeof(typename V::value_type);
+    if (capacity > vector.capacity()) {
+      vector.reserve(capacity);
+    }
+  }
+
   void addPartToContext(FairMQMessagePtr&& payload,
                         const Output& spec,
                         o2::header::SerializationMethod serializationMethod);
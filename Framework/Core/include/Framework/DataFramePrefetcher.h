@@ -0,0 +1,77 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef o2_framework_DataFramePrefetcher_H_INCLUDED
+#define o2_framework_DataFramePrefetcher_H_INCLUDED
+
+#include "Framework/DataInputDirector.h"
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TFile;
+class TTree;
+
+namespace o2::framework
+{
+
+/// The trees of the requested tables for one DF folder
+struct PrefetchedDataFrame {
+  int counter = -1;                          // file counter of the DF
+  int numTF = -1;                            // position of the DF in its file
+  uint64_t timeFrameNumber = 0;              // number of the DF folder
+  int timeFramesInFile = 0;                  // number of DFs in the file
+  bool atEnd = false;                        // no DF left to read
+  std::shared_ptr<TFile> file;               // file of the first table
+  std::vector<std::shared_ptr<TFile>> files; // all the files the trees belong to, kept open while they are used
+  std::vector<TTree*> trees;                 // one tree per table, in the order of the request, nullptr if missing
+};
+
+/// Reads ahead the next DF folder of the AOD input. A background task opens
+/// the files and loads in memory the baskets of the trees of all the tables,
+/// within a memory budget, while the current DF is processed. The files are
+/// never accessed concurrently: the next DF is requested only once the trees
+/// of the current one are no longer used.
+class DataFramePrefetcher
+{
+ public:
+  DataFramePrefetcher(std::shared_ptr<DataInputDirector> didir, std::vector<header::DataHeader> headers, int64_t memoryBudget);
+  ~DataFramePrefetcher();
+
+  /// Start reading the DF numTF of the file counter, or the first DF
+  /// of the file counter + stride if the file counter has no more DFs
+  void request(int counter, int numTF, int stride);
+  /// The DF of the last request, waiting for it to be read if needed
+  PrefetchedDataFrame get();
+  /// Wait for the last request to be done, without taking its DF
+  void wait();
+
+ private:
+  struct TableSource {
+    std::string treeName;
+    std::string fileName;     // file with the DF counter
+    std::string nextFileName; // file with the DF counter + stride
+  };
+
+  PrefetchedDataFrame read(std::vector<TableSource> const& sources, int counter, int numTF, int stride);
+  std::shared_ptr<TFile> openFile(std::string const& fileName);
+
+  std::shared_ptr<DataInputDirector> mDIDir;
+  std::vector<header::DataHeader> mHeaders;
+  int64_t mMemoryBudget = 0;
+  std::map<std::string, std::shared_ptr<TFile>> mFiles; // files opened by the background task
+  std::future<PrefetchedDataFrame> mNext;
+};
+
+} // namespace o2::framework
+
+#endif // o2_framework_DataFramePrefetcher_H_INCLUDED
@@ -29,6 +29,9 @@ struct FileNameHolder {
 };
 FileNameHolder* makeFileNameHolder(std::string fileName);
 
+/// Sorted numbers of the DF_<number> folders of an AOD file
+std::vector<uint64_t> getTimeFrameNumbers(TFile* file);
+
 struct FileAndFolder {
   TFile* file = nullptr;
   std::string folderName = "";
@@ -66,6 +69,7 @@ struct DataInputDescriptor {
   std::regex getFilenamesRegex();
   int getNumberInputfiles() { return mfilenames.size(); }
   int getNumberTimeFrames() { return mtotalNumberTimeFrames; }
+  std::string getFileName(int counter);
 
   uint64_t getTimeFrameNumber(int counter, int numTF);
   FileAndFolder getFileFolder(int counter, int numTF);
@@ -113,6 +117,8 @@ struct DataInputDirector {
 
   std::unique_ptr<TTreeReader> getTreeReader(header::DataHeader dh, int counter, int numTF, std::string treeName);
   TTree* getDataTree(header::DataHeader dh, int counter, int numTF);
+  std::string getTreeName(header::DataHeader dh);
+  std::string getFileName(header::DataHeader dh, int counter);
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
@@ -149,6 +149,8 @@ struct DriverInfo {
   DeviceMetricsInfo metrics;
   /// Skip shared memory cleanup if set
   bool noSHMCleanup;
+  /// Fork the devices of this executable from the driver, without exec
+  bool forkServer = false;
   /// Default value for the --driver-client-backend. Notice that if we start from
   /// the driver, the default backend will be the websocket one.  On the other hand,
   /// if the device is started standalone, the default becomes the old stdout:// so
@@ -40,6 +40,8 @@ class Filter;
 #include <variant>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 using atype = arrow::Type;
 struct ExpressionInfo {
@@ -48,6 +50,11 @@ struct ExpressionInfo {
   gandiva::NodePtr tree;
 };
 
+namespace o2::framework
+{
+struct ServiceRegistry;
+}
+
 namespace o2::framework::expressions
 {
 template <typename... T>
@@ -551,6 +558,10 @@ std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Sc
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Projector&& p,
                                                     gandiva::FieldPtr result);
+/// Function to create gandiva projector for several operation sequences at once
+std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
+                                                    std::vector<Operations> const& opSpecs,
+                                                    gandiva::FieldVector const& results);
 /// Function for attaching gandiva filters to to compatible task inputs
 void updateExpressionInfos(expressions::Filter const& filter, std::vector<ExpressionInfo>& eInfos);
 /// Function to create gandiva condition expression from generic gandiva expression tree
@@ -560,23 +571,51 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
 /// Update placeholder nodes from context
 void updatePlaceholders(Filter& filter, InitContext& context);
 
+/// Process-wide cache of the compiled gandiva filters and projectors, addressed by
+/// the input schema and by the operation sequences of the expressions. A hit skips
+/// the creation of the gandiva expression tree as well as the code generation, so
+/// tasks and spawners declaring the same expressions on the same table share the
+/// compiled object.
+class ExpressionCache
+{
+ public:
+  struct Statistics {
+    size_t hits = 0;     // requests served by an already compiled object
+    size_t misses = 0;   // requests which required a compilation
+    double hitTime = 0;  // ms spent in the requests served from the cache
+    double missTime = 0; // ms spent in the requests which required a compilation
+  };
+
+  static ExpressionCache& instance();
+
+  /// Get the compiled filter for the operations, compile it on the first request
+  std::shared_ptr<gandiva::Filter> getFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs);
+  /// Get the compiled projector for the operations, compile it on the first request
+  std::shared_ptr<gandiva::Projector> getProjector(gandiva::SchemaPtr const& Schema,
+                                                   std::vector<Operations> const& opSpecs,
+                                                   gandiva::FieldVector const& results);
+  Statistics getStatistics() const;
+  /// Drop all the compiled objects and reset the statistics
+  void clear();
+  /// Log the statistics and send them to the monitoring
+  void report(ServiceRegistry& services) const;
+
+ private:
+  ExpressionCache() = default;
+  void count(bool hit, double ms);
+
+  mutable std::mutex mMutex;
+  std::unordered_map<std::string, std::shared_ptr<gandiva::Filter>> mFilters;
+  std::unordered_map<std::string, std::shared_ptr<gandiva::Projector>> mProjectors;
+  Statistics mStatistics;
+};
+
 template <typename... C>
 std::shared_ptr<gandiva::Projector> createProjectors(framework::pack<C...>, gandiva::SchemaPtr schema)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
-    schema,
-    {makeExpression(
-      framework::expressions::createExpressionTree(
-        framework::expressions::createOperations(C::Projector()),
-        schema),
-      C::asArrowField())...},
-    &projector);
-  if (s.ok()) {
-    return projector;
-  } else {
-    throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
+  return createProjector(schema,
+                         {framework::expressions::createOperations(C::Projector())...},
+                         {C::asArrowField()...});
 }
 } // namespace o2::framework::expressions
 
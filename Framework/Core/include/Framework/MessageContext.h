@@ -10,6 +10,7 @@
 #ifndef FRAMEWORK_MESSAGECONTEXT_H
 #define FRAMEWORK_MESSAGECONTEXT_H
 
+#include "Framework/ConcreteDataMatcher.h"
 #include "Framework/DispatchControl.h"
 #include "Framework/FairMQDeviceProxy.h"
 #include "Framework/RuntimeError.h"
@@ -22,6 +23,7 @@
 #include <fairmq/FairMQMessage.h>
 #include <fairmq/FairMQParts.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <string>
@@ -188,6 +190,8 @@ class MessageContext
    protected:
     void* do_allocate(size_t bytes, size_t alignment) override
     {
+      mAllocations++;
+      mAllocatedBytes += bytes;
       return mUpstream->allocate(bytes, alignment < 64 ? 64 : alignment);
     }
 
@@ -201,8 +205,16 @@ class MessageContext
       return this == &other;
     }
 
+   public:
+    /// number of allocations served, more than one means the container had to grow
+    size_t getAllocations() const { return mAllocations; }
+    /// total number of bytes allocated, including the buffers discarded when growing
+    size_t getAllocatedBytes() const { return mAllocatedBytes; }
+
    private:
     fair::mq::FairMQMemoryResource* mUpstream = nullptr;
+    size_t mAllocations = 0;
+    size_t mAllocatedBytes = 0;
   };
 
   /// ContainerRefObject handles a message object holding an instance of type T
@@ -224,6 +236,7 @@ class MessageContext
     template <typename ContextType, typename... Args>
     ContainerRefObject(ContextType* context, FairMQMessagePtr&& headerMsg, const std::string& bindingChannel, int index, Args&&... args)
       : ContextObject(std::forward<FairMQMessagePtr>(headerMsg), context->getChannelRef(bindingChannel)),
+        mContext{context},
         // the transport factory
         mFactory{context->proxy().getTransport(bindingChannel, index)},
         // the memory resource takes ownership of the message
@@ -247,6 +260,7 @@ class MessageContext
     FairMQParts finalize() final
     {
       assert(mParts.Size() == 1);
+      mContext->updatePayloadSize(*header(), mData.size() * sizeof(value_type), mResource.getAllocations(), mResource.getAllocatedBytes());
       auto payloadMsg = o2::pmr::getMessage(std::move(mData));
       mParts.AddPart(std::move(payloadMsg));
       return ContextObject::finalize();
@@ -271,6 +285,7 @@ class MessageContext
     }
 
    private:
+    MessageContext* mContext = nullptr;             /// the owning context, collecting the size statistics
     FairMQTransportFactory* mFactory = nullptr;     /// pointer to transport factory
     AlignedMemoryResource mResource;                /// message resource
     buffer_type mData;                              /// the data buffer
@@ -543,12 +558,42 @@ class MessageContext
   /// mMessages then in mScheduledMessages
   o2::header::DataHeader* findMessageHeader(const Output& spec);
 
+  /// Counters of the allocations of the container payloads since the start
+  struct AllocationStats {
+    size_t reallocations = 0; /// number of times a payload had to grow after its first allocation
+    size_t wastedBytes = 0;   /// allocated bytes which did not end up in the sent payloads
+  };
+
+  /// Payload size in bytes to preallocate for the next message of the output: the size hint
+  /// if one was given, otherwise the decaying maximum of the sizes seen in the previous timeslices
+  size_t expectedPayloadSize(const Output& spec);
+  /// Set the payload size hint in bytes for the output, 0 reverts to the learned size
+  void setPayloadSizeHint(const Output& spec, size_t size);
+  /// Account the final size of a container payload and the allocations it required
+  void updatePayloadSize(o2::header::DataHeader const& header, size_t size, size_t allocations, size_t allocatedBytes);
+
+  AllocationStats const& getAllocationStats() const
+  {
+    return mAllocationStats;
+  }
+
  private:
+  /// Size statistics of one output
+  struct PayloadSizeInfo {
+    ConcreteDataMatcher matcher;
+    size_t expected = 0; /// decaying maximum of the payload size
+    size_t hint = 0;     /// size hint given by the producer
+  };
+  PayloadSizeInfo& getPayloadSizeInfo(ConcreteDataMatcher const& matcher);
+
   FairMQDeviceProxy mProxy;
   Messages mMessages;
   Messages mScheduledMessages;
   DispatchControl mDispatchControl;
   std::unordered_map<std::string, std::unique_ptr<std::string>> mChannelRefs;
+  // few outputs per device, a linear search is good enough
+  std::vector<PayloadSizeInfo> mPayloadSizes;
+  AllocationStats mAllocationStats;
 };
 } // namespace framework
 } // namespace o2
@@ -29,6 +29,10 @@
 #include <arrow/table.h>
 #include <arrow/builder.h>
 
+#include <gsl/span>
+
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -170,6 +174,22 @@ struct BuilderUtils {
     return holder.builder->AppendValues(ptr, bulkSize, nullptr);
   }
 
+  /// Appender for a contiguous range of values of one column
+  template <typename HolderType, typename T>
+  static arrow::Status bulkAppend(HolderType& holder, gsl::span<T const> values)
+  {
+    if (values.empty()) {
+      return arrow::Status::OK();
+    }
+    if constexpr (std::is_same_v<decltype(holder.builder), std::unique_ptr<arrow::FixedSizeListBuilder>>) {
+      return appendToList<std::remove_extent_t<T> const>(holder.builder, values.data()[0], values.size());
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return holder.builder->AppendValues(reinterpret_cast<uint8_t const*>(values.data()), values.size(), nullptr);
+    } else {
+      return holder.builder->AppendValues(values.data(), values.size(), nullptr);
+    }
+  }
+
   template <typename HolderType, typename PTR>
   static arrow::Status bulkAppendChunked(HolderType& holder, BulkInfo<PTR> info)
   {
@@ -453,6 +473,12 @@ struct TableBuilderHelpers {
     return (BuilderUtils::bulkAppend(std::get<Is>(holders), bulkSize, std::get<Is>(ptrs)).ok() && ...);
   }
 
+  template <typename HOLDERS, std::size_t... Is, typename SPANS>
+  static bool bulkAppendSpans(HOLDERS& holders, std::index_sequence<Is...>, SPANS spans)
+  {
+    return (BuilderUtils::bulkAppend(std::get<Is>(holders), std::get<Is>(spans)).ok() && ...);
+  }
+
   /// Return true if all columns are done.
   template <std::size_t... Is, typename BUILDERS, typename INFOS>
   static bool bulkAppendChunked(BUILDERS& builders, std::index_sequence<Is...>, INFOS infos)
@@ -715,6 +741,40 @@ class TableBuilder
     };
   }
 
+  /// Creates a lambda which appends a batch of rows at once, given as
+  /// one contiguous range of values per column. All the ranges must have
+  /// the same size. nRows is the expected total number of rows, which is
+  /// reserved up front. This cannot be mixed with the per-row cursors.
+  template <typename... ARGS>
+  auto bulkPersistSpans(std::vector<std::string> const& columnNames, size_t nRows)
+  {
+    constexpr int nColumns = sizeof...(ARGS);
+    validate(nColumns, columnNames);
+    mArrays.resize(nColumns);
+    makeBuilders<ARGS...>(columnNames, nRows);
+    makeFinalizer<ARGS...>();
+
+    return [holders = mHolders](unsigned int slot, gsl::span<ARGS const>... args) -> void {
+      std::array<size_t, sizeof...(ARGS)> sizes{args.size()...};
+      if (std::any_of(sizes.begin(), sizes.end(), [&sizes](size_t size) { return size != sizes[0]; })) {
+        throwError(runtime_error("Columns of different size in bulk append"));
+      }
+      if (TableBuilderHelpers::bulkAppendSpans(*(HoldersTuple<ARGS...>*)holders, std::index_sequence_for<ARGS...>{}, std::forward_as_tuple(args...)) == false) {
+        throwError(runtime_error("Unable to append"));
+      }
+    };
+  }
+
+  /// Same as cursor(), but appending whole columns: the lambda takes
+  /// one range of values per persistent column of T.
+  template <typename T>
+  auto bulkCursor(size_t nRows)
+  {
+    using persistent_columns_pack = typename T::table_t::persistent_columns_t;
+    constexpr auto persistent_size = pack_size(persistent_columns_pack{});
+    return bulkCursorHelper<typename soa::PackToTable<persistent_columns_pack>::table>(nRows, std::make_index_sequence<persistent_size>());
+  }
+
   /// Reserve method to expand the columns as needed.
   template <typename... ARGS>
   auto reserve(o2::framework::pack<ARGS...> pack, int s)
@@ -746,6 +806,13 @@ class TableBuilder
     return this->template persist<typename pack_element_t<Is, typename T::columns>::type...>(columnNames);
   }
 
+  template <typename T, size_t... Is>
+  auto bulkCursorHelper(size_t nRows, std::index_sequence<Is...>)
+  {
+    std::vector<std::string> columnNames{pack_element_t<Is, typename T::columns>::columnLabel()...};
+    return this->template bulkPersistSpans<typename pack_element_t<Is, typename T::columns>::type...>(columnNames, nRows);
+  }
+
   template <typename T, typename E, size_t... Is>
   auto cursorHelper(std::index_sequence<Is...>)
   {
@@ -121,6 +121,7 @@ void doBoostException(boost::exception& e);
 void doDPLException(o2::framework::RuntimeErrorRef& ref);
 void doUnknownException(std::string const& s);
 void doDefaultWorkflowTerminationHook();
+char* getIdString(int argc, char** argv);
 
 int main(int argc, char** argv)
 {
@@ -177,13 +178,7 @@ int main(int argc, char** argv)
     doUnknownException("");
   }
 
-  char* idstring = nullptr;
-  for (int argi = 0; argi < argc; argi++) {
-    if (strcmp(argv[argi], "--id") == 0 && argi + 1 < argc) {
-      idstring = argv[argi + 1];
-      break;
-    }
-  }
+  char* idstring = getIdString(argc, argv);
   o2::framework::OnWorkflowTerminationHook onWorkflowTerminationHook;
   UserCustomizationsHelper::userDefinedCustomization(onWorkflowTerminationHook, 0);
   onWorkflowTerminationHook(idstring);
@@ -11,9 +11,19 @@
 #include "Framework/RCombinedDS.h"
 #include "Framework/TableBuilder.h"
 #include "Framework/TableConsumer.h"
+#include "Framework/RuntimeError.h"
 
 #include <ROOT/RDataFrame.hxx>
 #include <ROOT/RArrowDS.hxx>
+#include <arrow/buffer.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 using namespace ROOT::RDF;
 
@@ -42,4 +52,226 @@ ROOT::RDataFrame doSelfCombinationsWith(std::unique_ptr<framework::TableConsumer
 }
 
 } // namespace analysis
+
+namespace framework
+{
+
+int IndexBuilderHelpers::sNThreads = 1;
+
+void IndexBuilderHelpers::setNThreads(int n)
+{
+  sNThreads = n > 0 ? n : 1;
+}
+
+void IndexBuilderHelpers::setKeys(IndexBuilderKeys& keys, arrow::ChunkedArray* column)
+{
+  if (column->num_chunks() == 1) {
+    keys.keys = std::static_pointer_cast<arrow::Int32Array>(column->chunk(0))->raw_values();
+    return;
+  }
+  keys.buffer.reserve(keys.size);
+  for (auto const& chunk : column->chunks()) {
+    auto values = std::static_pointer_cast<arrow::Int32Array>(chunk)->raw_values();
+    keys.buffer.insert(keys.buffer.end(), values, values + chunk->length());
+  }
+  keys.keys = keys.buffer.data();
+}
+
+namespace
+{
+/// Workers kept for the lifetime of the process, so that building an index
+/// does not spawn threads
+class WorkerPool
+{
+ public:
+  static WorkerPool& instance()
+  {
+    static WorkerPool pool;
+    return pool;
+  }
+
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mCondition.notify_all();
+    for (auto& worker : mWorkers) {
+      worker.join();
+    }
+  }
+
+  /// Run process(i) for i in [0, n), in the calling thread and in at most nHelpers workers
+  void run(size_t n, size_t nHelpers, std::function<void(size_t)> const& process)
+  {
+    nHelpers = std::min(nHelpers, n - std::min<size_t>(n, 1));
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+      for (auto i = next++; i < n; i = next++) {
+        process(i);
+      }
+    };
+    size_t running = nHelpers;
+    std::condition_variable finished;
+    if (nHelpers) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      while (mWorkers.size() < nHelpers) {
+        mWorkers.emplace_back([this]() { loop(); });
+      }
+      for (size_t i = 0; i < nHelpers; ++i) {
+        mTasks.emplace_back([&]() {
+          work();
+          std::lock_guard<std::mutex> lock(mMutex);
+          if (--running == 0) {
+            finished.notify_all();
+          }
+        });
+      }
+      mCondition.notify_all();
+    }
+    work();
+    std::unique_lock<std::mutex> lock(mMutex);
+    finished.wait(lock, [&running]() { return running == 0; });
+  }
+
+ private:
+  void loop()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+      mCondition.wait(lock, [this]() { return mStop || !mTasks.empty(); });
+      if (mTasks.empty()) {
+        return;
+      }
+      auto task = std::move(mTasks.front());
+      mTasks.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::deque<std::function<void()>> mTasks;
+  std::vector<std::thread> mWorkers;
+  bool mStop = false;
+};
+
+/// Position reached by lowerBound() (TableBuilder.h) on the iterator of the
+/// row-wise builders, reproduced step by step so that both builders bind the
+/// same rows, also when the keys are duplicated
+int64_t lowerBoundRowWise(IndexBuilderKeys const& keys, int64_t pos, int32_t idx)
+{
+  int64_t step;
+  auto count = keys.size - (keys.offset + pos);
+  while (count > 0) {
+    step = count / 2;
+    pos += step;
+    if (keys.keys[pos] <= idx) {
+      count -= step + 1;
+    } else {
+      pos -= step;
+      count = step;
+    }
+  }
+  return pos;
+}
+
+/// Global index of the row matching idx, which is then consumed, or -1
+int32_t matchKey(IndexBuilderKeys const& keys, int64_t& pos, int32_t idx)
+{
+  pos = lowerBoundRowWise(keys, pos, idx);
+  if (pos < keys.size && keys.keys[pos] == idx) {
+    return static_cast<int32_t>(keys.offset + pos++);
+  }
+  return -1;
+}
+
+/// Row of the other table bound to every row of the first one, or -1. The
+/// position in each table only depends on the keys of the first one, so the
+/// tables are processed independently
+void bindRows(IndexBuilderKeys const& first, IndexBuilderKeys const& other, int32_t* values)
+{
+  int64_t pos = 0;
+  for (int64_t row = 0; row < first.size; ++row) {
+    values[row] = matchKey(other, pos, first.keys[row]);
+  }
+}
+
+std::shared_ptr<arrow::Buffer> allocateColumn(int64_t nRows)
+{
+  auto buffer = arrow::AllocateBuffer(nRows * sizeof(int32_t));
+  if (!buffer.ok()) {
+    throw_error(runtime_error_f("Unable to allocate index column of %lld rows", static_cast<long long>(nRows)));
+  }
+  return std::move(buffer).ValueOrDie();
+}
+
+std::shared_ptr<arrow::Table> makeIndexTable(std::vector<std::string> const& labels, std::vector<std::shared_ptr<arrow::Buffer>> const& columns, int64_t nRows)
+{
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (size_t i = 0; i < labels.size(); ++i) {
+    fields.push_back(arrow::field(labels[i], arrow::int32()));
+    arrays.push_back(std::make_shared<arrow::Int32Array>(nRows, columns[i]));
+  }
+  return arrow::Table::Make(std::make_shared<arrow::Schema>(fields), arrays);
+}
+} // namespace
+
+std::shared_ptr<arrow::Table> IndexBuilderHelpers::buildExclusive(std::vector<std::string> const& labels, std::vector<IndexBuilderKeys> const& keys)
+{
+  auto const& first = keys[0];
+  auto nOthers = keys.size() - 1;
+
+  // the bound rows of all the other tables, of which the rows matched everywhere are kept
+  std::vector<std::vector<int32_t>> bound(nOthers, std::vector<int32_t>(first.size));
+  WorkerPool::instance().run(nOthers, sNThreads - 1, [&](size_t i) {
+    bindRows(first, keys[i + 1], bound[i].data());
+  });
+
+  std::vector<int64_t> selected;
+  for (int64_t row = 0; row < first.size; ++row) {
+    if (std::all_of(bound.begin(), bound.end(), [row](auto const& values) { return values[row] >= 0; })) {
+      selected.push_back(row);
+    }
+  }
+  int64_t nRows = selected.size();
+  std::vector<std::shared_ptr<arrow::Buffer>> columns;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    columns.push_back(allocateColumn(nRows));
+    auto data = reinterpret_cast<int32_t*>(columns.back()->mutable_data());
+    for (int64_t j = 0; j < nRows; ++j) {
+      data[j] = i == 0 ? static_cast<int32_t>(first.offset + selected[j]) : bound[i - 1][selected[j]];
+    }
+  }
+  return makeIndexTable(labels, columns, nRows);
+}
+
+std::shared_ptr<arrow::Table> IndexBuilderHelpers::buildSparse(std::vector<std::string> const& labels, std::vector<IndexBuilderKeys> const& keys)
+{
+  auto const& first = keys[0];
+  auto nOthers = keys.size() - 1;
+
+  // every row of the first table is in the index, the columns are filled directly
+  std::vector<std::shared_ptr<arrow::Buffer>> columns;
+  std::vector<int32_t*> data;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    columns.push_back(allocateColumn(first.size));
+    data.push_back(reinterpret_cast<int32_t*>(columns.back()->mutable_data()));
+  }
+  std::iota(data[0], data[0] + first.size, static_cast<int32_t>(first.offset));
+  WorkerPool::instance().run(nOthers, sNThreads - 1, [&](size_t i) {
+    if (keys[i + 1].isKey) {
+      std::copy(first.keys, first.keys + first.size, data[i + 1]);
+    } else {
+      bindRows(first, keys[i + 1], data[i + 1]);
+    }
+  });
+  return makeIndexTable(labels, columns, first.size);
+}
+
+} // namespace framework
 } // namespace o2
@@ -17,6 +17,7 @@
 #include "Framework/RawDeviceService.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/EndOfStreamContext.h"
+#include "Framework/ProcessingContext.h"
 #include "Framework/Tracing.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceInfo.h"
@@ -38,6 +39,25 @@ namespace o2::framework
 struct EndOfStreamContext;
 struct ProcessingContext;
 
+namespace
+{
+/// Send the counters of the payload (re)allocations, at most every 5 seconds
+auto sendAllocationMetrics(ServiceRegistry& services, MessageContext& context) -> void
+{
+  using namespace o2::monitoring;
+  static uint64_t lastSent = 0;
+  auto now = uv_hrtime() / 1000000;
+  if (now - lastSent < 5000) {
+    return;
+  }
+  lastSent = now;
+  auto& stats = context.getAllocationStats();
+  auto& monitoring = services.get<Monitoring>();
+  monitoring.send(Metric{(uint64_t)stats.reallocations, "output_reallocations"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+  monitoring.send(Metric{(uint64_t)stats.wastedBytes, "output_wasted_bytes"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+}
+} // namespace
+
 o2::framework::ServiceSpec CommonMessageBackends::fairMQBackendSpec()
 {
   return ServiceSpec{"fairmq-backend",
@@ -64,7 +84,13 @@ o2::framework::ServiceSpec CommonMessageBackends::fairMQBackendSpec()
                      },
                      CommonServices::noConfiguration(),
                      CommonMessageBackendsHelpers<MessageContext>::clearContext(),
-                     CommonMessageBackendsHelpers<MessageContext>::sendCallback(),
+                     [](ProcessingContext& ctx, void* service) {
+                       ZoneScopedN("send message callback");
+                       auto* context = reinterpret_cast<MessageContext*>(service);
+                       auto& device = ctx.services().get<RawDeviceService>();
+                       DataProcessor::doSend(*device.device(), *context, ctx.services());
+                       sendAllocationMetrics(ctx.services(), *context);
+                     },
                      nullptr,
                      nullptr,
                      CommonMessageBackendsHelpers<MessageContext>::clearContextEOS(),
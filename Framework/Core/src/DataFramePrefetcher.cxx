@@ -0,0 +1,148 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/DataFramePrefetcher.h"
+#include "Framework/Logger.h"
+
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <set>
+
+namespace o2::framework
+{
+
+DataFramePrefetcher::DataFramePrefetcher(std::shared_ptr<DataInputDirector> didir, std::vector<header::DataHeader> headers, int64_t memoryBudget)
+  : mDIDir{didir},
+    mHeaders{std::move(headers)},
+    mMemoryBudget{memoryBudget}
+{
+  // the files are opened and read by a background thread
+  ROOT::EnableThreadSafety();
+}
+
+DataFramePrefetcher::~DataFramePrefetcher()
+{
+  wait();
+}
+
+void DataFramePrefetcher::wait()
+{
+  if (mNext.valid()) {
+    mNext.wait();
+  }
+}
+
+void DataFramePrefetcher::request(int counter, int numTF, int stride)
+{
+  wait();
+  // the file names are resolved here, the background task does not use the DataInputDirector
+  std::vector<TableSource> sources;
+  for (auto const& dh : mHeaders) {
+    sources.push_back({mDIDir->getTreeName(dh), mDIDir->getFileName(dh, counter), mDIDir->getFileName(dh, counter + stride)});
+  }
+  mNext = std::async(std::launch::async, [this, sources = std::move(sources), counter, numTF, stride]() {
+    return read(sources, counter, numTF, stride);
+  });
+}
+
+PrefetchedDataFrame DataFramePrefetcher::get()
+{
+  if (!mNext.valid()) {
+    throw std::runtime_error("No DF was requested to the prefetcher");
+  }
+  return mNext.get();
+}
+
+std::shared_ptr<TFile> DataFramePrefetcher::openFile(std::string const& fileName)
+{
+  auto found = mFiles.find(fileName);
+  if (found != mFiles.end()) {
+    return found->second;
+  }
+  std::shared_ptr<TFile> file(TFile::Open(fileName.c_str()), [](TFile* f) {
+    if (f) {
+      f->Close();
+      delete f;
+    }
+  });
+  if (!file) {
+    throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", fileName));
+  }
+  file->SetReadaheadSize(50 * 1024 * 1024);
+  mFiles.emplace(fileName, file);
+  return file;
+}
+
+PrefetchedDataFrame DataFramePrefetcher::read(std::vector<TableSource> const& sources, int counter, int numTF, int stride)
+{
+  PrefetchedDataFrame df;
+  if (sources.empty()) {
+    df.atEnd = true;
+    return df;
+  }
+
+  // the DFs of the first table decide when to move to the next file
+  bool nextFile = false;
+  std::vector<uint64_t> numbers;
+  for (;;) {
+    auto const& fileName = nextFile ? sources[0].nextFileName : sources[0].fileName;
+    if (fileName.empty()) {
+      df.atEnd = true;
+      return df;
+    }
+    numbers = getTimeFrameNumbers(openFile(fileName).get());
+    if (numTF < (int)numbers.size()) {
+      break;
+    }
+    if (nextFile) {
+      throw std::runtime_error(fmt::format("No DF found in file \"{}\"!", fileName));
+    }
+    nextFile = true;
+    counter += stride;
+    numTF = 0;
+  }
+  df.counter = counter;
+  df.numTF = numTF;
+  df.timeFrameNumber = numbers[numTF];
+  df.timeFramesInFile = numbers.size();
+
+  auto folderName = "DF_" + std::to_string(df.timeFrameNumber);
+  auto budget = mMemoryBudget;
+  std::set<std::string> used;
+  for (auto const& source : sources) {
+    auto const& fileName = nextFile ? source.nextFileName : source.fileName;
+    auto file = openFile(fileName);
+    auto treeName = folderName + "/" + source.treeName;
+    // a missing tree is reported by the reader when it takes the DF
+    auto tree = (TTree*)file->Get(treeName.c_str());
+    // what does not fit in the budget is read when the tree is converted
+    if (tree && budget > 0) {
+      tree->LoadBaskets(budget);
+      budget -= std::min(budget, (int64_t)tree->GetZipBytes());
+    }
+    if (!df.file) {
+      df.file = file;
+    }
+    if (used.insert(fileName).second) {
+      df.files.push_back(file);
+    }
+    df.trees.push_back(tree);
+  }
+
+  // files which are not needed anymore are closed once the DFs using them are gone
+  for (auto it = mFiles.begin(); it != mFiles.end();) {
+    it = used.count(it->first) ? std::next(it) : mFiles.erase(it);
+  }
+  return df;
+}
+
+} // namespace o2::framework
@@ -33,6 +33,24 @@ FileNameHolder* makeFileNameHolder(std::string fileName)
   return fileNameHolder;
 }
 
+std::vector<uint64_t> getTimeFrameNumbers(TFile* file)
+{
+  std::vector<uint64_t> numbers;
+  std::regex TFRegex = std::regex("DF_[0-9]+");
+  TList* keyList = file->GetListOfKeys();
+
+  // extract TF numbers and sort accordingly
+  for (auto key : *keyList) {
+    if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
+      auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
+      numbers.emplace_back(folderNumber);
+    }
+  }
+  std::sort(numbers.begin(), numbers.end());
+
+  return numbers;
+}
+
 DataInputDescriptor::DataInputDescriptor(bool alienSupport)
 {
   mAlienSupport = alienSupport;
@@ -106,17 +124,7 @@ bool DataInputDescriptor::setFile(int counter)
 
   // get the directory names
   if (mfilenames[counter]->numberOfTimeFrames <= 0) {
-    std::regex TFRegex = std::regex("DF_[0-9]+");
-    TList* keyList = mcurrentFile->GetListOfKeys();
-
-    // extract TF numbers and sort accordingly
-    for (auto key : *keyList) {
-      if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
-        auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
-        mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
-      }
-    }
-    std::sort(mfilenames[counter]->listOfTimeFrameNumbers.begin(), mfilenames[counter]->listOfTimeFrameNumbers.end());
+    mfilenames[counter]->listOfTimeFrameNumbers = getTimeFrameNumbers(mcurrentFile);
 
     for (auto folderNumber : mfilenames[counter]->listOfTimeFrameNumbers) {
       auto folderName = "DF_" + std::to_string(folderNumber);
@@ -164,6 +172,14 @@ FileAndFolder DataInputDescriptor::getFileFolder(int counter, int numTF)
   return fileAndFolder;
 }
 
+std::string DataInputDescriptor::getFileName(int counter)
+{
+  if (counter < 0 || counter >= getNumberInputfiles()) {
+    return "";
+  }
+  return mfilenames[counter]->fileName;
+}
+
 int DataInputDescriptor::getTimeFramesInFile(int counter)
 {
   return mfilenames.at(counter)->numberOfTimeFrames;
@@ -553,21 +569,37 @@ uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counte
   return didesc->getTimeFrameNumber(counter, numTF);
 }
 
+std::string DataInputDirector::getTreeName(header::DataHeader dh)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  if (didesc) {
+    // if match then use treename from DataInputDescriptor
+    return didesc->treename;
+  }
+  // if NOT match then use treename from DataHeader
+  return aod::datamodel::getTreeName(dh);
+}
+
+std::string DataInputDirector::getFileName(header::DataHeader dh, int counter)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  // if NOT match then use defaultDataInputDescriptor
+  if (!didesc) {
+    didesc = mdefaultDataInputDescriptor;
+  }
+
+  return didesc->getFileName(counter);
+}
+
 TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int numTF)
 {
-  std::string treename;
   TTree* tree = nullptr;
+  auto treename = getTreeName(dh);
 
   auto didesc = getDataInputDescriptor(dh);
-  if (didesc) {
-    // if match then use filename and treename from DataInputDescriptor
-    treename = didesc->treename;
-  } else {
-    // if NOT match then use
-    //  . filename from defaultDataInputDescriptor
-    //  . treename from DataHeader
+  // if NOT match then use filename from defaultDataInputDescriptor
+  if (!didesc) {
     didesc = mdefaultDataInputDescriptor;
-    treename = aod::datamodel::getTreeName(dh);
   }
 
   auto fileAndFolder = didesc->getFileFolder(counter, numTF);
@@ -12,9 +12,12 @@
 #include "Framework/VariantHelpers.h"
 #include "Framework/Logger.h"
 #include "Framework/RuntimeError.h"
+#include "Framework/ServiceRegistry.h"
 #include "gandiva/tree_expr_builder.h"
 #include "arrow/table.h"
 #include "fmt/format.h"
+#include <Monitoring/Monitoring.h>
+#include <chrono>
 #include <stack>
 #include <iostream>
 #include <unordered_map>
@@ -308,19 +311,165 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(node, result);
 }
 
-std::shared_ptr<gandiva::Filter>
-  createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
+namespace
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+double msSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the operation sequence fully describes the expression: operators, column names,
+// literal values and the inferred types. Literals are written in their shortest
+// exact form so that different values never share a key
+void appendKey(std::string& key, DatumSpec const& spec)
+{
+  key += fmt::format("{}:{}:", spec.datum.index(), static_cast<int>(spec.type));
+  std::visit(
+    overloaded{
+      [&key](LiteralNode::var_t const& arg) {
+        std::visit(
+          [&key, index = arg.index()](auto const& value) { key += fmt::format("{}:{}", index, value); },
+          arg);
+      },
+      [&key](size_t const& arg) { key += fmt::format("{}", arg); },
+      [&key](std::string const& arg) { key += arg; },
+      [](auto const&) {}},
+    spec.datum);
+  key += ';';
+}
+
+void appendKey(std::string& key, Operations const& opSpecs)
+{
+  for (auto& spec : opSpecs) {
+    key += fmt::format("{}:{}(", static_cast<int>(spec.op), static_cast<int>(spec.type));
+    appendKey(key, spec.left);
+    appendKey(key, spec.right);
+    appendKey(key, spec.result);
+    key += ')';
+  }
+  key += '\n';
+}
+
+// look up the key, compile on a miss without holding the lock: concurrent misses
+// on the same key compile twice and the first object stored is kept
+template <typename T, typename F>
+std::shared_ptr<T> getOrCompile(std::mutex& mutex, std::unordered_map<std::string, std::shared_ptr<T>>& objects,
+                                std::string&& key, F&& compile, bool& hit)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto it = objects.find(key); it != objects.end()) {
+      hit = true;
+      return it->second;
+    }
   }
+  hit = false;
+  auto object = compile();
+  std::lock_guard<std::mutex> lock(mutex);
+  return objects.emplace(std::move(key), std::move(object)).first->second;
+}
+} // namespace
+
+ExpressionCache& ExpressionCache::instance()
+{
+  static ExpressionCache cache;
+  return cache;
+}
+
+void ExpressionCache::count(bool hit, double ms)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (hit) {
+    mStatistics.hits++;
+    mStatistics.hitTime += ms;
+  } else {
+    mStatistics.misses++;
+    mStatistics.missTime += ms;
+  }
+}
+
+std::shared_ptr<gandiva::Filter>
+  ExpressionCache::getFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto key = Schema->ToString() + '\n';
+  appendKey(key, opSpecs);
+  auto compile = [&]() {
+    return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
+  };
+  bool hit = false;
+  auto filter = getOrCompile(mMutex, mFilters, std::move(key), compile, hit);
+  count(hit, msSince(start));
   return filter;
 }
 
+std::shared_ptr<gandiva::Projector>
+  ExpressionCache::getProjector(gandiva::SchemaPtr const& Schema, std::vector<Operations> const& opSpecs, gandiva::FieldVector const& results)
+{
+  if (opSpecs.size() != results.size()) {
+    throw runtime_error_f("Mismatch between %zu expressions and %zu result fields", opSpecs.size(), results.size());
+  }
+  auto start = std::chrono::steady_clock::now();
+  auto key = Schema->ToString() + '\n';
+  for (auto i = 0u; i < opSpecs.size(); ++i) {
+    key += results[i]->ToString();
+    appendKey(key, opSpecs[i]);
+  }
+  auto compile = [&]() {
+    gandiva::ExpressionVector expressions;
+    for (auto i = 0u; i < opSpecs.size(); ++i) {
+      expressions.push_back(makeExpression(createExpressionTree(opSpecs[i], Schema), results[i]));
+    }
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema, expressions, &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  };
+  bool hit = false;
+  auto projector = getOrCompile(mMutex, mProjectors, std::move(key), compile, hit);
+  count(hit, msSince(start));
+  return projector;
+}
+
+ExpressionCache::Statistics ExpressionCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mStatistics;
+}
+
+void ExpressionCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFilters.clear();
+  mProjectors.clear();
+  mStatistics = Statistics{};
+}
+
+void ExpressionCache::report(ServiceRegistry& services) const
+{
+  using namespace o2::monitoring;
+  auto stats = getStatistics();
+  if (stats.hits + stats.misses == 0) {
+    return;
+  }
+  LOGP(INFO, "Expression cache: {} compilations in {:.1f} ms, {} reuses in {:.1f} ms",
+       stats.misses, stats.missTime, stats.hits, stats.hitTime);
+  auto& monitoring = services.get<Monitoring>();
+  monitoring.send(Metric{(uint64_t)stats.misses, "expression-cache-misses"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+  monitoring.send(Metric{(uint64_t)stats.hits, "expression-cache-hits"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+  monitoring.send(Metric{stats.missTime, "expression-cache-miss-time-ms"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+  monitoring.send(Metric{stats.hitTime, "expression-cache-hit-time-ms"}.addTag(tags::Key::Subsystem, tags::Value::DPL));
+  monitoring.flushBuffer();
+}
+
+std::shared_ptr<gandiva::Filter>
+  createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
+{
+  return ExpressionCache::instance().getFilter(Schema, opSpecs);
+}
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
@@ -337,14 +486,13 @@ std::shared_ptr<gandiva::Filter>
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), result)},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
-  return projector;
+  return ExpressionCache::instance().getProjector(Schema, {opSpecs}, {std::move(result)});
+}
+
+std::shared_ptr<gandiva::Projector>
+  createProjector(gandiva::SchemaPtr const& Schema, std::vector<Operations> const& opSpecs, gandiva::FieldVector const& results)
+{
+  return ExpressionCache::instance().getProjector(Schema, opSpecs, results);
 }
 
 std::shared_ptr<gandiva::Projector>
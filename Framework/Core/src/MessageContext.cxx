@@ -44,5 +44,40 @@ o2::header::DataHeader* MessageContext::findMessageHeader(const Output& spec)
   return nullptr;
 }
 
+MessageContext::PayloadSizeInfo& MessageContext::getPayloadSizeInfo(ConcreteDataMatcher const& matcher)
+{
+  for (auto& info : mPayloadSizes) {
+    if (info.matcher == matcher) {
+      return info;
+    }
+  }
+  return mPayloadSizes.emplace_back(PayloadSizeInfo{matcher});
+}
+
+size_t MessageContext::expectedPayloadSize(const Output& spec)
+{
+  auto& info = getPayloadSizeInfo({spec.origin, spec.description, spec.subSpec});
+  return info.hint ? info.hint : info.expected;
+}
+
+void MessageContext::setPayloadSizeHint(const Output& spec, size_t size)
+{
+  getPayloadSizeInfo({spec.origin, spec.description, spec.subSpec}).hint = size;
+}
+
+void MessageContext::updatePayloadSize(o2::header::DataHeader const& header, size_t size, size_t allocations, size_t allocatedBytes)
+{
+  auto& info = getPayloadSizeInfo({header.dataOrigin, header.dataDescription, header.subSpecification});
+  // the maximum decays by 1/8 per timeslice, so that a single large timeslice
+  // does not keep the following ones overallocated for long
+  info.expected = std::max(size, info.expected - info.expected / 8);
+  if (allocations > 1) {
+    mAllocationStats.reallocations += allocations - 1;
+  }
+  if (allocatedBytes > size) {
+    mAllocationStats.wastedBytes += allocatedBytes - size;
+  }
+}
+
 } // namespace framework
 } // namespace o2
@@ -152,6 +152,10 @@ std::vector<DeviceMetricsInfo> gDeviceMetricsInfos;
 // overloaded in the config spec
 bpo::options_description gHiddenDeviceOptions("Hidden child options");
 
+// Id of the device when this process was forked from the driver without exec.
+// In this case the --id option is not part of the command line of the process.
+std::string gForkedDeviceId;
+
 // To be used to allow specifying the TerminationPolicy on the command line.
 namespace o2::framework
 {
@@ -636,9 +640,28 @@ void ws_connect_callback(uv_stream_t* server, int status)
   }
 }
 
+/// Release in a device forked from the driver without exec the state of the
+/// driver it inherited: the kernel state of the driver loop, which would be
+/// shared with the driver otherwise, and the descriptors of the driver handles
+/// (websocket server and connections, pipes from the other devices).
+void releaseDriverLoop(uv_loop_t* loop)
+{
+  uv_loop_fork(loop);
+  uv_walk(
+    loop, [](uv_handle_t* handle, void*) {
+      uv_os_fd_t fd;
+      if (uv_fileno(handle, &fd) == 0) {
+        close(fd);
+      }
+    },
+    nullptr);
+}
+
 /// This will start a new device by forking and executing a
-/// new child
-void spawnDevice(std::string const& forwardedStdin,
+/// new child. If @a noExec is true, the child does not exec and the
+/// function returns true in the child, which is then expected to run
+/// the device out of the DeviceSpec already computed by the driver.
+bool spawnDevice(std::string const& forwardedStdin,
                  DeviceSpec const& spec,
                  DriverInfo& driverInfo,
                  DeviceControl& control,
@@ -649,7 +672,8 @@ void spawnDevice(std::string const& forwardedStdin,
                  uv_loop_t* loop,
                  std::vector<uv_poll_t*> handles,
                  unsigned parentCPU,
-                 unsigned parentNode)
+                 unsigned parentNode,
+                 bool noExec)
 {
   int childstdin[2];
   int childstdout[2];
@@ -708,6 +732,12 @@ void spawnDevice(std::string const& forwardedStdin,
                                  .c_str());
       putenv(formatted);
     }
+    if (noExec) {
+      // The driver signal handlers are not reset by exec in this case.
+      signal(SIGINT, SIG_DFL);
+      signal(SIGCHLD, SIG_DFL);
+      return true;
+    }
     execvp(execution.args[0], execution.args.data());
   }
   if (varmap.count("post-fork-command")) {
@@ -767,9 +797,12 @@ void spawnDevice(std::string const& forwardedStdin,
   close(childstdin[0]);
   close(childstdout[1]);
   close(childstderr[1]);
-  size_t result = write(childstdin[1], forwardedStdin.data(), forwardedStdin.size());
-  if (result != forwardedStdin.size()) {
-    LOG(ERROR) << "Unable to pass configuration to children";
+  // A child which was not exec'ed does not import the workflow from stdin
+  if (noExec == false) {
+    size_t result = write(childstdin[1], forwardedStdin.data(), forwardedStdin.size());
+    if (result != forwardedStdin.size()) {
+      LOG(ERROR) << "Unable to pass configuration to children";
+    }
   }
   close(childstdin[1]); // Not allowing further communication...
 
@@ -799,6 +832,7 @@ void spawnDevice(std::string const& forwardedStdin,
 
   addPoller(deviceInfos.size() - 1, childstdout[0]);
   addPoller(deviceInfos.size() - 1, childstderr[0]);
+  return false;
 }
 
 
@@ -969,6 +1003,19 @@ void doUnknownException(std::string const& s)
   }
 }
 
+char* getIdString(int argc, char** argv)
+{
+  if (gForkedDeviceId.empty() == false) {
+    return gForkedDeviceId.data();
+  }
+  for (int argi = 0; argi < argc; argi++) {
+    if (strcmp(argv[argi], "--id") == 0 && argi + 1 < argc) {
+      return argv[argi + 1];
+    }
+  }
+  return nullptr;
+}
+
 void doDefaultWorkflowTerminationHook()
 {
   //LOG(INFO) << "Process " << getpid() << " is exiting.";
@@ -1161,6 +1208,11 @@ int runStateMachine(DataProcessorSpecs const& workflow,
     LOG(WARN) << "Could not create GUI. Switching to batch mode. Do you have GLFW on your system?";
     driverInfo.batch = true;
   }
+  // The GUI context cannot be shared with the devices forked without exec
+  if (driverInfo.forkServer && window != nullptr) {
+    LOG(WARN) << "Fork server disabled when running with the GUI, devices will be exec'ed.";
+    driverInfo.forkServer = false;
+  }
   bool guiQuitRequested = false;
   bool hasError = false;
 
@@ -1512,15 +1564,41 @@ int runStateMachine(DataProcessorSpecs const& workflow,
         for (auto& callback : preScheduleCallbacks) {
           callback(serviceRegistry, varmap);
         }
+        // With the fork server, the devices defined by this executable with the same
+        // command line as the driver are forked from the driver and run out of the
+        // DeviceSpecs computed here, without re-executing the workflow definition and
+        // reloading the libraries. Devices imported from other executables are exec'ed.
+        auto canSkipExec = [&dataProcessorInfos, &workflowInfo](DeviceSpec const& spec) -> bool {
+          auto pi = std::find_if(dataProcessorInfos.begin(), dataProcessorInfos.end(),
+                                 [&spec](DataProcessorInfo const& info) { return info.name == spec.id; });
+          return pi != dataProcessorInfos.end() && pi->executable == workflowInfo.executable && pi->cmdLineArgs == workflowInfo.args;
+        };
         for (size_t di = 0; di < deviceSpecs.size(); ++di) {
           if (deviceSpecs[di].resource.hostname != driverInfo.deployHostname) {
             spawnRemoteDevice(forwardedStdin.str(),
                               deviceSpecs[di], controls[di], deviceExecutions[di], infos);
           } else {
-            spawnDevice(forwardedStdin.str(),
-                        deviceSpecs[di], driverInfo,
-                        controls[di], deviceExecutions[di], infos,
-                        serviceRegistry, varmap, loop, pollHandles, parentCPU, parentNode);
+            bool noExec = driverInfo.forkServer && canSkipExec(deviceSpecs[di]);
+            if (spawnDevice(forwardedStdin.str(),
+                            deviceSpecs[di], driverInfo,
+                            controls[di], deviceExecutions[di], infos,
+                            serviceRegistry, varmap, loop, pollHandles, parentCPU, parentNode, noExec)) {
+              // We are the child forked without exec: run the device with the
+              // arguments it would have been exec'ed with.
+              if (driverControl.defaultStopped) {
+                kill(getpid(), SIGSTOP);
+              }
+              // The driver loop is never run again here, the device gets a fresh one.
+              releaseDriverLoop(loop);
+              gForkedDeviceId = deviceSpecs[di].id;
+              auto& execution = deviceExecutions[di];
+              auto errorPolicy = varmap["error-policy"].defaulted() ? TerminationPolicy::QUIT : varmap["error-policy"].as<TerminationPolicy>();
+              ServiceRegistry deviceRegistry;
+              return doChild(execution.args.size() - 1, execution.args.data(),
+                             deviceRegistry, deviceSpecs[di],
+                             errorPolicy, "stdout://",
+                             uv_loop_new());
+            }
           }
         }
         for (auto& callback : postScheduleCallbacks) {
@@ -2064,6 +2142,7 @@ int doMain(int argc, char** argv, o2::framework::WorkflowSpec const& workflow,
     ("dump-workflow-file", bpo::value<std::string>()->default_value("-"), "file to which do the dump")                                         //                                                                                                                                      //
     ("run", bpo::value<bool>()->zero_tokens()->default_value(false), "run workflow merged so far")                                             //                                                                                                                                        //
     ("no-IPC", bpo::value<bool>()->zero_tokens()->default_value(false), "disable IPC topology optimization")                                   //                                                                                                                                        //
+    ("fork-server", bpo::value<bool>()->zero_tokens()->default_value(false), "fork devices from the driver without exec")                      //
     ("o2-control,o2", bpo::value<std::string>()->default_value(""), "dump O2 Control workflow configuration under the specified name")         //
     ("resources-monitoring", bpo::value<unsigned short>()->default_value(0), "enable cpu/memory monitoring for provided interval in seconds"); //
   // some of the options must be forwarded by default to the device
@@ -2265,6 +2344,7 @@ int doMain(int argc, char** argv, o2::framework::WorkflowSpec const& workflow,
   driverInfo.argv = argv;
   driverInfo.batch = varmap["no-batch"].defaulted() ? varmap["batch"].as<bool>() : false;
   driverInfo.noSHMCleanup = varmap["no-cleanup"].as<bool>();
+  driverInfo.forkServer = varmap["fork-server"].as<bool>();
   driverInfo.terminationPolicy = varmap["completion-policy"].as<TerminationPolicy>();
   if (varmap["error-policy"].defaulted() && driverInfo.batch == false) {
     driverInfo.errorPolicy = TerminationPolicy::WAIT;
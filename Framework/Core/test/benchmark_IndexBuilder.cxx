@@ -0,0 +1,139 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/AnalysisHelpers.h"
+#include "Framework/TableBuilder.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <thread>
+
+using namespace o2::framework;
+using namespace o2::soa;
+
+DECLARE_SOA_STORE();
+namespace coords
+{
+DECLARE_SOA_COLUMN_FULL(X, x, float, "x");
+} // namespace coords
+DECLARE_SOA_TABLE(Points, "TST", "POINTS", Index<>, coords::X);
+
+namespace extra_1
+{
+DECLARE_SOA_INDEX_COLUMN(Point, point);
+DECLARE_SOA_COLUMN_FULL(D, d, float, "d");
+} // namespace extra_1
+DECLARE_SOA_TABLE(Distances, "TST", "DISTANCES", Index<>, extra_1::PointId, extra_1::D);
+
+namespace extra_2
+{
+DECLARE_SOA_INDEX_COLUMN(Point, point);
+DECLARE_SOA_COLUMN_FULL(IsTrue, istrue, bool, "istrue");
+} // namespace extra_2
+DECLARE_SOA_TABLE(Flags, "TST", "FLAGS", Index<>, extra_2::PointId, extra_2::IsTrue);
+
+namespace indices
+{
+DECLARE_SOA_INDEX_COLUMN(Point, point);
+DECLARE_SOA_INDEX_COLUMN(Distance, distance);
+DECLARE_SOA_INDEX_COLUMN(Flag, flag);
+} // namespace indices
+DECLARE_SOA_TABLE(IDXs, "TST", "INDEX", Index<>, indices::PointId, indices::DistanceId, indices::FlagId);
+
+// state.range(0) points, each with 0 to 2 distances and a flag for one point in two
+struct IndexInputs {
+  explicit IndexInputs(int nPoints)
+  {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> nDistances(0, 2);
+    TableBuilder b1;
+    auto w1 = b1.cursor<Points>();
+    TableBuilder b2;
+    auto w2 = b2.cursor<Distances>();
+    TableBuilder b3;
+    auto w3 = b3.cursor<Flags>();
+    for (auto i = 0; i < nPoints; ++i) {
+      w1(0, i * 2.f);
+      for (auto j = nDistances(gen); j > 0; --j) {
+        w2(0, i, i * 10.f);
+      }
+      if (i % 2) {
+        w3(0, i, true);
+      }
+    }
+    points = std::make_unique<Points>(b1.finalize());
+    distances = std::make_unique<Distances>(b2.finalize());
+    flags = std::make_unique<Flags>(b3.finalize());
+  }
+  std::unique_ptr<Points> points;
+  std::unique_ptr<Distances> distances;
+  std::unique_ptr<Flags> flags;
+};
+
+static void BM_IndexSparseRowWise(benchmark::State& state)
+{
+  IndexInputs inputs(state.range(0));
+  for (auto _ : state) {
+    auto table = IndexSparse::indexBuilderRowWise(typename IDXs::persistent_columns_t{}, *inputs.points, std::tie(*inputs.points, *inputs.distances, *inputs.flags));
+    benchmark::DoNotOptimize(table);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_IndexSparse(benchmark::State& state)
+{
+  IndexInputs inputs(state.range(0));
+  IndexBuilderHelpers::setNThreads(state.range(1));
+  for (auto _ : state) {
+    auto table = IndexSparse::indexBuilder(typename IDXs::persistent_columns_t{}, *inputs.points, std::tie(*inputs.points, *inputs.distances, *inputs.flags));
+    benchmark::DoNotOptimize(table);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_IndexExclusiveRowWise(benchmark::State& state)
+{
+  IndexInputs inputs(state.range(0));
+  for (auto _ : state) {
+    auto table = IndexExclusive::indexBuilderRowWise(typename IDXs::persistent_columns_t{}, *inputs.points, std::tie(*inputs.points, *inputs.distances, *inputs.flags));
+    benchmark::DoNotOptimize(table);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_IndexExclusive(benchmark::State& state)
+{
+  IndexInputs inputs(state.range(0));
+  IndexBuilderHelpers::setNThreads(state.range(1));
+  for (auto _ : state) {
+    auto table = IndexExclusive::indexBuilder(typename IDXs::persistent_columns_t{}, *inputs.points, std::tie(*inputs.points, *inputs.distances, *inputs.flags));
+    benchmark::DoNotOptimize(table);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (int nPoints : {10'000, 1'000'000}) {
+    for (int nThreads = 1; nThreads < maxThreads; nThreads *= 2) {
+      bench->Args({nPoints, nThreads});
+    }
+    bench->Args({nPoints, maxThreads});
+  }
+}
+
+BENCHMARK(BM_IndexSparseRowWise)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IndexSparse)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_IndexExclusiveRowWise)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IndexExclusive)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -94,6 +94,23 @@ static void BM_TableBuilderScalarBulk(benchmark::State& state)
 
 BENCHMARK(BM_TableBuilderScalarBulk)->Range(256, 1 << 20);
 
+static void BM_TableBuilderScalarBulkCursor(benchmark::State& state)
+{
+  using namespace o2::framework;
+  auto chunkSize = state.range(0) / 256;
+  std::vector<float> buffer(chunkSize, 0.); // We assume data is chunked in blocks 256th of the total size
+  for (auto _ : state) {
+    TableBuilder builder;
+    auto bulkWriter = builder.bulkPersistSpans<float, float, float>({"x", "y", "z"}, state.range(0));
+    for (size_t i = 0; i < state.range(0) / chunkSize; ++i) {
+      bulkWriter(0, buffer, buffer, buffer);
+    }
+    auto table = builder.finalize();
+  }
+}
+
+BENCHMARK(BM_TableBuilderScalarBulkCursor)->Range(256, 1 << 20);
+
 static void BM_TableBuilderSimple(benchmark::State& state)
 {
   using namespace o2::framework;
@@ -147,6 +147,12 @@ DataProcessorSpec getSourceSpec()
     // make a vector of POD and set some data
     pc.outputs().make<std::vector<int>>(OutputRef{"podvector"}) = {10, 21, 42};
 
+    // make a vector of POD with a size hint, the capacity follows the hint and only the data is sent
+    pc.outputs().setSizeHint(OutputRef{"sizedpodvector"}, 64 * sizeof(int));
+    auto& sizedpodvector = pc.outputs().make<std::vector<int>>(OutputRef{"sizedpodvector"});
+    ASSERT_ERROR(sizedpodvector.capacity() >= 64);
+    sizedpodvector = {11, 22, 43};
+
     // now we are done and signal this downstream
     pc.services().get<ControlService>().endOfStream();
     pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
@@ -177,7 +183,8 @@ DataProcessorSpec getSourceSpec()
                             OutputSpec{"TST", "ROOTSERLZDVEC", 0, Lifetime::Timeframe},
                             OutputSpec{"TST", "ROOTSERLZDVEC2", 0, Lifetime::Timeframe},
                             OutputSpec{"TST", "PMRTESTVECTOR", 0, Lifetime::Timeframe},
-                            OutputSpec{{"podvector"}, "TST", "PODVECTOR", 0, Lifetime::Timeframe}},
+                            OutputSpec{{"podvector"}, "TST", "PODVECTOR", 0, Lifetime::Timeframe},
+                            OutputSpec{{"sizedpodvector"}, "TST", "SIZEDPODVECTOR", 0, Lifetime::Timeframe}},
                            AlgorithmSpec(processingFct)};
 }
 
@@ -332,6 +339,14 @@ DataProcessorSpec getSinkSpec()
     ASSERT_ERROR(podvector.size() == 3);
     ASSERT_ERROR(podvector[0] == 10 && podvector[1] == 21 && podvector[2] == 42);
 
+    LOG(INFO) << "extracting POD vector made with a size hint";
+    auto sizedpodvector = pc.inputs().get<std::vector<int>>("inputSizedPODvector");
+    ASSERT_ERROR(sizedpodvector.size() == 3);
+    ASSERT_ERROR(sizedpodvector[0] == 11 && sizedpodvector[1] == 22 && sizedpodvector[2] == 43);
+    auto sizedref = pc.inputs().get<DataRef>("inputSizedPODvector");
+    auto sizedheader = o2::header::get<const o2::header::DataHeader*>(sizedref.header);
+    ASSERT_ERROR((sizedheader->payloadSize == 3 * sizeof(int)));
+
     pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
   };
 
@@ -353,6 +368,7 @@ DataProcessorSpec getSinkSpec()
                             InputSpec{"input15", "TST", "ROOTSERLZBLVECT", 0, Lifetime::Timeframe},
                             InputSpec{"inputPMR", "TST", "PMRTESTVECTOR", 0, Lifetime::Timeframe},
                             InputSpec{"inputPODvector", "TST", "PODVECTOR", 0, Lifetime::Timeframe},
+                            InputSpec{"inputSizedPODvector", "TST", "SIZEDPODVECTOR", 0, Lifetime::Timeframe},
                             InputSpec{"inputMP", ConcreteDataTypeMatcher{"TST", "MULTIPARTS"}, Lifetime::Timeframe}},
                            Outputs{OutputSpec{"TST", "MSGABLVECTORCPY", 0, Lifetime::Timeframe}},
                            AlgorithmSpec(processingFct)};
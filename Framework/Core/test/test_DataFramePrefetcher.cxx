@@ -0,0 +1,106 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DataFramePrefetcher
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Headers/DataHeader.h"
+#include "Framework/DataFramePrefetcher.h"
+#include "Framework/DataInputDirector.h"
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace o2::framework;
+using namespace o2::header;
+
+namespace
+{
+// write an AOD file with the DF folders of the numbers, the ones of withTree have a tree
+// with entries rows, the other ones are empty
+void writeAODFile(std::string const& fileName, std::string const& treeName, std::vector<int> const& numbers, std::vector<bool> const& withTree, int entries)
+{
+  std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "RECREATE"));
+  for (size_t i = 0; i < numbers.size(); ++i) {
+    auto dir = file->mkdir(("DF_" + std::to_string(numbers[i])).c_str());
+    if (!withTree[i]) {
+      continue;
+    }
+    dir->cd();
+    TTree tree(treeName.c_str(), treeName.c_str());
+    int value = 0;
+    tree.Branch("fValue", &value);
+    for (value = 0; value < entries; ++value) {
+      tree.Fill();
+    }
+    tree.Write();
+  }
+  file->Close();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestDataFramePrefetcher)
+{
+  auto dh = DataHeader(DataDescription{"TRACK"}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0});
+  std::vector<std::string> fileNames{"test_DataFramePrefetcher_0.root", "test_DataFramePrefetcher_1.root"};
+  auto didir = std::make_shared<DataInputDirector>(fileNames);
+  auto treeName = didir->getTreeName(dh);
+  // the second DF of the first file misses the tree
+  writeAODFile(fileNames[0], treeName, {3, 1, 7}, {true, false, true}, 10);
+  writeAODFile(fileNames[1], treeName, {12}, {true}, 5);
+
+  DataFramePrefetcher prefetcher(didir, {dh}, 1024 * 1024);
+
+  // the DFs are taken in the order of their numbers
+  prefetcher.request(0, 0, 1);
+  auto df = prefetcher.get();
+  BOOST_CHECK(!df.atEnd);
+  BOOST_CHECK_EQUAL(df.counter, 0);
+  BOOST_CHECK_EQUAL(df.numTF, 0);
+  BOOST_CHECK_EQUAL(df.timeFrameNumber, 1);
+  BOOST_CHECK_EQUAL(df.timeFramesInFile, 3);
+  BOOST_REQUIRE_EQUAL(df.trees.size(), 1);
+  // a missing tree is not an error of the prefetching, it is reported by the reader when it takes the DF
+  BOOST_CHECK(df.trees[0] == nullptr);
+
+  prefetcher.request(0, 1, 1);
+  df = prefetcher.get();
+  BOOST_CHECK_EQUAL(df.timeFrameNumber, 3);
+  BOOST_REQUIRE(df.trees[0] != nullptr);
+  // same content as the tree read without prefetching
+  auto tree = didir->getDataTree(dh, 0, 1);
+  BOOST_REQUIRE(tree != nullptr);
+  BOOST_CHECK_EQUAL(df.trees[0]->GetEntries(), tree->GetEntries());
+  BOOST_CHECK_EQUAL(df.trees[0]->GetEntries(), 10);
+
+  // past the last DF of the file, the first DF of the next file
+  prefetcher.request(0, 3, 1);
+  df = prefetcher.get();
+  BOOST_CHECK(!df.atEnd);
+  BOOST_CHECK_EQUAL(df.counter, 1);
+  BOOST_CHECK_EQUAL(df.numTF, 0);
+  BOOST_CHECK_EQUAL(df.timeFrameNumber, 12);
+  BOOST_REQUIRE(df.trees[0] != nullptr);
+  BOOST_CHECK_EQUAL(df.trees[0]->GetEntries(), 5);
+  df = PrefetchedDataFrame{};
+
+  // no file left
+  prefetcher.request(1, 1, 1);
+  df = prefetcher.get();
+  BOOST_CHECK(df.atEnd);
+
+  didir->closeInputFiles();
+}
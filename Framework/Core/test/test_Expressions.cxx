@@ -16,6 +16,7 @@
 #include "../src/ExpressionHelpers.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
+#include "Framework/TableBuilder.h"
 #include <boost/test/unit_test.hpp>
 
 using namespace o2::framework;
@@ -178,3 +179,59 @@ BOOST_AUTO_TEST_CASE(TestGandivaTreeCreation)
   auto schema_p = o2::soa::createSchemaFromColumns(o2::aod::Tracks::persistent_columns_t{});
   auto projector_alt = o2::framework::expressions::createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, schema_p);
 }
+
+BOOST_AUTO_TEST_CASE(TestExpressionCache)
+{
+  auto& cache = ExpressionCache::instance();
+  cache.clear();
+  auto schema = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Signed1Pt::asArrowField(), o2::aod::track::Pt::asArrowField()});
+
+  // the second request for the same expression on the same schema is served from the cache
+  auto projector = createProjector(schema, o2::aod::track::Pt::Projector(), o2::aod::track::Pt::asArrowField());
+  auto projector2 = createProjector(schema, o2::aod::track::Pt::Projector(), o2::aod::track::Pt::asArrowField());
+  BOOST_CHECK_EQUAL(projector.get(), projector2.get());
+  auto stats = cache.getStatistics();
+  BOOST_CHECK_EQUAL(stats.misses, 1);
+  BOOST_CHECK_EQUAL(stats.hits, 1);
+
+  // the spawners go through the same cache
+  auto projector3 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, schema);
+  auto projector4 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, schema);
+  BOOST_CHECK_EQUAL(projector3.get(), projector4.get());
+
+  Filter f1 = o2::aod::track::signed1Pt > 1.f;
+  Filter f2 = o2::aod::track::signed1Pt > 1.f;
+  Filter f3 = o2::aod::track::signed1Pt > 1.0000001f;
+  auto filter1 = createFilter(schema, createOperations(f1));
+  auto filter2 = createFilter(schema, createOperations(f2));
+  BOOST_CHECK_EQUAL(filter1.get(), filter2.get());
+  // a different literal is a different expression
+  auto filter3 = createFilter(schema, createOperations(f3));
+  BOOST_CHECK(filter1.get() != filter3.get());
+
+  // the same expression on a different schema is compiled again
+  auto schema2 = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Signed1Pt::asArrowField()});
+  auto filter4 = createFilter(schema2, createOperations(f1));
+  BOOST_CHECK(filter1.get() != filter4.get());
+
+  stats = cache.getStatistics();
+  BOOST_CHECK_EQUAL(stats.misses, 5);
+  BOOST_CHECK_EQUAL(stats.hits, 3);
+  BOOST_CHECK(stats.missTime > 0);
+
+  // a cached filter selects the same rows as a freshly compiled one
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float>({"fSigned1Pt", "fPt"});
+  rowWriter(0, 0.5f, 2.f);
+  rowWriter(0, 2.f, 0.5f);
+  rowWriter(0, 1.5f, 0.6f);
+  auto table = builder.finalize();
+  createFilter(table->schema(), createOperations(f1));
+  auto selection = createSelection(table, createFilter(table->schema(), createOperations(f2)));
+  auto reference = createSelection(table, createFilter(table->schema(), makeCondition(createExpressionTree(createOperations(f1), table->schema()))));
+  BOOST_REQUIRE_EQUAL(selection->GetNumSlots(), reference->GetNumSlots());
+  BOOST_CHECK_EQUAL(selection->GetNumSlots(), 2);
+  for (auto i = 0; i < selection->GetNumSlots(); ++i) {
+    BOOST_CHECK_EQUAL(selection->GetIndex(i), reference->GetIndex(i));
+  }
+}
@@ -0,0 +1,106 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/ControlService.h"
+#include "Framework/CallbackService.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/Logger.h"
+#include "Framework/runDataProcessing.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace o2::framework;
+
+// Smoke test of --fork-server: both devices are forked from the driver without
+// exec, must exchange data and must not keep the state of the driver.
+namespace
+{
+void checkForkedDevice()
+{
+#ifdef __linux__
+  // A device forked from the driver keeps the command line of the driver,
+  // an exec'ed one gets its own with --id
+  std::ifstream cmdLine("/proc/self/cmdline");
+  std::string args{std::istreambuf_iterator<char>(cmdLine), std::istreambuf_iterator<char>()};
+  std::vector<std::string> argv;
+  for (size_t pos = 0; pos < args.size(); pos += argv.back().size() + 1) {
+    argv.emplace_back(args.c_str() + pos);
+  }
+  if (std::find(argv.begin(), argv.end(), "--id") != argv.end()) {
+    LOG(FATAL) << "Device was exec'ed instead of being forked from the driver";
+  }
+  // The websocket server of the driver must not be inherited
+  auto driverPort = 8080 + (getppid() % 30000);
+  auto dir = opendir("/proc/self/fd");
+  while (auto entry = readdir(dir)) {
+    int fd = atoi(entry->d_name);
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int listening = 0;
+    socklen_t optLen = sizeof(listening);
+    if (fd > 2 && getsockname(fd, (sockaddr*)&addr, &len) == 0 && addr.sin_family == AF_INET &&
+        getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &optLen) == 0 && listening &&
+        ntohs(addr.sin_port) >= driverPort && ntohs(addr.sin_port) < driverPort + 100) {
+      LOG(FATAL) << "Device inherited the listening socket of the driver on port " << ntohs(addr.sin_port);
+    }
+  }
+  closedir(dir);
+#endif
+}
+} // namespace
+
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  return WorkflowSpec{
+    {"producer",
+     Inputs{},
+     {OutputSpec{{"p"}, "TST", "FORKED"}},
+     AlgorithmSpec{[](InitContext&) {
+       checkForkedDevice();
+       return [](ProcessingContext& ctx) {
+         auto& data = ctx.outputs().make<int>(OutputRef{"p"}, 10);
+         for (size_t i = 0; i < data.size(); i++) {
+           data[i] = i;
+         }
+         ctx.services().get<ControlService>().endOfStream();
+         ctx.services().get<ControlService>().readyToQuit(QuitRequest::Me);
+       };
+     }}},
+    {"consumer",
+     {InputSpec{"p", "TST", "FORKED"}},
+     Outputs{},
+     AlgorithmSpec{[](InitContext& ic) {
+       checkForkedDevice();
+       ic.services().get<CallbackService>().set(CallbackService::Id::EndOfStream, [](EndOfStreamContext& context) {
+         context.services().get<ControlService>().readyToQuit(QuitRequest::All);
+       });
+       return [](ProcessingContext& ctx) {
+         auto data = ctx.inputs().get<gsl::span<int>>("p");
+         if (data.size() != 10) {
+           LOG(FATAL) << "Expecting 10 values, found " << data.size();
+         }
+         for (int i = 0; i < data.size(); i++) {
+           if (data[i] != i) {
+             LOG(FATAL) << "Expecting " << i << " found " << data[i];
+           }
+         }
+       };
+     }}}};
+}
@@ -132,3 +132,87 @@ BOOST_AUTO_TEST_CASE(TestIndexBuilder)
     ++i;
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestIndexBuilderThreads)
+{
+  const int nPoints = 200000;
+  TableBuilder b1;
+  auto w1 = b1.cursor<Points>();
+  TableBuilder b2;
+  auto w2 = b2.cursor<Distances>();
+  TableBuilder b3;
+  auto w3 = b3.cursor<Flags>();
+  TableBuilder b4;
+  auto w4 = b4.cursor<Categorys>();
+  for (auto i = 0; i < nPoints; ++i) {
+    w1(0, i * 2., i * 3., i * 4.);
+    if (i % 3 != 0) {
+      w2(0, i, i * 10.);
+    }
+    if (i % 5 != 0) {
+      w3(0, i, static_cast<bool>(i % 2));
+    }
+    for (auto j = 0; j < i % 3; ++j) {
+      w4(0, i, i + 2);
+    }
+  }
+  Points st1{b1.finalize()};
+  Distances st2{b2.finalize()};
+  Flags st3{b3.finalize()};
+  Categorys st4{b4.finalize()};
+
+  auto nThreads = IndexBuilderHelpers::getNThreads();
+  IndexBuilderHelpers::setNThreads(4);
+  auto t1 = IndexExclusive::indexBuilder(typename IDXs::persistent_columns_t{}, st1, std::tie(st1, st2, st3, st4));
+  auto t2 = IndexSparse::indexBuilder(typename IDX2s::persistent_columns_t{}, st1, std::tie(st2, st1, st3, st4));
+  IndexBuilderHelpers::setNThreads(nThreads);
+
+  auto r1 = IndexExclusive::indexBuilderRowWise(typename IDXs::persistent_columns_t{}, st1, std::tie(st1, st2, st3, st4));
+  auto r2 = IndexSparse::indexBuilderRowWise(typename IDX2s::persistent_columns_t{}, st1, std::tie(st2, st1, st3, st4));
+  BOOST_REQUIRE(t1->num_rows() > 0);
+  BOOST_CHECK(t1->Equals(*r1));
+  BOOST_REQUIRE_EQUAL(t2->num_rows(), st2.size());
+  BOOST_CHECK(t2->Equals(*r2));
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexBuilderDuplicateKeys)
+{
+  // duplicated and missing keys in all the tables, the columnar builders must bind the same rows as the row-wise ones
+  TableBuilder b1;
+  auto w1 = b1.cursor<Points>();
+  TableBuilder b2;
+  auto w2 = b2.cursor<Distances>();
+  TableBuilder b3;
+  auto w3 = b3.cursor<Flags>();
+  TableBuilder b4;
+  auto w4 = b4.cursor<Categorys>();
+  for (auto i = 0; i < 1000; ++i) {
+    w1(0, i * 2., i * 3., i * 4.);
+    for (auto j = 0; j < (i * 7) % 4; ++j) {
+      w2(0, i, i * 10.);
+    }
+    for (auto j = 0; j < (i * 5) % 3; ++j) {
+      w3(0, i, static_cast<bool>(i % 2));
+    }
+    for (auto j = 0; j < 7 - i % 7; ++j) {
+      w4(0, i / 2, i + 2);
+    }
+  }
+  Points st1{b1.finalize()};
+  Distances st2{b2.finalize()};
+  Flags st3{b3.finalize()};
+  Categorys st4{b4.finalize()};
+
+  auto r1 = IndexExclusive::indexBuilderRowWise(typename IDXs::persistent_columns_t{}, st1, std::tie(st1, st2, st3, st4));
+  auto r2 = IndexSparse::indexBuilderRowWise(typename IDX2s::persistent_columns_t{}, st1, std::tie(st2, st1, st3, st4));
+  BOOST_REQUIRE(r1->num_rows() > 0);
+  auto nThreads = IndexBuilderHelpers::getNThreads();
+  for (int n : {1, 3}) {
+    IndexBuilderHelpers::setNThreads(n);
+    auto t1 = IndexExclusive::indexBuilder(typename IDXs::persistent_columns_t{}, st1, std::tie(st1, st2, st3, st4));
+    auto t2 = IndexSparse::indexBuilder(typename IDX2s::persistent_columns_t{}, st1, std::tie(st2, st1, st3, st4));
+    BOOST_CHECK(t1->Equals(*r1));
+    BOOST_CHECK(t2->Equals(*r2));
+  }
+  IndexBuilderHelpers::setNThreads(nThreads);
+}
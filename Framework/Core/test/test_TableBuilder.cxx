@@ -184,6 +184,46 @@ BOOST_AUTO_TEST_CASE(TestTableBuilderBulk)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestTableBuilderBulkCursor)
+{
+  using namespace o2::framework;
+  TableBuilder builder;
+  auto bulkWriter = builder.bulkCursor<TestTable>(8);
+  std::vector<uint64_t> x{0, 10, 20, 30};
+  std::vector<uint64_t> y{0, 1, 2, 3};
+  bulkWriter(0, x, y);
+  x = {40, 50, 60, 70};
+  y = {4, 5, 6, 7};
+  bulkWriter(0, x, y);
+  BOOST_CHECK_THROW(bulkWriter(0, x, gsl::span<uint64_t const>(y.data(), 2)), o2::framework::RuntimeErrorRef);
+
+  auto table = builder.finalize();
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 2);
+  BOOST_REQUIRE_EQUAL(table->num_rows(), 8);
+  BOOST_REQUIRE_EQUAL(table->schema()->field(0)->name(), "x");
+  BOOST_REQUIRE_EQUAL(table->schema()->field(1)->name(), "y");
+
+  auto readBack = TestTable{table};
+  size_t i = 0;
+  for (auto& row : readBack) {
+    BOOST_CHECK_EQUAL(row.x(), i * 10);
+    BOOST_CHECK_EQUAL(row.y(), i);
+    ++i;
+  }
+
+  TableBuilder arrayBuilder;
+  auto arrayWriter = arrayBuilder.bulkCursor<ArrayTable>(2);
+  int pos[2][4] = {{1, 10, 300, 350}, {0, 20, 30, 40}};
+  arrayWriter(0, gsl::span<int const[4]>(pos, 2));
+  auto arrayTable = arrayBuilder.finalize();
+  BOOST_REQUIRE_EQUAL(arrayTable->num_rows(), 2);
+  auto arrayReadBack = ArrayTable{arrayTable};
+  auto row = arrayReadBack.begin();
+  BOOST_CHECK_EQUAL(row.pos()[3], 350);
+  row++;
+  BOOST_CHECK_EQUAL(row.pos()[1], 20);
+}
+
 BOOST_AUTO_TEST_CASE(TestTableBuilderMore)
 {
   using namespace o2::framework;
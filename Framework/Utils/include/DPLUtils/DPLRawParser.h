@@ -36,8 +36,9 @@ namespace o2::framework
 ///      specs matching the same route spec
 ///   3) variable number of raw pages in one payload
 ///
-/// Internally, class @ref RawParser is used to access raw pages withon one
-/// payload message and dynamically adopt to RAWDataHeader version.
+/// Internally, the raw pages within one payload message are indexed in one pass
+/// by @ref raw_parser::scan, which adopts dynamically to the RAWDataHeader version.
+/// The iterator then runs over this index.
 ///
 /// The parser provides an iterator interface to loop over raw pages,
 /// starting at the first raw page of the first payload at the first route
@@ -65,15 +66,13 @@ namespace o2::framework
 class DPLRawParser
 {
  public:
-  using rawparser_type = RawParser<8192>;
+  static constexpr size_t MaxPageSize = 8192;
+  using rawparser_type = RawParser<MaxPageSize>;
   using buffer_type = typename rawparser_type::buffer_type;
 
   DPLRawParser() = delete;
   DPLRawParser(InputRecord& inputs, std::vector<InputSpec> filterSpecs = {}) : mInputs(inputs), mFilterSpecs(filterSpecs) {}
 
-  // this is a dummy default buffer used to initialize the RawParser in the iterator
-  // constructor
-  static constexpr o2::header::RAWDataHeaderV4 initializer = o2::header::RAWDataHeaderV4{};
   template <typename T>
   using IteratorBase = std::iterator<std::forward_iterator_tag, T>;
 
@@ -93,15 +92,14 @@ class DPLRawParser
     using pointer = typename IteratorBase<T>::pointer;
     // the iterator over the input channels
     using input_iterator = decltype(std::declval<InputRecord>().begin());
-    // the parser type
-    using parser_type = rawparser_type const;
+    // the common header info of all RDH versions
+    using header_info_type = typename rawparser_type::RawDataHeaderInfo;
 
     Iterator() = delete;
 
     Iterator(InputRecord& parent, input_iterator it, input_iterator end, std::vector<InputSpec> const& filterSpecs)
-      : mParent(parent), mInputIterator(it), mEnd(end), mPartIterator(mInputIterator.begin()), mParser(std::make_unique<parser_type>(reinterpret_cast<const char*>(&initializer), sizeof(initializer))), mCurrent(mParser->begin()), mFilterSpecs(filterSpecs)
+      : mParent(parent), mInputIterator(it), mEnd(end), mPartIterator(mInputIterator.begin()), mFilterSpecs(filterSpecs)
     {
-      mParser.reset();
       next();
     }
 
@@ -121,17 +119,17 @@ class DPLRawParser
       return copy;
     }
     // return reference
-    reference operator*()
+    header_info_type const& operator*() const
     {
-      return *mCurrent;
+      return *reinterpret_cast<header_info_type const*>(raw());
     }
     // comparison
     bool operator==(const self_type& other) const
     {
       bool result = mInputIterator == other.mInputIterator;
       result = result && mPartIterator == other.mPartIterator;
-      if (mParser != nullptr && other.mParser != nullptr) {
-        result = result && mCurrent == other.mCurrent;
+      if (mRaw != nullptr && other.mRaw != nullptr) {
+        result = result && mRaw == other.mRaw && mPage == other.mPage;
       }
       return result;
     }
@@ -162,25 +160,44 @@ class DPLRawParser
     /// get pointer to raw block at current position, rdh starts here
     buffer_type const* raw() const
     {
-      return mCurrent.raw();
+      return mRaw != nullptr ? mRaw + mIndex.offset[mPage] : nullptr;
     }
 
     /// get pointer to payload at current position
     buffer_type const* data() const
     {
-      return mCurrent.data();
+      size_t size = this->size();
+      if (size == 0) {
+        return nullptr;
+      }
+      if (mIndex.offset[mPage] + mIndex.headerSize[mPage] + size > mRawSize) {
+        throw std::runtime_error("not enough data at position " + std::to_string(mIndex.offset[mPage]));
+      }
+      return raw() + mIndex.headerSize[mPage];
     }
 
     /// offset of payload at current position
     size_t offset() const
     {
-      return mCurrent.offset();
+      return mRaw != nullptr ? mIndex.headerSize[mPage] : 0;
     }
 
     /// get size of payload at current position
     size_t size() const
     {
-      return mCurrent.size();
+      return mRaw != nullptr ? mIndex.payloadSize[mPage] : 0;
+    }
+
+    /// get link ID of the page at current position
+    uint8_t linkID() const
+    {
+      return mRaw != nullptr ? mIndex.linkID[mPage] : 0;
+    }
+
+    /// check if the page at current position has the stop bit set
+    bool stop() const
+    {
+      return mRaw != nullptr && mIndex.stop[mPage];
     }
 
     /// get header as specific type
@@ -188,13 +205,16 @@ class DPLRawParser
     template <typename U>
     U const* get_if() const
     {
-      return mCurrent.get_if<U>();
+      if (mRaw != nullptr && raw_parser::rdh_version<U> == mIndex.version) {
+        return reinterpret_cast<U const*>(raw());
+      }
+      return nullptr;
     }
 
     friend std::ostream& operator<<(std::ostream& os, self_type const& it)
     {
-      if (it.mInputIterator != it.mEnd && it.mPartIterator != it.mInputIterator.end() && it.mParser != nullptr) {
-        os << it.mCurrent;
+      if (it.mInputIterator != it.mEnd && it.mPartIterator != it.mInputIterator.end() && it.mRaw != nullptr) {
+        it.format(os, raw_parser::FormatSpec::Entry, "");
       }
       return os;
     }
@@ -211,11 +231,11 @@ class DPLRawParser
     friend std::ostream& operator<<(std::ostream& os, Fmt<FmtCtrl> const& fmt)
     {
       auto const& it = fmt.it;
-      if (it.mInputIterator != it.mEnd && it.mPartIterator != it.mInputIterator.end() && it.mParser != nullptr) {
+      if (it.mInputIterator != it.mEnd && it.mPartIterator != it.mInputIterator.end() && it.mRaw != nullptr) {
         if constexpr (FmtCtrl == raw_parser::FormatSpec::Info) {
-          // TODO: need to propagate the format spec also on the RawParser object
           // for now this operation prints the RDH version info and the table header
-          os << *it.mParser;
+          it.format(os, raw_parser::FormatSpec::Info, "\n");
+          it.format(os, raw_parser::FormatSpec::TableHeader, "\n");
         } else {
           os << it;
         }
@@ -226,21 +246,27 @@ class DPLRawParser
    private:
     // the iterator over the parts in one channel
     using part_iterator = typename input_iterator::const_iterator;
-    // the iterator over the over the parser pages
-    using parser_iterator = typename parser_type::const_iterator;
+
+    void format(std::ostream& os, raw_parser::FormatSpec choice, const char* delimiter) const
+    {
+      raw_parser::dispatch_version(mIndex.version, [this, &os, choice, delimiter](auto const* type) {
+        using header_type = std::remove_cv_t<std::remove_pointer_t<decltype(type)>>;
+        raw_parser::RDHFormatter<header_type>::apply(os, *reinterpret_cast<header_type const*>(raw()), choice, delimiter);
+      });
+    }
 
     bool next()
     {
       while (mInputIterator != mEnd) {
-        bool isInitial = mParser == nullptr;
+        bool isInitial = mRaw == nullptr;
         while (mPartIterator != mInputIterator.end()) {
-          // first increment on the parser level
-          if (mParser && mCurrent != mParser->end() && ++mCurrent != mParser->end()) {
-            // we have an active parser and there is still data at the incremented iterator
+          // first increment on the page level
+          if (mRaw != nullptr && ++mPage < mIndex.size()) {
+            // we have an indexed part and there are pages left
             return true;
           }
           // now increment on the level of one input
-          mParser.reset();
+          mRaw = nullptr;
           if (!isInitial && (mPartIterator == mInputIterator.end() || ++mPartIterator == mInputIterator.end())) {
             // no more parts, go to next input
             break;
@@ -271,16 +297,15 @@ class DPLRawParser
           }
 
           try {
-            mParser = std::make_unique<parser_type>(raw.data(), raw.size());
+            raw_parser::scan<MaxPageSize>(raw.data(), raw.size(), mIndex);
+            mRaw = reinterpret_cast<buffer_type const*>(raw.data());
+            mRawSize = raw.size();
+            mPage = 0;
+            return true;
           } catch (const std::runtime_error& e) {
             LOG(ERROR) << "can not create raw parser form input data";
             LOG(ERROR) << e.what();
           }
-
-          if (mParser != nullptr) {
-            mCurrent = mParser->begin();
-            return true;
-          }
         } // end loop over parts on one input
         ++mInputIterator;
         mPartIterator = mInputIterator.begin();
@@ -292,8 +317,10 @@ class DPLRawParser
     input_iterator mInputIterator;
     input_iterator mEnd;
     part_iterator mPartIterator;
-    std::unique_ptr<parser_type> mParser;
-    parser_iterator mCurrent;
+    buffer_type const* mRaw = nullptr; // payload of the current part, nullptr if no part is indexed
+    size_t mRawSize = 0;
+    raw_parser::PageIndex mIndex; // index of the pages of the current part
+    size_t mPage = 0;             // current page in the index
     std::vector<InputSpec> const& mFilterSpecs;
   };
 
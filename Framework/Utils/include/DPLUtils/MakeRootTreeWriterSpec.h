@@ -21,6 +21,7 @@
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/CallbackService.h"
 #include "Framework/ControlService.h"
+#include "Framework/Monitoring.h"
 #include <algorithm>
 #include <vector>
 #include <string>
@@ -28,6 +29,7 @@
 #include <variant>
 #include <unordered_set>
 #include <tuple>
+#include <chrono>
 
 namespace o2
 {
@@ -65,6 +67,16 @@ namespace framework
 ///     --treename
 ///     --nevents
 ///     --terminate
+///     --async-queue-size
+///     --implicit-mt
+///     --flush-interval
+///
+/// \par Asynchronous writing:
+/// With a non-zero \c --async-queue-size, the branches are filled and the baskets compressed
+/// by a dedicated I/O thread of the writer, see RootTreeWriter::setAsyncWriting. ROOT implicit
+/// multithreading can be enabled with \c --implicit-mt to compress the baskets of the branches in
+/// parallel when they are flushed every \c --flush-interval entries. The queue depth and the
+/// write bandwidth are published as metrics.
 ///
 /// \par
 /// In addition to that, a custom option can be added for every branch to configure the
@@ -346,6 +358,9 @@ class MakeRootTreeWriterSpec
       Preprocessor preprocessor;
       // the total number of served branches on the n inputs
       size_t nofBranches;
+      // bytes written and time at the last bandwidth measurement
+      size_t lastBytesWritten = 0;
+      std::chrono::steady_clock::time_point lastMetricsTime;
     };
     auto processAttributes = std::make_shared<ProcessAttributes>();
     processAttributes->writer = mWriter;
@@ -389,6 +404,13 @@ class MakeRootTreeWriterSpec
         processAttributes->writer->setBranchName(branchIndex, branchName.c_str());
       }
       processAttributes->writer->init(filename.c_str(), treename.c_str(), treetitle.c_str());
+      auto nIMTThreads = ic.options().get<int>("implicit-mt");
+      if (nIMTThreads >= 0) {
+        WriterType::enableImplicitMT(nIMTThreads);
+      }
+      processAttributes->writer->setFlushInterval(std::max(0, ic.options().get<int>("flush-interval")));
+      processAttributes->writer->setAsyncWriting(std::max(0, ic.options().get<int>("async-queue-size")));
+      processAttributes->lastMetricsTime = std::chrono::steady_clock::now();
 
       // the callback to be set as hook at stop of processing for the framework
       auto finishWriting = [processAttributes]() {
@@ -454,6 +476,7 @@ class MakeRootTreeWriterSpec
         if (checkProcessing(pc.inputs())) {
           (*writer)(pc.inputs());
           counter = counter + 1;
+          sendMetrics(pc, *processAttributes);
         }
 
         if ((nEvents >= 0 && counter == nEvents) || checkReady(pc.inputs())) {
@@ -472,6 +495,9 @@ class MakeRootTreeWriterSpec
       {"treetitle", VariantType::String, mDefaultTreeTitle.c_str(), {"Title of tree"}},
       {"nevents", VariantType::Int, mDefaultNofEvents, {"Number of events to execute"}},
       {"terminate", VariantType::String, mDefaultTerminationPolicy.c_str(), {"Terminate the 'process' or 'workflow'"}},
+      {"async-queue-size", VariantType::Int, 0, {"Max number of entries queued for the I/O thread, 0 for synchronous writing"}},
+      {"implicit-mt", VariantType::Int, -1, {"Number of ROOT implicit MT threads for basket compression, 0 for ROOT default, -1 to disable"}},
+      {"flush-interval", VariantType::Int, 0, {"Flush the baskets every n entries, 0 to leave it to ROOT"}},
     };
     for (size_t branchIndex = 0; branchIndex < mBranchNameOptions.size(); branchIndex++) {
       // adding option definitions for those ones defined in the branch definition
@@ -497,6 +523,26 @@ class MakeRootTreeWriterSpec
   }
 
  private:
+  /// publish the queue depth and the write bandwidth of the writer
+  template <typename ProcessAttributes>
+  static void sendMetrics(ProcessingContext& pc, ProcessAttributes& attributes)
+  {
+    using o2::monitoring::Metric;
+    auto& writer = *attributes.writer;
+    auto& monitoring = pc.services().get<o2::monitoring::Monitoring>();
+    monitoring.send(Metric{(uint64_t)writer.getQueueDepth(), "writer-queue-depth"});
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - attributes.lastMetricsTime;
+    if (elapsed.count() < 1.) {
+      return;
+    }
+    auto bytesWritten = writer.getBytesWritten();
+    monitoring.send(Metric{(uint64_t)bytesWritten, "writer-bytes-written"});
+    monitoring.send(Metric{(bytesWritten - attributes.lastBytesWritten) / elapsed.count() / (1024 * 1024), "writer-bandwidth-mb-s"});
+    attributes.lastBytesWritten = bytesWritten;
+    attributes.lastMetricsTime = now;
+  }
+
   /// helper function to recursively parse constructor arguments
   /// the default file and tree name can come before all the branch specs
   template <size_t N, typename... Args>
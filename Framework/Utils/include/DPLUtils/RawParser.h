@@ -23,6 +23,7 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 // FIXME: probably moved somewhere else
 namespace o2::framework
@@ -317,6 +318,116 @@ U const* get_if(T& instances)
   return nullptr;
 }
 
+/// version number of the supported RAWDataHeader types, 0 for all other types
+template <typename T>
+constexpr unsigned int rdh_version = 0;
+template <>
+constexpr unsigned int rdh_version<V6> = 6;
+template <>
+constexpr unsigned int rdh_version<V5> = 5;
+template <>
+constexpr unsigned int rdh_version<V4> = 4;
+
+/// call the processor with a typed null pointer of the RAWDataHeader matching the version
+template <typename Processor>
+decltype(auto) dispatch_version(unsigned int version, Processor&& processor)
+{
+  if (version == 6) {
+    return processor(static_cast<V6 const*>(nullptr));
+  } else if (version == 5) {
+    return processor(static_cast<V5 const*>(nullptr));
+  } else if (version == 4) {
+    return processor(static_cast<V4 const*>(nullptr));
+  }
+  throw std::runtime_error("can not create RawParser: invalid version " + std::to_string(version));
+}
+
+/// @struct PageIndex
+/// Compact index of the pages in a raw buffer, one entry per page in each of the
+/// columns. Filled by @ref scan in one pass over the buffer, the index can be reused
+/// for several buffers to avoid reallocations: the columns keep their size, only the
+/// first size() entries are valid.
+struct PageIndex {
+  unsigned int version = 0;          // RAWDataHeader version of all pages
+  size_t nPages = 0;                 // number of valid entries
+  std::vector<size_t> offset;        // offset of the page in the buffer
+  std::vector<uint32_t> payloadSize; // size of the payload as returned by ConcreteRawParser::size
+  std::vector<uint8_t> headerSize;   // size of the RAWDataHeader
+  std::vector<uint8_t> linkID;       // link ID from the RAWDataHeader
+  std::vector<uint8_t> stop;         // stop bit from the RAWDataHeader
+
+  size_t size() const { return nPages; }
+
+  void reserve(size_t n)
+  {
+    if (n <= offset.size()) {
+      return;
+    }
+    offset.resize(n);
+    payloadSize.resize(n);
+    headerSize.resize(n);
+    linkID.resize(n);
+    stop.resize(n);
+  }
+
+  void clear()
+  {
+    version = 0;
+    nPages = 0;
+  }
+};
+
+/// Fill the page index for a buffer of pages with given RAWDataHeader type.
+/// The pages are walked as in ConcreteRawParser::next, the walk stops at the first page
+/// whose header does not fit into the buffer.
+template <typename HeaderType, size_t MAX_SIZE>
+void scan_pages(unsigned char const* buffer, size_t size, PageIndex& index)
+{
+  index.clear();
+  index.version = rdh_version<HeaderType>;
+  if (size < sizeof(HeaderType)) {
+    return;
+  }
+  // the columns are grown in steps and filled by position, the first step assumes pages
+  // of maximum size
+  index.reserve(size / MAX_SIZE + 1);
+  size_t position = 0, nPages = 0;
+  while (true) {
+    if (nPages == index.offset.size()) {
+      index.reserve(2 * nPages);
+    }
+    auto const& h = *reinterpret_cast<HeaderType const*>(buffer + position);
+    index.offset[nPages] = position;
+    index.payloadSize[nPages] = h.memorySize >= h.headerSize ? h.memorySize - h.headerSize : MAX_SIZE - h.headerSize;
+    index.headerSize[nPages] = h.headerSize;
+    index.linkID[nPages] = h.linkID;
+    index.stop[nPages] = h.stop & 0x1;
+    nPages++;
+    size_t offsetToNext = h.offsetToNext;
+    if ((position + offsetToNext + sizeof(HeaderType) > size) || (offsetToNext < sizeof(HeaderType))) {
+      break;
+    }
+    position += offsetToNext;
+  }
+  index.nPages = nPages;
+}
+
+/// Fill the page index for a raw buffer, the RAWDataHeader version is determined once
+/// from the first page
+template <size_t PageSize, typename T>
+void scan(T const* buffer, size_t size, PageIndex& index)
+{
+  static_assert(sizeof(T) == 1, "buffer required to be byte-type");
+  if (buffer == nullptr || size < sizeof(header::RAWDataHeaderV5)) {
+    throw std::runtime_error("can not create RawParser: invalid buffer");
+  }
+  auto const* raw = reinterpret_cast<unsigned char const*>(buffer);
+  dispatch_version(reinterpret_cast<V5 const*>(buffer)->version, [raw, size, &index](auto const* type) {
+    using header_type = std::remove_cv_t<std::remove_pointer_t<decltype(type)>>;
+    scan_pages<header_type, PageSize>(raw, size, index);
+  });
+}
+
 } // namespace raw_parser
 
 /// @class RawParser parser for the O2 raw data
@@ -25,6 +25,7 @@
 #include <TTree.h>
 #include <TBranch.h>
 #include <TClass.h>
+#include <TROOT.h>
 #include <vector>
 #include <string>
 #include <stdexcept> // std::runtime_error
@@ -32,6 +33,11 @@
 #include <memory>     // std::make_unique
 #include <functional> // std::function
 #include <utility>    // std::forward
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace o2
 {
@@ -132,6 +138,13 @@ struct DefaultKey {
 /// Binary data is stored as vector of char alongside with a branch storing the
 /// size, as both indicator and consistency check.
 ///
+/// \par Prefetching:
+/// With \ref setPrefetching, the entries are read on a background thread ahead of the
+/// publishing, the processing then only needs to serialize the prefetched objects. Together
+/// with a TTreeCache, see \ref setCacheSize, the baskets are read in large blocks and can be
+/// decompressed in parallel. Entries must be processed in sequence, the entries skipped by
+/// calling \ref next without processing are dropped.
+///
 /// \note
 /// In the examples, `reader` has to be set up in the init callback and it must
 /// be static there to persist. It can also be a shared_pointer, which then
@@ -187,6 +200,14 @@ class GenericRootTreeReader
   // passed to the construction of the constructed mixin class
   using ConstructorArgs = std::vector<ConstructorArg>;
 
+  /// object read from a branch, the size is only used for binary branches
+  struct BranchData {
+    char* data = nullptr;
+    size_t size = 0;
+  };
+  // the objects of all branches of one entry
+  using EntryData = std::vector<BranchData>;
+
   /// @class BranchConfigurationInterface
   /// The interface for the branch configuration. The branch configuration is constructed at
   /// compile time from the constructor argments of the tree reader. A mixin class is constructed
@@ -211,6 +232,13 @@ class GenericRootTreeReader
     /// for the header stack is provided to build the stack from the variadic list of header template
     /// arguments.
     virtual void exec(ProcessingContext& ctx, int entry, std::function<o2::header::Stack()> stackcreator) {}
+    /// Read the objects of all branches at position \a entry without publishing, the objects
+    /// are owned by the caller and must be handed back to publish or release.
+    virtual void read(int entry, EntryData& objects) {}
+    /// Publish the objects previously read for all branches and release them
+    virtual void publish(ProcessingContext& ctx, EntryData& objects, std::function<o2::header::Stack()> stackcreator) {}
+    /// Release the objects previously read without publishing
+    virtual void release(EntryData& objects) {}
 
    private:
   };
@@ -239,6 +267,28 @@ class GenericRootTreeReader
       process(ctx, entry, stackcreator);
     }
 
+    /// Read all branches without publishing
+    /// This is the virtal overload entry point to the upper most stage of the branch configuration
+    void read(int entry, EntryData& objects) override
+    {
+      objects.resize(STAGE);
+      readInstance(entry, objects);
+    }
+
+    /// Publish objects previously read
+    /// This is the virtal overload entry point to the upper most stage of the branch configuration
+    void publish(ProcessingContext& ctx, EntryData& objects, std::function<o2::header::Stack()> stackcreator) override
+    {
+      publishInstance(ctx, objects, stackcreator);
+    }
+
+    /// Release objects previously read
+    /// This is the virtal overload entry point to the upper most stage of the branch configuration
+    void release(EntryData& objects) override
+    {
+      releaseInstance(objects);
+    }
+
     /// Setup branch configuration
     /// This is the virtal overload entry point to the upper most stage of the branch configuration
     void setup(TTree& tree, SpecialPublishHook* publishhook = nullptr) override
@@ -300,14 +350,65 @@ class GenericRootTreeReader
       if constexpr (STAGE > 1) {
         PrevT::process(context, entry, stackcreator);
       }
+      BranchData object;
+      readBranch(entry, object);
+      publishBranch(context, object, stackcreator);
+    }
 
-      auto snapshot = [&context, &stackcreator](const KeyType& key, const auto& object) {
-        context.outputs().snapshot(Output{key.origin, key.description, key.subSpec, key.lifetime, std::move(stackcreator())}, object);
-      };
+    /// Read all stages, first recursively for all lower stages, and then the current stage
+    void readInstance(int entry, EntryData& objects)
+    {
+      if constexpr (STAGE > 1) {
+        PrevT::readInstance(entry, objects);
+      }
+      readBranch(entry, objects[STAGE - 1]);
+    }
 
+    /// Publish all stages, first recursively for all lower stages, and then the current stage
+    void publishInstance(ProcessingContext& context, EntryData& objects, std::function<o2::header::Stack()>& stackcreator)
+    {
+      if constexpr (STAGE > 1) {
+        PrevT::publishInstance(context, objects, stackcreator);
+      }
+      publishBranch(context, objects[STAGE - 1], stackcreator);
+    }
+
+    /// Release all stages, first recursively for all lower stages, and then the current stage
+    void releaseInstance(EntryData& objects)
+    {
+      if constexpr (STAGE > 1) {
+        PrevT::releaseInstance(objects);
+      }
+      if (objects.size() >= STAGE) {
+        releaseBranch(objects[STAGE - 1]);
+      }
+    }
+
+   private:
+    /// read the object of this stage at position \a entry
+    void readBranch(int entry, BranchData& object)
+    {
       char* data = nullptr;
       mBranch->SetAddress(&data);
       mBranch->GetEntry(entry);
+      object.data = data;
+      if (mSizeBranch != nullptr) {
+        size_t datasize = 0;
+        mSizeBranch->SetAddress(&datasize);
+        mSizeBranch->GetEntry(entry);
+        object.size = datasize;
+      }
+      mBranch->DropBaskets("all");
+    }
+
+    /// publish the object of this stage and release it
+    void publishBranch(ProcessingContext& context, BranchData& branchData, std::function<o2::header::Stack()>& stackcreator)
+    {
+      auto snapshot = [&context, &stackcreator](const KeyType& key, const auto& object) {
+        context.outputs().snapshot(Output{key.origin, key.description, key.subSpec, key.lifetime, std::move(stackcreator())}, object);
+      };
+
+      char* data = branchData.data;
 
       // execute hook if it was registered; if this return true do not proceed further
       if (mPublishHook != nullptr && (*mPublishHook).hook(mName, context, Output{mKey.origin, mKey.description, mKey.subSpec, mKey.lifetime, std::move(stackcreator())}, data)) {
@@ -316,9 +417,7 @@ class GenericRootTreeReader
       // try to figureout when we need to do something special
       else {
         if (mSizeBranch != nullptr) {
-          size_t datasize = 0;
-          mSizeBranch->SetAddress(&datasize);
-          mSizeBranch->GetEntry(entry);
+          size_t datasize = branchData.size;
           auto* buffer = reinterpret_cast<BinaryDataStoreType*>(data);
           if (buffer->size() == datasize) {
             LOG(INFO) << "branch " << mName << ": publishing binary chunk of " << datasize << " bytes(s)";
@@ -341,14 +440,19 @@ class GenericRootTreeReader
         }
       }
       // cleanup the memory
+      releaseBranch(branchData);
+    }
+
+    /// delete the object of this stage
+    void releaseBranch(BranchData& object)
+    {
       auto* delfunc = mClassInfo->GetDelete();
       if (delfunc) {
-        (*delfunc)(data);
+        (*delfunc)(object.data);
       }
-      mBranch->DropBaskets("all");
+      object.data = nullptr;
     }
 
-   private:
     key_type mKey;
     std::string mName;
     TBranch* mBranch = nullptr;
@@ -401,17 +505,72 @@ class GenericRootTreeReader
     mBranchConfiguration->setup(mInput, mPublishHook);
   }
 
+  ~GenericRootTreeReader()
+  {
+    stopPrefetching();
+  }
+
   /// add a file as source for the tree
   void addFile(const char* fileName)
   {
+    if (mPrefetcher && mPrefetcher->thread.joinable()) {
+      throw std::runtime_error("can not add files while prefetching");
+    }
     mInput.AddFile(fileName);
     mNEntries = mInput.GetEntries();
   }
 
+  /// Set the size of the TTreeCache of the input, all branches are added to the cache
+  /// @param cacheSize      size in bytes, 0 disables the cache
+  /// @param parallelUnzip  decompress the baskets in the cache in parallel, this requires
+  ///                       ROOT implicit multithreading to be enabled
+  void setCacheSize(Long64_t cacheSize, bool parallelUnzip = false)
+  {
+    if (mPrefetcher && mPrefetcher->thread.joinable()) {
+      throw std::runtime_error("can not change the cache while prefetching");
+    }
+    mInput.SetCacheSize(cacheSize);
+    if (cacheSize > 0) {
+      mInput.AddBranchToCache("*", true);
+    }
+    mInput.SetParallelUnzip(parallelUnzip);
+  }
+
+  /// Enable prefetching of entries on a background thread
+  /// @param depth  maximum number of entries read ahead, 0 disables prefetching
+  ///
+  /// The background thread reads the entries in the order they are going to be requested,
+  /// and keeps the deserialized objects until they are published. The input tree must not
+  /// be accessed otherwise while prefetching.
+  void setPrefetching(size_t depth)
+  {
+    stopPrefetching();
+    if (depth == 0) {
+      mPrefetcher.reset();
+      return;
+    }
+    ROOT::EnableThreadSafety();
+    mPrefetcher = std::make_unique<Prefetcher>();
+    mPrefetcher->depth = depth;
+  }
+
+  /// number of entries which have been prefetched and wait for publishing
+  size_t getNPrefetched() const
+  {
+    if (!mPrefetcher) {
+      return 0;
+    }
+    std::lock_guard<std::mutex> lock(mPrefetcher->mutex);
+    return mPrefetcher->queue.size();
+  }
+
   /// move to the next entry
   /// @return true if data is available
   bool next()
   {
+    if (mPrefetcher && !mPrefetcher->thread.joinable() && !mPrefetcher->finished) {
+      mPrefetcher->thread = std::thread([this]() { prefetchLoop(); });
+    }
     if ((mReadEntry + 1) >= mNEntries || mNEntries == 0) {
       if (mPublishingMode == PublishingMode::Single) {
         // stop here
@@ -466,7 +625,12 @@ class GenericRootTreeReader
       return o2::header::Stack{std::forward<HeaderTypes>(headers)...};
     };
 
-    mBranchConfiguration->exec(context, mReadEntry, stackcreator);
+    if (mPrefetcher) {
+      auto objects = getPrefetched(mReadEntry);
+      mBranchConfiguration->publish(context, objects, stackcreator);
+    } else {
+      mBranchConfiguration->exec(context, mReadEntry, stackcreator);
+    }
     return true;
   }
 
@@ -477,6 +641,117 @@ class GenericRootTreeReader
   }
 
  private:
+  /// an entry read by the prefetching thread
+  struct PrefetchedEntry {
+    int entry = -1;
+    EntryData objects;
+  };
+
+  /// state of the prefetching, shared between the processing and the prefetching thread
+  struct Prefetcher {
+    /// maximum number of entries in the queue
+    size_t depth = 1;
+    std::deque<PrefetchedEntry> queue;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::thread thread;
+    /// stop requested by the processing thread
+    bool stop = false;
+    /// all entries have been read
+    bool finished = false;
+    /// exception caught in the prefetching thread, forwarded to the processing thread
+    std::exception_ptr error;
+  };
+
+  /// the loop of the prefetching thread, reads the entries in the sequence of \ref next
+  void prefetchLoop()
+  {
+    auto& prefetcher = *mPrefetcher;
+    int entry = 0;
+    int nRead = 0;
+    while (mNEntries > 0 && (mMaxEntries <= 0 || nRead < mMaxEntries)) {
+      if (entry >= mNEntries) {
+        if (mPublishingMode == PublishingMode::Single) {
+          break;
+        }
+        entry = 0;
+      }
+      {
+        std::unique_lock<std::mutex> lock(prefetcher.mutex);
+        prefetcher.notFull.wait(lock, [&prefetcher]() { return prefetcher.stop || prefetcher.queue.size() < prefetcher.depth; });
+        if (prefetcher.stop) {
+          break;
+        }
+      }
+      PrefetchedEntry prefetched{entry, {}};
+      try {
+        mBranchConfiguration->read(entry, prefetched.objects);
+      } catch (...) {
+        mBranchConfiguration->release(prefetched.objects);
+        std::lock_guard<std::mutex> lock(prefetcher.mutex);
+        prefetcher.error = std::current_exception();
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(prefetcher.mutex);
+        prefetcher.queue.emplace_back(std::move(prefetched));
+      }
+      prefetcher.notEmpty.notify_one();
+      ++entry;
+      ++nRead;
+    }
+    {
+      std::lock_guard<std::mutex> lock(prefetcher.mutex);
+      prefetcher.finished = true;
+    }
+    prefetcher.notEmpty.notify_one();
+  }
+
+  /// get the prefetched objects of \a entry, waits until the entry is available
+  /// entries before the requested one have been skipped by the caller and are released
+  EntryData getPrefetched(int entry) const
+  {
+    auto& prefetcher = *mPrefetcher;
+    std::unique_lock<std::mutex> lock(prefetcher.mutex);
+    while (true) {
+      prefetcher.notEmpty.wait(lock, [&prefetcher]() { return !prefetcher.queue.empty() || prefetcher.finished; });
+      if (prefetcher.queue.empty()) {
+        if (prefetcher.error) {
+          std::rethrow_exception(prefetcher.error);
+        }
+        throw std::runtime_error("entry " + std::to_string(entry) + " not available from prefetching");
+      }
+      auto prefetched = std::move(prefetcher.queue.front());
+      prefetcher.queue.pop_front();
+      prefetcher.notFull.notify_one();
+      if (prefetched.entry == entry) {
+        return std::move(prefetched.objects);
+      }
+      mBranchConfiguration->release(prefetched.objects);
+    }
+  }
+
+  /// stop the prefetching thread and release all prefetched objects
+  void stopPrefetching()
+  {
+    if (!mPrefetcher) {
+      return;
+    }
+    if (mPrefetcher->thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mPrefetcher->mutex);
+        mPrefetcher->stop = true;
+      }
+      mPrefetcher->notFull.notify_one();
+      mPrefetcher->thread.join();
+    }
+    for (auto& prefetched : mPrefetcher->queue) {
+      mBranchConfiguration->release(prefetched.objects);
+    }
+    mPrefetcher->queue.clear();
+  }
+
   // special helper to get the char argument from the argument pack
   template <typename T, typename... Args>
   const char* getCharArg(T arg, Args&&...)
@@ -552,6 +827,8 @@ class GenericRootTreeReader
   PublishingMode mPublishingMode = PublishingMode::Single;
   /// special user hook
   SpecialPublishHook* mPublishHook = nullptr;
+  /// prefetching state, optional
+  std::unique_ptr<Prefetcher> mPrefetcher;
 };
 
 using RootTreeReader = GenericRootTreeReader<rtr::DefaultKey>;
@@ -23,6 +23,7 @@
 #include <TTree.h>
 #include <TBranch.h>
 #include <TClass.h>
+#include <TROOT.h>
 #include <vector>
 #include <functional>
 #include <string>
@@ -34,6 +35,12 @@
 #include <utility>    // std::forward
 #include <algorithm>  // std::generate
 #include <variant>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace o2
 {
@@ -116,6 +123,11 @@ struct can_assign<
 /// as a \c std::vector<char>, this ensures separation on event basis as well as having binary
 /// data in parallel to ROOT objects in the same file, e.g. a binary data format from the
 /// reconstruction in parallel to MC labels.
+///
+/// \par Asynchronous writing:
+/// The filling of the branches and the compression of the baskets can be moved to a dedicated
+/// I/O thread, see \ref setAsyncWriting. The inputs are then copied into an entry owning all
+/// objects and the entry is handed over to the I/O thread through a bounded queue.
 class RootTreeWriter
 {
  public:
@@ -130,6 +142,9 @@ class RootTreeWriter
   // writing of tree and closing of file need to be implemented, but the pointers
   // remain owned by the tool
   using CustomClose = std::function<void(TFile* file, TTree* tree)>;
+  // the fill operations for one entry, each operation owns the data to be written to one branch,
+  // used to defer the filling to the I/O thread in asynchronous mode
+  using DeferredFills = std::vector<std::function<void()>>;
 
   /// DefaultKeyExtractor maps a data type used as key in the branch definition
   /// to the default internal key type std::string
@@ -294,6 +309,11 @@ class RootTreeWriter
     }
   }
 
+  ~RootTreeWriter()
+  {
+    stopWriterThread();
+  }
+
   /// Init the output file and tree.
   /// @param filename output file
   /// @param treename output tree
@@ -307,6 +327,71 @@ class RootTreeWriter
     mTreeStructure->setup(mBranchSpecs, mTree.get());
   }
 
+  /// Enable asynchronous writing
+  /// @param queueSize  maximum number of entries waiting for the I/O thread, 0 disables asynchronous writing
+  ///
+  /// In asynchronous mode, the inputs are extracted on the processing thread and copied into an
+  /// entry owning all data, because the input messages are released after processing. Filling of
+  /// the branches and compression of the baskets is done by a dedicated I/O thread, the processing
+  /// thread only blocks if the queue is full. The entry being written is counted in the queue, a
+  /// queue size of 2 corresponds to double buffering.
+  /// Spectator callbacks are executed on the processing thread. Fill callbacks operate directly
+  /// on the branches and can not be deferred, the writer stays synchronous if any of the branch
+  /// definitions has a Fill callback.
+  void setAsyncWriting(size_t queueSize)
+  {
+    if (mWriterThread.joinable()) {
+      throw std::runtime_error("can not change the writing mode after writing has started");
+    }
+    if (queueSize > 0 && mTreeStructure->hasFillCallback()) {
+      LOG(WARNING) << "custom fill callbacks can not be deferred to the I/O thread, keeping synchronous writing";
+      queueSize = 0;
+    }
+    if (queueSize > 0) {
+      ROOT::EnableThreadSafety();
+    }
+    mAsyncQueueSize = queueSize;
+  }
+
+  /// Flush the baskets of all branches every nEntries entries, 0 leaves flushing to ROOT
+  /// With ROOT implicit multithreading enabled, the baskets of the branches are compressed
+  /// in parallel when flushing, see enableImplicitMT
+  void setFlushInterval(size_t nEntries)
+  {
+    mFlushInterval = nEntries;
+  }
+
+  /// Enable ROOT implicit multithreading, used for parallel compression of the baskets
+  /// Note: this is a global setting of ROOT, 0 lets ROOT choose the number of threads
+  static void enableImplicitMT(unsigned int nThreads = 0)
+  {
+    ROOT::EnableImplicitMT(nThreads);
+  }
+
+  bool isAsync() const
+  {
+    return mAsyncQueueSize > 0;
+  }
+
+  /// number of entries in the asynchronous writing queue, including the entry being written
+  size_t getQueueDepth() const
+  {
+    std::lock_guard<std::mutex> lock(mQueueMutex);
+    return mQueue.size();
+  }
+
+  /// number of entries written to the tree
+  size_t getNEntriesWritten() const
+  {
+    return mNEntriesWritten;
+  }
+
+  /// number of bytes written to the output file
+  size_t getBytesWritten() const
+  {
+    return mBytesWritten;
+  }
+
   /// Set the branch name for a branch definition from the constructor argument list
   /// @param index       position in the argument list
   /// @param branchName  (base)branch name
@@ -336,15 +421,44 @@ class RootTreeWriter
     if (!mTree || !mFile || mFile->IsZombie()) {
       throw std::runtime_error("Writer is invalid state, probably closed previously");
     }
-    // execute tree structure handlers and fill the individual branches
-    mTreeStructure->exec(std::forward<ContextType>(context), mBranchSpecs);
-    // Note: number of entries will be set when closing the writer
+    if (mAsyncQueueSize == 0) {
+      // execute tree structure handlers and fill the individual branches
+      mTreeStructure->exec(std::forward<ContextType>(context), mBranchSpecs, nullptr);
+      finishEntry();
+      // Note: number of entries will be set when closing the writer
+      return;
+    }
+    // extract the inputs into an entry owning all data, the branches are filled by the I/O thread
+    DeferredFills entry;
+    mTreeStructure->exec(std::forward<ContextType>(context), mBranchSpecs, &entry);
+    if (!mWriterThread.joinable()) {
+      mStopWriter = false;
+      mWriterThread = std::thread([this]() { writerLoop(); });
+    }
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+    mQueueNotFull.wait(lock, [this]() { return mQueue.size() < mAsyncQueueSize || mWriterError; });
+    if (mWriterError) {
+      std::rethrow_exception(mWriterError);
+    }
+    mQueue.emplace_back(std::move(entry));
+    mQueueNotEmpty.notify_one();
   }
 
   /// write the tree and close the file
   /// the writer is invalid after calling close
   void close()
   {
+    // all queued entries are written before closing
+    stopWriterThread();
+    if (mWriterError) {
+      try {
+        std::rethrow_exception(mWriterError);
+      } catch (std::exception const& e) {
+        LOG(ERROR) << "asynchronous writing failed: " << e.what();
+      } catch (...) {
+        LOG(ERROR) << "asynchronous writing failed";
+      }
+    }
     mIsClosed = true;
     if (!mFile) {
       return;
@@ -433,7 +547,10 @@ class RootTreeWriter
     /// enters at the outermost element and recurses to the base elements
     /// Read the configured inputs from the input context, select the output branch
     /// and write the object
-    virtual void exec(InputContext&, std::vector<BranchSpec>&) {}
+    /// In asynchronous mode, the fill operations are appended to the deferred list instead
+    virtual void exec(InputContext&, std::vector<BranchSpec>&, DeferredFills*) {}
+    /// check if any of the branch definitions has a custom fill callback
+    virtual bool hasFillCallback() const { return false; }
     /// get the size of the branch structure, i.e. the number of registered branch
     /// definitions
     virtual size_t size() const { return STAGE; }
@@ -441,7 +558,9 @@ class RootTreeWriter
     // a dummy method called in the recursive processing
     void setupInstance(std::vector<BranchSpec>&, TTree*) {}
     // a dummy method called in the recursive processing
-    void process(InputContext&, std::vector<BranchSpec>&) {}
+    void process(InputContext&, std::vector<BranchSpec>&, DeferredFills*) {}
+    // a dummy method called in the recursive processing
+    bool hasFillCallbackInstance() const { return false; }
   };
 
   template <typename T = char>
@@ -534,9 +653,13 @@ class RootTreeWriter
 
     // this is the polymorphic entry point for processing of branch specs
     // recursive processing starting from the highest instance
-    void exec(InputContext& context, std::vector<BranchSpec>& specs) override
+    void exec(InputContext& context, std::vector<BranchSpec>& specs, DeferredFills* deferred) override
     {
-      process(context, specs);
+      process(context, specs, deferred);
+    }
+    bool hasFillCallback() const override
+    {
+      return hasFillCallbackInstance();
     }
     size_t size() const override { return STAGE; }
 
@@ -600,6 +723,14 @@ class RootTreeWriter
       }
     }
 
+    /// check this instance and recurse to the parent one
+    bool hasFillCallbackInstance() const
+    {
+      return PrevT::hasFillCallbackInstance() ||
+             std::holds_alternative<typename BranchDef<value_type>::Fill>(mCallback) ||
+             std::holds_alternative<typename BranchDef<value_type>::FillExt>(mCallback);
+    }
+
     /// check the alternatives for the callback and run if there are any
     /// @return true if branch has been filled, false if still to be filled
     template <typename DataType>
@@ -625,10 +756,17 @@ class RootTreeWriter
     // specialization for trivial structs or serialized objects without a TClass interface
     // the extracted object is copied to store variable
     template <typename S, typename std::enable_if_t<std::is_same<S, MessageableTypeSpecialization>::value, int> = 0>
-    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx)
+    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx, DeferredFills* deferred)
     {
       auto data = context.get<value_type>(ref);
       if (!runCallback(branch, data, ref)) {
+        if (deferred) {
+          deferred->emplace_back([this, branch, branchIdx, data]() {
+            mStore[branchIdx] = data;
+            branch->Fill();
+          });
+          return;
+        }
         mStore[branchIdx] = data;
         branch->Fill();
       }
@@ -639,10 +777,15 @@ class RootTreeWriter
     // in order to directly use the pointer to extracted object
     // store is a pointer to object
     template <typename S, typename std::enable_if_t<std::is_same<S, ROOTTypeSpecialization>::value, int> = 0>
-    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx)
+    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx, DeferredFills* deferred)
     {
       auto data = context.get<typename std::add_pointer<value_type>::type>(ref);
       if (!runCallback(branch, *data, ref)) {
+        if (deferred) {
+          // the deserialized object is owned by the returned pointer, hand it over to the fill operation
+          deferFill(deferred, branch, branchIdx, std::shared_ptr<value_type const>(data.release()));
+          return;
+        }
         // this is ugly but necessary because of the TTree API does not allow a const
         // object as input. Have to rely on that ROOT treats the object as const
         mStore[branchIdx] = const_cast<value_type*>(data.get());
@@ -653,9 +796,19 @@ class RootTreeWriter
     // specialization for binary buffers using const char*
     // this writes both the data branch and a size branch
     template <typename S, typename std::enable_if_t<std::is_same<S, BinaryBranchSpecialization>::value, int> = 0>
-    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx)
+    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx, DeferredFills* deferred)
     {
       auto data = context.get<gsl::span<char>>(ref);
+      if (deferred) {
+        auto buffer = std::make_shared<std::vector<char>>(data.begin(), data.end());
+        deferred->emplace_back([this, branch, branchIdx, buffer]() {
+          std::get<2>(mStore.at(branchIdx)) = buffer->size();
+          std::get<1>(mStore.at(branchIdx))->Fill();
+          std::get<0>(mStore.at(branchIdx)).swap(*buffer);
+          branch->Fill();
+        });
+        return;
+      }
       std::get<2>(mStore.at(branchIdx)) = data.size();
       std::get<1>(mStore.at(branchIdx))->Fill();
       std::get<0>(mStore.at(branchIdx)).resize(data.size());
@@ -665,7 +818,7 @@ class RootTreeWriter
 
     // specialization for vectors of messageable types
     template <typename S, typename std::enable_if_t<std::is_same<S, MessageableVectorSpecialization>::value, int> = 0>
-    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx)
+    void fillData(InputContext& context, DataRef const& ref, TBranch* branch, size_t branchIdx, DeferredFills* deferred)
     {
       using ElementType = typename value_type::value_type;
       static_assert(is_messageable<ElementType>::value, "logical error: should be correctly selected by StructureElementTypeTrait");
@@ -699,6 +852,14 @@ class RootTreeWriter
         // try extracting from message with serialization method NONE, throw runtime error
         // if message is serialized
         auto data = context.get<gsl::span<ElementType>>(ref);
+        if (deferred) {
+          // the message is released after processing, the I/O thread needs a copy of the data
+          std::shared_ptr<value_type const> copy = std::make_shared<value_type>(data.begin(), data.end());
+          if (!runCallback(branch, *copy, ref)) {
+            deferFill(deferred, branch, branchIdx, std::move(copy));
+          }
+          return;
+        }
         // take an ordinary std::vector "view" on the data
         auto* dataview = new value_type;
         adopt(data, *dataview);
@@ -716,6 +877,10 @@ class RootTreeWriter
           // try extracting from message with serialization method ROOT
           auto data = context.get<typename std::add_pointer<value_type>::type>(ref);
           if (!runCallback(branch, *data, ref)) {
+            if (deferred) {
+              deferFill(deferred, branch, branchIdx, std::shared_ptr<value_type const>(data.release()));
+              return;
+            }
             mStore[branchIdx] = const_cast<value_type*>(data.get());
             branch->Fill();
           }
@@ -726,12 +891,22 @@ class RootTreeWriter
       }
     }
 
+    // append the fill operation for an object owned by the operation to the deferred list,
+    // store is a pointer to object
+    void deferFill(DeferredFills* deferred, TBranch* branch, size_t branchIdx, std::shared_ptr<value_type const> object)
+    {
+      deferred->emplace_back([this, branch, branchIdx, object = std::move(object)]() {
+        mStore[branchIdx] = const_cast<value_type*>(object.get());
+        branch->Fill();
+      });
+    }
+
     // process previous stage and this stage
-    void process(InputContext& context, std::vector<BranchSpec>& specs)
+    void process(InputContext& context, std::vector<BranchSpec>& specs, DeferredFills* deferred)
     {
       // recursing through the tree structure by simply using method of the previous type,
       // i.e. the base class method.
-      PrevT::process(context, specs);
+      PrevT::process(context, specs, deferred);
       constexpr size_t SpecIndex = STAGE - 1;
       BranchSpec const& spec = specs[SpecIndex];
       if (spec.branches.size() == 0) {
@@ -752,7 +927,7 @@ class RootTreeWriter
               continue;
             }
           }
-          fillData<specialization_id>(context, dataref, spec.branches.at(branchIdx), branchIdx);
+          fillData<specialization_id>(context, dataref, spec.branches.at(branchIdx), branchIdx, deferred);
         }
       }
     }
@@ -866,6 +1041,64 @@ class RootTreeWriter
     return std::make_unique<T>();
   }
 
+  /// bookkeeping after an entry has been filled, flush the baskets if configured
+  void finishEntry()
+  {
+    mNEntriesWritten++;
+    if (mFlushInterval > 0 && mNEntriesWritten % mFlushInterval == 0) {
+      mTree->FlushBaskets();
+    }
+    mBytesWritten = mFile->GetBytesWritten();
+  }
+
+  /// the loop of the I/O thread, writes the entries in the order of the queue until
+  /// stop has been requested and the queue is empty
+  void writerLoop()
+  {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+    while (true) {
+      mQueueNotEmpty.wait(lock, [this]() { return mStopWriter || !mQueue.empty(); });
+      if (mQueue.empty()) {
+        break;
+      }
+      // the entry stays in the queue while being written to count it in the queue depth
+      auto& entry = mQueue.front();
+      bool skip = mWriterError != nullptr;
+      lock.unlock();
+      std::exception_ptr error;
+      if (!skip) {
+        try {
+          for (auto& fill : entry) {
+            fill();
+          }
+          finishEntry();
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+      lock.lock();
+      if (error) {
+        mWriterError = error;
+      }
+      mQueue.pop_front();
+      mQueueNotFull.notify_one();
+    }
+  }
+
+  /// write all queued entries and stop the I/O thread
+  void stopWriterThread()
+  {
+    if (!mWriterThread.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mStopWriter = true;
+    }
+    mQueueNotEmpty.notify_one();
+    mWriterThread.join();
+  }
+
   /// the output file
   std::unique_ptr<TFile> mFile;
   /// the output tree
@@ -878,6 +1111,23 @@ class RootTreeWriter
   bool mIsClosed = false;
   /// custom close handler, optional
   CustomClose mCustomClose;
+  /// maximum number of entries in the asynchronous writing queue, 0 for synchronous writing
+  size_t mAsyncQueueSize = 0;
+  /// flush the baskets every n entries, 0 leaves flushing to ROOT
+  size_t mFlushInterval = 0;
+  /// the queue of entries to be written by the I/O thread
+  std::deque<DeferredFills> mQueue;
+  /// protects the queue, the stop flag and the error state
+  mutable std::mutex mQueueMutex;
+  std::condition_variable mQueueNotEmpty;
+  std::condition_variable mQueueNotFull;
+  /// the I/O thread
+  std::thread mWriterThread;
+  bool mStopWriter = false;
+  /// exception caught in the I/O thread, forwarded to the processing thread
+  std::exception_ptr mWriterError;
+  std::atomic<size_t> mNEntriesWritten{0};
+  std::atomic<size_t> mBytesWritten{0};
 };
 
 } // namespace framework
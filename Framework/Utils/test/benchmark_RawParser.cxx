@@ -88,7 +88,48 @@ static void BM_RawParserV4(benchmark::State& state)
   }
 }
 
+static void BM_RawParserIterator(benchmark::State& state)
+{
+  size_t nofPages = state.range(0);
+  if (nofPages > TestPages::MaxNPages) {
+    return;
+  }
+  using Parser = RawParser<TestPages::PageSize>;
+  Parser parser(reinterpret_cast<const char*>(gPages.data()), nofPages * TestPages::PageSize);
+  size_t payload = 0;
+  for (auto _ : state) {
+    for (auto it = parser.begin(), end = parser.end(); it != end; ++it) {
+      auto const* rdh = it.get_if<TestPages::V4>();
+      if (rdh && rdh->linkID == 0 && !rdh->stop) {
+        payload += it.size() + *it.data();
+      }
+    }
+  }
+  benchmark::DoNotOptimize(payload);
+}
+
+static void BM_RawParserIndex(benchmark::State& state)
+{
+  size_t nofPages = state.range(0);
+  if (nofPages > TestPages::MaxNPages) {
+    return;
+  }
+  raw_parser::PageIndex index;
+  size_t payload = 0;
+  for (auto _ : state) {
+    raw_parser::scan<TestPages::PageSize>(gPages.data(), nofPages * TestPages::PageSize, index);
+    for (size_t page = 0; page < index.size(); page++) {
+      if (index.linkID[page] == 0 && !index.stop[page]) {
+        payload += index.payloadSize[page] + gPages.data()[index.offset[page] + index.headerSize[page]];
+      }
+    }
+  }
+  benchmark::DoNotOptimize(payload);
+}
+
 BENCHMARK(BM_RawParserV4)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
 BENCHMARK(BM_RawParserAuto)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+BENCHMARK(BM_RawParserIterator)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+BENCHMARK(BM_RawParserIndex)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
 
 BENCHMARK_MAIN();
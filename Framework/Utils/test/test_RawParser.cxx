@@ -87,4 +87,34 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_RawParser, RDH, testTypes)
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_RawParserScan, RDH, testTypes)
+{
+  constexpr size_t NofPages = 3;
+  std::array<unsigned char, NofPages * PageSize> buffer;
+  fillPages<RDH>(buffer);
+
+  raw_parser::PageIndex index;
+  raw_parser::scan<PageSize>(buffer.data(), buffer.size(), index);
+  BOOST_REQUIRE(index.size() == NofPages);
+  BOOST_CHECK(index.version == raw_parser::rdh_version<RDH>);
+
+  RawParser parser(buffer.data(), buffer.size());
+  size_t count = 0;
+  for (auto it = parser.begin(), end = parser.end(); it != end; ++it, ++count) {
+    BOOST_REQUIRE(count < index.size());
+    BOOST_CHECK(buffer.data() + index.offset[count] == it.raw());
+    BOOST_CHECK(index.headerSize[count] == it.offset());
+    BOOST_CHECK(index.payloadSize[count] == it.size());
+    BOOST_CHECK(index.stop[count] == (count + 1 == NofPages));
+  }
+  BOOST_CHECK(count == NofPages);
+
+  // the last page is cut, its header still fits
+  raw_parser::scan<PageSize>(buffer.data(), buffer.size() - PageSize / 2, index);
+  BOOST_CHECK(index.size() == NofPages);
+  // header of the last page does not fit
+  raw_parser::scan<PageSize>(buffer.data(), buffer.size() - PageSize + 1, index);
+  BOOST_CHECK(index.size() == NofPages - 1);
+}
+
 } // namespace o2::framework
@@ -25,6 +25,7 @@
 #include <TSystem.h>
 #include <TTree.h>
 #include <TFile.h>
+#include <cstring>
 #include <vector>
 
 using namespace o2::framework;
@@ -153,9 +154,129 @@ DataProcessorSpec getSinkSpec()
                            AlgorithmSpec(processingFct)};
 }
 
+// Publish every entry of a tree twice: read directly (subspec 0) and from a reader prefetching
+// the entries on a background thread through a TTreeCache (subspec 1). The prefetching depth does
+// not divide the number of entries, so the last batch of prefetched entries is a partial one.
+const size_t gPrefetchDepth = 4;
+DataProcessorSpec getPrefetchSourceSpec()
+{
+  auto initFct = [](InitContext& ic) {
+    std::string fileName = gSystem->TempDirectory();
+    fileName += "/test_RootTreeReaderPrefetch.root";
+
+    {
+      std::unique_ptr<TFile> testFile(TFile::Open(fileName.c_str(), "RECREATE"));
+      std::unique_ptr<TTree> testTree = std::make_unique<TTree>("testtree", "testtree");
+
+      std::vector<o2::test::TriviallyCopyable> msgblarray;
+      std::vector<o2::test::Polymorphic> valarray;
+      testTree->Branch("msgblarray", &msgblarray);
+      testTree->Branch("dataarray", &valarray);
+
+      for (int entry = 0; entry < gTreeSize; entry++) {
+        msgblarray.clear();
+        valarray.clear();
+        for (int idx = 0; idx < entry + 1; ++idx) {
+          msgblarray.emplace_back((entry * 10) + idx, 0, 0);
+          valarray.emplace_back((entry * 10) + idx);
+        }
+        testTree->Fill();
+      }
+      testTree->Write();
+      testTree->SetDirectory(nullptr);
+      testFile->Close();
+    }
+
+    constexpr auto persistency = Lifetime::Transient;
+    auto makeReader = [&fileName](o2::header::DataHeader::SubSpecificationType subSpec) {
+      return std::make_shared<RootTreeReader>("testtree",
+                                              fileName.c_str(),
+                                              RootTreeReader::BranchDefinition<std::vector<o2::test::TriviallyCopyable>>{Output{"TST", "PFMSGBL", subSpec, persistency}, "msgblarray"},
+                                              Output{"TST", "PFDATA", subSpec, persistency},
+                                              "dataarray",
+                                              RootTreeReader::PublishingMode::Single);
+    };
+    auto plainReader = makeReader(0);
+    auto prefetchReader = makeReader(1);
+    prefetchReader->setCacheSize(1024 * 1024);
+    prefetchReader->setPrefetching(gPrefetchDepth);
+
+    auto processingFct = [plainReader, prefetchReader](ProcessingContext& pc) {
+      if (plainReader->getCount() >= gTreeSize) {
+        return;
+      }
+      bool plainNext = plainReader->next();
+      bool prefetchNext = prefetchReader->next();
+      ASSERT_ERROR(plainNext == prefetchNext);
+      if (plainNext && prefetchNext) {
+        (*plainReader)(pc);
+        (*prefetchReader)(pc);
+      }
+      ASSERT_ERROR(plainReader->getCount() == prefetchReader->getCount());
+      if (plainReader->getCount() >= gTreeSize) {
+        // all entries, including the ones of the last partial batch, have been handed out
+        ASSERT_ERROR(prefetchReader->next() == false);
+        ASSERT_ERROR(prefetchReader->getNPrefetched() == 0);
+        pc.services().get<ControlService>().endOfStream();
+        pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
+      }
+    };
+
+    return processingFct;
+  };
+
+  return DataProcessorSpec{"prefetch-source",
+                           {},
+                           {OutputSpec{"TST", "PFDATA", 0},
+                            OutputSpec{"TST", "PFMSGBL", 0},
+                            OutputSpec{"TST", "PFDATA", 1},
+                            OutputSpec{"TST", "PFMSGBL", 1}},
+                           AlgorithmSpec(initFct)};
+}
+
+DataProcessorSpec getPrefetchSinkSpec()
+{
+  auto processingFct = [](ProcessingContext& pc) {
+    static int counter = 0;
+    // the prefetched entry must be serialized exactly as the one read directly
+    for (auto const& [plain, prefetched] : {std::make_pair("plaindata", "prefetchdata"), std::make_pair("plainmsgbl", "prefetchmsgbl")}) {
+      auto plainRef = pc.inputs().get(plain);
+      auto prefetchedRef = pc.inputs().get(prefetched);
+      auto size = DataRefUtils::getPayloadSize(plainRef);
+      ASSERT_ERROR(size == DataRefUtils::getPayloadSize(prefetchedRef));
+      if (size == DataRefUtils::getPayloadSize(prefetchedRef)) {
+        ASSERT_ERROR(memcmp(plainRef.payload, prefetchedRef.payload, size) == 0);
+      }
+    }
+
+    auto data = pc.inputs().get<std::vector<o2::test::Polymorphic>>("prefetchdata");
+    auto msgblspan = pc.inputs().get<gsl::span<o2::test::TriviallyCopyable>>("prefetchmsgbl");
+    LOG(INFO) << "prefetched count: " << counter << "  data elements:" << data.size();
+    ASSERT_ERROR(counter + 1 == data.size());
+    ASSERT_ERROR(counter + 1 == msgblspan.size());
+    for (unsigned int idx = 0; idx < data.size() && idx < msgblspan.size(); idx++) {
+      auto expected = 10 * counter + idx;
+      ASSERT_ERROR(data[idx].get() == expected);
+      ASSERT_ERROR((msgblspan[idx] == o2::test::TriviallyCopyable{expected, 0, 0}));
+    }
+
+    ++counter;
+  };
+
+  return DataProcessorSpec{"prefetch-sink",
+                           {InputSpec{"plaindata", "TST", "PFDATA", 0},
+                            InputSpec{"plainmsgbl", "TST", "PFMSGBL", 0},
+                            InputSpec{"prefetchdata", "TST", "PFDATA", 1},
+                            InputSpec{"prefetchmsgbl", "TST", "PFMSGBL", 1}},
+                           Outputs{},
+                           AlgorithmSpec(processingFct)};
+}
+
 WorkflowSpec defineDataProcessing(ConfigContext const&)
 {
   return WorkflowSpec{
     getSourceSpec(),
-    getSinkSpec()};
+    getSinkSpec(),
+    getPrefetchSourceSpec(),
+    getPrefetchSinkSpec()};
 }
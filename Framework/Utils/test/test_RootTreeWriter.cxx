@@ -236,6 +236,101 @@ BOOST_AUTO_TEST_CASE(test_RootTreeWriter)
             BranchContent<decltype(trivvec)>{"srlzdvecbranch", trivvec});
 }
 
+BOOST_AUTO_TEST_CASE(test_RootTreeWriterAsync)
+{
+  std::string filename = "test_RootTreeWriterAsync.root";
+  const char* treename = "testtree";
+
+  using Container = std::vector<o2::test::Polymorphic>;
+  RootTreeWriter writer(filename.c_str(), treename, // file and tree name
+                        RootTreeWriter::BranchDef<int>{"input1", "intbranch"},
+                        RootTreeWriter::BranchDef<Container>{"input2", "containerbranch"},
+                        RootTreeWriter::BranchDef<const char*>{"input3", "binarybranch"},
+                        RootTreeWriter::BranchDef<std::vector<int>>{"input4", "intvecbranch"});
+  writer.setAsyncWriting(2);
+  writer.setFlushInterval(3);
+  BOOST_REQUIRE(writer.isAsync());
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  std::vector<InputRoute> schema = {
+    {InputSpec{"input1", "TST", "INT"}, 0, "input1", 0},       //
+    {InputSpec{"input2", "TST", "CONTAINER"}, 1, "input2", 0}, //
+    {InputSpec{"input3", "TST", "BINARY"}, 2, "input3", 0},    //
+    {InputSpec{"input4", "TST", "FDMTLVEC"}, 3, "input4", 0},  //
+  };
+
+  const int nEntries = 10;
+  for (int entry = 0; entry < nEntries; entry++) {
+    std::vector<FairMQMessagePtr> store;
+    auto addMessage = [&transport, &store](DataHeader&& dh, FairMQMessagePtr payload) {
+      dh.payloadSize = payload->GetSize();
+      DataProcessingHeader dph{0, 1};
+      o2::header::Stack stack{dh, dph};
+      FairMQMessagePtr header = transport->CreateMessage(stack.size());
+      memcpy(header->GetData(), stack.data(), stack.size());
+      store.emplace_back(std::move(header));
+      store.emplace_back(std::move(payload));
+    };
+    auto createPlainMessage = [&transport, &addMessage](DataHeader&& dh, void const* data, size_t size) {
+      dh.payloadSerializationMethod = o2::header::gSerializationMethodNone;
+      FairMQMessagePtr payload = transport->CreateMessage(size);
+      memcpy(payload->GetData(), data, size);
+      addMessage(std::move(dh), std::move(payload));
+    };
+
+    std::vector<int> intvec{entry, 2 * entry, 3 * entry};
+    Container container{o2::test::Polymorphic(entry)};
+    createPlainMessage(o2::header::DataHeader{"INT", "TST", 0}, &entry, sizeof(entry));
+    FairMQMessagePtr serialized = transport->CreateMessage();
+    TMessageSerializer().Serialize(*serialized, &container, TClass::GetClass(typeid(Container)));
+    DataHeader containerHeader{"CONTAINER", "TST", 0};
+    containerHeader.payloadSerializationMethod = o2::header::gSerializationMethodROOT;
+    addMessage(std::move(containerHeader), std::move(serialized));
+    createPlainMessage(o2::header::DataHeader{"BINARY", "TST", 0}, intvec.data(), intvec.size() * sizeof(int));
+    createPlainMessage(o2::header::DataHeader{"FDMTLVEC", "TST", 0}, intvec.data(), intvec.size() * sizeof(int));
+
+    auto getter = [&store](size_t i) -> DataRef {
+      return DataRef{nullptr, static_cast<char const*>(store[2 * i]->GetData()), static_cast<char const*>(store[2 * i + 1]->GetData())};
+    };
+    InputRecord inputs{schema, InputSpan{getter, store.size() / 2}};
+    writer(inputs);
+    BOOST_CHECK(writer.getQueueDepth() <= 2);
+    // the messages are released after processing, the writer must not refer to the payload
+    for (size_t i = 1; i < store.size(); i += 2) {
+      memset(store[i]->GetData(), 0xff, store[i]->GetSize());
+    }
+  }
+  writer.close();
+  BOOST_CHECK(writer.getQueueDepth() == 0);
+  BOOST_CHECK(writer.getNEntriesWritten() == static_cast<size_t>(nEntries));
+  BOOST_CHECK(writer.getBytesWritten() > 0);
+
+  std::unique_ptr<TFile> file(TFile::Open(filename.c_str()));
+  BOOST_REQUIRE(file != nullptr);
+  auto* tree = reinterpret_cast<TTree*>(file->GetObjectChecked(treename, "TTree"));
+  BOOST_REQUIRE(tree != nullptr);
+  BOOST_REQUIRE(tree->GetEntries() == nEntries);
+  int intValue = -1;
+  Container* container = nullptr;
+  std::vector<char>* binary = nullptr;
+  std::vector<int>* intvec = nullptr;
+  tree->SetBranchAddress("intbranch", &intValue);
+  tree->SetBranchAddress("containerbranch", &container);
+  tree->SetBranchAddress("binarybranch", &binary);
+  tree->SetBranchAddress("intvecbranch", &intvec);
+  for (int entry = 0; entry < nEntries; entry++) {
+    tree->GetEntry(entry);
+    std::vector<int> reference{entry, 2 * entry, 3 * entry};
+    BOOST_CHECK(intValue == entry);
+    BOOST_REQUIRE(container != nullptr && container->size() == 1);
+    BOOST_CHECK((*container)[0] == o2::test::Polymorphic(entry));
+    BOOST_REQUIRE(binary != nullptr && binary->size() == reference.size() * sizeof(int));
+    BOOST_CHECK(memcmp(binary->data(), reference.data(), binary->size()) == 0);
+    BOOST_REQUIRE(intvec != nullptr);
+    BOOST_CHECK(*intvec == reference);
+  }
+}
+
 template <typename T>
 using BranchDefinition = MakeRootTreeWriterSpec::BranchDefinition<T>;
 
@@ -26,6 +26,10 @@
 #include <Vc/SimdArray>
 #endif
 
+#if !defined(GPUCA_GPUCODE)
+#include <vector>
+#endif
+
 class TFile;
 
 namespace GPUCA_NAMESPACE
@@ -304,6 +308,117 @@ class Spline2DSpec<DataT, YdimT, 0>
     gridX2.interpolateU(nYdim, knotV, Sv0, Dv0, Sv1, Dv1, v, S);
   }
 
+#if !defined(GPUCA_GPUCODE)
+  /// Number of points evaluated together by interpolateUbatch()
+  static constexpr int BatchLanes = 8;
+
+  /// Get interpolated values for n points {u1[i], u2[i]}, the inpYdim values of the point i are written to S[inpYdim * i].
+  /// The points are grouped by the spline cell: the knot data and the coefficients of the cubic polynomials along u1
+  /// are computed once per cell, and the points of the cell are then interpolated in BatchLanes SIMD lanes.
+  /// Every point goes through the same arithmetic operations as in interpolateU(), so the results are identical.
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  void interpolateUbatch(int inpYdim, const DataT Parameters[], int n, const DataT u1[], const DataT u2[], DataT S[]) const
+  {
+    const auto nYdimTmp = SplineUtil::getNdim<YdimT>(inpYdim);
+    const int nYdim = nYdimTmp.get();
+
+    const auto maxYdim = SplineUtil::getMaxNdim<YdimT>(inpYdim);
+    const int maxYdim4 = 4 * maxYdim.get();
+
+    const auto nYdim2 = nYdim * 2;
+    const auto nYdim4 = nYdim * 4;
+
+    // knot search, grouping of the points by the cell (counting sort)
+    const int nu = mGridX1.getNumberOfKnots();
+    const int nCells = nu * mGridX2.getNumberOfKnots();
+    std::vector<int> cell(n), first(nCells + 1, 0), order(n);
+    for (int i = 0; i < n; i++) {
+      const float u = u1[i], v = u2[i]; // same rounding as in interpolateU()
+      cell[i] = nu * mGridX2.template getLeftKnotIndexForU<SafeT>(v) + mGridX1.template getLeftKnotIndexForU<SafeT>(u);
+      first[cell[i] + 1]++;
+    }
+    for (int ic = 0; ic < nCells; ic++) {
+      first[ic + 1] += first[ic];
+    }
+    {
+      std::vector<int> pos(first.begin(), first.end() - 1);
+      for (int i = 0; i < n; i++) {
+        order[pos[cell[i]]++] = i;
+      }
+    }
+
+    for (int ic = 0; ic < nCells; ic++) {
+      const int k0 = first[ic], k1 = first[ic + 1];
+      if (k0 == k1) {
+        continue;
+      }
+      const int iu = ic % nu, iv = ic / nu;
+      const typename TBase::Knot& knotU = mGridX1.template getKnot<SafetyLevel::kNotSafe>(iu);
+      const typename TBase::Knot& knotV = mGridX2.template getKnot<SafetyLevel::kNotSafe>(iv);
+
+      const DataT* par00 = Parameters + (nu * iv + iu) * nYdim4;
+      const DataT* par10 = par00 + nYdim4;
+      const DataT* par01 = par00 + nYdim4 * nu;
+      const DataT* par11 = par01 + nYdim4;
+
+      // the cubic along u1 of each parameter is ((a * t + b) * t + Du0) * (u - knotU.u) + Su0, t = (u - knotU.u) * knotU.Li,
+      // with a and b depending on the cell only
+      DataT Su0[maxYdim4], Du0[maxYdim4], a[maxYdim4], b[maxYdim4];
+      const DataT liU = knotU.Li;
+      for (int i = 0; i < nYdim2; i++) {
+        Su0[i] = par00[i];
+        Su0[nYdim2 + i] = par01[i];
+        Du0[i] = par00[nYdim2 + i];
+        Du0[nYdim2 + i] = par01[nYdim2 + i];
+      }
+      for (int i = 0; i < nYdim2; i++) {
+        const DataT su1[2] = {par10[i], par11[i]}, du1[2] = {par10[nYdim2 + i], par11[nYdim2 + i]};
+        for (int j = 0; j < 2; j++) {
+          const int id = j * nYdim2 + i;
+          DataT df = (su1[j] - Su0[id]) * liU;
+          a[id] = Du0[id] + du1[j] - df - df;
+          b[id] = df - Du0[id] - a[id];
+        }
+      }
+
+      for (int k = k0; k < k1; k += BatchLanes) {
+        const int nl = (k1 - k < BatchLanes) ? k1 - k : BatchLanes;
+        int idx[BatchLanes];
+        DataT uu[BatchLanes], tu[BatchLanes], vv[BatchLanes], tv[BatchLanes];
+        DataT parU[maxYdim4][BatchLanes], res[maxYdim4][BatchLanes];
+        const DataT liV = knotV.Li;
+        for (int l = 0; l < BatchLanes; l++) {
+          idx[l] = order[k + (l < nl ? l : nl - 1)]; // the unused lanes repeat the last point
+          const float u = u1[idx[l]], v = u2[idx[l]];
+          uu[l] = DataT(u - knotU.u);
+          tu[l] = uu[l] * liU;
+          vv[l] = DataT(v - knotV.u);
+          tv[l] = vv[l] * liV;
+        }
+        for (int i = 0; i < nYdim4; i++) {
+          for (int l = 0; l < BatchLanes; l++) {
+            parU[i][l] = ((a[i] * tu[l] + b[i]) * tu[l] + Du0[i]) * uu[l] + Su0[i];
+          }
+        }
+        for (int dim = 0; dim < nYdim; dim++) {
+          const DataT *sv0 = parU[dim], *dv0 = parU[nYdim + dim], *sv1 = parU[nYdim2 + dim], *dv1 = parU[nYdim2 + nYdim + dim];
+          for (int l = 0; l < BatchLanes; l++) {
+            DataT df = (sv1[l] - sv0[l]) * liV;
+            DataT av = dv0[l] + dv1[l] - df - df;
+            DataT bv = df - dv0[l] - av;
+            res[dim][l] = ((av * tv[l] + bv) * tv[l] + dv0[l]) * vv[l] + sv0[l];
+          }
+        }
+        for (int l = 0; l < nl; l++) {
+          for (int dim = 0; dim < nYdim; dim++) {
+            S[nYdim * idx[l] + dim] = res[dim][l];
+          }
+        }
+      }
+    }
+  }
+#endif
+
  protected:
   using TBase::mGridX1;
   using TBase::mGridX2;
@@ -380,12 +495,22 @@ class Spline2DSpec<DataT, YdimT, 1>
     TBase::template interpolateU<SafeT>(YdimT, Parameters, u1, u2, S);
   }
 
+#if !defined(GPUCA_GPUCODE)
+  /// Get interpolated values for n points {u1[i], u2[i]} using spline parameters Parameters, see Spline2DSpec<DataT, YdimT, 0>
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  void interpolateUbatch(const DataT Parameters[], int n, const DataT u1[], const DataT u2[], DataT S[]) const
+  {
+    TBase::template interpolateUbatch<SafeT>(YdimT, Parameters, n, u1, u2, S);
+  }
+#endif
+
   using TBase::getNumberOfKnots;
 
   /// _______________  Suppress some parent class methods   ________________________
  private:
 #if !defined(GPUCA_GPUCODE)
   using TBase::recreate;
+  using TBase::interpolateUbatch;
 #endif
   using TBase::interpolateU;
 };
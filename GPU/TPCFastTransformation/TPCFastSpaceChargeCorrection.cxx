@@ -18,6 +18,7 @@
 #if !defined(GPUCA_GPUCODE)
 #include <iostream>
 #include <cmath>
+#include <vector>
 #include "ChebyshevFit1D.h"
 #include "Spline2DHelper.h"
 #endif
@@ -231,6 +232,29 @@ void TPCFastSpaceChargeCorrection::print() const
   }
 }
 
+#if !defined(GPUCA_GPUCODE)
+
+void TPCFastSpaceChargeCorrection::getCorrection(int slice, int row, int n, const float* u, const float* v, float* dx, float* du, float* dv) const
+{
+  const SplineType& spline = getSpline(slice, row);
+  const float* splineData = getSplineData(slice, row);
+  std::vector<float> suv(2 * n), dxuv(3 * n);
+  float *su = suv.data(), *sv = su + n;
+  for (int i = 0; i < n; i++) {
+    mGeo.convUVtoScaledUV(slice, row, u[i], v[i], su[i], sv[i]);
+    su[i] *= spline.getGridX1().getUmax();
+    sv[i] *= spline.getGridX2().getUmax();
+  }
+  spline.interpolateUbatch(splineData, n, su, sv, dxuv.data());
+  for (int i = 0; i < n; i++) {
+    dx[i] = dxuv[3 * i];
+    du[i] = dxuv[3 * i + 1];
+    dv[i] = dxuv[3 * i + 2];
+  }
+}
+
+#endif
+
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
 
 void TPCFastSpaceChargeCorrection::startConstruction(const TPCFastTransformGeo& geo, int numberOfSplineScenarios)
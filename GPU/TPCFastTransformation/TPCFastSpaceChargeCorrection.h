@@ -146,6 +146,12 @@ class TPCFastSpaceChargeCorrection : public FlatObject
   ///
   GPUd() int getCorrection(int slice, int row, float u, float v, float& dx, float& du, float& dv) const;
 
+#if !defined(GPUCA_GPUCODE)
+  /// Correction for n clusters of the same row, identical to getCorrection() called for each cluster.
+  /// The spline is evaluated for all the clusters at once, see Spline2D::interpolateUbatch()
+  void getCorrection(int slice, int row, int n, const float* u, const float* v, float* dx, float* du, float* dv) const;
+#endif
+
   /// inverse correction: Corrected U and V -> coorrected X
   GPUd() void getCorrectionInvCorrectedX(int slice, int row, float corrU, float corrV, float& corrX) const;
 
@@ -21,6 +21,7 @@
 
 #if !defined(GPUCA_GPUCODE)
 #include <iostream>
+#include <vector>
 #endif
 
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
@@ -151,6 +152,41 @@ void TPCFastTransform::print() const
 #endif
 }
 
+#if !defined(GPUCA_GPUCODE)
+
+void TPCFastTransform::Transform(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime) const
+{
+  /// Same steps as in the single cluster Transform(), the UV coordinates are kept in the y and z arrays
+  /// until they are converted to the local coordinates
+
+  const TPCFastTransformGeo::RowInfo& rowInfo = getGeometry().getRowInfo(row);
+  float *u = y, *v = z;
+  for (int i = 0; i < n; i++) {
+    x[i] = rowInfo.x;
+    convPadTimeToUV(slice, row, pad[i], time[i], u[i], v[i], vertexTime);
+  }
+
+  if (mApplyCorrection) {
+    std::vector<float> corr(3 * n);
+    float *dx = corr.data(), *du = dx + n, *dv = du + n;
+    mCorrection.getCorrection(slice, row, n, u, v, dx, du, dv);
+    for (int i = 0; i < n; i++) {
+      x[i] += dx[i];
+      u[i] += du[i];
+      v[i] += dv[i];
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    getGeometry().convUVtoLocal(slice, u[i], v[i], y[i], z[i]);
+    float dzTOF = 0;
+    getTOFcorrection(slice, row, x[i], y[i], z[i], dzTOF);
+    z[i] += dzTOF;
+  }
+}
+
+#endif
+
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE) && !defined(GPUCA_ALIROOT_LIB)
 
 int TPCFastTransform::writeToFile(std::string outFName, std::string name)
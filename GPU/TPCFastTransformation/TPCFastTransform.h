@@ -130,6 +130,12 @@ class TPCFastTransform : public FlatObject
   ///
   GPUd() void Transform(int slice, int row, float pad, float time, float& x, float& y, float& z, float vertexTime = 0) const;
 
+#if !defined(GPUCA_GPUCODE)
+  /// Transforms n clusters of the same row given by their pad and time arrays, with the result identical
+  /// to Transform() called for each cluster. The correction splines are evaluated for all clusters at once.
+  void Transform(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime = 0) const;
+#endif
+
   /// Transformation in the time frame
   GPUd() void TransformInTimeFrame(int slice, int row, float pad, float time, float& x, float& y, float& z, float maxTimeBin) const;
 
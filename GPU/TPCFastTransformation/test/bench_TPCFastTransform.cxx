@@ -0,0 +1,97 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_TPCFastTransform.cxx
+/// \brief Benchmark of the TPC cluster transformation cluster by cluster and for whole rows
+
+#include "benchmark/benchmark.h"
+#include "TPCReconstruction/TPCFastTransformHelperO2.h"
+#include "TPCFastTransform.h"
+#include <fairlogger/Logger.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace o2::gpu;
+
+// transformation with a smooth space charge correction
+TPCFastTransform& getTransform()
+{
+  static std::unique_ptr<TPCFastTransform> transform;
+  if (!transform) {
+    fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+    auto correction = [](int roc, const double XYZ[3], double dXdYdZ[3]) {
+      dXdYdZ[0] = 0.5 + 0.01 * XYZ[1];
+      dXdYdZ[1] = -0.3 + 0.002 * XYZ[0];
+      dXdYdZ[2] = 0.2 + 0.001 * XYZ[2];
+    };
+    o2::tpc::TPCFastTransformHelperO2::instance()->setSpaceChargeCorrection(correction);
+    transform = o2::tpc::TPCFastTransformHelperO2::instance()->create(0);
+  }
+  return *transform;
+}
+
+// random clusters of each row of a slice, Arg = number of clusters per row
+struct RowClusters {
+  std::vector<std::vector<float>> pad, time;
+  RowClusters(const TPCFastTransform& transform, int slice, int nClusters)
+  {
+    const auto& geo = transform.getGeometry();
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> time01(0.f, 1.f);
+    for (int row = 0; row < geo.getNumberOfRows(); row++) {
+      std::uniform_real_distribution<float> padDist(0.f, geo.getRowInfo(row).maxPad);
+      pad.emplace_back(nClusters);
+      time.emplace_back(nClusters);
+      float maxTime = transform.getMaxDriftTime(slice, row);
+      for (int i = 0; i < nClusters; i++) {
+        pad.back()[i] = padDist(gen);
+        time.back()[i] = time01(gen) * maxTime;
+      }
+    }
+  }
+};
+
+static void BM_TransformCluster(benchmark::State& state)
+{
+  const auto& transform = getTransform();
+  RowClusters clusters(transform, 0, state.range(0));
+  const int nRows = clusters.pad.size();
+  for (auto _ : state) {
+    for (int row = 0; row < nRows; row++) {
+      for (int i = 0; i < state.range(0); i++) {
+        float x, y, z;
+        transform.Transform(0, row, clusters.pad[row][i], clusters.time[row][i], x, y, z);
+        benchmark::DoNotOptimize(z);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nRows * state.range(0));
+}
+
+static void BM_TransformRow(benchmark::State& state)
+{
+  const auto& transform = getTransform();
+  RowClusters clusters(transform, 0, state.range(0));
+  const int nRows = clusters.pad.size();
+  std::vector<float> x(state.range(0)), y(state.range(0)), z(state.range(0));
+  for (auto _ : state) {
+    for (int row = 0; row < nRows; row++) {
+      transform.Transform(0, row, state.range(0), clusters.pad[row].data(), clusters.time[row].data(), x.data(), y.data(), z.data());
+      benchmark::DoNotOptimize(z.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nRows * state.range(0));
+}
+
+BENCHMARK(BM_TransformCluster)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(BM_TransformRow)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_MAIN();
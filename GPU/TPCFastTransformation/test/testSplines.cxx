@@ -18,6 +18,8 @@
 #include <boost/test/unit_test.hpp>
 #include "Spline1D.h"
 #include "Spline2D.h"
+#include <random>
+#include <vector>
 
 namespace o2::gpu
 {
@@ -32,4 +34,41 @@ BOOST_AUTO_TEST_CASE(Spline_test1)
   int err2 = o2::gpu::Spline2D<float>::test(0);
   BOOST_CHECK_MESSAGE(err2 == 0, "test of GPU/TPCFastTransform/Spline2D failed with the error code " << err2);
 }
+/// @brief Check that the batch interpolation gives exactly the same result as the point-by-point one
+BOOST_AUTO_TEST_CASE(Spline_test_batch)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> par(-1.f, 1.f);
+
+  const int knotsU1[] = {0, 2, 3, 7, 10, 15}, knotsU2[] = {0, 1, 4, 6, 12, 20, 21};
+  const int n = 10000;
+  std::uniform_real_distribution<float> u1(-2.f, 17.f), u2(-1.f, 22.f); // including points outside of the grid
+  std::vector<float> u(n), v(n);
+  for (int i = 0; i < n; i++) {
+    u[i] = u1(gen);
+    v[i] = u2(gen);
+  }
+
+  Spline2D<float, 3> spline(6, knotsU1, 7, knotsU2);
+  for (int i = 0; i < spline.getNumberOfParameters(); i++) {
+    spline.getParameters()[i] = par(gen);
+  }
+  std::vector<float> s(3 * n), sBatch(3 * n);
+  for (int i = 0; i < n; i++) {
+    spline.interpolateU(spline.getParameters(), u[i], v[i], &s[3 * i]);
+  }
+  spline.interpolateUbatch(spline.getParameters(), n, u.data(), v.data(), sBatch.data());
+  BOOST_CHECK(s == sBatch);
+
+  Spline2D<double> splineD(2, 6, knotsU1, 7, knotsU2);
+  for (int i = 0; i < splineD.getNumberOfParameters(); i++) {
+    splineD.getParameters()[i] = par(gen);
+  }
+  std::vector<double> ud(u.begin(), u.end()), vd(v.begin(), v.end()), sD(2 * n), sDBatch(2 * n);
+  for (int i = 0; i < n; i++) {
+    splineD.interpolateU(2, splineD.getParameters(), ud[i], vd[i], &sD[2 * i]);
+  }
+  splineD.interpolateUbatch(2, splineD.getParameters(), n, ud.data(), vd.data(), sDBatch.data());
+  BOOST_CHECK(sD == sDBatch);
+}
 } // namespace o2::gpu
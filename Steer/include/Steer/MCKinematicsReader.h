@@ -14,6 +14,11 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
+#include <gsl/span>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <utility>
 #include <vector>
 
 class TChain;
@@ -81,6 +86,29 @@ class MCKinematicsReader
   /// variant returning all tracks for source and event at once
   std::vector<MCTrack> const& getTracks(int event) const;
 
+  /// bulk query of MC tracks given labels; the tracks are returned in the order of the labels.
+  /// The requests are grouped by source and event, so that each event is loaded only once.
+  /// Invalid labels, or labels pointing outside of the kinematics, give a default-constructed MCTrack.
+  std::vector<MCTrack> getTracks(gsl::span<const o2::MCCompLabel> labels) const;
+
+  /// limits the memory (in bytes) taken by the tracks of loaded events; 0 (default) means no limit.
+  /// When the budget is exceeded, the least recently used events are released. The references and pointers
+  /// to tracks of released events are invalidated, so only those from the last query are guaranteed to be valid.
+  /// Setting the budget releases all loaded events.
+  void setTrackCacheBudget(size_t bytes);
+  size_t getTrackCacheBudget() const { return mTrackCacheBudget; }
+  /// memory (in bytes) taken by the tracks of loaded events
+  size_t getTrackCacheSize() const { return mTrackCacheSize; }
+
+  /// writes the tracks of all events of a source to a flat file, which can be memory-mapped by mapFlatTracks.
+  /// returns true if successful
+  bool writeFlatTracks(int source, std::string const& filename) const;
+
+  /// memory-maps a flat file written by writeFlatTracks, after which the tracks of the source are taken from it:
+  /// getTrack is then a constant time access w/o ROOT I/O. Returns true if successful
+  bool mapFlatTracks(int source, std::string const& filename);
+  bool hasFlatTracks(int source) const { return source < int(mFlatTracks.size()) && mFlatTracks[source].tracks != nullptr; }
+
   /// get all primaries for a certain event
 
   /// get all secondaries of the given label
@@ -114,6 +142,9 @@ class MCKinematicsReader
   void loadHeadersForSource(int source) const;
   void loadTrackRefsForSource(int source) const;
   void initIndexedTrackRefs(std::vector<o2::TrackReference>& refs, o2::dataformats::MCTruthContainer<o2::TrackReference>& indexedrefs) const;
+  void useTracksForSourceAndEvent(int source, int event) const;
+  void releaseTracks(int source, int event) const;
+  void unmapFlatTracks(int source);
 
   DigitizationContext const* mDigitizationContext = nullptr;
 
@@ -125,6 +156,23 @@ class MCKinematicsReader
   mutable std::vector<std::vector<o2::dataformats::MCEventHeader>> mHeaders;                                 // the in-memory header container
   mutable std::vector<std::vector<o2::dataformats::MCTruthContainer<o2::TrackReference>>> mIndexedTrackRefs; // the in-memory track ref container
 
+  // least recently used bookkeeping of the loaded events (only when a cache budget is set)
+  using EventID = std::pair<int, int>; // source, event
+  mutable std::list<EventID> mTrackCacheUse;                                     //! loaded events, the most recently used first
+  mutable std::vector<std::vector<std::list<EventID>::iterator>> mTrackCachePos; //! position of each loaded event in mTrackCacheUse
+  size_t mTrackCacheBudget = 0;                                                  // maximal memory taken by the loaded tracks, 0 = no limit
+  mutable size_t mTrackCacheSize = 0;                                            // memory taken by the loaded tracks
+
+  // tracks memory-mapped from flat files (see writeFlatTracks)
+  struct FlatTracks {
+    void* mapping = nullptr;           // start of the mapped file
+    size_t mappingSize = 0;            // size of the mapped file
+    size_t nEvents = 0;                // number of events
+    const uint64_t* offsets = nullptr; // index of the first track of each event, nEvents + 1 entries
+    const MCTrack* tracks = nullptr;   // tracks of all events
+  };
+  std::vector<FlatTracks> mFlatTracks; //!
+
   bool mInitialized = false; // whether initialized
 };
 
@@ -138,6 +186,10 @@ inline MCTrack const* MCKinematicsReader::getTrack(o2::MCCompLabel const& label)
 
 inline MCTrack const* MCKinematicsReader::getTrack(int source, int event, int track) const
 {
+  if (hasFlatTracks(source)) {
+    const auto& flat = mFlatTracks[source];
+    return &flat.tracks[flat.offsets[event] + track];
+  }
   return &getTracks(source, event)[track];
 }
 
@@ -153,6 +205,8 @@ inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int source, int
   }
   if (mTracks[source][event] == nullptr) {
     loadTracksForSourceAndEvent(source, event);
+  } else if (mTrackCacheBudget > 0) {
+    useTracksForSourceAndEvent(source, event);
   }
   return *mTracks[source][event];
 }
@@ -14,10 +14,31 @@
 #include "SimulationDataFormat/TrackReference.h"
 #include <TChain.h>
 #include <vector>
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "FairLogger.h"
 
 using namespace o2::steer;
 
+namespace
+{
+// layout of the flat track files: header, offsets of the events (nEvents + 1 entries), tracks of all events
+struct FlatTracksHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t trackSize; // sizeof(MCTrack) of the writer, the file is not portable across layouts
+  uint64_t nEvents;
+};
+constexpr uint64_t FlatTracksMagic = 0x534b434d54414c46; // "FLATMCKS"
+constexpr uint32_t FlatTracksVersion = 1;
+static_assert(std::is_trivially_copyable_v<o2::MCTrack>, "MCTrack must be trivially copyable to be stored in flat files");
+} // namespace
+
 MCKinematicsReader::~MCKinematicsReader()
 {
   for (auto chain : mInputChains) {
@@ -25,6 +46,10 @@ MCKinematicsReader::~MCKinematicsReader()
   }
   mInputChains.clear();
 
+  for (int source = 0; source < int(mFlatTracks.size()); ++source) {
+    unmapFlatTracks(source);
+  }
+
   if (mDigitizationContext) {
     delete mDigitizationContext;
   }
@@ -52,36 +77,222 @@ void MCKinematicsReader::initIndexedTrackRefs(std::vector<o2::TrackReference>& r
 void MCKinematicsReader::initTracksForSource(int source) const
 {
   auto chain = mInputChains[source];
-  if (chain) {
+  if (hasFlatTracks(source)) {
+    mTracks[source].resize(mFlatTracks[source].nEvents, nullptr);
+  } else if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
     mTracks[source].resize(br->GetEntries(), nullptr);
   }
+  mTrackCachePos[source].resize(mTracks[source].size());
 }
 
 void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
 {
   auto chain = mInputChains[source];
-  if (chain) {
+  if (hasFlatTracks(source)) {
+    const auto& flat = mFlatTracks[source];
+    mTracks[source][event] = new std::vector<o2::MCTrack>(flat.tracks + flat.offsets[event], flat.tracks + flat.offsets[event + 1]);
+  } else if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
     if (br) {
       std::vector<MCTrack>* loadtracks = nullptr;
       br->SetAddress(&loadtracks);
       br->GetEntry(event);
-      mTracks[source][event] = new std::vector<o2::MCTrack>;
-      *mTracks[source][event] = *loadtracks;
-      delete loadtracks;
+      // take the ownership of the vector read by ROOT rather than copying it
+      mTracks[source][event] = loadtracks;
+    }
+  }
+  if (mTrackCacheBudget > 0 && mTracks[source][event] != nullptr) {
+    mTrackCacheUse.emplace_front(source, event);
+    mTrackCachePos[source][event] = mTrackCacheUse.begin();
+    mTrackCacheSize += mTracks[source][event]->size() * sizeof(MCTrack);
+    // release the least recently used events, but never the one which was just asked for
+    while (mTrackCacheSize > mTrackCacheBudget && mTrackCacheUse.size() > 1) {
+      auto [releaseSource, releaseEvent] = mTrackCacheUse.back();
+      releaseTracks(releaseSource, releaseEvent);
     }
   }
 }
 
+void MCKinematicsReader::useTracksForSourceAndEvent(int source, int event) const
+{
+  mTrackCacheUse.splice(mTrackCacheUse.begin(), mTrackCacheUse, mTrackCachePos[source][event]);
+}
+
+void MCKinematicsReader::releaseTracks(int source, int event) const
+{
+  if (mTracks[source][event] == nullptr) {
+    return;
+  }
+  if (mTrackCacheBudget > 0) {
+    mTrackCacheUse.erase(mTrackCachePos[source][event]);
+    mTrackCacheSize -= mTracks[source][event]->size() * sizeof(MCTrack);
+  }
+  delete mTracks[source][event];
+  mTracks[source][event] = nullptr;
+}
+
 void MCKinematicsReader::releaseTracksForSourceAndEvent(int source, int eventID)
 {
   if (mTracks.at(source).at(eventID) != nullptr) {
-    delete mTracks[source][eventID];
-    mTracks[source][eventID] = nullptr;
+    releaseTracks(source, eventID);
+  }
+}
+
+void MCKinematicsReader::setTrackCacheBudget(size_t bytes)
+{
+  // start the bookkeeping from scratch: release everything which was loaded so far
+  for (int source = 0; source < int(mTracks.size()); ++source) {
+    for (int event = 0; event < int(mTracks[source].size()); ++event) {
+      releaseTracks(source, event);
+    }
+  }
+  mTrackCacheUse.clear();
+  mTrackCacheSize = 0;
+  mTrackCacheBudget = bytes;
+}
+
+std::vector<MCTrack> MCKinematicsReader::getTracks(gsl::span<const o2::MCCompLabel> labels) const
+{
+  std::vector<MCTrack> tracks(labels.size());
+
+  // group the requests by source and event (and then by track for the memory locality)
+  std::vector<size_t> order;
+  order.reserve(labels.size());
+  for (size_t i = 0; i < labels.size(); ++i) {
+    if (labels[i].isValid() && labels[i].getSourceID() < int(getNSources())) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+
+  for (size_t i = 0; i < order.size();) {
+    const int source = labels[order[i]].getSourceID();
+    const int event = labels[order[i]].getEventID();
+    size_t end = i + 1;
+    while (end < order.size() && labels[order[end]].getSourceID() == source && labels[order[end]].getEventID() == event) {
+      ++end;
+    }
+    if (event < int(getNEvents(source))) {
+      gsl::span<const MCTrack> eventTracks;
+      if (hasFlatTracks(source)) {
+        const auto& flat = mFlatTracks[source];
+        eventTracks = gsl::span<const MCTrack>(flat.tracks + flat.offsets[event], flat.offsets[event + 1] - flat.offsets[event]);
+      } else {
+        const auto& loaded = getTracks(source, event);
+        eventTracks = gsl::span<const MCTrack>(loaded.data(), loaded.size());
+      }
+      for (; i < end; ++i) {
+        const auto track = labels[order[i]].getTrackID();
+        if (track < int(eventTracks.size())) {
+          tracks[order[i]] = eventTracks[track];
+        }
+      }
+    }
+    i = end;
+  }
+  return tracks;
+}
+
+bool MCKinematicsReader::writeFlatTracks(int source, std::string const& filename) const
+{
+  if (source >= int(getNSources())) {
+    LOG(ERROR) << "No source " << source << " to write flat tracks for";
+    return false;
+  }
+  const size_t nEvents = getNEvents(source);
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LOG(ERROR) << "Failed to open " << filename << " for writing";
+    return false;
+  }
+
+  // the offsets of the events precede the tracks: they are filled while writing the tracks and written at the end
+  std::vector<uint64_t> offsets(nEvents + 1, 0);
+  FlatTracksHeader header{FlatTracksMagic, FlatTracksVersion, sizeof(MCTrack), nEvents};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+  for (size_t event = 0; event < nEvents; ++event) {
+    const bool loaded = mTracks[source][event] != nullptr;
+    const auto& tracks = getTracks(source, event);
+    out.write(reinterpret_cast<const char*>(tracks.data()), tracks.size() * sizeof(MCTrack));
+    offsets[event + 1] = offsets[event] + tracks.size();
+    if (!loaded) {
+      releaseTracks(source, event); // do not keep in memory what was not there before
+    }
+  }
+  out.seekp(sizeof(header));
+  out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+  out.close();
+  if (!out) {
+    LOG(ERROR) << "Failed to write flat tracks to " << filename;
+    return false;
+  }
+  return true;
+}
+
+bool MCKinematicsReader::mapFlatTracks(int source, std::string const& filename)
+{
+  if (source >= int(getNSources())) {
+    LOG(ERROR) << "No source " << source << " to map flat tracks for";
+    return false;
+  }
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << "Failed to open flat tracks file " << filename;
+    return false;
+  }
+  struct stat st;
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(FlatTracksHeader)) {
+    mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd); // the mapping stays valid
+  if (mapping == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map flat tracks file " << filename;
+    return false;
+  }
+
+  const size_t size = st.st_size;
+  const auto& header = *reinterpret_cast<const FlatTracksHeader*>(mapping);
+  const auto offsets = reinterpret_cast<const uint64_t*>(reinterpret_cast<const char*>(mapping) + sizeof(FlatTracksHeader));
+  const size_t tracksStart = sizeof(FlatTracksHeader) + (header.nEvents + 1) * sizeof(uint64_t);
+  bool valid = header.magic == FlatTracksMagic && header.version == FlatTracksVersion && header.trackSize == sizeof(MCTrack) &&
+               header.nEvents < size / sizeof(uint64_t) && tracksStart <= size &&
+               tracksStart + offsets[header.nEvents] * sizeof(MCTrack) == size;
+  for (size_t event = 0; valid && event < header.nEvents; ++event) {
+    valid = offsets[event] <= offsets[event + 1];
+  }
+  if (!valid) {
+    LOG(ERROR) << "File " << filename << " does not contain valid flat tracks";
+    munmap(mapping, size);
+    return false;
+  }
+
+  unmapFlatTracks(source);
+  // events loaded from ROOT are replaced by those in the file
+  for (int event = 0; event < int(mTracks[source].size()); ++event) {
+    releaseTracks(source, event);
+  }
+  mTracks[source].clear();
+  auto& flat = mFlatTracks[source];
+  flat.mapping = mapping;
+  flat.mappingSize = size;
+  flat.nEvents = header.nEvents;
+  flat.offsets = offsets;
+  flat.tracks = reinterpret_cast<const MCTrack*>(reinterpret_cast<const char*>(mapping) + tracksStart);
+  return true;
+}
+
+void MCKinematicsReader::unmapFlatTracks(int source)
+{
+  auto& flat = mFlatTracks[source];
+  if (flat.mapping != nullptr) {
+    munmap(flat.mapping, flat.mappingSize);
   }
+  flat = FlatTracks{};
 }
 
 void MCKinematicsReader::loadHeadersForSource(int source) const
@@ -152,6 +363,8 @@ bool MCKinematicsReader::initFromDigitContext(std::string_view name)
   mTracks.resize(mInputChains.size());
   mHeaders.resize(mInputChains.size());
   mIndexedTrackRefs.resize(mInputChains.size());
+  mTrackCachePos.resize(mInputChains.size());
+  mFlatTracks.resize(mInputChains.size());
 
   // actual loading will be done only if someone asks
   // the first time for a particular source ...
@@ -170,6 +383,8 @@ bool MCKinematicsReader::initFromKinematics(std::string_view name)
   mTracks.resize(1);
   mHeaders.resize(1);
   mIndexedTrackRefs.resize(1);
+  mTrackCachePos.resize(1);
+  mFlatTracks.resize(1);
   mInitialized = true;
 
   return true;
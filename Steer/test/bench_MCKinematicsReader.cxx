@@ -0,0 +1,102 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_MCKinematicsReader.cxx
+/// \brief Benchmark of MCKinematicsReader on a workload of random labels, as in matching QC or efficiency studies
+
+#include "benchmark/benchmark.h"
+#include "Steer/MCKinematicsReader.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include <fairlogger/Logger.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <random>
+#include <vector>
+
+using namespace o2::steer;
+
+const std::string Prefix = "bench_mckinereader";
+const std::string FlatName = Prefix + "_Kine.flat";
+constexpr int NEvents = 200;
+constexpr int NTracksPerEvent = 20000;
+constexpr size_t NLabels = 100000;
+
+void writeKinematicsFile()
+{
+  static bool done = false;
+  if (done) {
+    return;
+  }
+  TFile file(o2::base::NameConf::getMCKinematicsFileName(Prefix).c_str(), "RECREATE");
+  TTree tree("o2sim", "");
+  std::vector<o2::MCTrack> tracks;
+  auto tracksPtr = &tracks;
+  tree.Branch("MCTrack", &tracksPtr);
+  std::mt19937 gen(12345);
+  std::normal_distribution<double> mom(0., 1.);
+  for (int event = 0; event < NEvents; event++) {
+    tracks.clear();
+    for (int track = 0; track < NTracksPerEvent; track++) {
+      tracks.emplace_back(211, track - 1, -1, -1, -1, mom(gen), mom(gen), mom(gen), 0., 0., 0., 0., 0);
+    }
+    tree.Fill();
+  }
+  tree.Write();
+  file.Close();
+
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  reader.writeFlatTracks(0, FlatName);
+  done = true;
+}
+
+std::vector<o2::MCCompLabel> randomLabels()
+{
+  std::mt19937 gen(54321);
+  std::uniform_int_distribution<int> event(0, NEvents - 1), track(0, NTracksPerEvent - 1);
+  std::vector<o2::MCCompLabel> labels;
+  labels.reserve(NLabels);
+  for (size_t i = 0; i < NLabels; i++) {
+    labels.emplace_back(track(gen), event(gen), 0);
+  }
+  return labels;
+}
+
+// look up random labels one by one (Arg = 0), in bulk (1) or one by one in the memory-mapped flat file (2),
+// with a cache budget of 10% of the events
+static void BM_RandomLabels(benchmark::State& state)
+{
+  fair::Logger::SetConsoleSeverity(fair::Severity::ERROR);
+  writeKinematicsFile();
+  const auto labels = randomLabels();
+  const int mode = state.range(0);
+  for (auto _ : state) {
+    MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+    reader.setTrackCacheBudget(NEvents / 10 * NTracksPerEvent * sizeof(o2::MCTrack));
+    if (mode == 2) {
+      reader.mapFlatTracks(0, FlatName);
+    }
+    double sum = 0;
+    if (mode == 1) {
+      for (const auto& track : reader.getTracks(labels)) {
+        sum += track.Px();
+      }
+    } else {
+      for (const auto& label : labels) {
+        sum += reader.getTrack(label)->Px();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NLabels);
+}
+
+BENCHMARK(BM_RandomLabels)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
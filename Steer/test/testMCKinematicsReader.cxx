@@ -0,0 +1,141 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MCKinematicsReader class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "Steer/MCKinematicsReader.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <TRandom.h>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace steer
+{
+
+const std::string Prefix = "mckinereadertest";
+const int NEvents = 20;
+
+// number of tracks in an event
+int nTracks(int event) { return 10 + 7 * event; }
+
+// mockup kinematics with the event and track IDs encoded in the tracks
+void makeKinematicsFile()
+{
+  TFile file(o2::base::NameConf::getMCKinematicsFileName(Prefix).c_str(), "RECREATE");
+  TTree tree("o2sim", "");
+  std::vector<MCTrack> tracks;
+  auto tracksPtr = &tracks;
+  tree.Branch("MCTrack", &tracksPtr);
+  for (int event = 0; event < NEvents; event++) {
+    tracks.clear();
+    for (int track = 0; track < nTracks(event); track++) {
+      tracks.emplace_back(211, track - 1, -1, -1, -1, event, track, 1., 0., 0., 0., 0., 0);
+    }
+    tree.Fill();
+  }
+  tree.Write();
+  file.Close();
+}
+
+bool isTrack(MCTrack const& track, int event, int trackID)
+{
+  return track.Px() == event && track.Py() == trackID;
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReaderCache)
+{
+  makeKinematicsFile();
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  BOOST_REQUIRE(reader.isInitialized());
+  BOOST_CHECK_EQUAL(reader.getNEvents(0), NEvents);
+
+  // budget for ~2 events
+  const size_t budget = 2 * nTracks(NEvents - 1) * sizeof(MCTrack);
+  reader.setTrackCacheBudget(budget);
+  for (int i = 0; i < 200; i++) {
+    int event = gRandom->Integer(NEvents);
+    int track = gRandom->Integer(nTracks(event));
+    BOOST_CHECK(isTrack(*reader.getTrack(event, track), event, track));
+    BOOST_CHECK_LE(reader.getTrackCacheSize(), budget);
+  }
+  // the event which was just used is kept even if it does not fit alone
+  reader.setTrackCacheBudget(1);
+  BOOST_CHECK_EQUAL(reader.getTracks(3).size(), nTracks(3));
+  BOOST_CHECK_EQUAL(reader.getTrackCacheSize(), nTracks(3) * sizeof(MCTrack));
+  BOOST_CHECK_EQUAL(reader.getTracks(4).size(), nTracks(4));
+  BOOST_CHECK_EQUAL(reader.getTrackCacheSize(), nTracks(4) * sizeof(MCTrack));
+  reader.releaseTracksForSourceAndEvent(0, 4);
+  BOOST_CHECK_EQUAL(reader.getTrackCacheSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReaderBulk)
+{
+  makeKinematicsFile();
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  reader.setTrackCacheBudget(nTracks(NEvents - 1) * sizeof(MCTrack));
+
+  std::vector<o2::MCCompLabel> labels;
+  for (int i = 0; i < 500; i++) {
+    int event = gRandom->Integer(NEvents);
+    labels.emplace_back(gRandom->Integer(nTracks(event)), event, 0);
+  }
+  labels.emplace_back();                    // not set
+  labels.emplace_back(nTracks(0) + 5, 0, 0); // beyond the tracks of the event
+  labels.emplace_back(0, NEvents, 0);        // beyond the events
+
+  auto tracks = reader.getTracks(labels);
+  BOOST_REQUIRE_EQUAL(tracks.size(), labels.size());
+  for (size_t i = 0; i < labels.size() - 3; i++) {
+    BOOST_CHECK(isTrack(tracks[i], labels[i].getEventID(), labels[i].getTrackID()));
+  }
+  for (size_t i = labels.size() - 3; i < labels.size(); i++) {
+    BOOST_CHECK_EQUAL(tracks[i].GetPdgCode(), MCTrack().GetPdgCode());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReaderFlatTracks)
+{
+  makeKinematicsFile();
+  const std::string flatName = Prefix + "_Kine.flat";
+  {
+    MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+    reader.getTracks(5); // loaded events are written as the others
+    BOOST_REQUIRE(reader.writeFlatTracks(0, flatName));
+  }
+
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  BOOST_CHECK(!reader.hasFlatTracks(0));
+  BOOST_CHECK(!reader.mapFlatTracks(0, o2::base::NameConf::getMCKinematicsFileName(Prefix))); // not a flat file
+  BOOST_REQUIRE(reader.mapFlatTracks(0, flatName));
+  BOOST_CHECK(reader.hasFlatTracks(0));
+  BOOST_CHECK_EQUAL(reader.getNEvents(0), NEvents);
+  for (int event = 0; event < NEvents; event++) {
+    BOOST_REQUIRE_EQUAL(reader.getTracks(event).size(), nTracks(event));
+    for (int track = 0; track < nTracks(event); track++) {
+      BOOST_CHECK(isTrack(*reader.getTrack(event, track), event, track));
+      BOOST_CHECK(isTrack(reader.getTracks(event)[track], event, track));
+    }
+  }
+
+  std::vector<o2::MCCompLabel> labels{{3, 7, 0}, {0, 1, 0}, {12, 19, 0}};
+  auto tracks = reader.getTracks(labels);
+  for (size_t i = 0; i < labels.size(); i++) {
+    BOOST_CHECK(isTrack(tracks[i], labels[i].getEventID(), labels[i].getTrackID()));
+  }
+}
+
+} // namespace steer
+} // namespace o2
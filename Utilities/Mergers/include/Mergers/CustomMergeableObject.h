@@ -17,6 +17,7 @@
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
 #include "Mergers/MergeInterface.h"
+#include <cstring>
 
 namespace o2::mergers
 {
@@ -32,6 +33,32 @@ class CustomMergeableObject : public MergeInterface
     mSecret += dynamic_cast<const CustomMergeableObject* const>(other)->getSecret();
   }
 
+  bool writeFlat(std::vector<char>& buffer) const override
+  {
+    auto offset = buffer.size();
+    buffer.resize(offset + sizeof(mSecret));
+    std::memcpy(buffer.data() + offset, &mSecret, sizeof(mSecret));
+    return true;
+  }
+
+  void readFlat(const char* data, size_t size) override
+  {
+    if (size < sizeof(mSecret)) {
+      throw std::runtime_error("Flat object is truncated");
+    }
+    std::memcpy(&mSecret, data, sizeof(mSecret));
+  }
+
+  void mergeFlat(const char* data, size_t size) override
+  {
+    int secret = 0;
+    if (size < sizeof(secret)) {
+      throw std::runtime_error("Flat object is truncated");
+    }
+    std::memcpy(&secret, data, sizeof(secret));
+    mSecret += secret;
+  }
+
   int getSecret() const { return mSecret; }
 
  private:
@@ -18,6 +18,7 @@
 
 #include <TObject.h>
 #include "Mergers/MergeInterface.h"
+#include <cstring>
 
 namespace o2::mergers
 {
@@ -38,6 +39,32 @@ class CustomMergeableTObject : public TObject, public MergeInterface
     mSecret += dynamic_cast<const CustomMergeableTObject* const>(other)->getSecret();
   }
 
+  bool writeFlat(std::vector<char>& buffer) const override
+  {
+    auto offset = buffer.size();
+    buffer.resize(offset + sizeof(mSecret));
+    std::memcpy(buffer.data() + offset, &mSecret, sizeof(mSecret));
+    return true;
+  }
+
+  void readFlat(const char* data, size_t size) override
+  {
+    if (size < sizeof(mSecret)) {
+      throw std::runtime_error("Flat object is truncated");
+    }
+    std::memcpy(&mSecret, data, sizeof(mSecret));
+  }
+
+  void mergeFlat(const char* data, size_t size) override
+  {
+    int secret = 0;
+    if (size < sizeof(secret)) {
+      throw std::runtime_error("Flat object is truncated");
+    }
+    std::memcpy(&secret, data, sizeof(secret));
+    mSecret += secret;
+  }
+
   int getSecret() const
   {
     return mSecret;
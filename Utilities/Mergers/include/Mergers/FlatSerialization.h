@@ -0,0 +1,68 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef ALICEO2_MERGERS_FLATSERIALIZATION_H
+#define ALICEO2_MERGERS_FLATSERIALIZATION_H
+
+/// \file FlatSerialization.h
+/// \brief Flat binary format of mergeable objects, which Mergers can merge without ROOT streamers.
+///
+/// Histograms (TH1, TH2 and TH3 with fixed or variable binning) are written as a short description
+/// of the binning and statistics, followed by the raw bin contents and sums of squared weights.
+/// They are merged by adding these arrays directly to the target histogram, with the same result as TH1::Merge.
+/// A delta update carries only the bins which changed w.r.t. a previous version of the same histogram,
+/// as increments. Profiles, polygon bins, alphanumeric labels and non-empty fill buffers are not supported.
+///
+/// Classes inheriting MergeInterface can take part by implementing writeFlat, readFlat and mergeFlat.
+///
+/// Flat messages are sent with gSerializationMethodNone and are recognised by a magic number at the beginning.
+
+#include "Mergers/ObjectStore.h"
+
+#include <cstddef>
+#include <vector>
+
+class TObject;
+class TH1;
+
+namespace o2::mergers::flat
+{
+
+/// \brief Writes the complete object to the buffer. Returns false (and leaves the buffer empty) if it is not supported.
+bool serialize(const TObject& object, std::vector<char>& buffer);
+/// \brief Writes the complete object to the buffer. Returns false (and leaves the buffer empty) if it is not supported.
+bool serialize(const MergeInterface& object, std::vector<char>& buffer);
+/// \brief Writes the object held by the store to the buffer. Returns false if it is empty or not supported.
+bool serialize(const ObjectStore& object, std::vector<char>& buffer);
+/// \brief Writes the bins of the current histogram which differ from the previous one, as increments.
+/// Returns false if the histograms are not supported or do not have the same type, binning and Sumw2 structure.
+bool serializeDelta(const TH1& current, const TH1& previous, std::vector<char>& buffer);
+
+/// \brief Tells if the buffer contains an object in the flat format
+bool isFlat(const char* data, size_t size);
+/// \brief Tells if the message is not ROOT-serialized and contains an object in the flat format
+bool isFlat(const framework::DataRef& ref);
+/// \brief Tells if the buffer contains a delta update
+bool isDelta(const char* data, size_t size);
+
+/// \brief Creates the object stored in the flat buffer. A delta update gives an object containing only the increments.
+ObjectStore extractObjectFrom(const char* data, size_t size);
+
+/// \brief Merges the flat buffer into the target, without creating a temporary object if the binning is the same.
+void merge(TObject* const target, const char* data, size_t size);
+void merge(MergeInterface* const target, const char* data, size_t size);
+void merge(const ObjectStore& target, const char* data, size_t size);
+/// \brief Merges the flat buffer into the complete histogram stored in the target flat buffer.
+/// Used to keep the latest version of an object up to date with delta updates.
+void merge(std::vector<char>& target, const char* data, size_t size);
+
+} // namespace o2::mergers::flat
+
+#endif //ALICEO2_MERGERS_FLATSERIALIZATION_H
@@ -21,6 +21,9 @@
 
 #include <Framework/Task.h>
 
+#include <unordered_map>
+#include <vector>
+
 namespace o2::monitoring
 {
 class Monitoring;
@@ -51,6 +54,9 @@ class FullHistoryMerger : public framework::Task
   ObjectStore mMergedObject = std::monostate{};
   std::pair<std::string, framework::DataRef> mFirstObjectSerialized;
   std::unordered_map<std::string, ObjectStore> mCache;
+  // Latest complete versions of objects received in the flat format, they are kept up to date with delta updates.
+  std::unordered_map<std::string, std::vector<char>> mFlatCache;
+  std::vector<char> mFlatBuffer; // reused for publishing in the flat format
 
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
@@ -23,6 +23,7 @@
 #include "Framework/Task.h"
 
 #include <memory>
+#include <vector>
 
 class TObject;
 
@@ -56,6 +57,7 @@ class IntegratingMerger : public framework::Task
  private:
   header::DataHeader::SubSpecificationType mSubSpec;
   ObjectStore mMergedObject = std::monostate{};
+  std::vector<char> mFlatBuffer; // reused for publishing in the flat format
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
 
@@ -17,6 +17,9 @@
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
 #include <Rtypes.h>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
 
 namespace o2::mergers
 {
@@ -35,6 +38,20 @@ class MergeInterface
   /// \brief Custom merge function. Can return a number of merged entries/bins/etc for statistics.
   virtual void merge(MergeInterface* const other) = 0; // const argument
 
+  /// \brief Optional support of the flat format (see FlatSerialization.h), which avoids ROOT streamers.
+  /// Appends the content of the object to the buffer. Returns false if the flat format is not supported.
+  virtual bool writeFlat(std::vector<char>& buffer) const { return false; }
+  /// \brief Sets the content of the object from the data written by writeFlat.
+  virtual void readFlat(const char* data, size_t size)
+  {
+    throw std::runtime_error("The object does not support the flat format");
+  }
+  /// \brief Merges the data written by writeFlat of another object into this object.
+  virtual void mergeFlat(const char* data, size_t size)
+  {
+    throw std::runtime_error("The object does not support the flat format");
+  }
+
   ClassDef(MergeInterface, 0);
 };
 
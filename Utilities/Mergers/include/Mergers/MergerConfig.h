@@ -40,6 +40,12 @@ enum class PublicationDecision {
   EachNSeconds,       // Merged object is published each N seconds.
 };
 
+enum class PublicationFormat {
+  ROOT, // Merged object is serialized with ROOT.
+  Flat  // Merged object is sent in the flat binary format if supported (see FlatSerialization.h), with ROOT otherwise.
+        // Intended for intermediate layers, the last layer always publishes ROOT-serialized objects.
+};
+
 enum class TopologySize {
   NumberOfLayers, // User specifies the number of layers in topology.
   ReductionFactor // User specifies how many sources should be handled by one merger (by maximum).
@@ -56,6 +62,7 @@ struct MergerConfig {
   ConfigEntry<InputObjectsTimespan> inputObjectTimespan = {InputObjectsTimespan::FullHistory};
   ConfigEntry<MergedObjectTimespan> mergedObjectTimespan = {MergedObjectTimespan::FullHistory};
   ConfigEntry<PublicationDecision> publicationDecision = {PublicationDecision::EachNSeconds, 10};
+  ConfigEntry<PublicationFormat> publicationFormat = {PublicationFormat::ROOT};
   ConfigEntry<TopologySize, int> topologySize = {TopologySize::NumberOfLayers, 1};
 };
 
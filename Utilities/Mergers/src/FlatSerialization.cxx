@@ -0,0 +1,830 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatSerialization.cxx
+/// \brief Implementation of the flat binary format of mergeable objects
+
+#include "Mergers/FlatSerialization.h"
+
+#include "Mergers/MergeInterface.h"
+#include "Mergers/MergerAlgorithm.h"
+
+#include "Framework/DataRef.h"
+#include "Headers/DataHeader.h"
+
+#include <TH1.h>
+#include <TAxis.h>
+#include <TClass.h>
+#include <TObject.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace o2::mergers::flat
+{
+
+namespace
+{
+
+constexpr uint32_t FlatMagic = 0x464d324f; // "O2MF"
+constexpr uint8_t FlatVersion = 1;
+
+enum class Kind : uint8_t {
+  Full, // complete object
+  Delta // increments of the bins which changed
+};
+
+enum class Type : uint8_t {
+  Histogram,
+  Custom // object inheriting MergeInterface, with its own flat content
+};
+
+struct Header {
+  uint32_t magic;
+  uint8_t version;
+  Kind kind;
+  Type type;
+  uint8_t reserved;
+};
+
+/// Layout of a histogram in a flat buffer:
+///  Header, class name, name, title, dimension,
+///  3 x (number of bins, min, max, number of variable bin edges, variable bin edges, title),
+///  storage type, has Sumw2, number of cells, entries, statistics (TH1::kNstat doubles), then
+///  Full:  contents (number of cells x storage type), Sumw2 (number of cells x double, if any)
+///  Delta: number of changed cells, indices (uint32_t), content increments (double), Sumw2 increments (double, if any)
+/// The entries and statistics of a delta update are increments as well.
+struct AxisDescription {
+  int32_t nBins = 0;
+  double min = 0.;
+  double max = 0.;
+  std::vector<double> edges{}; // empty for fixed bins
+  std::string title{};
+};
+
+struct HistogramDescription {
+  std::string className{};
+  std::string name{};
+  std::string title{};
+  int32_t dimension = 0;
+  AxisDescription axes[3];
+  char storage = 0;
+  bool hasSumw2 = false;
+  int32_t nCells = 0;
+  double entries = 0.;
+  double stats[TH1::kNstat] = {0.};
+  size_t entriesOffset = 0; // position of the entries in the buffer, followed by the statistics and the cells
+  size_t cellsOffset = 0;
+};
+
+class Writer
+{
+ public:
+  explicit Writer(std::vector<char>& buffer) : mBuffer(buffer) {}
+
+  void write(const void* data, size_t size)
+  {
+    if (size > 0) {
+      auto offset = mBuffer.size();
+      mBuffer.resize(offset + size);
+      std::memcpy(mBuffer.data() + offset, data, size);
+    }
+  }
+
+  template <typename T>
+  void write(const T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write(&value, sizeof(T));
+  }
+
+  void write(const std::string& value)
+  {
+    write(static_cast<uint32_t>(value.size()));
+    write(value.data(), value.size());
+  }
+
+ private:
+  std::vector<char>& mBuffer;
+};
+
+class Reader
+{
+ public:
+  Reader(const char* data, size_t size) : mData(data), mSize(size) {}
+
+  const char* read(size_t size)
+  {
+    if (size > mSize - mPosition) {
+      throw std::runtime_error("Flat object is truncated");
+    }
+    auto data = mData + mPosition;
+    mPosition += size;
+    return data;
+  }
+
+  template <typename T>
+  T read()
+  {
+    T value;
+    std::memcpy(&value, read(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::string readString()
+  {
+    auto length = read<uint32_t>();
+    return std::string(read(length), length);
+  }
+
+  size_t position() const { return mPosition; }
+  size_t remaining() const { return mSize - mPosition; }
+
+ private:
+  const char* mData;
+  size_t mSize;
+  size_t mPosition = 0;
+};
+
+template <typename T>
+T load(const char* data, size_t index)
+{
+  T value;
+  std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <typename T>
+void store(char* data, size_t index, T value)
+{
+  std::memcpy(data + index * sizeof(T), &value, sizeof(T));
+}
+
+size_t storageSize(char storage)
+{
+  switch (storage) {
+    case 'D':
+      return sizeof(Double_t);
+    case 'F':
+      return sizeof(Float_t);
+    case 'I':
+      return sizeof(Int_t);
+    case 'S':
+      return sizeof(Short_t);
+    case 'C':
+      return sizeof(Char_t);
+    default:
+      throw std::runtime_error(std::string("Unknown storage type of flat histogram: ") + storage);
+  }
+}
+
+/// calls f with a typed pointer to the cells of the storage type
+template <typename F>
+void visitStorage(char storage, const char* cells, F&& f)
+{
+  switch (storage) {
+    case 'D':
+      return f(reinterpret_cast<const Double_t*>(cells));
+    case 'F':
+      return f(reinterpret_cast<const Float_t*>(cells));
+    case 'I':
+      return f(reinterpret_cast<const Int_t*>(cells));
+    case 'S':
+      return f(reinterpret_cast<const Short_t*>(cells));
+    case 'C':
+      return f(reinterpret_cast<const Char_t*>(cells));
+    default:
+      throw std::runtime_error(std::string("Unknown storage type of flat histogram: ") + storage);
+  }
+}
+
+char storageType(const TH1& histo)
+{
+  if (dynamic_cast<const TArrayD*>(&histo)) {
+    return 'D';
+  } else if (dynamic_cast<const TArrayF*>(&histo)) {
+    return 'F';
+  } else if (dynamic_cast<const TArrayI*>(&histo)) {
+    return 'I';
+  } else if (dynamic_cast<const TArrayS*>(&histo)) {
+    return 'S';
+  } else if (dynamic_cast<const TArrayC*>(&histo)) {
+    return 'C';
+  }
+  return 0;
+}
+
+const char* cellArray(const TH1& histo)
+{
+  if (auto array = dynamic_cast<const TArrayD*>(&histo)) {
+    return reinterpret_cast<const char*>(array->GetArray());
+  } else if (auto array = dynamic_cast<const TArrayF*>(&histo)) {
+    return reinterpret_cast<const char*>(array->GetArray());
+  } else if (auto array = dynamic_cast<const TArrayI*>(&histo)) {
+    return reinterpret_cast<const char*>(array->GetArray());
+  } else if (auto array = dynamic_cast<const TArrayS*>(&histo)) {
+    return reinterpret_cast<const char*>(array->GetArray());
+  } else if (auto array = dynamic_cast<const TArrayC*>(&histo)) {
+    return reinterpret_cast<const char*>(array->GetArray());
+  }
+  return nullptr;
+}
+
+const TAxis* axis(const TH1& histo, int i)
+{
+  return i == 0 ? histo.GetXaxis() : (i == 1 ? histo.GetYaxis() : histo.GetZaxis());
+}
+
+TAxis* axis(TH1& histo, int i)
+{
+  return i == 0 ? histo.GetXaxis() : (i == 1 ? histo.GetYaxis() : histo.GetZaxis());
+}
+
+bool isSupportedHistogram(const TH1& histo)
+{
+  // profiles and polygon bins need more than the bin contents and Sumw2 to be merged,
+  // while labels and buffers make TH1::Merge take another path
+  if (storageType(histo) == 0 || histo.InheritsFrom("TProfile") || histo.InheritsFrom("TProfile2D") ||
+      histo.InheritsFrom("TProfile3D") || histo.InheritsFrom("TH2Poly") || histo.GetBufferLength() > 0) {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (axis(histo, i)->GetLabels() != nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameBinning(const TAxis& axis, const AxisDescription& description)
+{
+  const TArrayD* edges = axis.GetXbins();
+  if (axis.GetNbins() != description.nBins || static_cast<size_t>(edges->GetSize()) != description.edges.size()) {
+    return false;
+  }
+  if (edges->GetSize() > 0) {
+    return std::equal(description.edges.begin(), description.edges.end(), edges->GetArray());
+  }
+  return axis.GetXmin() == description.min && axis.GetXmax() == description.max;
+}
+
+bool sameBinning(const TH1& histo, const HistogramDescription& description)
+{
+  if (histo.GetDimension() != description.dimension || histo.GetNcells() != description.nCells) {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (!sameBinning(*axis(histo, i), description.axes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameBinning(const HistogramDescription& first, const HistogramDescription& second)
+{
+  if (first.dimension != second.dimension || first.nCells != second.nCells) {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i) {
+    const auto& a = first.axes[i];
+    const auto& b = second.axes[i];
+    if (a.nBins != b.nBins || a.edges != b.edges || (a.edges.empty() && (a.min != b.min || a.max != b.max))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Header readHeader(Reader& reader)
+{
+  auto header = reader.read<Header>();
+  if (header.magic != FlatMagic) {
+    throw std::runtime_error("The buffer does not contain a flat object");
+  }
+  if (header.version != FlatVersion) {
+    throw std::runtime_error("Unsupported version of flat object: " + std::to_string(header.version));
+  }
+  return header;
+}
+
+void writeDescription(Writer& writer, const TH1& histo, double entries, const double stats[TH1::kNstat])
+{
+  writer.write(std::string(histo.ClassName()));
+  writer.write(std::string(histo.GetName()));
+  writer.write(std::string(histo.GetTitle()));
+  writer.write<int32_t>(histo.GetDimension());
+  for (int i = 0; i < 3; ++i) {
+    const TAxis* histoAxis = axis(histo, i);
+    const TArrayD* edges = histoAxis->GetXbins();
+    writer.write<int32_t>(histoAxis->GetNbins());
+    writer.write<double>(histoAxis->GetXmin());
+    writer.write<double>(histoAxis->GetXmax());
+    writer.write<int32_t>(edges->GetSize());
+    writer.write(edges->GetArray(), edges->GetSize() * sizeof(double));
+    writer.write(std::string(histoAxis->GetTitle()));
+  }
+  writer.write<char>(storageType(histo));
+  writer.write<uint8_t>(histo.GetSumw2N() > 0);
+  writer.write<int32_t>(histo.GetNcells());
+  writer.write<double>(entries);
+  writer.write(stats, TH1::kNstat * sizeof(double));
+}
+
+HistogramDescription readDescription(Reader& reader)
+{
+  HistogramDescription description;
+  description.className = reader.readString();
+  description.name = reader.readString();
+  description.title = reader.readString();
+  description.dimension = reader.read<int32_t>();
+  for (auto& axis : description.axes) {
+    axis.nBins = reader.read<int32_t>();
+    axis.min = reader.read<double>();
+    axis.max = reader.read<double>();
+    auto nEdges = reader.read<int32_t>();
+    if (nEdges < 0) {
+      throw std::runtime_error("Flat histogram has a negative number of bin edges");
+    }
+    axis.edges.resize(nEdges);
+    std::memcpy(axis.edges.data(), reader.read(nEdges * sizeof(double)), nEdges * sizeof(double));
+    axis.title = reader.readString();
+  }
+  description.storage = reader.read<char>();
+  storageSize(description.storage); // check the storage type
+  description.hasSumw2 = reader.read<uint8_t>();
+  description.nCells = reader.read<int32_t>();
+  if (description.nCells < 0) {
+    throw std::runtime_error("Flat histogram has a negative number of cells");
+  }
+  description.entriesOffset = reader.position();
+  description.entries = reader.read<double>();
+  std::memcpy(description.stats, reader.read(TH1::kNstat * sizeof(double)), TH1::kNstat * sizeof(double));
+  description.cellsOffset = reader.position();
+  return description;
+}
+
+/// cells (and Sumw2) to be added, either all of them in their storage type or only those which changed as double increments
+struct Cells {
+  char storage = 0;
+  size_t size = 0;
+  const char* indices = nullptr; // nullptr if all the cells are given
+  const char* contents = nullptr;
+  const char* sumw2 = nullptr; // nullptr if no Sumw2
+
+  size_t index(size_t i) const { return indices == nullptr ? i : load<uint32_t>(indices, i); }
+};
+
+Cells readCells(Reader& reader, const HistogramDescription& description, Kind kind)
+{
+  Cells cells;
+  if (kind == Kind::Full) {
+    cells.storage = description.storage;
+    cells.size = description.nCells;
+  } else {
+    cells.storage = 'D';
+    cells.size = reader.read<uint32_t>();
+    cells.indices = reader.read(cells.size * sizeof(uint32_t));
+    for (size_t i = 0; i < cells.size; ++i) {
+      if (cells.index(i) >= static_cast<size_t>(description.nCells)) {
+        throw std::runtime_error("Flat histogram delta refers to a cell out of range");
+      }
+    }
+  }
+  cells.contents = reader.read(cells.size * storageSize(cells.storage));
+  if (description.hasSumw2) {
+    cells.sumw2 = reader.read(cells.size * sizeof(double));
+  }
+  return cells;
+}
+
+/// adds the cells to the contents of the histogram, as TH1::AddBinContent
+template <typename Src>
+void addContents(TH1& target, const Src* source, const Cells& cells)
+{
+  auto contents = reinterpret_cast<const char*>(source);
+  if (auto array = dynamic_cast<TArrayD*>(&target)) {
+    auto targetCells = array->GetArray();
+    if (cells.indices == nullptr) {
+      for (size_t i = 0; i < cells.size; ++i) {
+        targetCells[i] += load<Src>(contents, i);
+      }
+    } else {
+      for (size_t i = 0; i < cells.size; ++i) {
+        targetCells[cells.index(i)] += load<Src>(contents, i);
+      }
+    }
+  } else if (auto array = dynamic_cast<TArrayF*>(&target)) {
+    auto targetCells = array->GetArray();
+    if (cells.indices == nullptr) {
+      for (size_t i = 0; i < cells.size; ++i) {
+        targetCells[i] += static_cast<Float_t>(static_cast<Double_t>(load<Src>(contents, i)));
+      }
+    } else {
+      for (size_t i = 0; i < cells.size; ++i) {
+        targetCells[cells.index(i)] += static_cast<Float_t>(static_cast<Double_t>(load<Src>(contents, i)));
+      }
+    }
+  } else {
+    // integer storage saturates
+    for (size_t i = 0; i < cells.size; ++i) {
+      target.AddBinContent(static_cast<Int_t>(cells.index(i)), load<Src>(contents, i));
+    }
+  }
+}
+
+/// adds the cells to the Sumw2 of the histogram (if any), using the contents if the cells have no Sumw2
+template <typename Src>
+void addSumw2(TH1& target, const Src* source, const Cells& cells)
+{
+  if (target.GetSumw2N() == 0) {
+    return;
+  }
+  auto targetSumw2 = target.GetSumw2()->GetArray();
+  auto contents = reinterpret_cast<const char*>(source);
+  for (size_t i = 0; i < cells.size; ++i) {
+    targetSumw2[cells.index(i)] += cells.sumw2 ? load<double>(cells.sumw2, i) : static_cast<double>(load<Src>(contents, i));
+  }
+}
+
+/// adds the histogram stored in the reader to the target, which must have the same binning
+void addHistogram(TH1& target, Reader& reader, const HistogramDescription& description, Kind kind)
+{
+  auto cells = readCells(reader, description, kind);
+
+  // as TH1::Merge, skip empty histograms
+  if (kind == Kind::Full && description.stats[0] == 0. && description.entries == 0.) {
+    return;
+  }
+
+  if (description.hasSumw2 && target.GetSumw2N() == 0) {
+    target.Sumw2();
+  }
+
+  // the statistics must be read before adding the contents, as they may be computed from them
+  double stats[TH1::kNstat] = {0.};
+  target.GetStats(stats);
+  double entries = target.GetEntries();
+
+  visitStorage(cells.storage, cells.contents, [&](auto source) {
+    addContents(target, source, cells);
+    addSumw2(target, source, cells);
+  });
+
+  for (int i = 0; i < TH1::kNstat; ++i) {
+    stats[i] += description.stats[i];
+  }
+  target.PutStats(stats);
+  target.SetEntries(entries + description.entries);
+}
+
+std::unique_ptr<TH1> createHistogram(const HistogramDescription& description)
+{
+  TClass* histoClass = TClass::GetClass(description.className.c_str());
+  if (histoClass == nullptr || !histoClass->InheritsFrom(TH1::Class())) {
+    throw std::runtime_error("Flat object has an unknown histogram class '" + description.className + "'");
+  }
+  std::unique_ptr<TH1> histo(static_cast<TH1*>(histoClass->DynamicCast(TH1::Class(), histoClass->New())));
+  histo->SetDirectory(nullptr);
+  histo->SetName(description.name.c_str());
+  histo->SetTitle(description.title.c_str());
+  for (int i = 0; i < 3; ++i) {
+    const auto& axisDescription = description.axes[i];
+    auto histoAxis = axis(*histo, i);
+    if (axisDescription.edges.empty()) {
+      histoAxis->Set(axisDescription.nBins, axisDescription.min, axisDescription.max);
+    } else {
+      histoAxis->Set(axisDescription.nBins, axisDescription.edges.data());
+    }
+    histoAxis->SetTitle(axisDescription.title.c_str());
+  }
+  histo->SetBinsLength(description.nCells);
+  if (histo->GetSumw2N() > 0) {
+    histo->GetSumw2()->Set(description.nCells);
+  }
+  if (description.hasSumw2 && histo->GetSumw2N() == 0) {
+    histo->Sumw2();
+  }
+  return histo;
+}
+
+void mergeHistogram(TH1& target, Reader& reader, const HistogramDescription& description, Kind kind)
+{
+  if (isSupportedHistogram(target) && sameBinning(target, description)) {
+    addHistogram(target, reader, description, kind);
+  } else {
+    // the binning differs, let ROOT take care of it
+    auto other = createHistogram(description);
+    addHistogram(*other, reader, description, kind);
+    algorithm::merge(&target, other.get());
+  }
+}
+
+/// adds value to the cell, saturating integer storage as TH1::AddBinContent does
+template <typename Dst>
+Dst addToCell(Dst cell, double value)
+{
+  if constexpr (std::is_floating_point_v<Dst>) {
+    return cell + static_cast<Dst>(value);
+  } else {
+    constexpr auto max = static_cast<long long>(std::numeric_limits<Dst>::max());
+    auto sum = static_cast<long long>(cell) + static_cast<long long>(value);
+    return static_cast<Dst>(std::clamp(sum, -max, max));
+  }
+}
+
+/// adds the histogram stored in the reader to the complete flat histogram of the same binning and structure
+void addFlatHistogram(std::vector<char>& target, const HistogramDescription& targetDescription,
+                      Reader& reader, const HistogramDescription& description, Kind kind)
+{
+  auto cells = readCells(reader, description, kind);
+  if (kind == Kind::Full && description.stats[0] == 0. && description.entries == 0.) {
+    return;
+  }
+
+  char* targetCells = target.data() + targetDescription.cellsOffset;
+  char* targetSumw2 = targetDescription.hasSumw2 ? targetCells + targetDescription.nCells * storageSize(targetDescription.storage) : nullptr;
+  visitStorage(targetDescription.storage, targetCells, [&](auto typedTargetCells) {
+    using Dst = std::remove_const_t<std::remove_pointer_t<decltype(typedTargetCells)>>;
+    visitStorage(cells.storage, cells.contents, [&](auto source) {
+      using Src = std::remove_const_t<std::remove_pointer_t<decltype(source)>>;
+      for (size_t i = 0; i < cells.size; ++i) {
+        auto index = cells.index(i);
+        double value = load<Src>(cells.contents, i);
+        store<Dst>(targetCells, index, addToCell(load<Dst>(targetCells, index), value));
+        if (targetSumw2 != nullptr) {
+          store<double>(targetSumw2, index, load<double>(targetSumw2, index) + (cells.sumw2 ? load<double>(cells.sumw2, i) : value));
+        }
+      }
+    });
+  });
+
+  char* entries = target.data() + targetDescription.entriesOffset;
+  store<double>(entries, 0, load<double>(entries, 0) + description.entries);
+  char* stats = entries + sizeof(double);
+  for (int i = 0; i < TH1::kNstat; ++i) {
+    store<double>(stats, i, load<double>(stats, i) + description.stats[i]);
+  }
+}
+
+} // namespace
+
+bool serialize(const TObject& object, std::vector<char>& buffer)
+{
+  if (auto custom = dynamic_cast<const MergeInterface*>(&object)) {
+    return serialize(*custom, buffer);
+  }
+
+  buffer.clear();
+  auto histo = dynamic_cast<const TH1*>(&object);
+  if (histo == nullptr || !isSupportedHistogram(*histo)) {
+    return false;
+  }
+
+  Writer writer(buffer);
+  writer.write(Header{FlatMagic, FlatVersion, Kind::Full, Type::Histogram, 0});
+  double stats[TH1::kNstat] = {0.};
+  histo->GetStats(stats);
+  writeDescription(writer, *histo, histo->GetEntries(), stats);
+  writer.write(cellArray(*histo), histo->GetNcells() * storageSize(storageType(*histo)));
+  if (histo->GetSumw2N() > 0) {
+    writer.write(histo->GetSumw2()->GetArray(), histo->GetNcells() * sizeof(double));
+  }
+  return true;
+}
+
+bool serialize(const MergeInterface& object, std::vector<char>& buffer)
+{
+  buffer.clear();
+  TClass* objectClass = TClass::GetClass(typeid(object));
+  if (objectClass == nullptr) {
+    return false;
+  }
+  Writer writer(buffer);
+  writer.write(Header{FlatMagic, FlatVersion, Kind::Full, Type::Custom, 0});
+  writer.write(std::string(objectClass->GetName()));
+  if (!object.writeFlat(buffer)) {
+    buffer.clear();
+    return false;
+  }
+  return true;
+}
+
+bool serialize(const ObjectStore& object, std::vector<char>& buffer)
+{
+  if (std::holds_alternative<TObjectPtr>(object)) {
+    return serialize(*std::get<TObjectPtr>(object), buffer);
+  } else if (std::holds_alternative<MergeInterfacePtr>(object)) {
+    return serialize(*std::get<MergeInterfacePtr>(object), buffer);
+  }
+  buffer.clear();
+  return false;
+}
+
+bool serializeDelta(const TH1& current, const TH1& previous, std::vector<char>& buffer)
+{
+  buffer.clear();
+  if (!isSupportedHistogram(current) || !isSupportedHistogram(previous) || current.IsA() != previous.IsA() ||
+      current.GetSumw2N() != previous.GetSumw2N()) {
+    return false;
+  }
+  HistogramDescription previousBinning;
+  previousBinning.dimension = previous.GetDimension();
+  previousBinning.nCells = previous.GetNcells();
+  for (int i = 0; i < 3; ++i) {
+    const TAxis* previousAxis = axis(previous, i);
+    previousBinning.axes[i].nBins = previousAxis->GetNbins();
+    previousBinning.axes[i].min = previousAxis->GetXmin();
+    previousBinning.axes[i].max = previousAxis->GetXmax();
+    const TArrayD* edges = previousAxis->GetXbins();
+    previousBinning.axes[i].edges.assign(edges->GetArray(), edges->GetArray() + edges->GetSize());
+  }
+  if (!sameBinning(current, previousBinning)) {
+    return false;
+  }
+
+  // find the cells which changed
+  const size_t nCells = current.GetNcells();
+  const bool hasSumw2 = current.GetSumw2N() > 0;
+  std::vector<uint32_t> indices{};
+  std::vector<double> contents{};
+  std::vector<double> sumw2{};
+  visitStorage(storageType(current), cellArray(current), [&](auto currentCells) {
+    auto previousCells = reinterpret_cast<decltype(currentCells)>(cellArray(previous));
+    const double* currentSumw2 = hasSumw2 ? current.GetSumw2()->GetArray() : nullptr;
+    const double* previousSumw2 = hasSumw2 ? previous.GetSumw2()->GetArray() : nullptr;
+    for (size_t i = 0; i < nCells; ++i) {
+      if (currentCells[i] != previousCells[i] || (hasSumw2 && currentSumw2[i] != previousSumw2[i])) {
+        indices.push_back(i);
+        contents.push_back(static_cast<double>(currentCells[i]) - static_cast<double>(previousCells[i]));
+        if (hasSumw2) {
+          sumw2.push_back(currentSumw2[i] - previousSumw2[i]);
+        }
+      }
+    }
+  });
+
+  double stats[TH1::kNstat] = {0.};
+  double previousStats[TH1::kNstat] = {0.};
+  current.GetStats(stats);
+  previous.GetStats(previousStats);
+  for (int i = 0; i < TH1::kNstat; ++i) {
+    stats[i] -= previousStats[i];
+  }
+
+  Writer writer(buffer);
+  writer.write(Header{FlatMagic, FlatVersion, Kind::Delta, Type::Histogram, 0});
+  writeDescription(writer, current, current.GetEntries() - previous.GetEntries(), stats);
+  writer.write<uint32_t>(indices.size());
+  writer.write(indices.data(), indices.size() * sizeof(uint32_t));
+  writer.write(contents.data(), contents.size() * sizeof(double));
+  writer.write(sumw2.data(), sumw2.size() * sizeof(double));
+  return true;
+}
+
+bool isFlat(const char* data, size_t size)
+{
+  uint32_t magic = 0;
+  if (data == nullptr || size < sizeof(Header)) {
+    return false;
+  }
+  std::memcpy(&magic, data, sizeof(magic));
+  return magic == FlatMagic;
+}
+
+bool isFlat(const framework::DataRef& ref)
+{
+  auto header = o2::header::get<const o2::header::DataHeader*>(ref.header);
+  return header != nullptr && header->payloadSerializationMethod == o2::header::gSerializationMethodNone &&
+         isFlat(ref.payload, header->payloadSize);
+}
+
+bool isDelta(const char* data, size_t size)
+{
+  if (!isFlat(data, size)) {
+    return false;
+  }
+  Reader reader(data, size);
+  return readHeader(reader).kind == Kind::Delta;
+}
+
+ObjectStore extractObjectFrom(const char* data, size_t size)
+{
+  Reader reader(data, size);
+  auto header = readHeader(reader);
+
+  if (header.type == Type::Histogram) {
+    auto description = readDescription(reader);
+    auto histo = createHistogram(description);
+    addHistogram(*histo, reader, description, header.kind);
+    return TObjectPtr(histo.release(), algorithm::deleteTCollections);
+  }
+
+  auto className = reader.readString();
+  TClass* objectClass = TClass::GetClass(className.c_str());
+  TClass* mergeInterfaceClass = TClass::GetClass(typeid(MergeInterface));
+  if (objectClass == nullptr || !objectClass->InheritsFrom(mergeInterfaceClass)) {
+    throw std::runtime_error("Flat object has an unknown class '" + className + "' or it does not inherit from MergeInterface");
+  }
+  void* object = objectClass->New();
+  auto custom = static_cast<MergeInterface*>(objectClass->DynamicCast(mergeInterfaceClass, object));
+  ObjectStore store;
+  if (objectClass->InheritsFrom(TObject::Class())) {
+    store = TObjectPtr(static_cast<TObject*>(objectClass->DynamicCast(TObject::Class(), object)), algorithm::deleteTCollections);
+  } else {
+    store = MergeInterfacePtr(custom);
+  }
+  custom->readFlat(data + reader.position(), reader.remaining());
+  return store;
+}
+
+void merge(TObject* const target, const char* data, size_t size)
+{
+  if (target == nullptr) {
+    throw std::runtime_error("Merging target is nullptr");
+  }
+  Reader reader(data, size);
+  auto header = readHeader(reader);
+
+  if (header.type == Type::Custom) {
+    auto custom = dynamic_cast<MergeInterface*>(target);
+    if (custom == nullptr) {
+      throw std::runtime_error(std::string("The target object '") + target->GetName() + "' does not inherit from MergeInterface");
+    }
+    reader.readString(); // class name
+    custom->mergeFlat(data + reader.position(), reader.remaining());
+    return;
+  }
+
+  auto histo = dynamic_cast<TH1*>(target);
+  if (histo == nullptr) {
+    throw std::runtime_error(std::string("The target object '") + target->GetName() + "' is not a histogram, while the other object is");
+  }
+  auto description = readDescription(reader);
+  mergeHistogram(*histo, reader, description, header.kind);
+}
+
+void merge(MergeInterface* const target, const char* data, size_t size)
+{
+  if (target == nullptr) {
+    throw std::runtime_error("Merging target is nullptr");
+  }
+  if (auto object = dynamic_cast<TObject*>(target)) {
+    merge(object, data, size);
+    return;
+  }
+  Reader reader(data, size);
+  if (readHeader(reader).type != Type::Custom) {
+    throw std::runtime_error("The target object does not inherit from TObject, while the other object is a histogram");
+  }
+  reader.readString(); // class name
+  target->mergeFlat(data + reader.position(), reader.remaining());
+}
+
+void merge(const ObjectStore& target, const char* data, size_t size)
+{
+  if (std::holds_alternative<TObjectPtr>(target)) {
+    merge(std::get<TObjectPtr>(target).get(), data, size);
+  } else if (std::holds_alternative<MergeInterfacePtr>(target)) {
+    merge(std::get<MergeInterfacePtr>(target).get(), data, size);
+  } else {
+    throw std::runtime_error("Merging target is empty");
+  }
+}
+
+void merge(std::vector<char>& target, const char* data, size_t size)
+{
+  Reader targetReader(target.data(), target.size());
+  auto targetHeader = readHeader(targetReader);
+  Reader reader(data, size);
+  auto header = readHeader(reader);
+  if (targetHeader.type != Type::Histogram || targetHeader.kind != Kind::Full || header.type != Type::Histogram) {
+    throw std::runtime_error("Only histograms can be merged into a flat buffer");
+  }
+  auto targetDescription = readDescription(targetReader);
+  auto description = readDescription(reader);
+
+  if (sameBinning(targetDescription, description) && (targetDescription.hasSumw2 || !description.hasSumw2)) {
+    addFlatHistogram(target, targetDescription, reader, description, header.kind);
+  } else {
+    // the buffer cannot be updated in place, merge the histograms and write the result again
+    auto histo = createHistogram(targetDescription);
+    addHistogram(*histo, targetReader, targetDescription, Kind::Full);
+    mergeHistogram(*histo, reader, description, header.kind);
+    serialize(*histo, target);
+  }
+}
+
+} // namespace o2::mergers::flat
@@ -14,6 +14,7 @@
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
 #include "Mergers/FullHistoryMerger.h"
+#include "Mergers/FlatSerialization.h"
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerBuilder.h"
 #include "Mergers/MergeInterface.h"
@@ -23,6 +24,8 @@
 #include "Framework/Logger.h"
 #include <Monitoring/MonitoringFactory.h>
 
+#include <algorithm>
+
 using namespace o2::header;
 using namespace o2::framework;
 using namespace std::chrono;
@@ -60,7 +63,7 @@ void FullHistoryMerger::run(framework::ProcessingContext& ctx)
     }
   }
 
-  if (ctx.inputs().isValid("timer-publish") && !mFirstObjectSerialized.first.empty()) {
+  if (ctx.inputs().isValid("timer-publish") && (!mFirstObjectSerialized.first.empty() || !mFlatCache.empty())) {
     mergeCache();
     publish(ctx.outputs());
   }
@@ -71,6 +74,22 @@ void FullHistoryMerger::updateCache(const DataRef& ref)
   auto* dh = get<DataHeader*>(ref.header);
   std::string sourceID = std::string(dh->dataOrigin.str) + "/" + std::string(dh->dataDescription.str) + "/" + std::to_string(dh->subSpecification);
 
+  if (flat::isFlat(ref)) {
+    // Flat objects are cached as they are, delta updates are applied to the latest complete version.
+    auto size = DataRefUtils::getPayloadSize(ref);
+    if (flat::isDelta(ref.payload, size)) {
+      auto cached = mFlatCache.find(sourceID);
+      if (cached == mFlatCache.end()) {
+        LOG(WARNING) << "Received a delta update from '" << sourceID << "' before a complete object, it is ignored.";
+        return;
+      }
+      flat::merge(cached->second, ref.payload, size);
+    } else {
+      mFlatCache[sourceID].assign(ref.payload, ref.payload + size);
+    }
+    return;
+  }
+
   // I am not sure if ref.spec is always a concrete spec and not a broader matcher. Comparing it this way should be safer.
   if (mFirstObjectSerialized.first.empty() || mFirstObjectSerialized.first == sourceID) {
 
@@ -96,12 +115,24 @@ void FullHistoryMerger::updateCache(const DataRef& ref)
 
 void FullHistoryMerger::mergeCache()
 {
-  LOG(INFO) << "Merging " << mCache.size() + 1 << " objects.";
+  LOG(INFO) << "Merging " << mCache.size() + mFlatCache.size() + !mFirstObjectSerialized.first.empty() << " objects.";
 
-  mMergedObject = object_store_helpers::extractObjectFrom(mFirstObjectSerialized.second);
+  auto flatEntry = mFlatCache.begin();
+  if (!mFirstObjectSerialized.first.empty()) {
+    mMergedObject = object_store_helpers::extractObjectFrom(mFirstObjectSerialized.second);
+  } else {
+    mMergedObject = flat::extractObjectFrom(flatEntry->second.data(), flatEntry->second.size());
+    ++flatEntry;
+  }
   assert(!std::holds_alternative<std::monostate>(mMergedObject));
   mObjectsMerged++;
 
+  // Flat objects are added directly to the merged object, without creating temporary ones.
+  for (; flatEntry != mFlatCache.end(); ++flatEntry) {
+    flat::merge(mMergedObject, flatEntry->second.data(), flatEntry->second.size());
+    mObjectsMerged++;
+  }
+
   // We expect that all the objects use the same kind of interface
   if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
 
@@ -129,6 +160,9 @@ void FullHistoryMerger::publish(framework::DataAllocator& allocator)
   // todo see if std::visit is faster here
   if (std::holds_alternative<std::monostate>(mMergedObject)) {
     LOG(INFO) << "Nothing to publish yet";
+  } else if (mConfig.publicationFormat.value == PublicationFormat::Flat && flat::serialize(mMergedObject, mFlatBuffer)) {
+    auto output = allocator.make<char>(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, mFlatBuffer.size());
+    std::copy(mFlatBuffer.begin(), mFlatBuffer.end(), output.begin());
   } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
     allocator.snapshot(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec},
                        *std::get<MergeInterfacePtr>(mMergedObject));
@@ -15,6 +15,7 @@
 
 #include "Mergers/IntegratingMerger.h"
 
+#include "Mergers/FlatSerialization.h"
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerBuilder.h"
 
@@ -22,6 +23,8 @@
 
 #include "Framework/InputRecordWalker.h"
 #include "Framework/Logger.h"
+
+#include <algorithm>
 //#include "Framework/DataRef.h"
 
 //using namespace o2;
@@ -53,6 +56,10 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
       if (std::holds_alternative<std::monostate>(mMergedObject)) {
         mMergedObject = object_store_helpers::extractObjectFrom(ref);
 
+      } else if (flat::isFlat(ref)) {
+        // Flat objects are added directly to the merged object, without creating a temporary one.
+        flat::merge(mMergedObject, ref.payload, framework::DataRefUtils::getPayloadSize(ref));
+
       } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
         // We expect that if the first object was TObject, then all should.
         auto other = TObjectPtr(framework::DataRefUtils::as<TObject>(ref).release(), algorithm::deleteTCollections);
@@ -84,6 +91,9 @@ void IntegratingMerger::publish(framework::DataAllocator& allocator)
 {
   if (std::holds_alternative<std::monostate>(mMergedObject)) {
     LOG(INFO) << "Nothing to publish yet";
+  } else if (mConfig.publicationFormat.value == PublicationFormat::Flat && flat::serialize(mMergedObject, mFlatBuffer)) {
+    auto output = allocator.make<char>(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, mFlatBuffer.size());
+    std::copy(mFlatBuffer.begin(), mFlatBuffer.end(), output.begin());
   } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
     allocator.snapshot(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec},
                        *std::get<MergeInterfacePtr>(mMergedObject));
@@ -125,6 +125,9 @@ framework::WorkflowSpec MergerInfrastructureBuilder::generateInfrastructure()
         assert(layer == mergersPerLayer.size() - 1);
         // the last layer => use the specified external OutputSpec
         mergerBuilder.setOutputSpec(mOutputSpec);
+        // and publish objects which the consumers can read
+        layerConfig.publicationFormat = {PublicationFormat::ROOT};
+        mergerBuilder.setConfig(layerConfig);
       }
 
       auto merger = mergerBuilder.buildSpec();
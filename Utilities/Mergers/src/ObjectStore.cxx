@@ -16,6 +16,7 @@
 #include "Mergers/ObjectStore.h"
 #include "Framework/DataRefUtils.h"
 #include "Mergers/MergeInterface.h"
+#include "Mergers/FlatSerialization.h"
 #include "Mergers/MergerAlgorithm.h"
 #include <TObject.h>
 
@@ -37,8 +38,11 @@ ObjectStore extractObjectFrom(const framework::DataRef& ref)
 
   using DataHeader = o2::header::DataHeader;
   auto header = o2::header::get<const DataHeader*>(ref.header);
+  if (flat::isFlat(ref)) {
+    return flat::extractObjectFrom(ref.payload, header->payloadSize);
+  }
   if (header->payloadSerializationMethod != o2::header::gSerializationMethodROOT) {
-    throw std::runtime_error(errorPrefix + "It is not ROOT-serialized");
+    throw std::runtime_error(errorPrefix + "It is neither ROOT-serialized nor in the flat format");
   }
 
   o2::framework::FairTMessage ftm(const_cast<char*>(ref.payload), header->payloadSize);
@@ -0,0 +1,121 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmark_FlatMerging.cxx
+/// \brief Benchmark of merging many serialized histograms with ROOT and in the flat format
+
+#include <benchmark/benchmark.h>
+
+#include "Mergers/FlatSerialization.h"
+#include "Mergers/MergerAlgorithm.h"
+#include "Framework/TMessageSerializer.h"
+
+#include <TH2.h>
+#include <TMessage.h>
+#include <TRandom3.h>
+
+#include <memory>
+#include <vector>
+
+using namespace o2::mergers;
+
+const size_t bins = 250; // 250 bins * 250 bins * 4B makes 250kB
+const size_t entriesInFull = 5000;
+const size_t entriesInDiff = 50;
+
+std::unique_ptr<TH2F> createHistogram(size_t index, size_t entries)
+{
+  auto histo = std::make_unique<TH2F>(("test" + std::to_string(index)).c_str(), "test", bins, 0, 1000000, bins, 0, 1000000);
+  histo->SetDirectory(nullptr);
+  TRandom3 random(index + 1);
+  for (size_t i = 0; i < entries; i++) {
+    histo->Fill(random.Uniform(0, 1000000), random.Uniform(0, 1000000));
+  }
+  return histo;
+}
+
+// the inputs as they arrive to a Merger: ROOT-serialized (Arg(1) = 0), flat (1) or flat deltas (2)
+std::vector<std::vector<char>> createInputs(size_t nInputs, int format)
+{
+  std::vector<std::vector<char>> inputs(nInputs);
+  for (size_t i = 0; i < nInputs; i++) {
+    auto histo = createHistogram(i, entriesInFull);
+    if (format == 0) {
+      TMessage message(kMESS_OBJECT);
+      message.WriteObject(histo.get());
+      inputs[i].assign(message.Buffer(), message.Buffer() + message.Length());
+    } else if (format == 1) {
+      flat::serialize(*histo, inputs[i]);
+    } else {
+      std::unique_ptr<TH2F> current(dynamic_cast<TH2F*>(histo->Clone()));
+      TRandom3 random(nInputs + i + 1);
+      for (size_t e = 0; e < entriesInDiff; e++) {
+        current->Fill(random.Uniform(0, 1000000), random.Uniform(0, 1000000));
+      }
+      flat::serializeDelta(*current, *histo, inputs[i]);
+    }
+  }
+  return inputs;
+}
+
+static void BM_MergingSerializedTH2F(benchmark::State& state)
+{
+  const size_t nInputs = state.range(0);
+  const int format = state.range(1);
+  auto inputs = createInputs(nInputs, format);
+
+  auto target = createHistogram(nInputs, entriesInFull);
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (auto& input : inputs) {
+      if (format == 0) {
+        o2::framework::FairTMessage ftm(input.data(), input.size());
+        auto other = std::unique_ptr<TObject>(static_cast<TObject*>(ftm.ReadObjectAny(ftm.GetClass())));
+        algorithm::merge(target.get(), other.get());
+      } else {
+        flat::merge(target.get(), input.data(), input.size());
+      }
+      bytes += input.size();
+    }
+  }
+  benchmark::DoNotOptimize(target->GetEntries());
+  state.SetBytesProcessed(bytes);
+  state.SetItemsProcessed(state.iterations() * nInputs);
+  state.counters["bytesPerInput"] = inputs.front().size();
+}
+
+// keeping the latest versions of the inputs up to date with deltas, as FullHistoryMerger does
+static void BM_ApplyingDeltasToFlatTH2F(benchmark::State& state)
+{
+  const size_t nInputs = state.range(0);
+  auto latest = createInputs(nInputs, 1);
+  auto deltas = createInputs(nInputs, 2);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < nInputs; i++) {
+      flat::merge(latest[i], deltas[i].data(), deltas[i].size());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nInputs);
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nInputs : {100, 1000}) {
+    for (int format : {0, 1, 2}) {
+      bench->Args({nInputs, format});
+    }
+  }
+}
+
+BENCHMARK(BM_MergingSerializedTH2F)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ApplyingDeltasToFlatTH2F)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
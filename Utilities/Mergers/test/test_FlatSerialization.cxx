@@ -0,0 +1,290 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file test_FlatSerialization.cxx
+/// \brief A unit test of the flat format of mergeable objects, compared to merging with ROOT
+
+#define BOOST_TEST_MODULE Test Utilities MergerFlatSerialization
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Mergers/FlatSerialization.h"
+#include "Mergers/MergerAlgorithm.h"
+#include "Mergers/CustomMergeableTObject.h"
+#include "Mergers/CustomMergeableObject.h"
+
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+#include <TProfile.h>
+#include <TRandom3.h>
+
+#include <memory>
+
+using namespace o2::mergers;
+
+void fill(TH1& histo, size_t entries, unsigned seed, bool weighted = false)
+{
+  TRandom3 random(seed);
+  for (size_t i = 0; i < entries; i++) {
+    double weight = weighted ? random.Uniform(0.5, 2.) : 1.;
+    // some entries go to the underflow and overflow bins
+    double x = random.Gaus(5, 3);
+    double y = random.Gaus(5, 3);
+    double z = random.Gaus(5, 3);
+    if (histo.GetDimension() == 1) {
+      histo.Fill(x, weight);
+    } else if (histo.GetDimension() == 2) {
+      dynamic_cast<TH2&>(histo).Fill(x, y, weight);
+    } else {
+      dynamic_cast<TH3&>(histo).Fill(x, y, z, weight);
+    }
+  }
+}
+
+void checkEqual(const TH1& result, const TH1& expected)
+{
+  BOOST_REQUIRE_EQUAL(result.GetNcells(), expected.GetNcells());
+  for (int bin = 0; bin < expected.GetNcells(); bin++) {
+    BOOST_CHECK_CLOSE(result.GetBinContent(bin), expected.GetBinContent(bin), 1e-9);
+    BOOST_CHECK_CLOSE(result.GetBinError(bin), expected.GetBinError(bin), 1e-9);
+  }
+  BOOST_CHECK_EQUAL(result.GetSumw2N(), expected.GetSumw2N());
+  BOOST_CHECK_CLOSE(result.GetEntries(), expected.GetEntries(), 1e-9);
+  double stats[TH1::kNstat] = {0.};
+  double expectedStats[TH1::kNstat] = {0.};
+  result.GetStats(stats);
+  expected.GetStats(expectedStats);
+  for (int i = 0; i < TH1::kNstat; i++) {
+    BOOST_CHECK_CLOSE(stats[i], expectedStats[i], 1e-9);
+  }
+}
+
+// merges 'nObjects' clones of the histogram filled with different data with ROOT and in the flat format
+void checkMergingAsROOT(const TH1& prototype, bool weighted = false, size_t nObjects = 5)
+{
+  std::unique_ptr<TH1> expected(dynamic_cast<TH1*>(prototype.Clone("expected")));
+  std::unique_ptr<TH1> result(dynamic_cast<TH1*>(prototype.Clone("result")));
+  fill(*expected, 1000, 1, weighted);
+  fill(*result, 1000, 1, weighted);
+
+  std::vector<char> buffer;
+  for (size_t i = 0; i < nObjects; i++) {
+    std::unique_ptr<TH1> other(dynamic_cast<TH1*>(prototype.Clone("other")));
+    fill(*other, 1000, 2 + i, weighted);
+    BOOST_REQUIRE(flat::serialize(*other, buffer));
+    BOOST_CHECK(flat::isFlat(buffer.data(), buffer.size()));
+    BOOST_CHECK(!flat::isDelta(buffer.data(), buffer.size()));
+
+    algorithm::merge(expected.get(), other.get());
+    flat::merge(result.get(), buffer.data(), buffer.size());
+  }
+  checkEqual(*result, *expected);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMergingHistograms)
+{
+  checkMergingAsROOT(TH1F("th1f", "th1f", 100, 0, 10));
+  checkMergingAsROOT(TH1D("th1d", "th1d", 100, 0, 10));
+  checkMergingAsROOT(TH1I("th1i", "th1i", 100, 0, 10));
+  checkMergingAsROOT(TH1S("th1s", "th1s", 100, 0, 10));
+  checkMergingAsROOT(TH2F("th2f", "th2f", 20, 0, 10, 30, 0, 10));
+  checkMergingAsROOT(TH2D("th2d", "th2d", 20, 0, 10, 30, 0, 10));
+  checkMergingAsROOT(TH3F("th3f", "th3f", 10, 0, 10, 15, 0, 10, 20, 0, 10));
+  checkMergingAsROOT(TH3I("th3i", "th3i", 10, 0, 10, 15, 0, 10, 20, 0, 10));
+
+  const double edges[] = {0, 1, 2, 4, 8, 10};
+  checkMergingAsROOT(TH1F("variable", "variable", 5, edges));
+  checkMergingAsROOT(TH2D("variable2", "variable2", 5, edges, 5, edges));
+}
+
+BOOST_AUTO_TEST_CASE(FlatMergingWeightedHistograms)
+{
+  TH1F th1f("th1f", "th1f", 100, 0, 10);
+  th1f.Sumw2();
+  checkMergingAsROOT(th1f, true);
+  TH2D th2d("th2d", "th2d", 20, 0, 10, 30, 0, 10);
+  th2d.Sumw2();
+  checkMergingAsROOT(th2d, true);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMergingWithAndWithoutSumw2)
+{
+  TH1F target("target", "target", 100, 0, 10);
+  TH1F other("other", "other", 100, 0, 10);
+  other.Sumw2();
+  fill(target, 1000, 1);
+  fill(other, 1000, 2, true);
+
+  std::unique_ptr<TH1> expected(dynamic_cast<TH1*>(target.Clone("expected")));
+  algorithm::merge(expected.get(), &other);
+
+  std::vector<char> buffer;
+  BOOST_REQUIRE(flat::serialize(other, buffer));
+  flat::merge(&target, buffer.data(), buffer.size());
+  checkEqual(target, *expected);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMergingEmptyHistograms)
+{
+  TH1F target("target", "target", 100, 0, 10);
+  TH1F empty("empty", "empty", 100, 0, 10);
+  fill(target, 1000, 1);
+  std::unique_ptr<TH1> expected(dynamic_cast<TH1*>(target.Clone("expected")));
+
+  std::vector<char> buffer;
+  BOOST_REQUIRE(flat::serialize(empty, buffer));
+  flat::merge(&target, buffer.data(), buffer.size());
+  checkEqual(target, *expected);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMergingDifferentBinning)
+{
+  TH1F target("target", "target", 100, 0, 10);
+  TH1F other("other", "other", 50, 0, 10);
+  fill(target, 1000, 1);
+  fill(other, 1000, 2);
+
+  std::unique_ptr<TH1> expected(dynamic_cast<TH1*>(target.Clone("expected")));
+  algorithm::merge(expected.get(), &other);
+
+  std::vector<char> buffer;
+  BOOST_REQUIRE(flat::serialize(other, buffer));
+  flat::merge(&target, buffer.data(), buffer.size());
+  checkEqual(target, *expected);
+}
+
+BOOST_AUTO_TEST_CASE(FlatExtraction)
+{
+  const double edges[] = {0, 1, 2, 4, 8, 10};
+  TH2D histo("histo", "histo title", 5, edges, 20, 0, 10);
+  histo.GetXaxis()->SetTitle("x title");
+  histo.Sumw2();
+  fill(histo, 1000, 1, true);
+
+  std::vector<char> buffer;
+  BOOST_REQUIRE(flat::serialize(histo, buffer));
+  auto store = flat::extractObjectFrom(buffer.data(), buffer.size());
+  BOOST_REQUIRE(std::holds_alternative<TObjectPtr>(store));
+  auto extracted = dynamic_cast<TH2D*>(std::get<TObjectPtr>(store).get());
+  BOOST_REQUIRE(extracted != nullptr);
+  BOOST_CHECK_EQUAL(std::string(extracted->GetName()), "histo");
+  BOOST_CHECK_EQUAL(std::string(extracted->GetTitle()), "histo title");
+  BOOST_CHECK_EQUAL(std::string(extracted->GetXaxis()->GetTitle()), "x title");
+  BOOST_CHECK_EQUAL(extracted->GetXaxis()->GetBinUpEdge(3), 4);
+  checkEqual(*extracted, histo);
+
+  // the same goes through ObjectStore
+  BOOST_CHECK(flat::serialize(store, buffer));
+
+  buffer[0] = 0;
+  BOOST_CHECK(!flat::isFlat(buffer.data(), buffer.size()));
+  BOOST_CHECK_THROW(flat::extractObjectFrom(buffer.data(), buffer.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(FlatTruncatedBuffer)
+{
+  TH1F histo("histo", "histo", 100, 0, 10);
+  fill(histo, 1000, 1);
+  std::vector<char> buffer;
+  BOOST_REQUIRE(flat::serialize(histo, buffer));
+  BOOST_CHECK_THROW(flat::extractObjectFrom(buffer.data(), buffer.size() - 1), std::runtime_error);
+  BOOST_CHECK_THROW(flat::merge(&histo, buffer.data(), buffer.size() / 2), std::runtime_error);
+}
+
+void checkDeltaUpdates(const TH1& prototype, bool weighted)
+{
+  std::unique_ptr<TH1> previous(dynamic_cast<TH1*>(prototype.Clone("previous")));
+  fill(*previous, 1000, 1, weighted);
+  std::unique_ptr<TH1> current(dynamic_cast<TH1*>(previous->Clone("current")));
+  fill(*current, 10, 2, weighted); // only a few bins change
+
+  std::vector<char> full;
+  std::vector<char> delta;
+  BOOST_REQUIRE(flat::serialize(*previous, full));
+  BOOST_REQUIRE(flat::serializeDelta(*current, *previous, delta));
+  BOOST_CHECK(flat::isDelta(delta.data(), delta.size()));
+  BOOST_CHECK_LT(delta.size(), full.size());
+
+  // applied to an object
+  std::unique_ptr<TH1> result(dynamic_cast<TH1*>(previous->Clone("result")));
+  flat::merge(result.get(), delta.data(), delta.size());
+  checkEqual(*result, *current);
+
+  // applied to a flat buffer
+  flat::merge(full, delta.data(), delta.size());
+  auto store = flat::extractObjectFrom(full.data(), full.size());
+  checkEqual(*dynamic_cast<TH1*>(std::get<TObjectPtr>(store).get()), *current);
+}
+
+BOOST_AUTO_TEST_CASE(FlatDeltaUpdates)
+{
+  checkDeltaUpdates(TH2F("th2f", "th2f", 20, 0, 10, 30, 0, 10), false);
+  checkDeltaUpdates(TH1I("th1i", "th1i", 100, 0, 10), false);
+  TH2D weighted("weighted", "weighted", 20, 0, 10, 30, 0, 10);
+  weighted.Sumw2();
+  checkDeltaUpdates(weighted, true);
+
+  // the deltas need the same binning
+  TH1F previous("previous", "previous", 100, 0, 10);
+  TH1F current("current", "current", 50, 0, 10);
+  std::vector<char> delta;
+  BOOST_CHECK(!flat::serializeDelta(current, previous, delta));
+  BOOST_CHECK(delta.empty());
+}
+
+BOOST_AUTO_TEST_CASE(FlatUnsupportedObjects)
+{
+  std::vector<char> buffer;
+
+  TProfile profile("profile", "profile", 10, 0, 10);
+  BOOST_CHECK(!flat::serialize(profile, buffer));
+  BOOST_CHECK(buffer.empty());
+
+  TH1F labels("labels", "labels", 3, 0, 3);
+  labels.GetXaxis()->SetBinLabel(1, "a");
+  BOOST_CHECK(!flat::serialize(labels, buffer));
+
+  BOOST_CHECK(!flat::serialize(ObjectStore{std::monostate{}}, buffer));
+}
+
+BOOST_AUTO_TEST_CASE(FlatCustomObjects)
+{
+  std::vector<char> buffer;
+  {
+    CustomMergeableTObject target("target", 1);
+    CustomMergeableTObject other("other", 2);
+    BOOST_REQUIRE(flat::serialize(static_cast<TObject&>(other), buffer));
+    flat::merge(static_cast<TObject*>(&target), buffer.data(), buffer.size());
+    BOOST_CHECK_EQUAL(target.getSecret(), 3);
+
+    auto store = flat::extractObjectFrom(buffer.data(), buffer.size());
+    BOOST_REQUIRE(std::holds_alternative<TObjectPtr>(store));
+    BOOST_CHECK_EQUAL(dynamic_cast<CustomMergeableTObject*>(std::get<TObjectPtr>(store).get())->getSecret(), 2);
+  }
+  {
+    CustomMergeableObject target(1);
+    CustomMergeableObject other(2);
+    BOOST_REQUIRE(flat::serialize(other, buffer));
+    flat::merge(&target, buffer.data(), buffer.size());
+    BOOST_CHECK_EQUAL(target.getSecret(), 3);
+
+    auto store = flat::extractObjectFrom(buffer.data(), buffer.size());
+    BOOST_REQUIRE(std::holds_alternative<MergeInterfacePtr>(store));
+    BOOST_CHECK_EQUAL(dynamic_cast<CustomMergeableObject*>(std::get<MergeInterfacePtr>(store).get())->getSecret(), 2);
+
+    // a histogram cannot be merged into a custom object
+    TH1F histo("histo", "histo", 10, 0, 10);
+    BOOST_REQUIRE(flat::serialize(histo, buffer));
+    BOOST_CHECK_THROW(flat::merge(&target, buffer.data(), buffer.size()), std::runtime_error);
+  }
+}
@@ -28,11 +28,14 @@
 #include <CommonUtils/ConfigurableParam.h>
 #include <CommonUtils/RngHelper.h>
 #include "Field/MagneticField.h"
+#include "PrimaryEventQueue.h"
 #include <TGeoGlobalMagField.h>
 #include <typeinfo>
 #include <thread>
+#include <chrono>
 #include <TROOT.h>
 #include <TStopwatch.h>
+#include <Monitoring/MonitoringFactory.h>
 
 namespace o2
 {
@@ -45,12 +48,26 @@ class O2PrimaryServerDevice final : public FairMQDevice
   /// Default constructor
   O2PrimaryServerDevice() = default;
 
+  // state of the event generator, owned by the generator thread
+  struct GeneratorState {
+    o2::eventgen::PrimaryGenerator primGen;
+    o2::dataformats::MCEventHeader eventHeader;
+    o2::data::Stack stack;
+  };
+
+  // a generated event waiting to be distributed
+  struct GeneratedEvent {
+    std::vector<TParticle> primaries;
+    o2::dataformats::MCEventHeader header;
+  };
+
   /// Default destructor
   ~O2PrimaryServerDevice() final
   {
     if (mGeneratorThread.joinable()) {
       mGeneratorThread.join();
     }
+    mEventQueue.stop();
   }
 
  protected:
@@ -65,29 +82,64 @@ class O2PrimaryServerDevice final : public FairMQDevice
     TGeoGlobalMagField::Instance()->SetField(field);
     TGeoGlobalMagField::Instance()->Lock();
 
-    o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, &mPrimGen);
-    mPrimGen.SetEvent(&mEventHeader);
+    mGenerator = std::make_unique<GeneratorState>();
+    o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, &mGenerator->primGen);
+    mGenerator->primGen.SetEvent(&mGenerator->eventHeader);
 
     auto embedinto_filename = conf.getEmbedIntoFileName();
     if (!embedinto_filename.empty()) {
-      mPrimGen.embedInto(embedinto_filename);
+      mGenerator->primGen.embedInto(embedinto_filename);
     }
-    mPrimGen.Init();
+    mGenerator->primGen.Init();
+    mGenerator->stack.setExternalMode(true);
     LOG(INFO) << "Generator initialization took " << timer.CpuTime() << "s";
-    generateEvent(); // generate a first event
+    // start the generation of the events ahead of the requests, on a single thread: the generators,
+    // the vertex smearing and the generator factory draw from the global gRandom, which cannot be
+    // shared by several generator threads
+    mEventQueue.start({[state = mGenerator.get()](GeneratedEvent& event) { generateEvent(*state, event); }},
+                      mEventQueueSize, mMaxEvents);
   }
 
-  // function generating one event
-  void generateEvent()
+  // function generating one event with the given generator
+  static void generateEvent(GeneratorState& gen, GeneratedEvent& event)
   {
     TStopwatch timer;
     timer.Start();
-    mStack->Reset();
-    mPrimGen.GenerateEvent(mStack);
+    gen.stack.Reset();
+    gen.primGen.GenerateEvent(&gen.stack);
+    event.primaries = gen.stack.getPrimaries();
+    event.header = gen.eventHeader;
     timer.Stop();
     LOG(INFO) << "Event generation took " << timer.CpuTime() << "s";
   }
 
+  // update the estimate of the per-worker throughput (primaries per second) from the interval
+  // between two requests: with all workers busy, the requests come every chunk time / nworkers
+  void updateThroughput()
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (mLastChunkSize > 0) {
+      auto interval = std::chrono::duration<double>(now - mLastRequestTime).count();
+      if (interval > 0) {
+        auto throughput = mLastChunkSize / (interval * mNWorkers);
+        mThroughput = mThroughput > 0 ? 0.8 * mThroughput + 0.2 * throughput : throughput;
+      }
+    }
+    mLastRequestTime = now;
+  }
+
+  // plan the chunks of the new event
+  void planChunks(int nprimaries)
+  {
+    int maxChunk = mChunkGranularity;
+    if (mChunkTime > 0 && mThroughput > 0) {
+      // chunks taking about mChunkTime seconds on a worker
+      maxChunk = std::clamp((int)(mThroughput * mChunkTime), 1, mChunkGranularity);
+    }
+    mChunks = splitIntoChunks(nprimaries, mNWorkers, maxChunk, maxChunk / 10);
+    mChunkEnd = nprimaries;
+  }
+
   void InitTask() final
   {
     LOG(INFO) << "Init Server device ";
@@ -105,14 +157,16 @@ class O2PrimaryServerDevice final : public FairMQDevice
     // update the parameters from stuff given at command line (overrides file-based version)
     o2::conf::ConfigurableParam::updateFromString(conf.getKeyValueString());
 
-    mStack = new o2::data::Stack();
-    mStack->setExternalMode(true);
-
     // MC ENGINE
     LOG(INFO) << "ENGINE SET TO " << vm["mcEngine"].as<std::string>();
     // CHUNK SIZE
     mChunkGranularity = vm["chunkSize"].as<unsigned int>();
     LOG(INFO) << "CHUNK SIZE SET TO " << mChunkGranularity;
+    mChunkTime = vm["chunkTime"].as<float>();
+    mNWorkers = std::max(1, conf.getNSimWorkers());
+    // EVENT GENERATION
+    mEventQueueSize = std::max(1, vm["genQueueSize"].as<int>());
+    LOG(INFO) << "EVENT QUEUE SIZE " << mEventQueueSize;
 
     // initial initial seed --> we should store this somewhere
     mInitialSeed = vm["seed"].as<int>();
@@ -121,6 +175,8 @@ class O2PrimaryServerDevice final : public FairMQDevice
 
     mMaxEvents = conf.getNEvents();
 
+    mMonitoring = o2::monitoring::MonitoringFactory::Get("infologger:///debug?primary-server");
+
     // need to make ROOT thread-safe since we use ROOT services in all places
     ROOT::EnableThreadSafety();
 
@@ -196,20 +252,28 @@ class O2PrimaryServerDevice final : public FairMQDevice
     }
 
     LOG(INFO) << "Received request for work ";
+    updateThroughput();
     if (mNeedNewEvent) {
       // we need a newly generated event now
       if (mGeneratorThread.joinable()) {
         mGeneratorThread.join();
       }
+      if (!mEventQueue.pop(mEvent)) {
+        return false;
+      }
+      auto depth = mEventQueue.size();
+      auto idleTime = mEventQueue.getIdleTime();
+      LOG(INFO) << "EVENT QUEUE DEPTH " << depth << " WORKER IDLE TIME " << idleTime << "s";
+      mMonitoring->send({depth, "primary_event_queue_depth"});
+      mMonitoring->send({idleTime, "primary_event_queue_idle_time_s"});
       mNeedNewEvent = false;
       mPartCounter = 0;
       counter++;
+      planChunks(mEvent.primaries.size());
     }
 
-    auto& prims = mStack->getPrimaries();
-    auto numberofparts = (int)std::ceil(prims.size() / (1. * mChunkGranularity));
-    // number of parts should be at least 1 (even if empty)
-    numberofparts = std::max(1, numberofparts);
+    auto& prims = mEvent.primaries;
+    int numberofparts = mChunks.size();
 
     o2::data::PrimaryChunk m;
     o2::data::SubEventInfo i;
@@ -219,17 +283,14 @@ class O2PrimaryServerDevice final : public FairMQDevice
     i.nparts = numberofparts;
     i.seed = counter + mInitialSeed;
     i.index = m.mParticles.size();
-    i.mMCEventHeader = mEventHeader;
+    i.mMCEventHeader = mEvent.header;
     m.mSubEventInfo = i;
 
-    int endindex = prims.size() - mPartCounter * mChunkGranularity;
-    int startindex = prims.size() - (mPartCounter + 1) * mChunkGranularity;
-    if (startindex < 0) {
-      startindex = 0;
-    }
-    if (endindex < 0) {
-      endindex = 0;
-    }
+    // the primaries are distributed starting from the end of the stack
+    int endindex = mChunkEnd;
+    int startindex = std::max(0, endindex - mChunks[mPartCounter]);
+    mChunkEnd = startindex;
+    mLastChunkSize = endindex - startindex;
 
     for (int index = startindex; index < endindex; ++index) {
       m.mParticles.emplace_back(prims[index]);
@@ -247,8 +308,6 @@ class O2PrimaryServerDevice final : public FairMQDevice
     mPartCounter++;
     if (mPartCounter == numberofparts) {
       mNeedNewEvent = true;
-      // start generation of a new event
-      mGeneratorThread = std::thread(&O2PrimaryServerDevice::generateEvent, this);
     }
 
     TMessage* tmsg = new TMessage(kMESS_OBJECT);
@@ -276,19 +335,26 @@ class O2PrimaryServerDevice final : public FairMQDevice
 
  private:
   std::string mOutChannelName = "";
-  o2::eventgen::PrimaryGenerator mPrimGen;
-  o2::dataformats::MCEventHeader mEventHeader;
-  o2::data::Stack* mStack = nullptr; // the stack which is filled (pointer since constructor to be called only init method)
-  int mChunkGranularity = 500; // how many primaries to send to a worker
-  int mLastPosition = 0;       // last position in stack vector
+  std::unique_ptr<GeneratorState> mGenerator;    // the generator, used by the generator thread of mEventQueue
+  PrimaryEventQueue<GeneratedEvent> mEventQueue; // the events generated ahead of the requests
+  GeneratedEvent mEvent;                         // the event being distributed
+  int mEventQueueSize = 2;     // how many events to generate ahead
+  int mChunkGranularity = 500; // maximal number of primaries to send to a worker
+  float mChunkTime = 0.;       // target processing time of a chunk in s, 0 for no adaptation to the throughput
+  int mNWorkers = 1;           // number of simulation workers
+  double mThroughput = 0.;     // estimated primaries per second per worker
+  std::chrono::steady_clock::time_point mLastRequestTime;
+  int mLastChunkSize = 0;
+  std::vector<int> mChunks; // chunk sizes of the current event
+  int mChunkEnd = 0;        // end of the next chunk in the primaries of the current event
   int mPartCounter = 0;
   bool mNeedNewEvent = true;
   int mMaxEvents = 2;
   int mInitialSeed = -1;
   int mPipeToDriver = -1; // handle for direct piper to driver (to communicate meta info)
+  std::unique_ptr<o2::monitoring::Monitoring> mMonitoring; // publishes the depth and the idle time of the event queue
 
-  std::thread mGeneratorThread; //! a thread used to concurrently init the particle generator
-                                //  or to generate events
+  std::thread mGeneratorThread; //! a thread used to concurrently init the particle generators
 };
 
 } // namespace devices
@@ -0,0 +1,170 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_DEVICES_PRIMARYEVENTQUEUE_H_
+#define O2_DEVICES_PRIMARYEVENTQUEUE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace devices
+{
+
+/// A bounded queue of pre-generated events, filled by a pool of generator threads.
+/// Generator i produces the events i, i + N, i + 2N, ... (N being the number of generators)
+/// and the events are handed out in the order of their index. The sequence of events hence
+/// only depends on the state (seed) of each generator and not on the thread scheduling.
+/// At most "capacity" generated events are kept in memory, including the next one to be handed out.
+template <typename Event>
+class PrimaryEventQueue
+{
+ public:
+  /// generates the next event of one generator into the argument
+  using Generator = std::function<void(Event&)>;
+
+  PrimaryEventQueue() = default;
+  PrimaryEventQueue(PrimaryEventQueue const&) = delete;
+  PrimaryEventQueue& operator=(PrimaryEventQueue const&) = delete;
+  ~PrimaryEventQueue() { stop(); }
+
+  /// start the generation of maxEvents events, one thread per generator
+  void start(std::vector<Generator> generators, int capacity, int maxEvents)
+  {
+    stop();
+    mGenerators = std::move(generators);
+    mCapacity = std::max(1, capacity);
+    mMaxEvents = maxEvents;
+    mNext = 0;
+    mStop = false;
+    mIdleTime = 0.;
+    mReady.clear();
+    for (int i = 0; i < (int)mGenerators.size(); ++i) {
+      mThreads.emplace_back(&PrimaryEventQueue::generate, this, i);
+    }
+  }
+
+  /// take the next event, waiting for it to be generated if needed.
+  /// Returns false once all the events were handed out.
+  bool pop(Event& event)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mNext >= mMaxEvents) {
+      return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    mCondition.wait(lock, [this]() { return mStop || mReady.count(mNext) > 0; });
+    mIdleTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto it = mReady.find(mNext);
+    if (it == mReady.end()) {
+      return false; // stopped
+    }
+    event = std::move(it->second);
+    mReady.erase(it);
+    mNext++;
+    lock.unlock();
+    mCondition.notify_all();
+    return true;
+  }
+
+  /// stop the generation and join the threads
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mCondition.notify_all();
+    for (auto& thread : mThreads) {
+      thread.join();
+    }
+    mThreads.clear();
+  }
+
+  /// number of events generated and not yet handed out
+  int size() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mReady.size();
+  }
+
+  /// total time in seconds spent in pop waiting for events to be generated
+  double getIdleTime() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mIdleTime;
+  }
+
+ private:
+  void generate(int generator)
+  {
+    int n = mGenerators.size();
+    for (int index = generator; index < mMaxEvents; index += n) {
+      {
+        // do not run ahead of the consumer by more than the capacity
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this, index]() { return mStop || index < mNext + mCapacity; });
+        if (mStop) {
+          return;
+        }
+      }
+      Event event;
+      mGenerators[generator](event);
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mReady.emplace(index, std::move(event));
+      }
+      mCondition.notify_all();
+    }
+  }
+
+  std::vector<Generator> mGenerators;
+  std::vector<std::thread> mThreads;
+  mutable std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::map<int, Event> mReady; // generated events by index
+  int mCapacity = 1;
+  int mMaxEvents = 0;
+  int mNext = 0; // index of the next event to hand out
+  bool mStop = false;
+  double mIdleTime = 0.;
+};
+
+/// Split n primaries into chunks for nWorkers workers: chunks of at most maxChunk primaries,
+/// shrinking (not below minChunk) to the remaining share of each worker towards the end of
+/// the event, so that the last chunks do not leave most of the workers idle.
+inline std::vector<int> splitIntoChunks(int n, int nWorkers, int maxChunk, int minChunk)
+{
+  std::vector<int> chunks;
+  maxChunk = std::max(1, maxChunk);
+  minChunk = std::clamp(minChunk, 1, maxChunk);
+  nWorkers = std::max(1, nWorkers);
+  while (n > 0) {
+    int chunk = std::min(n, std::clamp((n + nWorkers - 1) / nWorkers, minChunk, maxChunk));
+    chunks.push_back(chunk);
+    n -= chunk;
+  }
+  if (chunks.empty()) {
+    chunks.push_back(0); // an empty event is still sent as one part
+  }
+  return chunks;
+}
+
+} // namespace devices
+} // namespace o2
+
+#endif
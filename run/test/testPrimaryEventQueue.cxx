@@ -0,0 +1,81 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test PrimaryEventQueue
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "../PrimaryEventQueue.h"
+#include <numeric>
+#include <random>
+
+using namespace o2::devices;
+
+using Event = std::vector<double>;
+
+// generate nEvents with nGenerators generators of fixed seeds, each event taking a random time
+std::vector<Event> generateEvents(int nGenerators, int capacity, int nEvents)
+{
+  std::vector<std::mt19937> engines;
+  for (int i = 0; i < nGenerators; ++i) {
+    engines.emplace_back(1234 + i);
+  }
+  std::vector<PrimaryEventQueue<Event>::Generator> generators;
+  for (int i = 0; i < nGenerators; ++i) {
+    generators.emplace_back([&engine = engines[i]](Event& event) {
+      std::uniform_int_distribution<int> mult(0, 100);
+      std::uniform_real_distribution<double> flat(0., 1.);
+      event.resize(mult(engine));
+      for (auto& value : event) {
+        value = flat(engine);
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(std::random_device{}() % 2000));
+    });
+  }
+  PrimaryEventQueue<Event> queue;
+  queue.start(std::move(generators), capacity, nEvents);
+  std::vector<Event> events;
+  Event event;
+  while (queue.pop(event)) {
+    BOOST_CHECK(queue.size() <= capacity);
+    events.push_back(event);
+  }
+  return events;
+}
+
+BOOST_AUTO_TEST_CASE(Reproducibility)
+{
+  for (int nGenerators : {1, 3}) {
+    auto events = generateEvents(nGenerators, 2, 20);
+    BOOST_REQUIRE_EQUAL(events.size(), 20);
+    auto again = generateEvents(nGenerators, 5, 20);
+    BOOST_CHECK(events == again);
+  }
+  // with a single generator, the events are those of its sequence
+  auto single = generateEvents(1, 2, 10);
+  auto triple = generateEvents(3, 2, 10);
+  BOOST_CHECK(single[0] == triple[0]);
+  BOOST_CHECK(single[1] == triple[3]);
+}
+
+BOOST_AUTO_TEST_CASE(Chunks)
+{
+  // a single worker gets chunks of the maximal size
+  BOOST_CHECK((splitIntoChunks(1200, 1, 500, 50) == std::vector<int>{500, 500, 200}));
+  // the chunks shrink towards the end of the event
+  auto chunks = splitIntoChunks(10000, 8, 500, 50);
+  BOOST_CHECK_EQUAL(std::accumulate(chunks.begin(), chunks.end(), 0), 10000);
+  BOOST_CHECK_EQUAL(chunks.front(), 500);
+  BOOST_CHECK(std::is_sorted(chunks.rbegin(), chunks.rend()));
+  BOOST_CHECK(chunks.back() <= 50);
+  // an empty event is sent in one part
+  BOOST_CHECK((splitIntoChunks(0, 8, 500, 50) == std::vector<int>{0}));
+}